@@ -5,4 +5,4 @@
 CC=gcc
 LIBSLOCAL=-L/usr/lib -llapack -lblas -lm
 INCLUDEBLASLOCAL=-I/usr/include
-OPTCLOCAL=-fPIC -march=native
+OPTCLOCAL=-fPIC -march=native -O3 -fopenmp
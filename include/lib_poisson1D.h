@@ -8,8 +8,47 @@
 #include <math.h>
 #include <float.h>
 #include <limits.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+/*
+ * Index type of every size, leading dimension, pivot and index of the library: int by default,
+ * int64_t with -DPOISSON1D_ILP64 (make ILP64=1) for operators beyond 2^31 entries. The LAPACK
+ * prototypes then take 64-bit integers too, and the build must link an ILP64 BLAS/LAPACK
+ * (e.g. OpenBLAS built with INTERFACE64=1, whose cblas.h also has 64-bit sizes).
+ */
+#ifdef POISSON1D_ILP64
+typedef int64_t poisson1D_int;
+#define POISSON1D_INT_MAX INT64_MAX
+#define POISSON1D_PRId PRId64  /* printf("%" POISSON1D_PRId, la) */
+#define lapack_int int64_t
+#else
+typedef int poisson1D_int;
+#define POISSON1D_INT_MAX INT_MAX
+#define POISSON1D_PRId "d"
+#endif
+
 #include "atlas_headers.h"
 
+/**
+ * Allocate an array of m*n elements of size bytes, checking the products instead of letting
+ * them wrap around (m*n in poisson1D_int, the byte count in size_t)
+ * @param m: Number of rows (e.g. lab)
+ * @param n: Number of columns (e.g. la)
+ * @param size: Size of one element in bytes
+ * @return Allocated array, NULL if m or n is negative, if a product overflows or if malloc fails
+ */
+void *poisson1D_malloc(poisson1D_int m, poisson1D_int n, size_t size);
+
+/**
+ * Check that m*n is representable as a poisson1D_int (sizes computed in the index type, such as
+ * the 3*la-2 nonzeros of the CSR operator)
+ * @param m: First factor (nonnegative)
+ * @param n: Second factor (nonnegative)
+ * @return 1 if m*n <= POISSON1D_INT_MAX, 0 otherwise
+ */
+int poisson1D_index_fits(poisson1D_int m, poisson1D_int n);
+
 /**
  * Set up the Poisson 1D operator in General Band (GB) storage format with column-major ordering
  * @param AB: Output matrix in GB format (allocated with size lab*la)
@@ -17,7 +56,7 @@
  * @param la: Number of columns in the matrix (problem size)
  * @param kv: Number of superdiagonals in the band storage
  */
-void set_GB_operator_colMajor_poisson1D(double* AB, int* lab, int *la, int *kv);
+void set_GB_operator_colMajor_poisson1D(double* AB, poisson1D_int* lab, poisson1D_int *la, poisson1D_int *kv);
 
 /**
  * Set up the identity operator in General Band (GB) storage format with column-major ordering
@@ -26,7 +65,31 @@ void set_GB_operator_colMajor_poisson1D(double* AB, int* lab, int *la, int *kv);
  * @param la: Number of columns in the matrix (problem size)
  * @param kv: Number of superdiagonals in the band storage
  */
-void set_GB_operator_colMajor_poisson1D_Id(double* AB, int* lab, int *la, int *kv);
+void set_GB_operator_colMajor_poisson1D_Id(double* AB, poisson1D_int* lab, poisson1D_int *la, poisson1D_int *kv);
+
+/**
+ * Set up the variable-coefficient operator -(kappa u')' in General Band (GB) storage format with
+ * column-major ordering: row i is (-kappa[i], kappa[i] + kappa[i+1], -kappa[i+1]), the conductivity
+ * being given at the la+1 cell faces (kappa = 1 gives the Poisson operator -1, 2, -1)
+ * @param AB: Output matrix in GB format (allocated with size lab*la)
+ * @param lab: Leading dimension of AB (number of rows in the band storage)
+ * @param la: Number of columns in the matrix (problem size)
+ * @param kv: Number of superdiagonals in the band storage
+ * @param kappa: Conductivity at the cell faces (size la+1, kappa[i] between points i-1 and i)
+ */
+void set_GB_operator_colMajor_poisson1D_varcoef(double* AB, poisson1D_int* lab, poisson1D_int *la, poisson1D_int *kv, double *kappa);
+
+/**
+ * Set up the implicit operator I + c * A of the theta-scheme in General Band (GB) storage format
+ * with column-major ordering, A being the Poisson operator of set_GB_operator_colMajor_poisson1D
+ * (c = theta * dt / h^2)
+ * @param AB: Output matrix in GB format (allocated with size lab*la)
+ * @param lab: Leading dimension of AB (number of rows in the band storage)
+ * @param la: Number of columns in the matrix (problem size)
+ * @param kv: Number of superdiagonals in the band storage
+ * @param c: Scaling of the Poisson operator
+ */
+void set_GB_operator_colMajor_poisson1D_shifted(double* AB, poisson1D_int* lab, poisson1D_int *la, poisson1D_int *kv, double *c);
 
 /**
  * Set up the right-hand side (RHS) vector for 1D Poisson problem with Dirichlet boundary conditions
@@ -35,7 +98,17 @@ void set_GB_operator_colMajor_poisson1D_Id(double* AB, int* lab, int *la, int *k
  * @param BC0: Boundary condition at x=0 (left boundary)
  * @param BC1: Boundary condition at x=1 (right boundary)
  */
-void set_dense_RHS_DBC_1D(double* RHS, int* la, double* BC0, double* BC1);
+void set_dense_RHS_DBC_1D(double* RHS, poisson1D_int* la, double* BC0, double* BC1);
+
+/**
+ * Set up nrhs right-hand side vectors for 1D Poisson problems with Dirichlet boundary conditions
+ * @param RHS: Output right-hand sides (allocated with size la*nrhs, column k at RHS + k*la)
+ * @param la: Problem size (number of interior grid points)
+ * @param nrhs: Number of right-hand sides
+ * @param BC0: Boundary conditions at x=0 (size nrhs)
+ * @param BC1: Boundary conditions at x=1 (size nrhs)
+ */
+void set_dense_RHS_DBC_1D_batch(double* RHS, poisson1D_int* la, poisson1D_int* nrhs, double* BC0, double* BC1);
 
 /**
  * Compute the analytical solution for 1D Poisson problem with Dirichlet boundary conditions
@@ -45,14 +118,36 @@ void set_dense_RHS_DBC_1D(double* RHS, int* la, double* BC0, double* BC1);
  * @param BC0: Boundary condition at x=0 (left boundary)
  * @param BC1: Boundary condition at x=1 (right boundary)
  */
-void set_analytical_solution_DBC_1D(double* EX_SOL, double* X, int* la, double* BC0, double* BC1);
+void set_analytical_solution_DBC_1D(double* EX_SOL, double* X, poisson1D_int* la, double* BC0, double* BC1);
+
+/**
+ * Set up the right-hand side of -(kappa u')' = 0 with Dirichlet boundary conditions
+ * @param RHS: Output right-hand side (allocated with size la)
+ * @param la: Problem size (number of interior grid points)
+ * @param kappa: Conductivity at the cell faces (size la+1)
+ * @param BC0: Boundary condition at x=0
+ * @param BC1: Boundary condition at x=1
+ */
+void set_dense_RHS_DBC_1D_varcoef(double* RHS, poisson1D_int* la, double *kappa, double* BC0, double* BC1);
+
+/**
+ * Compute the exact solution of the discrete problem -(kappa u')' = 0 with Dirichlet boundary
+ * conditions: the flux kappa[i] * (u[i] - u[i-1]) is the same on every face, so u grows with
+ * the accumulated resistance sum(1 / kappa)
+ * @param EX_SOL: Output solution vector (allocated with size la)
+ * @param la: Problem size (number of interior grid points)
+ * @param kappa: Conductivity at the cell faces (size la+1, positive)
+ * @param BC0: Boundary condition at x=0
+ * @param BC1: Boundary condition at x=1
+ */
+void set_exact_solution_DBC_1D_varcoef(double* EX_SOL, poisson1D_int* la, double *kappa, double* BC0, double* BC1);
 
 /**
  * Generate uniformly spaced grid points in [0,1]
  * @param x: Output array of grid points (allocated with size la)
  * @param la: Number of interior grid points
  */
-void set_grid_points_1D(double* x, int* la);
+void set_grid_points_1D(double* x, poisson1D_int* la);
 
 /**
  * Compute the relative forward error between two vectors
@@ -61,7 +156,63 @@ void set_grid_points_1D(double* x, int* la);
  * @param la: Vector size
  * @return Relative forward error ||x-y||/||x||
  */
-double relative_forward_error(double* x, double* y, int* la);
+double relative_forward_error(double* x, double* y, poisson1D_int* la);
+
+#define POISSON1D_WS_RICHARDSON 0     /* richardson_alpha_ws, richardson_jacobi_ws */
+#define POISSON1D_WS_RICHARDSON_MB 1  /* richardson_MB_ws */
+#define POISSON1D_WS_REDBLACK 2       /* richardson_MB_redblack_ws */
+#define POISSON1D_WS_CSR 3            /* richardson_alpha_csr_ws, richardson_alpha_dia_ws, richardson_alpha_sell_ws */
+#define POISSON1D_WS_CSC 4            /* richardson_alpha_csc_ws */
+#define POISSON1D_WS_CG 5             /* conjugate_gradient_op_ws, conjugate_gradient_ws and its CSR, DIA, SELL variants */
+#define POISSON1D_WS_CHEBYSHEV 6      /* chebyshev_op_ws, chebyshev_ws, chebyshev_csr_ws, chebyshev_csc_ws */
+#define POISSON1D_WS_NORM 7           /* relative_forward_error_ws */
+#define POISSON1D_WS_ALL 8            /* Large enough for every method above */
+
+/**
+ * Caller-owned scratch space for the *_ws solvers and norms. Create it once (per thread)
+ * and reuse it: the *_ws routines do not allocate.
+ */
+typedef struct {
+    double *work;   // scratch array
+    size_t size;    // number of doubles in work
+} Poisson1DWorkspace;
+
+/**
+ * Scratch size needed by a method
+ * @param method: POISSON1D_WS_*
+ * @param la: Problem size
+ * @return Number of doubles (0 for an unknown method)
+ */
+size_t poisson1D_workspace_query(int *method, poisson1D_int *la);
+
+/**
+ * Allocate a workspace of poisson1D_workspace_query(method, la) doubles
+ * @param method: POISSON1D_WS_* (POISSON1D_WS_ALL to share it between methods)
+ * @param la: Problem size
+ * @return Workspace, NULL on allocation failure
+ */
+Poisson1DWorkspace *poisson1D_workspace_create(int *method, poisson1D_int *la);
+
+/**
+ * Free a workspace created by poisson1D_workspace_create
+ * @param ws: Workspace (may be NULL)
+ */
+void poisson1D_workspace_destroy(Poisson1DWorkspace *ws);
+
+/**
+ * Scratch array of a workspace checked against the required size
+ * @param ws: Workspace
+ * @param size: Number of doubles needed
+ * @return ws->work, NULL (with a message on stderr) if ws is NULL or too small
+ */
+double *poisson1D_workspace_get(Poisson1DWorkspace *ws, size_t size);
+
+/**
+ * Relative forward error ||x-y||/||x|| using caller-provided scratch (POISSON1D_WS_NORM)
+ * @param ws: Workspace
+ * @return Relative forward error, DBL_MAX if the workspace is too small
+ */
+double relative_forward_error_ws(double* x, double* y, poisson1D_int* la, Poisson1DWorkspace *ws);
 
 /**
  * Write the GB operator matrix in AIJ (triplet) format to a file
@@ -69,7 +220,7 @@ double relative_forward_error(double* x, double* y, int* la);
  * @param la: Problem size
  * @param filename: Output filename
  */
-void write_GB2AIJ_operator_poisson1D(double* AB, int *la, char* filename);
+void write_GB2AIJ_operator_poisson1D(double* AB, poisson1D_int *la, char* filename);
 
 /**
  * Write the GB operator matrix in row-major format to a file
@@ -78,7 +229,7 @@ void write_GB2AIJ_operator_poisson1D(double* AB, int *la, char* filename);
  * @param la: Problem size
  * @param filename: Output filename
  */
-void write_GB_operator_rowMajor_poisson1D(double* AB, int* lab, int *la, char* filename);
+void write_GB_operator_rowMajor_poisson1D(double* AB, poisson1D_int* lab, poisson1D_int *la, char* filename);
 
 /**
  * Write the GB operator matrix in column-major format to a file
@@ -87,7 +238,7 @@ void write_GB_operator_rowMajor_poisson1D(double* AB, int* lab, int *la, char* f
  * @param la: Problem size
  * @param filename: Output filename
  */
-void write_GB_operator_colMajor_poisson1D(double* AB, int* lab, int* la, char* filename);
+void write_GB_operator_colMajor_poisson1D(double* AB, poisson1D_int* lab, poisson1D_int* la, char* filename);
 
 /**
  * Write a vector to a file (one value per line)
@@ -95,7 +246,7 @@ void write_GB_operator_colMajor_poisson1D(double* AB, int* lab, int* la, char* f
  * @param la: Vector size
  * @param filename: Output filename
  */
-void write_vec(double* vec, int* la, char* filename);
+void write_vec(double* vec, poisson1D_int* la, char* filename);
 
 /**
  * Write two vectors as x-y pairs to a file (tab-separated)
@@ -104,35 +255,35 @@ void write_vec(double* vec, int* la, char* filename);
  * @param la: Vector size
  * @param filename: Output filename
  */
-void write_xy(double* vec, double* x, int* la, char* filename);
+void write_xy(double* vec, double* x, poisson1D_int* la, char* filename);
 
 /**
  * Compute all eigenvalues of the 1D Poisson operator
  * @param eigval: Output array of eigenvalues (allocated with size la)
  * @param la: Problem size
  */
-void eig_poisson1D(double* eigval, int *la);
+void eig_poisson1D(double* eigval, poisson1D_int *la);
 
 /**
  * Compute the maximum eigenvalue of the 1D Poisson operator
  * @param la: Problem size
  * @return Maximum eigenvalue
  */
-double eigmax_poisson1D(int *la);
+double eigmax_poisson1D(poisson1D_int *la);
 
 /**
  * Compute the minimum eigenvalue of the 1D Poisson operator
  * @param la: Problem size
  * @return Minimum eigenvalue
  */
-double eigmin_poisson1D(int *la);
+double eigmin_poisson1D(poisson1D_int *la);
 
 /**
  * Compute the optimal relaxation parameter alpha for Richardson iteration
  * @param la: Problem size
  * @return Optimal alpha value
  */
-double richardson_alpha_opt(int *la);
+double richardson_alpha_opt(poisson1D_int *la);
 
 /**
  * Solve linear system using Richardson iteration with fixed relaxation parameter alpha
@@ -149,7 +300,59 @@ double richardson_alpha_opt(int *la);
  * @param resvec: Output residual history (allocated with size maxit)
  * @param nbite: Output number of iterations performed
  */
-void richardson_alpha(double *AB, double *RHS, double *X, double *alpha_rich, int *lab, int *la,int *ku, int*kl, double *tol, int *maxit, double *resvec, int *nbite);
+void richardson_alpha(double *AB, double *RHS, double *X, double *alpha_rich, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *tol, int *maxit, double *resvec, int *nbite);
+
+/**
+ * richardson_alpha with caller-provided scratch (POISSON1D_WS_RICHARDSON), no allocation
+ * @param ws: Workspace (nbite = 0 and X unchanged if too small)
+ */
+void richardson_alpha_ws(double *AB, double *RHS, double *X, double *alpha_rich, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws);
+
+/**
+ * Solve linear system using matrix-free Richardson iteration for the tridiag(-1, 2, -1) stencil:
+ * richardson_stencil_op on the operator of set_stencil_operator_poisson1D. Residual, residual norm
+ * and update are computed in a single blocked sweep over X and RHS, without r or Ax scratch
+ * vectors. The update of the last iteration is applied to X as well.
+ * @param RHS: Right-hand side vector (size la)
+ * @param X: Solution vector (size la, input: initial guess, output: solution)
+ * @param alpha_rich: Relaxation parameter alpha
+ * @param la: Problem size
+ * @param tol: Convergence tolerance for residual norm
+ * @param maxit: Maximum number of iterations
+ * @param resvec: Output residual history (allocated with size maxit)
+ * @param nbite: Output number of iterations performed
+ */
+void richardson_alpha_stencil(double *RHS, double *X, double *alpha_rich, poisson1D_int *la, double *tol, int *maxit, double *resvec, int *nbite);
+
+#define POISSON1D_TILE_STEPS 32   /* Default number of sweeps per tile of richardson_tiled */
+#define POISSON1D_TILE_SIZE 256   /* Default tile length (points) of richardson_tiled */
+
+/**
+ * Temporally blocked Richardson / damped Jacobi on a tridiagonal GB matrix: the grid is cut into
+ * tiles of 'tile' points and each tile advances s iterations x <- x + w (b - A x) in cache before
+ * the next one (overlapped trapezoids: a tile loads s extra points on each side and recomputes
+ * them), so X, RHS, AB and MB are streamed once per s iterations instead of once per iteration.
+ * Tiles are independent (x_k read from one vector, x_{k+s} written to another) and distributed
+ * over the OpenMP threads. resvec is complete, but the tolerance is only tested every s
+ * iterations: the method stops at the first multiple of s whose residual is below tol.
+ * @param AB: Coefficient matrix in GB storage format (tridiagonal, packed: stride kl+ku+1)
+ * @param RHS: Right-hand side vector (size la)
+ * @param X: Solution vector (size la, input: initial guess, output: solution)
+ * @param MB: Jacobi preconditioner (w = alpha / M_ii, only the diagonal row ku is read: the MB
+ *            of extract_MB_jacobi_tridiag or AB itself), NULL for Richardson (w = alpha)
+ * @param alpha: Relaxation parameter (richardson_alpha_opt for Richardson, 1 for plain Jacobi)
+ * @param lab: Leading dimension of MB
+ * @param la: Problem size
+ * @param ku: Number of superdiagonals
+ * @param kl: Number of subdiagonals
+ * @param s: Iterations per tile between two convergence tests (<= 0: POISSON1D_TILE_STEPS)
+ * @param tile: Tile length in points (<= 0: POISSON1D_TILE_SIZE)
+ * @param tol: Convergence tolerance for residual norm
+ * @param maxit: Maximum number of iterations
+ * @param resvec: Output residual history (allocated with size maxit)
+ * @param nbite: Output number of iterations performed
+ */
+void richardson_tiled(double *AB, double *RHS, double *X, double *MB, double *alpha, poisson1D_int *lab, poisson1D_int *la, poisson1D_int *ku, poisson1D_int *kl, int *s, int *tile, double *tol, int *maxit, double *resvec, int *nbite);
 
 /**
  * Extract the preconditioner matrix for Jacobi method from tridiagonal matrix
@@ -161,7 +364,7 @@ void richardson_alpha(double *AB, double *RHS, double *X, double *alpha_rich, in
  * @param kl: Number of subdiagonals
  * @param kv: Number of superdiagonals in output MB
  */
-void extract_MB_jacobi_tridiag(double *AB, double *MB, int *lab, int *la,int *ku, int*kl, int *kv);
+void extract_MB_jacobi_tridiag(double *AB, double *MB, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, poisson1D_int *kv);
 
 /**
  * Extract the preconditioner matrix for Gauss-Seidel method from tridiagonal matrix
@@ -173,7 +376,31 @@ void extract_MB_jacobi_tridiag(double *AB, double *MB, int *lab, int *la,int *ku
  * @param kl: Number of subdiagonals
  * @param kv: Number of superdiagonals in output MB
  */
-void extract_MB_gauss_seidel_tridiag(double *AB, double *MB, int *lab, int *la,int *ku, int*kl, int *kv);
+void extract_MB_gauss_seidel_tridiag(double *AB, double *MB, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, poisson1D_int *kv);
+
+/**
+ * Solve linear system using Jacobi iteration x = x + D^{-1} (b - A x). D is read in place from
+ * the diagonal row of AB, so no preconditioner matrix is built (same iterates as richardson_MB
+ * with the MB of extract_MB_jacobi_tridiag).
+ * @param AB: Coefficient matrix in GB storage format
+ * @param RHS: Right-hand side vector (size la)
+ * @param X: Solution vector (size la, input: initial guess, output: solution)
+ * @param lab: Leading dimension of AB
+ * @param la: Problem size
+ * @param ku: Number of superdiagonals
+ * @param kl: Number of subdiagonals
+ * @param tol: Convergence tolerance for residual norm
+ * @param maxit: Maximum number of iterations
+ * @param resvec: Output residual history (allocated with size maxit)
+ * @param nbite: Output number of iterations performed
+ */
+void richardson_jacobi(double *AB, double *RHS, double *X, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *tol, int *maxit, double *resvec, int *nbite);
+
+/**
+ * richardson_jacobi with caller-provided scratch (POISSON1D_WS_RICHARDSON), no allocation
+ * @param ws: Workspace (nbite = 0 and X unchanged if too small)
+ */
+void richardson_jacobi_ws(double *AB, double *RHS, double *X, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws);
 
 /**
  * Solve linear system using preconditioned Richardson iteration
@@ -190,7 +417,52 @@ void extract_MB_gauss_seidel_tridiag(double *AB, double *MB, int *lab, int *la,i
  * @param resvec: Output residual history (allocated with size maxit)
  * @param nbite: Output number of iterations performed
  */
-void richardson_MB(double *AB, double *RHS, double *X, double *MB, int *lab, int *la,int *ku, int*kl, double *tol, int *maxit, double *resvec, int *nbite);
+void richardson_MB(double *AB, double *RHS, double *X, double *MB, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *tol, int *maxit, double *resvec, int *nbite);
+
+/**
+ * richardson_MB with caller-provided scratch (POISSON1D_WS_RICHARDSON_MB), no allocation
+ * @param ws: Workspace (nbite = 0 and X unchanged if too small)
+ */
+void richardson_MB_ws(double *AB, double *RHS, double *X, double *MB, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws);
+
+/**
+ * Extract the preconditioner matrix for red-black ordered Gauss-Seidel from tridiagonal matrix.
+ * Red (even) rows keep the diagonal, black (odd) rows the diagonal and both neighbours, so M
+ * is the Gauss-Seidel splitting of A for the red-then-black ordering.
+ * @param AB: Input matrix in GB storage format
+ * @param MB: Output preconditioner matrix in GB format
+ * @param lab: Leading dimension of AB
+ * @param la: Problem size
+ * @param ku: Number of superdiagonals
+ * @param kl: Number of subdiagonals
+ * @param kv: Number of superdiagonals in output MB
+ */
+void extract_MB_gauss_seidel_redblack_tridiag(double *AB, double *MB, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, poisson1D_int *kv);
+
+/**
+ * Solve linear system using red-black Gauss-Seidel (Richardson preconditioned by the
+ * red-black M from extract_MB_gauss_seidel_redblack_tridiag). Both colour sweeps are
+ * independent across rows and run as OpenMP parallel SIMD loops.
+ * @param AB: Coefficient matrix in GB storage format
+ * @param RHS: Right-hand side vector (size la)
+ * @param X: Solution vector (size la, input: initial guess, output: solution)
+ * @param MB: Preconditioner matrix in GB format
+ * @param lab: Leading dimension of AB
+ * @param la: Problem size
+ * @param ku: Number of superdiagonals
+ * @param kl: Number of subdiagonals
+ * @param tol: Convergence tolerance for residual norm
+ * @param maxit: Maximum number of iterations
+ * @param resvec: Output residual history (allocated with size maxit)
+ * @param nbite: Output number of iterations performed
+ */
+void richardson_MB_redblack(double *AB, double *RHS, double *X, double *MB, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *tol, int *maxit, double *resvec, int *nbite);
+
+/**
+ * richardson_MB_redblack with caller-provided scratch (POISSON1D_WS_REDBLACK), no allocation
+ * @param ws: Workspace (nbite = 0 and X unchanged if too small)
+ */
+void richardson_MB_redblack_ws(double *AB, double *RHS, double *X, double *MB, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws);
 
 /**
  * Compute the index in the band storage for element (i,j) in column-major format
@@ -199,7 +471,7 @@ void richardson_MB(double *AB, double *RHS, double *X, double *MB, int *lab, int
  * @param lab: Leading dimension of the band storage
  * @return Linear index in the band storage array
  */
-int indexABCol(int i, int j, int *lab);
+poisson1D_int indexABCol(poisson1D_int i, poisson1D_int j, poisson1D_int *lab);
 
 /**
  * LU factorization for tridiagonal matrices (optimized version of dgbtrf)
@@ -213,66 +485,1260 @@ int indexABCol(int i, int j, int *lab);
  * @param info: Output info (0: success, >0: singular matrix)
  * @return info value
  */
-int dgbtrftridiag(int *la, int *n, int *kl, int *ku, double *AB, int *lab, int *ipiv, int *info);
+poisson1D_int dgbtrftridiag(poisson1D_int *la, poisson1D_int *n, poisson1D_int *kl, poisson1D_int *ku, double *AB, poisson1D_int *lab, poisson1D_int *ipiv, poisson1D_int *info);
+
+/**
+ * Single-precision version of dgbtrftridiag (same storage, LU factors usable by sgbtrs_)
+ */
+poisson1D_int sgbtrftridiag(poisson1D_int *la, poisson1D_int *n, poisson1D_int *kl, poisson1D_int *ku, float *AB, poisson1D_int *lab, poisson1D_int *ipiv, poisson1D_int *info);
+
+#define POISSON1D_MIXED_TRF 0      /* Single-precision factorization with LAPACK sgbtrf_ */
+#define POISSON1D_MIXED_TRI 1      /* Single-precision factorization with sgbtrftridiag */
+#define POISSON1D_MIXED_MAXREF 30  /* Default maximum number of refinement steps */
+
+/**
+ * Mixed-precision band solve with iterative refinement (as LAPACK dsgesv, on GB storage).
+ * A is factored in single precision and every triangular solve runs in single precision;
+ * the residual r = b - A x is computed in double with cblas_dgbmv and the correction added
+ * in double, until ||dx|| <= tol * ||x|| (infinity norms), or until the corrections stop
+ * shrinking once ||r|| <= sqrt(la) * DBL_EPSILON * ||A|| * ||x|| (limiting accuracy reached).
+ * When the corrections do not contract fast enough to get there within maxref steps
+ * (cond(A) * eps_single close to 1 or above), the remaining right-hand sides are solved
+ * with a double-precision factorization of the same kind.
+ * @param kind: POISSON1D_MIXED_TRF or POISSON1D_MIXED_TRI
+ * @param la: Order of the matrix
+ * @param kl: Number of subdiagonals
+ * @param ku: Number of superdiagonals
+ * @param nrhs: Number of right-hand sides
+ * @param AB: Matrix in GB format with kl extra rows on top, as for dgbtrf (not modified)
+ * @param lab: Leading dimension of AB (at least 2*kl+ku+1)
+ * @param B: Right-hand sides (input), solutions (output)
+ * @param ldb: Leading dimension of B
+ * @param tol: Relative size of the last correction, DBL_EPSILON if <= 0
+ * @param maxref: Maximum number of refinement steps
+ * @param iter: Output refinement steps (largest over the right-hand sides), -(steps + 1) if the
+ *              solve fell back to double precision
+ * @param info: Output info (0: success, >0: singular matrix, <0: allocation failure)
+ * @return info value
+ */
+poisson1D_int dgbsv_mixed(int *kind, poisson1D_int *la, poisson1D_int *kl, poisson1D_int *ku, poisson1D_int *nrhs, double *AB, poisson1D_int *lab, double *B, poisson1D_int *ldb, double *tol, int *maxref, int *iter, poisson1D_int *info);
 
 /**
  * CSRMatrix structure
  */
 typedef struct {
-    double *values; // stores non-zero elements
-    int *col_ind;   // stores column indices
-    int *row_ptr;   // stores row pointers
-    int nnz;        // number of non-zero elements
-    int n;          // number of rows/columns (square matrix)
+    double *values;         // stores non-zero elements
+    poisson1D_int *col_ind; // stores column indices
+    poisson1D_int *row_ptr; // stores row pointers
+    poisson1D_int nnz;      // number of non-zero elements
+    poisson1D_int n;        // number of rows/columns (square matrix)
 } CSRMatrix;
 
 /**
  * CSCMatrix structure
  */
 typedef struct {
-    double *values; // stores non-zero elements
-    int *row_ind;   // stores row indices
-    int *col_ptr;   // stores column pointers
-    int nnz;        // number of non-zero elements
-    int n;          // number of rows/columns (square matrix)
+    double *values;         // stores non-zero elements
+    poisson1D_int *row_ind; // stores row indices
+    poisson1D_int *col_ptr; // stores column pointers
+    poisson1D_int nnz;      // number of non-zero elements
+    poisson1D_int n;        // number of rows/columns (square matrix)
 } CSCMatrix;
 
 /**
- * Set up the Poisson 1D operator in CSR format
- * @param lambda: Output CSR matrix
+ * TriDiagMatrix structure (compact tridiagonal storage, no band padding)
+ */
+typedef struct {
+    double *dl;      // sub-diagonal elements (size n-1)
+    double *d;       // diagonal elements (size n)
+    double *du;      // super-diagonal elements (size n-1)
+    poisson1D_int n; // number of rows/columns (square matrix)
+} TriDiagMatrix;
+
+/**
+ * Set up the Poisson 1D operator in compact tridiagonal format
+ * @param mat: Output tridiagonal matrix (vectors are allocated here)
  * @param la: Problem size
  */
-void set_CSR_operator_poisson1D(CSRMatrix *mat, int *la);
+void set_tridiag_operator_poisson1D(TriDiagMatrix *mat, poisson1D_int *la);
 
 /**
- * Set up the Poisson 1D operator in CSC format
- * @param lambda: Output CSC matrix
+ * LU factorization (Thomas algorithm) for tridiagonal matrices in compact storage,
+ * same elimination as dgbtrftridiag without pivoting. On exit dl holds the multipliers
+ * of L and d the diagonal of U (du is unchanged), as dgttrf does when no rows are swapped.
+ * @param n: Order of the matrix
+ * @param dl: Sub-diagonal (size n-1, input: matrix, output: L multipliers)
+ * @param d: Diagonal (size n, input: matrix, output: diagonal of U)
+ * @param du: Super-diagonal (size n-1)
+ * @param info: Output info (0: success, >0: singular matrix)
+ * @return info value
+ */
+poisson1D_int dgttrftridiag(poisson1D_int *n, double *dl, double *d, double *du, poisson1D_int *info);
+
+/**
+ * Solve A * X = B with the factors computed by dgttrftridiag (forward and back substitution)
+ * @param n: Order of the matrix
+ * @param nrhs: Number of right-hand sides
+ * @param dl: L multipliers from dgttrftridiag (size n-1)
+ * @param d: Diagonal of U from dgttrftridiag (size n)
+ * @param du: Super-diagonal of U (size n-1)
+ * @param B: Right-hand sides (ldb x nrhs, column-major), overwritten by the solution
+ * @param ldb: Leading dimension of B
+ * @param info: Output info (0: success)
+ * @return info value
+ */
+poisson1D_int dgttrstridiag(poisson1D_int *n, poisson1D_int *nrhs, double *dl, double *d, double *du, double *B, poisson1D_int *ldb, poisson1D_int *info);
+
+/**
+ * Convert nrhs column-major vectors (B + k*la) to the interleaved layout BI[i*nrhs + k]
+ * @param B: Input vectors (size la*nrhs, column-major)
+ * @param BI: Output interleaved vectors (size la*nrhs)
+ * @param la: Vector size
+ * @param nrhs: Number of vectors
+ */
+void interleave_RHS(double *B, double *BI, poisson1D_int *la, poisson1D_int *nrhs);
+
+/**
+ * Convert nrhs interleaved vectors BI[i*nrhs + k] back to the column-major layout (B + k*la)
+ * @param BI: Input interleaved vectors (size la*nrhs)
+ * @param B: Output vectors (size la*nrhs, column-major)
+ * @param la: Vector size
+ * @param nrhs: Number of vectors
+ */
+void deinterleave_RHS(double *BI, double *B, poisson1D_int *la, poisson1D_int *nrhs);
+
+/**
+ * Solve A * X = B for nrhs right-hand sides stored interleaved (B[i*nrhs + k]) with the
+ * factors computed by dgttrftridiag. The substitutions run over the right-hand sides in
+ * the inner, unit-stride loop, so one factor row is applied to all of them with SIMD.
+ * @param n: Order of the matrix
+ * @param nrhs: Number of right-hand sides
+ * @param dl: L multipliers from dgttrftridiag (size n-1)
+ * @param d: Diagonal of U from dgttrftridiag (size n)
+ * @param du: Super-diagonal of U (size n-1)
+ * @param B: Interleaved right-hand sides (size n*nrhs), overwritten by the solutions
+ * @param info: Output info (0: success)
+ * @return info value
+ */
+poisson1D_int dgttrstridiag_interleaved(poisson1D_int *n, poisson1D_int *nrhs, double *dl, double *d, double *du, double *B, poisson1D_int *info);
+
+/**
+ * Solve A * x = B for a tridiagonal matrix in compact storage with the partition method.
+ * The rows are split into nparts contiguous blocks factorized and solved concurrently by
+ * OpenMP threads; the blocks are coupled through a reduced system of size 2*nparts on the
+ * block ends (solved with dgbsv). No pivoting inside the blocks (diagonally dominant A).
+ * @param n: Order of the matrix
+ * @param dl: Sub-diagonal (size n-1), overwritten
+ * @param d: Diagonal (size n), overwritten
+ * @param du: Super-diagonal (size n-1)
+ * @param B: Right-hand side (size n), overwritten by the solution
+ * @param nparts: Number of partitions (<= 0: number of OpenMP threads)
+ * @param info: Output info (0: success, >0: singular block pivot, <0: allocation failure)
+ * @return info value
+ */
+poisson1D_int dgtsvpartition(poisson1D_int *n, double *dl, double *d, double *du, double *B, int *nparts, poisson1D_int *info);
+
+/**
+ * TriDiagBatch structure: nbatch independent tridiagonal systems of order n with their own
+ * coefficients, stored interleaved ("structure of arrays"): element i of system b is at
+ * [i*nbatch + b], so one row of all the systems is contiguous and the elimination runs
+ * with SIMD lanes across systems. Right-hand sides use the same layout (see interleave_RHS).
+ */
+typedef struct {
+    double *dl;           // sub-diagonals (size (n-1)*nbatch, row i at dl + i*nbatch)
+    double *d;            // diagonals (size n*nbatch)
+    double *du;           // super-diagonals (size (n-1)*nbatch)
+    poisson1D_int n;      // order of each system
+    poisson1D_int nbatch; // number of systems
+} TriDiagBatch;
+
+#define POISSON1D_BATCH_BLOCK 64 /* Systems per OpenMP work item of the batched Thomas solver */
+
+/**
+ * Set up nbatch variable-coefficient operators -(kappa_b u')' in interleaved tridiagonal
+ * storage (same rows as set_GB_operator_colMajor_poisson1D_varcoef)
+ * @param mat: Output batch (vectors are allocated here, release with free_tridiag_batch)
+ * @param la: Order of each system
+ * @param nbatch: Number of systems
+ * @param kappa: Conductivities at the cell faces, one profile per system (kappa + b*(la+1))
+ * @return 0 on success, -1 on allocation failure
+ */
+int set_tridiag_batch_operator_poisson1D_varcoef(TriDiagBatch *mat, poisson1D_int *la, poisson1D_int *nbatch, double *kappa);
+
+/**
+ * Free the vectors of a TriDiagBatch
+ * @param mat: Batch to release
+ */
+void free_tridiag_batch(TriDiagBatch *mat);
+
+/**
+ * Batched LU factorization (Thomas algorithm) of nbatch independent tridiagonal systems in
+ * interleaved storage: the elimination of dgbtrftridiag/dgttrftridiag applied to all systems
+ * at once, row by row, the systems in the inner unit-stride loop. Blocks of
+ * POISSON1D_BATCH_BLOCK systems are shared among the OpenMP threads.
+ * On exit dl holds the multipliers of L and d the diagonal of U (du is unchanged).
+ * @param n: Order of each system
+ * @param nbatch: Number of systems
+ * @param dl: Sub-diagonals (size (n-1)*nbatch, input: matrices, output: L multipliers)
+ * @param d: Diagonals (size n*nbatch, input: matrices, output: diagonals of U)
+ * @param du: Super-diagonals (size (n-1)*nbatch)
+ * @param info: Output info (0: success, >0: index b+1 of the first system with a zero pivot;
+ *              the systems of its block are left partially factorized)
+ * @return info value
+ */
+poisson1D_int dgttrftridiag_batch(poisson1D_int *n, poisson1D_int *nbatch, double *dl, double *d, double *du, poisson1D_int *info);
+
+/**
+ * Solve A_b * x_b = b_b for nbatch systems factorized by dgttrftridiag_batch, one right-hand
+ * side per system, in interleaved storage
+ * @param n: Order of each system
+ * @param nbatch: Number of systems
+ * @param dl: L multipliers from dgttrftridiag_batch
+ * @param d: Diagonals of U from dgttrftridiag_batch
+ * @param du: Super-diagonals of U
+ * @param B: Interleaved right-hand sides (size n*nbatch, B[i*nbatch + b]), overwritten by the solutions
+ * @param info: Output info (0: success)
+ * @return info value
+ */
+poisson1D_int dgttrstridiag_batch(poisson1D_int *n, poisson1D_int *nbatch, double *dl, double *d, double *du, double *B, poisson1D_int *info);
+
+/**
+ * Constant-coefficient tridiagonal operator tridiag(sub, diag, sup) of order n, O(1) storage:
+ * the products, residuals, preconditioners and the direct solve below read the three
+ * coefficients instead of a materialized matrix, so a solve only needs its vectors in memory.
+ */
+typedef struct {
+    double sub;      // A(i, i-1)
+    double diag;     // A(i, i)
+    double sup;      // A(i, i+1)
+    poisson1D_int n; // Order of the operator
+} StencilOperator;
+
+#define POISSON1D_STENCIL_RICHARDSON 0  /* x <- x + alpha r */
+#define POISSON1D_STENCIL_JACOBI 1      /* x <- x + D^{-1} r */
+#define POISSON1D_STENCIL_GS 2          /* x <- x + (D - E)^{-1} r (forward Gauss-Seidel) */
+
+/**
+ * Initialize the Poisson 1D stencil operator tridiag(-1, 2, -1)
+ * @param A: Output operator
  * @param la: Problem size
  */
-void set_CSC_operator_poisson1D(CSCMatrix *mat, int *la);
+void set_stencil_operator_poisson1D(StencilOperator *A, poisson1D_int *la);
 
 /**
- * Matrix-Vector multiplication in CSR format: y = A * x
- * @param mat: CSR matrix A
- * @param x: Input vector x
- * @param y: Output vector y
+ * Stencil matrix-vector product y = A x (rows shared among the OpenMP threads from
+ * POISSON1D_SPMV_PAR_MIN rows)
+ * @param A: Stencil operator
+ * @param x: Input vector (size n)
+ * @param y: Output vector (size n)
  */
-void dcsrmv(CSRMatrix *mat, double *x, double *y);
+void dstencilmv(StencilOperator *A, double *x, double *y);
 
 /**
- * Matrix-Vector multiplication in CSC format: y = A * x
- * @param mat: CSC matrix A
- * @param x: Input vector x
- * @param y: Output vector y
+ * Poisson1DMatvec callback for the operator-generic solvers (op is a StencilOperator *), e.g.
+ * conjugate_gradient_op(matvec_stencil_op, &A, NULL, ...) or chebyshev_op
  */
-void dcscmv(CSCMatrix *mat, double *x, double *y);
+void matvec_stencil_op(void *op, double *x, double *y);
 
 /**
- * Solve linear system using Richardson iteration with CSR format
+ * Residual R = RHS - A X and its norm in one pass
+ * @param A: Stencil operator
+ * @param RHS: Right-hand side (size n)
+ * @param X: Current iterate (size n)
+ * @param R: Output residual (size n, may not alias X)
+ * @return ||R||_2
  */
-void richardson_alpha_csr(CSRMatrix *mat, double *RHS, double *X, double *alpha_rich, double *tol, int *maxit, double *resvec, int *nbite);
+double dstencil_residual(StencilOperator *A, double *RHS, double *X, double *R);
 
 /**
- * Solve linear system using Richardson iteration with CSC format
+ * Apply the Jacobi preconditioner Z = D^{-1} R (D = diag I)
+ * @param A: Stencil operator
+ * @param R: Input vector (size n)
+ * @param Z: Output vector (size n, may alias R)
  */
-void richardson_alpha_csc(CSCMatrix *mat, double *RHS, double *X, double *alpha_rich, double *tol, int *maxit, double *resvec, int *nbite);
+void dstencil_jacobi(StencilOperator *A, double *R, double *Z);
+
+/**
+ * Apply the Gauss-Seidel preconditioner Z = (D - E)^{-1} R by forward substitution
+ * @param A: Stencil operator
+ * @param R: Input vector (size n)
+ * @param Z: Output vector (size n, may alias R)
+ */
+void dstencil_gauss_seidel(StencilOperator *A, double *R, double *Z);
+
+/**
+ * Extreme eigenvalues diag + 2 sqrt(sub sup) cos(k pi / (n + 1)), k = n and k = 1, of an operator
+ * with sub * sup > 0 (spectral bounds for chebyshev_op)
+ * @param A: Stencil operator
+ * @param eigmin: Output smallest eigenvalue
+ * @param eigmax: Output largest eigenvalue
+ * @return 0, -1 if sub * sup <= 0 (complex or defective spectrum, bounds not set)
+ */
+int dstencil_eig(StencilOperator *A, double *eigmin, double *eigmax);
+
+/**
+ * Solve A X = B in place with the Thomas algorithm (no pivoting) without storing the factors:
+ * the pivots of a constant tridiagonal matrix are known in closed form,
+ * d_i = r1 (1 - q^{i+2}) / (1 - q^{i+1}) with r1, r2 = r1 q the roots of t^2 - diag t + sub sup,
+ * (i+2)/(i+1) r1 for a double root (Poisson) and rho sin((i+2)theta) / sin((i+1)theta) for
+ * complex roots. Once q^i is below the rounding error the pivot is r1. Forward and back
+ * substitution each recompute the pivots they need, so the extra storage is O(1).
+ * @param A: Stencil operator
+ * @param nrhs: Number of right-hand sides
+ * @param B: Right-hand sides (size ldb*nrhs), overwritten by the solutions
+ * @param ldb: Leading dimension of B
+ * @param info: Output info (0: success, i+1: zero pivot at row i)
+ * @return info value
+ */
+poisson1D_int dstencil_thomas(StencilOperator *A, poisson1D_int *nrhs, double *B, poisson1D_int *ldb, poisson1D_int *info);
+
+/**
+ * Richardson iteration on a stencil operator, preconditioned or not: residual, norm and update
+ * of each block of STENCIL_BLOCK points in one sweep, no residual vector (richardson_alpha_stencil
+ * runs this kernel on the Poisson stencil). Gauss-Seidel carries the last value of the forward
+ * substitution from block to block; the update of the last iteration is applied to X as well.
+ * resvec/nbite as in richardson_alpha.
+ * @param A: Stencil operator
+ * @param RHS: Right-hand side (size n)
+ * @param X: Solution (size n, input: initial guess, output: solution)
+ * @param alpha_rich: Relaxation parameter (POISSON1D_STENCIL_RICHARDSON only)
+ * @param prec: POISSON1D_STENCIL_RICHARDSON, _JACOBI or _GS
+ * @param tol: Convergence tolerance for residual norm
+ * @param maxit: Maximum number of iterations
+ * @param resvec: Output residual history (allocated with size maxit)
+ * @param nbite: Output number of iterations performed
+ */
+void richardson_stencil_op(StencilOperator *A, double *RHS, double *X, double *alpha_rich, int *prec, double *tol, int *maxit, double *resvec, int *nbite);
+
+/**
+ * Write a compact tridiagonal operator to a file (one row per line: dl, d, du)
+ * @param mat: Tridiagonal matrix
+ * @param filename: Output filename
+ */
+void write_tridiag_operator_poisson1D(TriDiagMatrix *mat, char* filename);
+
+#define POISSON1D_BIN_MAGIC "P1DBIN\0\0"  /* First 8 bytes of every binary file */
+#define POISSON1D_BIN_VERSION 1
+#define POISSON1D_BIN_HEADER_SIZE 64     /* Data starts here, aligned for mmap/SIMD loads */
+
+#define POISSON1D_BIN_VEC 0      /* Vector: rows = la, cols = 1 */
+#define POISSON1D_BIN_XY 1       /* Grid and values: rows = la, cols = 2 (x column then y column) */
+#define POISSON1D_BIN_GB 2       /* GB operator: rows = lab, cols = la, band parameters set */
+#define POISSON1D_BIN_TRIDIAG 3  /* Compact tridiagonal: rows = n, cols = 3 (dl, d, du padded with 0) */
+
+#define POISSON1D_BIN_COLMAJOR 0
+#define POISSON1D_BIN_ROWMAJOR 1
+
+/**
+ * Header of the binary container (64 bytes, native endianness, followed by rows*cols doubles)
+ */
+typedef struct {
+    char magic[8];      // POISSON1D_BIN_MAGIC
+    int32_t version;    // POISSON1D_BIN_VERSION
+    int32_t type;       // POISSON1D_BIN_VEC, _XY, _GB or _TRIDIAG
+    int32_t layout;     // POISSON1D_BIN_COLMAJOR or _ROWMAJOR
+    int32_t elem_size;  // sizeof(double)
+    int64_t rows;
+    int64_t cols;
+    int32_t kl, ku, kv, lab;  // band parameters (GB only, 0 otherwise)
+    char reserved[8];
+} Poisson1DBinHeader;
+
+/**
+ * Binary file mapped in memory by poisson1D_bin_map
+ */
+typedef struct {
+    Poisson1DBinHeader hdr;  // copy of the header
+    double *data;            // rows*cols values, column-major unless hdr.layout says otherwise
+    void *base;              // start of the mapping
+    size_t len;              // length of the mapping
+} Poisson1DBinFile;
+
+/**
+ * Write a vector to a binary file
+ * @param vec: Vector to write (size la)
+ * @param la: Vector size
+ * @param filename: Output filename
+ */
+void write_vec_bin(double* vec, poisson1D_int* la, char* filename);
+
+/**
+ * Write two vectors as x-y columns to a binary file
+ * @param vec: Y-values vector (size la)
+ * @param x: X-values vector (size la)
+ * @param la: Vector size
+ * @param filename: Output filename
+ */
+void write_xy_bin(double* vec, double* x, poisson1D_int* la, char* filename);
+
+/**
+ * Write a GB operator (column-major, as stored in AB) to a binary file
+ * @param AB: Matrix in GB storage format
+ * @param lab: Leading dimension of AB
+ * @param la: Problem size
+ * @param kl: Number of subdiagonals
+ * @param ku: Number of superdiagonals
+ * @param kv: Number of extra superdiagonals (fill-in rows)
+ * @param filename: Output filename
+ */
+void write_GB_operator_colMajor_poisson1D_bin(double* AB, poisson1D_int* lab, poisson1D_int* la, poisson1D_int *kl, poisson1D_int *ku, poisson1D_int *kv, char* filename);
+
+/**
+ * Write a compact tridiagonal operator to a binary file
+ * @param mat: Tridiagonal matrix
+ * @param filename: Output filename
+ */
+void write_tridiag_operator_poisson1D_bin(TriDiagMatrix *mat, char* filename);
+
+/**
+ * Map a binary file read-only in memory (zero-copy)
+ * @param filename: Input filename
+ * @param file: Output mapping (release with poisson1D_bin_unmap)
+ * @return 0 on success, -1 on I/O error or invalid header
+ */
+int poisson1D_bin_map(char* filename, Poisson1DBinFile *file);
+
+/**
+ * Release a mapping created by poisson1D_bin_map
+ * @param file: Mapping to release
+ */
+void poisson1D_bin_unmap(Poisson1DBinFile *file);
+
+#define POISSON1D_OOC_BUDGET ((size_t)64 << 20) /* Default resident memory of the out-of-core solves */
+
+/**
+ * Out-of-core tridiagonal solve A x = b (Thomas, no pivoting) on memory-mapped binary files,
+ * for systems larger than memory. The forward elimination is one sequential pass over the
+ * operator and the right-hand side that writes the modified coefficients c'_i = c_i / d'_i
+ * to factorfile and the forward-substituted right-hand side to solfile; the back substitution
+ * is one reverse pass over both that overwrites solfile with x. The passes walk windows sized
+ * from the budget: the next window is prefetched (MADV_WILLNEED) while the current one is
+ * computed, then the finished one is dropped from the process and from the page cache.
+ * @param opfile: Operator (POISSON1D_BIN_TRIDIAG, see write_tridiag_operator_poisson1D_bin)
+ * @param rhsfile: Right-hand side (POISSON1D_BIN_VEC, see write_vec_bin)
+ * @param solfile: Output solution (POISSON1D_BIN_VEC, created or truncated)
+ * @param factorfile: Output modified coefficients c' (POISSON1D_BIN_VEC, scratch, created or truncated)
+ * @param budget: Resident memory (bytes) of the mapped windows, 0 for POISSON1D_OOC_BUDGET
+ * @param info: Output info (0: success, i+1: zero pivot at row i, solfile incomplete,
+ *              -1: invalid file or I/O error)
+ * @return info value
+ */
+poisson1D_int dgtsv_ooc(char *opfile, char *rhsfile, char *solfile, char *factorfile, size_t *budget, poisson1D_int *info);
+
+/**
+ * Out-of-core solve with a stencil operator: same passes as dgtsv_ooc, the coefficients are
+ * read from A instead of an operator file
+ * @param A: Stencil operator (A->n must match the size of rhsfile)
+ * @param rhsfile: Right-hand side (POISSON1D_BIN_VEC)
+ * @param solfile: Output solution (POISSON1D_BIN_VEC, created or truncated)
+ * @param factorfile: Output modified coefficients c' (POISSON1D_BIN_VEC, scratch, created or truncated)
+ * @param budget: Resident memory (bytes) of the mapped windows, 0 for POISSON1D_OOC_BUDGET
+ * @param info: Output info (0: success, i+1: zero pivot at row i, -1: invalid file or I/O error)
+ * @return info value
+ */
+poisson1D_int dstencil_thomas_ooc(StencilOperator *A, char *rhsfile, char *solfile, char *factorfile, size_t *budget, poisson1D_int *info);
+
+/**
+ * Output format selected for the drivers
+ * @return 1 if POISSON1D_OUTPUT=text (legacy .dat files), 0 for binary .bin files (default)
+ */
+int poisson1D_output_text(void);
+
+#define POISSON1D_FACTOR_TRF 0     /* LU factors from LAPACK dgbtrf (GB storage) */
+#define POISSON1D_FACTOR_TRI 1     /* LU factors from dgbtrftridiag (GB storage) */
+#define POISSON1D_FACTOR_THOMAS 2  /* LU factors from dgttrftridiag (compact storage) */
+
+#define POISSON1D_CACHE_DEFAULT_MAX_BYTES ((size_t)256 << 20) /* Default memory cap of the factor cache */
+#define POISSON1D_CACHE_DEFAULT_MAX_ENTRIES 8                 /* Default number of cached factorizations */
+
+/**
+ * Poisson1DSolver structure: handle on the factorized Poisson 1D operator of size la.
+ * Factors are shared through an LRU cache keyed by (la, kind), so creating a handle for a
+ * size that was already factorized costs no factorization. The cache is not thread-safe.
+ */
+typedef struct {
+    poisson1D_int la;     // problem size
+    int kind;             // POISSON1D_FACTOR_TRF, POISSON1D_FACTOR_TRI or POISSON1D_FACTOR_THOMAS
+    poisson1D_int kl, ku; // number of sub/super-diagonals of the factors (GB kinds)
+    poisson1D_int lab;    // leading dimension of the GB factors
+    void *factor;         // cached factors, NULL until factorized
+} Poisson1DSolver;
+
+/**
+ * Create a solver handle for the Poisson 1D operator (no factorization yet)
+ * @param la: Problem size
+ * @param kind: Factorization kind (POISSON1D_FACTOR_TRF, _TRI or _THOMAS)
+ * @return New handle, NULL on invalid arguments or allocation failure
+ */
+Poisson1DSolver *poisson1D_solver_create(poisson1D_int *la, int *kind);
+
+/**
+ * Factorize the operator of the handle, or reuse the cached factors of the same (la, kind)
+ * @param solver: Solver handle
+ * @param info: Output info (0: success, >0: singular matrix, <0: allocation failure)
+ * @return info value
+ */
+poisson1D_int poisson1D_solver_factor(Poisson1DSolver *solver, poisson1D_int *info);
+
+/**
+ * Solve A * X = RHS with the factors of the handle (factorizes first if needed)
+ * @param solver: Solver handle
+ * @param RHS: Right-hand sides (la x nrhs, column-major), overwritten by the solutions
+ * @param nrhs: Number of right-hand sides
+ * @param info: Output info (0: success)
+ * @return info value
+ */
+poisson1D_int poisson1D_solver_solve(Poisson1DSolver *solver, double *RHS, poisson1D_int *nrhs, poisson1D_int *info);
+
+/**
+ * Release a solver handle. Its factors stay in the cache until evicted.
+ * @param solver: Solver handle
+ */
+void poisson1D_solver_destroy(Poisson1DSolver *solver);
+
+/**
+ * Set the limits of the factor cache and evict unused factors beyond them.
+ * Factors in use by a handle are never evicted.
+ * @param max_bytes: Maximum memory held by cached factors
+ * @param max_entries: Maximum number of cached factorizations
+ */
+void poisson1D_factor_cache_set_limits(size_t max_bytes, int max_entries);
+
+/**
+ * Free every unused factorization of the cache and reset its statistics
+ */
+void poisson1D_factor_cache_clear(void);
+
+/**
+ * Get the statistics of the factor cache
+ * @param hits: Output number of factorizations served from the cache
+ * @param misses: Output number of factorizations computed
+ * @param entries: Output number of cached factorizations
+ * @param bytes: Output memory held by cached factors
+ */
+void poisson1D_factor_cache_stats(int *hits, int *misses, int *entries, size_t *bytes);
+
+/**
+ * Set up the Poisson 1D operator in CSR format. If the 3*la-2 nonzeros overflow poisson1D_int
+ * (la beyond INT_MAX/3 without ILP64), an error is printed and mat is left empty (nnz = 0)
+ * @param lambda: Output CSR matrix
+ * @param la: Problem size
+ */
+void set_CSR_operator_poisson1D(CSRMatrix *mat, poisson1D_int *la);
+
+/**
+ * Set up the Poisson 1D operator in CSC format, same overflow check as set_CSR_operator_poisson1D
+ * @param lambda: Output CSC matrix
+ * @param la: Problem size
+ */
+void set_CSC_operator_poisson1D(CSCMatrix *mat, poisson1D_int *la);
+
+/**
+ * Set up the 2D five-point Poisson operator (4 on the diagonal, -1 for the four neighbours,
+ * square cells, unscaled like the 1D operator) on an nx x ny interior grid in CSR format.
+ * Unknown (i, j) is row i + j*nx (x fastest). If nx*ny or the 5n-2nx-2ny nonzeros overflow
+ * poisson1D_int, or the allocation fails, an error is printed and mat is left empty (nnz = 0)
+ * @param mat: Output CSR matrix (n = nx*ny)
+ * @param nx: Number of interior points along x
+ * @param ny: Number of interior points along y
+ */
+void set_CSR_operator_poisson2D(CSRMatrix *mat, poisson1D_int *nx, poisson1D_int *ny);
+
+/**
+ * Set up the right-hand side h^2 f of the 2D test problem -lap u = f, u = 0 on the boundary,
+ * whose solution is u = x (Lx - x) y (Ly - y) (h = 1/(nx+1), Lx = 1, Ly = (ny+1) h). u is
+ * quadratic along each direction, so it is also the exact solution of the discrete system.
+ * @param RHS: Output right-hand side (size nx*ny, index i + j*nx)
+ * @param nx: Number of interior points along x
+ * @param ny: Number of interior points along y
+ */
+void set_dense_RHS_poisson2D(double *RHS, poisson1D_int *nx, poisson1D_int *ny);
+
+/**
+ * Compute the analytical solution of the 2D test problem of set_dense_RHS_poisson2D
+ * @param EX_SOL: Output solution (size nx*ny, index i + j*nx)
+ * @param nx: Number of interior points along x
+ * @param ny: Number of interior points along y
+ */
+void set_analytical_solution_poisson2D(double *EX_SOL, poisson1D_int *nx, poisson1D_int *ny);
+
+/**
+ * Cache-blocked out-of-place transpose: B (nc x nr) = A^T, A being nr x nc column-major.
+ * Tiles of 32 x 32 are distributed over the OpenMP threads.
+ * @param nr: Number of rows of A
+ * @param nc: Number of columns of A
+ * @param A: Input matrix (size nr*nc)
+ * @param B: Output matrix (size nr*nc)
+ */
+void dtranspose_blocked(poisson1D_int *nr, poisson1D_int *nc, double *A, double *B);
+
+/**
+ * Default number of ADI shifts for an nx x ny grid (about half the log of the condition
+ * number of the 1D operators)
+ * @param nx: Number of interior points along x
+ * @param ny: Number of interior points along y
+ * @return Number of shifts
+ */
+int adi_poisson2D_nshifts(poisson1D_int *nx, poisson1D_int *ny);
+
+/**
+ * Solve the 2D five-point Poisson system with the Peaceman-Rachford alternating-direction-
+ * implicit iteration, A = H + V (H along x, V along y), in correction form:
+ *   u_half = u + (H + rho I)^{-1} (b - A u),   u = u_half + (V + rho I)^{-1} (b - A u_half)
+ * cycling over nshifts geometric shifts rho in the spectrum of the 1D operators. Each half-step
+ * is a batch of independent 1D tridiagonal solves (dgttrftridiag factors of T + rho I, computed
+ * once per shift) on lines stored interleaved, so the elimination runs with SIMD lanes across
+ * lines and blocks of lines are distributed over the OpenMP threads. The residual of each
+ * half-step is fused with a cache-blocked transpose between the two line layouts.
+ * Matrix-free: the operator is the one of set_CSR_operator_poisson2D.
+ * The small shifts amplify rounding errors, so the relative residual levels off around
+ * n^4 eps (n = max(nx, ny)) while the forward error is already at the discretization level:
+ * the iteration also stops (nbite < maxit, residual above tol) when a whole shift cycle no
+ * longer reduces the residual.
+ * @param RHS: Right-hand side (size nx*ny, index i + j*nx)
+ * @param X: Initial guess, overwritten by the solution (size nx*ny)
+ * @param nx: Number of interior points along x
+ * @param ny: Number of interior points along y
+ * @param nshifts: Number of shifts per cycle (<= 0: adi_poisson2D_nshifts)
+ * @param tol: Tolerance on the relative residual
+ * @param maxit: Maximum number of iterations (one iteration = two half-steps)
+ * @param resvec: Output residual history (allocated with size maxit)
+ * @param nbite: Output number of iterations performed (0 if nx*ny overflows the index type)
+ */
+void adi_poisson2D(double *RHS, double *X, poisson1D_int *nx, poisson1D_int *ny, int *nshifts, double *tol, int *maxit, double *resvec, int *nbite);
+
+#define POISSON1D_SPMV_PAR_MIN 16384 /* CSR/CSC products on fewer rows run on one thread */
+
+/**
+ * Matrix-Vector multiplication in CSR format: y = A * x
+ * Rows are split between the OpenMP threads when n >= POISSON1D_SPMV_PAR_MIN.
+ * @param mat: CSR matrix A
+ * @param x: Input vector x
+ * @param y: Output vector y
+ */
+void dcsrmv(CSRMatrix *mat, double *x, double *y);
+
+/**
+ * Matrix-Vector multiplication in CSC format: y = A * x
+ * When n >= POISSON1D_SPMV_PAR_MIN, each OpenMP thread owns a block of columns and the
+ * rows with the same indices: entries landing in the own block are accumulated directly,
+ * the others (only near the block edges for banded matrices) are added atomically after
+ * a barrier. No allocation.
+ * @param mat: CSC matrix A
+ * @param x: Input vector x
+ * @param y: Output vector y
+ */
+void dcscmv(CSCMatrix *mat, double *x, double *y);
+
+/**
+ * Solve linear system using Richardson iteration with CSR format
+ */
+void richardson_alpha_csr(CSRMatrix *mat, double *RHS, double *X, double *alpha_rich, double *tol, int *maxit, double *resvec, int *nbite);
+
+/**
+ * richardson_alpha_csr with caller-provided scratch (POISSON1D_WS_CSR), no allocation
+ */
+void richardson_alpha_csr_ws(CSRMatrix *mat, double *RHS, double *X, double *alpha_rich, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws);
+
+/**
+ * Solve linear system using Richardson iteration with CSC format
+ */
+void richardson_alpha_csc(CSCMatrix *mat, double *RHS, double *X, double *alpha_rich, double *tol, int *maxit, double *resvec, int *nbite);
+
+/**
+ * richardson_alpha_csc with caller-provided scratch (POISSON1D_WS_CSC), no allocation
+ */
+void richardson_alpha_csc_ws(CSCMatrix *mat, double *RHS, double *X, double *alpha_rich, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws);
+
+/**
+ * Matrix-vector product callback y = A * x used by the operator-generic solvers
+ * @param op: Operator descriptor (format-specific)
+ * @param x: Input vector x
+ * @param y: Output vector y
+ */
+typedef void (*Poisson1DMatvec)(void *op, double *x, double *y);
+
+/**
+ * Solve a SPD linear system with (Jacobi-preconditioned) Conjugate Gradient on any operator.
+ * resvec/nbite follow the contract of richardson_alpha (resvec[k] = ||r_k||/||b||).
+ * @param matvec: Matrix-vector product callback
+ * @param op: Operator descriptor passed to matvec
+ * @param Dinv: Inverse of the diagonal of A for Jacobi preconditioning (size la), NULL for plain CG
+ * @param RHS: Right-hand side vector (size la)
+ * @param X: Solution vector (size la, input: initial guess, output: solution)
+ * @param la: Problem size
+ * @param tol: Convergence tolerance for residual norm
+ * @param maxit: Maximum number of iterations
+ * @param resvec: Output residual history (allocated with size maxit)
+ * @param nbite: Output number of iterations performed
+ */
+void conjugate_gradient_op(Poisson1DMatvec matvec, void *op, double *Dinv, double *RHS, double *X, poisson1D_int *la, double *tol, int *maxit, double *resvec, int *nbite);
+
+/**
+ * conjugate_gradient_op with caller-provided scratch (POISSON1D_WS_CG), no allocation
+ * @param ws: Workspace (nbite = 0 and X unchanged if too small)
+ */
+void conjugate_gradient_op_ws(Poisson1DMatvec matvec, void *op, double *Dinv, double *RHS, double *X, poisson1D_int *la, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws);
+
+/**
+ * Solve linear system using Conjugate Gradient with GB storage (matvec with cblas_dgbmv)
+ * @param AB: Coefficient matrix in GB storage format
+ * @param RHS: Right-hand side vector (size la)
+ * @param X: Solution vector (size la, input: initial guess, output: solution)
+ * @param MB: Jacobi preconditioner, NULL for plain CG. Only its diagonal (row ku, stride lab) is
+ *            read: the MB of extract_MB_jacobi_tridiag, or AB itself for M = diag(A) without a copy
+ * @param lab: Leading dimension of AB and MB
+ * @param la: Problem size
+ * @param ku: Number of superdiagonals
+ * @param kl: Number of subdiagonals
+ * @param tol: Convergence tolerance for residual norm
+ * @param maxit: Maximum number of iterations
+ * @param resvec: Output residual history (allocated with size maxit)
+ * @param nbite: Output number of iterations performed
+ */
+void conjugate_gradient(double *AB, double *RHS, double *X, double *MB, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *tol, int *maxit, double *resvec, int *nbite);
+
+/**
+ * conjugate_gradient with caller-provided scratch (POISSON1D_WS_CG, includes the Jacobi diagonal)
+ * @param ws: Workspace (nbite = 0 and X unchanged if too small)
+ */
+void conjugate_gradient_ws(double *AB, double *RHS, double *X, double *MB, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws);
+
+/**
+ * Solve linear system using Conjugate Gradient with CSR format (matvec with dcsrmv)
+ * @param jacobi: 1 for Jacobi preconditioning (diagonal taken from mat), 0 for plain CG
+ */
+void conjugate_gradient_csr(CSRMatrix *mat, double *RHS, double *X, int *jacobi, double *tol, int *maxit, double *resvec, int *nbite);
+
+/**
+ * conjugate_gradient_csr with caller-provided scratch (POISSON1D_WS_CG, includes the Jacobi diagonal)
+ * @param ws: Workspace (nbite = 0 and X unchanged if too small)
+ */
+void conjugate_gradient_csr_ws(CSRMatrix *mat, double *RHS, double *X, int *jacobi, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws);
+
+/**
+ * Solve linear system using matrix-free Conjugate Gradient on the tridiag(-1, 2, -1) stencil
+ * (conjugate_gradient_op with matvec_stencil_op)
+ */
+void conjugate_gradient_stencil(double *RHS, double *X, poisson1D_int *la, double *tol, int *maxit, double *resvec, int *nbite);
+
+/**
+ * Solve a SPD linear system with Chebyshev semi-iterative acceleration on any operator.
+ * The step parameters come from the spectral bounds of M^{-1} A, so the loop has no inner
+ * products; the residual norm is only measured every 'check' iterations (resvec entries in
+ * between repeat the last measured value).
+ * @param matvec: Matrix-vector product callback
+ * @param op: Operator descriptor passed to matvec
+ * @param Dinv: Inverse of the diagonal of A for Jacobi preconditioning (size la), NULL for none
+ * @param eigmin: Lower bound of the spectrum of M^{-1} A (e.g. eigmin_poisson1D)
+ * @param eigmax: Upper bound of the spectrum of M^{-1} A (e.g. eigmax_poisson1D)
+ * @param check: Number of iterations between two residual norm evaluations (>= 1)
+ * @param RHS: Right-hand side vector (size la)
+ * @param X: Solution vector (size la, input: initial guess, output: solution)
+ * @param la: Problem size
+ * @param tol: Convergence tolerance for residual norm
+ * @param maxit: Maximum number of iterations
+ * @param resvec: Output residual history (allocated with size maxit)
+ * @param nbite: Output number of iterations performed
+ */
+void chebyshev_op(Poisson1DMatvec matvec, void *op, double *Dinv, double *eigmin, double *eigmax, int *check, double *RHS, double *X, poisson1D_int *la, double *tol, int *maxit, double *resvec, int *nbite);
+
+/**
+ * chebyshev_op with caller-provided scratch (POISSON1D_WS_CHEBYSHEV), no allocation
+ * @param ws: Workspace (nbite = 0 and X unchanged if too small)
+ */
+void chebyshev_op_ws(Poisson1DMatvec matvec, void *op, double *Dinv, double *eigmin, double *eigmax, int *check, double *RHS, double *X, poisson1D_int *la, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws);
+
+/**
+ * Solve linear system using Chebyshev iteration with GB storage
+ * @param MB: Jacobi preconditioner, NULL for none (only its diagonal is read, AB itself can be
+ *            passed as in conjugate_gradient)
+ * (other parameters as in chebyshev_op and richardson_MB)
+ */
+void chebyshev(double *AB, double *RHS, double *X, double *MB, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *eigmin, double *eigmax, int *check, double *tol, int *maxit, double *resvec, int *nbite);
+
+/**
+ * chebyshev with caller-provided scratch (POISSON1D_WS_CHEBYSHEV, includes the Jacobi diagonal)
+ * @param ws: Workspace (nbite = 0 and X unchanged if too small)
+ */
+void chebyshev_ws(double *AB, double *RHS, double *X, double *MB, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *eigmin, double *eigmax, int *check, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws);
+
+/**
+ * Solve linear system using Chebyshev iteration with CSR format
+ * @param jacobi: 1 for Jacobi preconditioning (diagonal taken from mat), 0 for none
+ */
+void chebyshev_csr(CSRMatrix *mat, double *RHS, double *X, int *jacobi, double *eigmin, double *eigmax, int *check, double *tol, int *maxit, double *resvec, int *nbite);
+
+/**
+ * chebyshev_csr with caller-provided scratch (POISSON1D_WS_CHEBYSHEV, includes the Jacobi diagonal)
+ * @param ws: Workspace (nbite = 0 and X unchanged if too small)
+ */
+void chebyshev_csr_ws(CSRMatrix *mat, double *RHS, double *X, int *jacobi, double *eigmin, double *eigmax, int *check, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws);
+
+/**
+ * Solve linear system using Chebyshev iteration with CSC format
+ * @param jacobi: 1 for Jacobi preconditioning (diagonal taken from mat), 0 for none
+ */
+void chebyshev_csc(CSCMatrix *mat, double *RHS, double *X, int *jacobi, double *eigmin, double *eigmax, int *check, double *tol, int *maxit, double *resvec, int *nbite);
+
+/**
+ * chebyshev_csc with caller-provided scratch (POISSON1D_WS_CHEBYSHEV, includes the Jacobi diagonal)
+ * @param ws: Workspace (nbite = 0 and X unchanged if too small)
+ */
+void chebyshev_csc_ws(CSCMatrix *mat, double *RHS, double *X, int *jacobi, double *eigmin, double *eigmax, int *check, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws);
+
+#define POISSON1D_SIMD_SCALAR 0   /* Portable C kernels */
+#define POISSON1D_SIMD_AVX2 1     /* AVX2 + FMA kernels (4 doubles per vector) */
+#define POISSON1D_SIMD_AVX512 2   /* AVX-512F kernels (8 doubles per vector) */
+#define POISSON1D_DIA_MAX_DIAGS 64 /* csr_to_dia refuses matrices with more diagonals */
+#define POISSON1D_SELL_C 8        /* Default slice height (one AVX-512 vector, two AVX2 vectors) */
+
+/**
+ * DIAMatrix structure (diagonal storage, for banded matrices)
+ * Diagonal d holds A(i, i + offsets[d]) at values[d * n + i]; entries outside the matrix are 0.
+ */
+typedef struct {
+    double *values;  // ndiag * n diagonal values
+    int *offsets;    // offset of each diagonal (increasing, 0 = main diagonal)
+    int ndiag;       // number of stored diagonals
+    poisson1D_int n; // number of rows/columns (square matrix)
+} DIAMatrix;
+
+/**
+ * SELLMatrix structure (SELL-C-sigma: sliced ELLPACK with rows sorted by length in windows of sigma rows)
+ * Slice s stores its C rows column by column: entry j of sorted row s*C + r is at slice_ptr[s] + j*C + r.
+ * Padding entries have value 0 and a valid column index.
+ */
+typedef struct {
+    double *values;  // slice_ptr[nslices] values, including padding
+    int *col_ind;    // column index of each value
+    int *slice_ptr;  // start of each slice (size nslices + 1)
+    int *slice_len;  // width (longest row) of each slice
+    int *perm;       // perm[k] = original row of sorted row k (size nslices * C, -1 for padding rows)
+    int C;           // slice height
+    int sigma;       // sorting window (1 = no sorting)
+    int nslices;     // number of slices
+    int nnz;         // number of non-zero elements (without padding)
+    int n;           // number of rows/columns (square matrix)
+} SELLMatrix;
+
+/**
+ * Best SIMD level supported by the CPU (__builtin_cpu_supports)
+ * @return POISSON1D_SIMD_*
+ */
+int poisson1D_simd_detect(void);
+
+/**
+ * Select the kernels used by ddiamv/dsellmv. The level is clamped to what the CPU supports.
+ * @param level: Requested POISSON1D_SIMD_* level
+ * @return Level in use
+ */
+int poisson1D_simd_select(int *level);
+
+/**
+ * SIMD level used by ddiamv/dsellmv: the last poisson1D_simd_select, else the detected level
+ * lowered by the POISSON1D_SIMD environment variable (scalar, avx2, avx512)
+ * @return POISSON1D_SIMD_*
+ */
+int poisson1D_simd_level(void);
+
+/**
+ * Name of a SIMD level ("scalar", "avx2", "avx512")
+ */
+const char *poisson1D_simd_name(int level);
+
+/**
+ * Convert a CSR matrix to DIA storage
+ * @param csr: Input CSR matrix
+ * @param dia: Output DIA matrix (arrays allocated here, free with free_DIA_matrix)
+ * @return 0 on success, -1 if the matrix has more than POISSON1D_DIA_MAX_DIAGS diagonals or allocation fails
+ */
+int csr_to_dia(CSRMatrix *csr, DIAMatrix *dia);
+
+/**
+ * Convert a CSR matrix to SELL-C-sigma storage
+ * @param csr: Input CSR matrix
+ * @param C: Slice height (a multiple of 8 uses the AVX-512 kernel, of 4 the AVX2 kernel)
+ * @param sigma: Sorting window in rows (1 = keep the row order)
+ * @param sell: Output SELL matrix (arrays allocated here, free with free_SELL_matrix)
+ * @return 0 on success, -1 on invalid C/sigma, allocation failure, or sizes beyond INT_MAX (SELL
+ *         keeps 32-bit indices for the vector gathers, also in the ILP64 build)
+ */
+int csr_to_sell(CSRMatrix *csr, int *C, int *sigma, SELLMatrix *sell);
+
+/**
+ * Free the arrays of a DIA matrix
+ */
+void free_DIA_matrix(DIAMatrix *dia);
+
+/**
+ * Free the arrays of a SELL matrix
+ */
+void free_SELL_matrix(SELLMatrix *sell);
+
+/**
+ * Matrix-Vector multiplication in DIA format: y = A * x (unit-stride loads, SIMD dispatch)
+ * @param mat: DIA matrix A
+ * @param x: Input vector x
+ * @param y: Output vector y
+ */
+void ddiamv(DIAMatrix *mat, double *x, double *y);
+
+/**
+ * Matrix-Vector multiplication in SELL-C-sigma format: y = A * x (gathers, SIMD dispatch)
+ * @param mat: SELL matrix A
+ * @param x: Input vector x
+ * @param y: Output vector y
+ */
+void dsellmv(SELLMatrix *mat, double *x, double *y);
+
+/**
+ * Solve linear system using Richardson iteration with DIA format
+ */
+void richardson_alpha_dia(DIAMatrix *mat, double *RHS, double *X, double *alpha_rich, double *tol, int *maxit, double *resvec, int *nbite);
+
+/**
+ * richardson_alpha_dia with caller-provided scratch (POISSON1D_WS_CSR), no allocation
+ */
+void richardson_alpha_dia_ws(DIAMatrix *mat, double *RHS, double *X, double *alpha_rich, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws);
+
+/**
+ * Solve linear system using Richardson iteration with SELL-C-sigma format
+ */
+void richardson_alpha_sell(SELLMatrix *mat, double *RHS, double *X, double *alpha_rich, double *tol, int *maxit, double *resvec, int *nbite);
+
+/**
+ * richardson_alpha_sell with caller-provided scratch (POISSON1D_WS_CSR), no allocation
+ */
+void richardson_alpha_sell_ws(SELLMatrix *mat, double *RHS, double *X, double *alpha_rich, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws);
+
+/**
+ * Solve linear system using Conjugate Gradient with DIA format (matvec with ddiamv)
+ * @param jacobi: 1 for Jacobi preconditioning (main diagonal of mat), 0 for plain CG
+ */
+void conjugate_gradient_dia(DIAMatrix *mat, double *RHS, double *X, int *jacobi, double *tol, int *maxit, double *resvec, int *nbite);
+
+/**
+ * conjugate_gradient_dia with caller-provided scratch (POISSON1D_WS_CG, includes the Jacobi diagonal)
+ * @param ws: Workspace (nbite = 0 and X unchanged if too small)
+ */
+void conjugate_gradient_dia_ws(DIAMatrix *mat, double *RHS, double *X, int *jacobi, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws);
+
+/**
+ * Solve linear system using Conjugate Gradient with SELL-C-sigma format (matvec with dsellmv)
+ * @param jacobi: 1 for Jacobi preconditioning (diagonal entries of mat), 0 for plain CG
+ */
+void conjugate_gradient_sell(SELLMatrix *mat, double *RHS, double *X, int *jacobi, double *tol, int *maxit, double *resvec, int *nbite);
+
+/**
+ * conjugate_gradient_sell with caller-provided scratch (POISSON1D_WS_CG, includes the Jacobi diagonal)
+ * @param ws: Workspace (nbite = 0 and X unchanged if too small)
+ */
+void conjugate_gradient_sell_ws(SELLMatrix *mat, double *RHS, double *X, int *jacobi, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws);
+
+#define MG_SMOOTHER_JACOBI 0  /* Damped Jacobi smoothing (MB from extract_MB_jacobi_tridiag) */
+#define MG_SMOOTHER_GS 1      /* Gauss-Seidel smoothing (MB from extract_MB_gauss_seidel_tridiag) */
+#define MG_MAX_LEVELS 32      /* Maximum depth of the multigrid hierarchy */
+#define MG_COARSE_SIZE 3      /* Grids with fewer interior points are not coarsened */
+
+/**
+ * MGLevel structure: one grid of the multigrid hierarchy (GB storage, lab = 3, kv = 0)
+ */
+typedef struct {
+    poisson1D_int la; // number of interior points on this level
+    double *AB;       // Galerkin operator (tridiag(-1, 2, -1) on nested grids)
+    double *MB;       // smoother matrix (D or D - E)
+    double *x;        // level solution / correction
+    double *b;        // level right-hand side
+    double *r;        // level residual (scratch)
+} MGLevel;
+
+/**
+ * MGHierarchy structure: preallocated multigrid hierarchy, reused by every solve
+ */
+typedef struct {
+    int nlevels;                    // number of levels (0 is the finest)
+    int smoother;                   // MG_SMOOTHER_JACOBI or MG_SMOOTHER_GS
+    int nu1, nu2;                   // pre- and post-smoothing steps
+    double omega;                   // damping of the Jacobi smoother
+    poisson1D_int lab, ku, kl, kv;  // band parameters of AB and MB
+    MGLevel levels[MG_MAX_LEVELS];  // grids, from fine to coarse
+    double *LU;                     // coarsest operator factorized by dgbtrftridiag
+    poisson1D_int *ipiv;            // pivots of the coarse factorization
+    poisson1D_int lab_lu;           // leading dimension of LU
+} MGHierarchy;
+
+/**
+ * Allocate the multigrid hierarchy for a problem of size la. Grids are coarsened by
+ * h -> 2h (la -> la / 2) down to MG_COARSE_SIZE points, with Galerkin coarse operators;
+ * la = 2^k - 1 keeps every level nested and equal to tridiag(-1, 2, -1).
+ * @param la: Problem size on the finest grid
+ * @param smoother: MG_SMOOTHER_JACOBI or MG_SMOOTHER_GS
+ * @param maxlevels: Maximum number of levels (<= 0: no limit)
+ * @return New hierarchy, NULL on allocation or factorization failure
+ */
+MGHierarchy *mg_hierarchy_create(poisson1D_int *la, int *smoother, int *maxlevels);
+
+/**
+ * Free a multigrid hierarchy
+ * @param mg: Hierarchy from mg_hierarchy_create
+ */
+void mg_hierarchy_destroy(MGHierarchy *mg);
+
+/**
+ * Solve the Poisson 1D problem with multigrid V-cycles (no allocation)
+ * @param mg: Hierarchy from mg_hierarchy_create
+ * @param RHS: Right-hand side vector (size la)
+ * @param X: Solution vector (size la, input: initial guess unless fmg, output: solution)
+ * @param fmg: 1 to start with one full multigrid (FMG) pass, 0 for V-cycles only
+ * @param tol: Convergence tolerance for residual norm
+ * @param maxit: Maximum number of V-cycles
+ * @param resvec: Output residual history (allocated with size maxit)
+ * @param nbite: Output number of V-cycles performed
+ */
+void multigrid_solve(MGHierarchy *mg, double *RHS, double *X, int *fmg, double *tol, int *maxit, double *resvec, int *nbite);
+
+#define DST_MAX_FACTORS 64      /* Maximum number of radix stages of a DST plan */
+#define DST_MAX_RADIX 16        /* Larger prime factors of 2(la+1) go through Bluestein's algorithm */
+#define DST_PLAN_CACHE_SIZE 8   /* Number of DST plans kept, keyed by la */
+
+/**
+ * DSTPlan structure: precomputed data of the DST-I of length la (FFT of length 2(la+1)).
+ * Plans hold their own work buffers, so a plan is used by one thread at a time.
+ */
+typedef struct DSTPlan {
+    poisson1D_int la;                       // transform length (problem size)
+    poisson1D_int m;                        // FFT length 2(la+1)
+    int nfactors;                           // number of radix stages (0 for Bluestein)
+    poisson1D_int factors[DST_MAX_FACTORS]; // radices (4, 2, then odd primes up to DST_MAX_RADIX)
+    double *twiddle;                        // exp(-2 i pi k / m), k < m (complex, interleaved re/im)
+    double *work;                           // two FFT buffers of m complex values
+    double *eigval;                         // eigenvalues from eig_poisson1D
+    double *chirp;                          // Bluestein: exp(-i pi k^2 / m), k < m (complex), else NULL
+    double *chirp_fft;                      // Bluestein: FFT of the conjugate chirp filter, scaled by 1/nb (complex, nb)
+    struct DSTPlan *inner;                  // Bluestein: power-of-two FFT of length nb >= 2m - 1, else NULL
+} DSTPlan;
+
+/**
+ * Create a DST-I plan (factorization of 2(la+1) and twiddle factors). If 2(la+1) has a prime
+ * factor above DST_MAX_RADIX, the FFT is computed with Bluestein's algorithm (chirp convolution
+ * by power-of-two FFTs of length nb >= 4(la+1) - 1, about 3 times the work and 5 times the memory
+ * of a smooth length), so every la is solved in O(la log la).
+ * @param la: Transform length
+ * @return New plan, NULL on allocation failure or if nb overflows poisson1D_int
+ */
+DSTPlan *dst_plan_create(poisson1D_int *la);
+
+/**
+ * Free a DST-I plan created with dst_plan_create
+ * @param plan: Plan to free
+ */
+void dst_plan_destroy(DSTPlan *plan);
+
+/**
+ * Get the cached plan for la, creating it on first use (do not destroy it)
+ * @param la: Transform length
+ * @return Cached plan, NULL on allocation failure
+ */
+DSTPlan *dst_plan_get(poisson1D_int *la);
+
+/**
+ * Free every cached DST plan
+ */
+void dst_plan_cache_clear(void);
+
+/**
+ * Unnormalized DST-I y_k = sum_j x_j sin(jk pi / (la+1)) of nrhs vectors, two per complex FFT
+ * @param plan: DST plan of length la
+ * @param x: Input vectors (size la*nrhs, column-major)
+ * @param y: Output vectors (size la*nrhs, may be x)
+ * @param nrhs: Number of vectors
+ */
+void dst1(DSTPlan *plan, double *x, double *y, poisson1D_int *nrhs);
+
+/**
+ * Solve A * X = RHS for the Poisson 1D operator by fast diagonalization in O(la log la):
+ * forward DST, division by the eig_poisson1D eigenvalues, inverse DST. Plans are cached per la.
+ * @param RHS: Right-hand sides (size la*nrhs, column-major)
+ * @param X: Output solutions (size la*nrhs, may be RHS)
+ * @param la: Problem size
+ * @param nrhs: Number of right-hand sides
+ * @return 0 on success, -1 on allocation failure
+ */
+int poisson1D_dst_solve(double *RHS, double *X, poisson1D_int *la, poisson1D_int *nrhs);
+
+#define POISSON1D_PHASE_ASSEMBLY 0  /* Grid, RHS and operator construction */
+#define POISSON1D_PHASE_PRECOND 1   /* Preconditioner extraction (MB) */
+#define POISSON1D_PHASE_FACTOR 2    /* LU / Thomas factorization */
+#define POISSON1D_PHASE_SOLVE 3     /* Triangular solves, or whole direct solve for one-shot drivers */
+#define POISSON1D_PHASE_ITER 4      /* Iterative solver loop (count = iterations) */
+#define POISSON1D_PHASE_WRITE 5     /* Writers */
+#define POISSON1D_NPHASES 6
+#define POISSON1D_NCOUNTERS 3       /* cycles, instructions, LLC misses */
+#define POISSON1D_TIMING_SAMPLES 1024 /* Iteration samples kept for the report */
+
+/**
+ * Reset the per-phase timers, switch on the instrumentation of the library entry points
+ * (assembly, preconditioner, factorization, solves, iterative loops, writers) and optionally
+ * open the hardware counters (perf_event_open, calling thread only; silently unavailable if
+ * the kernel refuses them). Until this call every timing routine is a no-op. Iterations are
+ * sampled only when POISSON1D_TIMING is set.
+ * @param counters: 1 to open the hardware counters, 0 for timing only
+ * @return Number of hardware counters opened
+ */
+int poisson1D_timing_init(int *counters);
+
+/**
+ * Close the hardware counters opened by poisson1D_timing_init and switch the instrumentation off
+ */
+void poisson1D_timing_finalize(void);
+
+/**
+ * Start timing a phase (CLOCK_MONOTONIC wall clock); phases accumulate over begin/end pairs.
+ * Pairs nest: an entry point called by another one is accounted to the outermost phase.
+ * Calls from inside an OpenMP parallel region are ignored.
+ * @param phase: POISSON1D_PHASE_*
+ */
+void poisson1D_timing_begin(int phase);
+
+/**
+ * Stop timing a phase started with poisson1D_timing_begin
+ * @param phase: POISSON1D_PHASE_*
+ */
+void poisson1D_timing_end(int phase);
+
+/**
+ * Sample the time of iteration it inside the open POISSON1D_PHASE_ITER phase, called by the
+ * iterative loops once their residual is known. At most POISSON1D_TIMING_SAMPLES samples of
+ * the last solve are kept: when full, every other one is dropped and only every second
+ * iteration is sampled from then on.
+ * @param it: Iteration index
+ */
+void poisson1D_timing_iteration(long it);
+
+/**
+ * Copy the iteration samples of the last iterative solve
+ * @param it: Output iteration indices (size max)
+ * @param seconds: Output time since the start of the solve (size max)
+ * @param max: Capacity of it and seconds
+ * @return Number of samples copied
+ */
+int poisson1D_timing_samples(long *it, double *seconds, int *max);
+
+/**
+ * Add work items to a phase (e.g. iterations), used for per-item averages in the report
+ * @param phase: POISSON1D_PHASE_*
+ * @param count: Number of items
+ */
+void poisson1D_timing_add_count(int phase, long count);
+
+/**
+ * Accumulated wall-clock time of a phase
+ * @param phase: POISSON1D_PHASE_*
+ * @return Time in seconds
+ */
+double poisson1D_timing_seconds(int phase);
+
+/**
+ * Print the time of every phase used so far on stdout
+ */
+void poisson1D_timing_print(void);
+
+/**
+ * Write the per-phase report: JSON if filename ends with .json (overwritten), CSV otherwise
+ * (appended, one line per phase, header written to a new file), followed by the iteration
+ * samples ("iterations" object in JSON, "iteration" lines with count = iteration index in CSV)
+ * @param filename: Output filename
+ * @param driver: Driver name written in the report
+ * @param implem: Method number written in the report
+ * @param n: Problem size written in the report
+ * @return 0 on success, -1 on I/O error
+ */
+int poisson1D_timing_write(char *filename, char *driver, int *implem, poisson1D_int *n);
+
+#define POISSON1D_THETA_EULER 1.0   /* Implicit Euler (first order, L-stable) */
+#define POISSON1D_THETA_CN 0.5      /* Crank-Nicolson (second order) */
+
+/**
+ * Poisson1DHeatStepper structure: theta-scheme for the heat equation u_t = u_xx on (0, 1) with
+ * constant Dirichlet boundary conditions, on la interior points (h = 1/(la+1)):
+ *   (I + theta r A) u^{n+1} = (I - (1 - theta) r A) u^n + r g,   r = dt / h^2
+ * where A is the Poisson operator and g holds the boundary values. I + theta r A is factorized
+ * once by dgbtrftridiag at creation; every step is two passes over u, O(la): the explicit stencil
+ * fused with the forward substitution, then the back substitution.
+ */
+typedef struct {
+    poisson1D_int la;         // problem size
+    poisson1D_int kl, ku, kv; // band parameters of the factors (kl = ku = kv = 1)
+    poisson1D_int lab;        // leading dimension of the factors
+    double theta;             // 1: implicit Euler, 0.5: Crank-Nicolson
+    double r;                 // dt / h^2
+    double BC0;               // boundary value at x=0
+    double BC1;               // boundary value at x=1
+    double *AB;               // LU factors of I + theta r A (GB storage, usable by dgbtrs_)
+    poisson1D_int *ipiv;      // pivot indices (identity)
+    double *lu;               // the same factors unit-stride: multipliers, reciprocal pivots, super-diagonal (3*la)
+} Poisson1DHeatStepper;
+
+/**
+ * Create a theta-scheme stepper and factorize its implicit operator
+ * @param la: Problem size (number of interior grid points)
+ * @param theta: Implicitness in (0, 1] (POISSON1D_THETA_EULER, POISSON1D_THETA_CN)
+ * @param dt: Time step
+ * @param BC0: Boundary value at x=0
+ * @param BC1: Boundary value at x=1
+ * @param info: Output info (0: success, >0: singular matrix, <0: invalid argument or allocation failure)
+ * @return New stepper, NULL on failure
+ */
+Poisson1DHeatStepper *poisson1D_heat_create(poisson1D_int *la, double *theta, double *dt, double *BC0, double *BC1, poisson1D_int *info);
+
+/**
+ * Advance the solution by nsteps time steps with the factors of the stepper (no allocation)
+ * @param st: Stepper
+ * @param u: Solution at the interior points (size la), overwritten by the solution nsteps later
+ * @param nsteps: Number of time steps
+ * @param info: Output info (0: success)
+ * @return info value
+ */
+poisson1D_int poisson1D_heat_step(Poisson1DHeatStepper *st, double *u, int *nsteps, poisson1D_int *info);
+
+/**
+ * Release a stepper and its factors
+ * @param st: Stepper
+ */
+void poisson1D_heat_destroy(Poisson1DHeatStepper *st);
+
+/**
+ * Background snapshot writer: snapshots are copied into a ring of depth buffers and written by a
+ * dedicated thread (POSIX threads), so the time loop only waits for the disk when every buffer
+ * is still pending. Files are <prefix>_<step>.bin (write_vec_bin) or .dat (write_vec) with text.
+ */
+typedef struct Poisson1DSnapshotWriter Poisson1DSnapshotWriter;
+
+#define POISSON1D_SNAPSHOT_DEPTH 4  /* Default number of snapshot buffers */
+
+/**
+ * Create a snapshot writer and start its thread
+ * @param la: Snapshot size
+ * @param depth: Number of buffers (<= 0: POISSON1D_SNAPSHOT_DEPTH)
+ * @param prefix: Filename prefix (copied)
+ * @param text: 1 to write text .dat files, 0 for binary .bin files
+ * @return New writer, NULL on allocation or thread creation failure
+ */
+Poisson1DSnapshotWriter *poisson1D_snapshot_writer_create(poisson1D_int *la, int *depth, char *prefix, int *text);
+
+/**
+ * Queue a snapshot: u is copied, the file is written later by the writer thread
+ * @param w: Writer
+ * @param u: Snapshot (size la)
+ * @param step: Step number used in the filename
+ */
+void poisson1D_snapshot_writer_push(Poisson1DSnapshotWriter *w, double *u, int *step);
+
+/**
+ * Write the pending snapshots, stop the thread and release the writer
+ * @param w: Writer
+ * @param written: Output number of snapshots written (may be NULL)
+ * @param stalls: Output number of pushes that had to wait for a free buffer (may be NULL)
+ */
+void poisson1D_snapshot_writer_destroy(Poisson1DSnapshotWriter *w, int *written, int *stalls);
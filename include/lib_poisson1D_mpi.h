@@ -0,0 +1,187 @@
+/**********************************************/
+/* lib_poisson1D_mpi.h                        */
+/* Header for the distributed-memory 1D       */
+/* Poisson solvers (MPI domain decomposition) */
+/**********************************************/
+#include "lib_poisson1D.h"
+#include <mpi.h>
+
+// MPI datatype of poisson1D_int
+#ifdef POISSON1D_ILP64
+#define POISSON1D_MPI_INT MPI_INT64_T
+#else
+#define POISSON1D_MPI_INT MPI_INT
+#endif
+
+/**
+ * Block distribution of the la interior points over the ranks of a communicator: rank p owns
+ * the contiguous global rows [offset, offset + n), offset = floor(la p / P). Vectors are stored
+ * locally (size n); the halo-exchanging routines use ghost values of the neighbouring ranks.
+ */
+typedef struct {
+    MPI_Comm comm;        // communicator (not duplicated)
+    int rank;             // rank in comm
+    int size;             // number of ranks P
+    poisson1D_int la;     // global number of interior points
+    poisson1D_int n;      // number of local points
+    poisson1D_int offset; // global index of the first local point
+    int left;             // rank owning the previous slice, MPI_PROC_NULL on rank 0
+    int right;            // rank owning the next slice, MPI_PROC_NULL on rank P-1
+    double cl;            // coupling A(offset, offset-1) to the left ghost (0 on rank 0)
+    double cr;            // coupling A(offset+n-1, offset+n) to the right ghost (0 on rank P-1)
+} Poisson1DDist;
+
+/**
+ * Set up the block distribution of la points over comm (collective); cl and cr are set to the
+ * couplings of the Poisson operator (-1 to an existing neighbour, 0 at the physical boundaries)
+ * @param dist: Output distribution
+ * @param comm: Communicator
+ * @param la: Global number of interior points (at least the number of ranks)
+ * @return 0, -1 if some rank would own no point or more than INT_MAX points (MPI counts are int)
+ */
+int poisson1D_dist_create(Poisson1DDist *dist, MPI_Comm comm, poisson1D_int *la);
+
+/**
+ * Local slice of set_grid_points_1D: x[i] = (offset + i + 1) h, h = 1/(la+1)
+ * @param x: Output local grid points (size n)
+ * @param dist: Distribution
+ */
+void set_grid_points_1D_dist(double *x, Poisson1DDist *dist);
+
+/**
+ * Local rows of the Poisson 1D operator in GB storage: the diagonal block of the rows
+ * [offset, offset + n), which is the Poisson operator of order n, as set_GB_operator_colMajor_poisson1D.
+ * The couplings to the ghost points of the neighbours are dist->cl and dist->cr.
+ * @param AB: Output local matrix in GB format (allocated with size lab*n)
+ * @param lab: Leading dimension of AB
+ * @param kv: Number of superdiagonals in the band storage
+ * @param dist: Distribution
+ */
+void set_GB_operator_colMajor_poisson1D_dist(double *AB, poisson1D_int *lab, poisson1D_int *kv, Poisson1DDist *dist);
+
+/**
+ * Local rows of the Poisson 1D operator in row-wise compact tridiagonal storage: local row i is
+ * dl[i] x_{i-1} + d[i] x_i + du[i] x_{i+1}, dl[0] and du[n-1] being the couplings to the
+ * neighbouring ranks (0 at the physical boundaries). Input format of dgtsvpartition_dist.
+ * @param dl: Output sub-diagonal (size n)
+ * @param d: Output diagonal (size n)
+ * @param du: Output super-diagonal (size n)
+ * @param dist: Distribution
+ */
+void set_tridiag_operator_poisson1D_dist(double *dl, double *d, double *du, Poisson1DDist *dist);
+
+/**
+ * Local slice of set_dense_RHS_DBC_1D (BC0 on the first global row, BC1 on the last)
+ * @param RHS: Output local right-hand side (size n)
+ * @param dist: Distribution
+ * @param BC0: Left boundary value
+ * @param BC1: Right boundary value
+ */
+void set_dense_RHS_DBC_1D_dist(double *RHS, Poisson1DDist *dist, double *BC0, double *BC1);
+
+/**
+ * Exchange the one-point halos with the neighbouring ranks (collective): the first and last
+ * local values are sent, the last value of the left neighbour and the first value of the
+ * right one received (0 at the physical boundaries)
+ * @param x: Local vector (size n)
+ * @param ghost: Output ghost values {x_{offset-1}, x_{offset+n}}
+ * @param dist: Distribution
+ */
+void poisson1D_dist_halo_exchange(double *x, double *ghost, Poisson1DDist *dist);
+
+/**
+ * Distributed product y = A x with the local GB rows of set_GB_operator_colMajor_poisson1D_dist:
+ * the halo exchange is started first and overlapped with the local dgbmv, the ghost
+ * contributions are added to the end rows once it completes (collective)
+ * @param AB: Local matrix in GB format (packed: stride kl+ku+1)
+ * @param x: Local input vector (size n)
+ * @param y: Local output vector (size n)
+ * @param ku: Number of superdiagonals
+ * @param kl: Number of subdiagonals
+ * @param dist: Distribution
+ */
+void dgbmv_dist(double *AB, double *x, double *y, poisson1D_int *ku, poisson1D_int *kl, Poisson1DDist *dist);
+
+/**
+ * Global dot product (local dot followed by MPI_Allreduce, collective)
+ * @param x: Local vector (size n)
+ * @param y: Local vector (size n)
+ * @param dist: Distribution
+ * @return x^T y over all ranks
+ */
+double ddot_dist(double *x, double *y, Poisson1DDist *dist);
+
+/**
+ * Distributed Richardson iteration x = x + alpha (b - A x), or Jacobi x = x + M^{-1} (b - A x)
+ * with the local diagonal MB (extract_MB_jacobi_tridiag on the local AB). Same residual history
+ * as richardson_alpha / richardson_MB on the global problem; one halo exchange and one
+ * reduction per iteration (collective).
+ * @param AB: Local matrix in GB format (packed: stride kl+ku+1)
+ * @param RHS: Local right-hand side (size n)
+ * @param X: Local solution (size n, input: initial guess, output: solution)
+ * @param MB: Local Jacobi preconditioner in GB format (stride lab), NULL for Richardson
+ * @param alpha: Relaxation parameter (ignored for Jacobi)
+ * @param lab: Leading dimension of MB
+ * @param ku: Number of superdiagonals
+ * @param kl: Number of subdiagonals
+ * @param tol: Convergence tolerance for the global relative residual norm
+ * @param maxit: Maximum number of iterations
+ * @param resvec: Output residual history (allocated with size maxit, same on every rank)
+ * @param nbite: Output number of iterations performed
+ * @param dist: Distribution
+ */
+void richardson_dist(double *AB, double *RHS, double *X, double *MB, double *alpha, poisson1D_int *lab, poisson1D_int *ku, poisson1D_int *kl, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DDist *dist);
+
+/**
+ * Distributed Conjugate Gradient, plain or Jacobi-preconditioned (MB != NULL): one halo
+ * exchange (dgbmv_dist) and two reductions per iteration (collective)
+ * @param AB: Local matrix in GB format (packed: stride kl+ku+1)
+ * @param RHS: Local right-hand side (size n)
+ * @param X: Local solution (size n, input: initial guess, output: solution)
+ * @param MB: Local Jacobi preconditioner in GB format (stride lab), NULL for plain CG
+ * @param lab: Leading dimension of MB
+ * @param ku: Number of superdiagonals
+ * @param kl: Number of subdiagonals
+ * @param tol: Convergence tolerance for the global relative residual norm
+ * @param maxit: Maximum number of iterations
+ * @param resvec: Output residual history (allocated with size maxit, same on every rank)
+ * @param nbite: Output number of iterations performed
+ * @param dist: Distribution
+ */
+void conjugate_gradient_dist(double *AB, double *RHS, double *X, double *MB, poisson1D_int *lab, poisson1D_int *ku, poisson1D_int *kl, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DDist *dist);
+
+/**
+ * Distributed partitioned tridiagonal solve, one partition per rank (the algorithm of
+ * dgtsvpartition): each rank eliminates its block and computes its two spikes, the 6 end values
+ * of every rank are gathered (MPI_Allgather) and the reduced system of 2P unknowns is solved
+ * redundantly with dgbsv, then each rank back-substitutes with the coupling values of its
+ * neighbours. No pivoting (diagonally dominant or SPD matrices). Collective.
+ * @param dl: Local sub-diagonal, row-wise (size n, dl[0] couples to the left rank; overwritten)
+ * @param d: Local diagonal (size n; overwritten)
+ * @param du: Local super-diagonal, row-wise (size n, du[n-1] couples to the right rank)
+ * @param B: Local right-hand side (size n), overwritten by the local solution
+ * @param dist: Distribution
+ * @param info: Output, 0 on success, global row + 1 of the first zero pivot of a block, or
+ *              the dgbsv info of the reduced system plus la (same on every rank)
+ * @return info
+ */
+poisson1D_int dgtsvpartition_dist(double *dl, double *d, double *du, double *B, Poisson1DDist *dist, poisson1D_int *info);
+
+/**
+ * Global relative forward error ||x - y|| / ||x|| of distributed vectors (collective)
+ * @param x: Local reference vector (size n)
+ * @param y: Local vector (size n)
+ * @param dist: Distribution
+ * @return Relative forward error, same on every rank
+ */
+double relative_forward_error_dist(double *x, double *y, Poisson1DDist *dist);
+
+/**
+ * Write a distributed vector to one binary file (format of write_vec_bin, la rows) with
+ * MPI-IO: rank 0 writes the header, every rank its slice at its global offset (collective)
+ * @param vec: Local vector (size n)
+ * @param dist: Distribution
+ * @param filename: Output filename
+ * @return 0 on success, -1 on an MPI-IO error
+ */
+int write_vec_bin_dist(double *vec, Poisson1DDist *dist, char *filename);
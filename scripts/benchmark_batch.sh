@@ -0,0 +1,60 @@
+#!/bin/bash
+
+# Compile the project
+echo "Compiling..."
+cd "$(dirname "$0")/.." || exit
+make
+
+# Output file
+OUTPUT_FILE="benchmark_results_batch.txt"
+echo "Running multi-RHS benchmarks... Results will be saved to $OUTPUT_FILE"
+echo "Method,Size,NRHS,Time(ms),Throughput(solves/s)" > "$OUTPUT_FILE"
+
+# Problem size, and numbers of right-hand sides solved with one factorization
+SIZE=${1:-10000}
+NRHS_LIST=(1 2 4 8 16 32 64 128 256 512 1024)
+
+# Define methods: 0=TRF, 1=TRI, 2=SV (dgbtrs/dgbsv with NRHS columns),
+# 3=THOMAS (interleaved right-hand sides), 4=GTTRF, 5=GTSV, 6=CACHED (one handle per solve)
+METHODS=(0 1 2 3 4 5 6)
+
+for nrhs in "${NRHS_LIST[@]}"; do
+    for method in "${METHODS[@]}"; do
+        echo "Running Method $method with N=$SIZE, NRHS=$nrhs (5 repetitions)..."
+
+        for i in {1..5}; do
+            result=$(./bin/tpPoisson1D_direct "$method" "$SIZE" "$nrhs")
+
+            # Format: "Execution time (IMPLEM=X, N=Y): Z ms" and "Throughput (IMPLEM=X, N=Y, NRHS=K): T solves/s"
+            time_ms=$(echo "$result" | grep "Execution time" | awk '{print $(NF-1)}')
+            throughput=$(echo "$result" | grep "Throughput" | awk '{print $(NF-1)}')
+
+            if [ -z "$time_ms" ]; then time_ms="Error"; fi
+            if [ -z "$throughput" ]; then throughput="Error"; fi
+
+            echo "$method,$SIZE,$nrhs,$time_ms,$throughput" >> "$OUTPUT_FILE"
+        done
+    done
+done
+
+# Independent systems (different conductivity profiles) solved by the batched Thomas solver
+# (method 11), against one Thomas solve per system (method 3 with NRHS=1, scaled)
+SYSTEMS_FILE="benchmark_results_batch_systems.txt"
+echo "Running batched-systems benchmarks... Results will be saved to $SYSTEMS_FILE"
+echo "Method,Size,Systems,Time(ms),Throughput(systems/s)" > "$SYSTEMS_FILE"
+NBATCH=${2:-4096}
+for size in 66 130 258 514 1026 2050 4098; do
+    echo "Running Method 11 with N=$size, systems=$NBATCH (5 repetitions)..."
+    for i in {1..5}; do
+        result=$(./bin/tpPoisson1D_direct 11 "$size" "$NBATCH")
+        time_ms=$(echo "$result" | grep "Execution time" | awk '{print $(NF-1)}')
+        throughput=$(echo "$result" | grep "Throughput" | awk '{print $(NF-1)}')
+        if [ -z "$time_ms" ]; then time_ms="Error"; fi
+        if [ -z "$throughput" ]; then throughput="Error"; fi
+        echo "11,$size,$NBATCH,$time_ms,$throughput" >> "$SYSTEMS_FILE"
+    done
+done
+
+echo "Benchmark complete."
+cat "$OUTPUT_FILE"
+cat "$SYSTEMS_FILE"
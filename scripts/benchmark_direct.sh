@@ -9,12 +9,19 @@ make
 OUTPUT_FILE="benchmark_results.txt"
 echo "Running benchmarks... Results will be saved to $OUTPUT_FILE"
 echo "Method,Size,Time(ms)" > "$OUTPUT_FILE"
+# Refinement steps of the mixed-precision modes (negative: fell back to double precision)
+REFINE_FILE="benchmark_results_refinement.txt"
+echo "Method,Size,RefinementSteps" > "$REFINE_FILE"
 
 # Define sizes to test
 SIZES=(100 200 500 1000 2000 5000 10000 20000 50000 100000)
 
-# Define methods: 0=TRF (LAPACK), 1=TRI (Custom), 2=SV (LAPACK Driver)
-METHODS=(0 1 2)
+# Define methods: 0=TRF (LAPACK), 1=TRI (Custom), 2=SV (LAPACK Driver),
+# 3=THOMAS (Custom, compact storage), 4=GTTRF (LAPACK dgttrf/dgttrs), 5=GTSV (LAPACK dgtsv),
+# 8=DST (fast diagonalization, O(N log N)),
+# 9=MIXED_TRF (sgbtrf + refinement), 10=MIXED_TRI (sgbtrftridiag + refinement),
+# 12=STENCIL (closed-form pivots, O(1) operator storage), 13=OOC (memory-mapped files, bounded memory)
+METHODS=(0 1 2 3 4 5 8 9 10 12 13)
 
 for size in "${SIZES[@]}"; do
     for method in "${METHODS[@]}"; do
@@ -34,8 +41,18 @@ for size in "${SIZES[@]}"; do
             
             echo "$method,$size,$time_ms" >> "$OUTPUT_FILE"
         done
+
+        # Format: "Refinement steps (N=Y): K" or "... no convergence after K, solved in double precision"
+        if [ "$method" -ge 9 ]; then
+            steps=$(./bin/tpPoisson1D_direct "$method" "$size" | grep "Refinement steps" | awk -F': ' '{print $2}')
+            case "$steps" in
+                "no convergence after "*) steps=-$(echo "$steps" | awk '{print $4}' | tr -d ',') ;;
+            esac
+            echo "$method,$size,$steps" >> "$REFINE_FILE"
+        fi
     done
 done
 
 echo "Benchmark complete."
 cat "$OUTPUT_FILE"
+cat "$REFINE_FILE"
@@ -10,11 +10,17 @@ OUTPUT_FILE="benchmark_results_iter.txt"
 echo "Running iterative benchmarks... Results will be saved to $OUTPUT_FILE"
 echo "Method,Size,Time(ms),RelRes,Iterations" > "$OUTPUT_FILE"
 
-# Define sizes to test
-SIZES=(10 100 1000)
+# Define sizes to test (2^k + 1: nested multigrid levels)
+SIZES=(17 129 1025)
 
-# Define methods: 0=ALPHA (Richardson), 1=JAC (Jacobi), 2=GS (Gauss-Seidel), 3=CSR, 4=CSC
-METHODS=(0 1 2 3 4)
+# Define methods: 0=ALPHA (Richardson), 1=JAC (Jacobi), 2=GS (Gauss-Seidel), 3=CSR, 4=CSC, 5=STENCIL (matrix-free),
+# 6=GSRB (red-black Gauss-Seidel, OpenMP: set OMP_NUM_THREADS),
+# 7=CG (GB), 8=PCG (GB, Jacobi), 9=CG_CSR (CSR, Jacobi), 10=CG_STENCIL (matrix-free),
+# 11=MG (multigrid V-cycles), 12=FMG (full multigrid),
+# 13=CHEB (GB), 14=PCHEB (GB, Jacobi), 15=CHEB_CSR (CSR, Jacobi), 16=CHEB_CSC (CSC, Jacobi),
+# 17=DIA (Richardson), 18=SELL (Richardson, SELL-8-1), 19=CG_DIA (Jacobi), 20=CG_SELL (Jacobi),
+# 21=ALPHA_TILED, 22=JAC_TILED (temporally blocked, default s and tile), 23=GS_STENCIL (O(1) operator)
+METHODS=(0 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23)
 
 for size in "${SIZES[@]}"; do
     for method in "${METHODS[@]}"; do
@@ -0,0 +1,56 @@
+#!/bin/bash
+
+# Compile the project (MPI binaries are not part of "make all")
+echo "Compiling..."
+cd "$(dirname "$0")/.." || exit
+make mpi
+
+# Launcher: MPIRUN_FLAGS="--oversubscribe" to run more ranks than cores, add
+# "--mca mpi_yield_when_idle 1" in that case so that waiting ranks leave the core
+MPIRUN=${MPIRUN:-mpirun}
+MPIRUN_FLAGS=${MPIRUN_FLAGS:-}
+
+# Output file
+OUTPUT_FILE="benchmark_results_mpi.txt"
+echo "Running MPI scaling benchmarks... Results will be saved to $OUTPUT_FILE"
+echo "Scaling,Method,Size,Ranks,Time(ms),Iterations" > "$OUTPUT_FILE"
+
+# Rank counts: powers of two up to the number of cores, then all cores (override with RANKS="1 2 4 8")
+NCORES=$(nproc)
+if [ -n "$RANKS" ]; then
+    read -r -a RANK_LIST <<< "$RANKS"
+else
+    RANK_LIST=()
+    for ((p = 1; p < NCORES; p *= 2)); do RANK_LIST+=("$p"); done
+    RANK_LIST+=("$NCORES")
+fi
+
+# Methods: 0=ALPHA, 1=JAC, 2=CG, 3=PCG (fixed iteration count), 4=PAR (partitioned direct solve)
+METHODS=(0 2 3 4)
+MAXIT=200
+
+# Strong scaling: fixed global size; weak scaling: fixed size per rank
+STRONG_SIZE=${STRONG_SIZE:-10000002}
+WEAK_SIZE_PER_RANK=${WEAK_SIZE_PER_RANK:-2500000}
+
+run() {
+    # Format: "Execution time (IMPLEM=X, N=Y, P=Z): T ms"
+    result=$(OMP_NUM_THREADS=1 $MPIRUN $MPIRUN_FLAGS -np "$4" ./bin/tpPoisson1D_mpi "$2" "$3" "$MAXIT")
+    time_ms=$(echo "$result" | grep "Execution time" | awk '{print $(NF-1)}')
+    nb_ite=$(echo "$result" | grep "Nb iterations" | awk '{print $NF}')
+    if [ -z "$time_ms" ]; then time_ms="Error"; fi
+    echo "$1,$2,$3,$4,$time_ms,$nb_ite" >> "$OUTPUT_FILE"
+}
+
+for method in "${METHODS[@]}"; do
+    for ranks in "${RANK_LIST[@]}"; do
+        echo "Strong scaling: Method $method with N=$STRONG_SIZE on $ranks ranks (3 repetitions)..."
+        for i in {1..3}; do run strong "$method" "$STRONG_SIZE" "$ranks"; done
+        size=$((WEAK_SIZE_PER_RANK * ranks + 2))
+        echo "Weak scaling: Method $method with N=$size on $ranks ranks (3 repetitions)..."
+        for i in {1..3}; do run weak "$method" "$size" "$ranks"; done
+    done
+done
+
+echo "Benchmark complete."
+cat "$OUTPUT_FILE"
@@ -0,0 +1,47 @@
+#!/bin/bash
+
+# Compile the project
+echo "Compiling..."
+cd "$(dirname "$0")/.." || exit
+make
+
+# Output file
+OUTPUT_FILE="benchmark_results_parallel.txt"
+echo "Running strong-scaling benchmarks... Results will be saved to $OUTPUT_FILE"
+echo "Method,Size,Threads,Time(ms)" > "$OUTPUT_FILE"
+
+# Define sizes to test (10^8 needs about 3.2 GB for the GB storage)
+SIZES=(1000000 10000000 100000000)
+
+# Thread counts: powers of two up to all cores, then all cores
+NCORES=$(nproc)
+THREADS=()
+for ((t = 1; t < NCORES; t *= 2)); do THREADS+=("$t"); done
+THREADS+=("$NCORES")
+
+# Define methods: 0=TRF, 1=TRI, 2=SV (sequential references), 7=PAR (partitioned, OpenMP)
+SEQ_METHODS=(0 1 2)
+PAR_METHODS=(7)
+
+run() {
+    # Format: "Execution time (IMPLEM=X, N=Y): Z ms"
+    time_ms=$(OMP_NUM_THREADS="$3" ./bin/tpPoisson1D_direct "$1" "$2" | grep "Execution time" | awk '{print $(NF-1)}')
+    if [ -z "$time_ms" ]; then time_ms="Error"; fi
+    echo "$1,$2,$3,$time_ms" >> "$OUTPUT_FILE"
+}
+
+for size in "${SIZES[@]}"; do
+    for method in "${SEQ_METHODS[@]}"; do
+        echo "Running Method $method with N=$size (5 repetitions)..."
+        for i in {1..5}; do run "$method" "$size" 1; done
+    done
+    for method in "${PAR_METHODS[@]}"; do
+        for threads in "${THREADS[@]}"; do
+            echo "Running Method $method with N=$size on $threads threads (5 repetitions)..."
+            for i in {1..5}; do run "$method" "$size" "$threads"; done
+        done
+    done
+done
+
+echo "Benchmark complete."
+cat "$OUTPUT_FILE"
@@ -0,0 +1,45 @@
+#!/bin/bash
+
+# Compile the project
+echo "Compiling..."
+cd "$(dirname "$0")/.." || exit
+make
+
+# Output file
+OUTPUT_FILE="benchmark_results_poisson2D.txt"
+echo "Running 2D Poisson benchmarks... Results will be saved to $OUTPUT_FILE"
+echo "Method,N,Iterations,Time(ms),Relres,ForwardError" > "$OUTPUT_FILE"
+
+# Interior points per direction (N x N grid), relative residual tolerance
+SIZES=(63 127 255 511 1023 2047 4095)
+TOL=${1:-1e-6}
+
+# Define methods: 0=ADI (batched line solves), 1=PCG_CSR (Jacobi-preconditioned CG on CSR)
+# PCG needs O(N) iterations: it is skipped above MAX_PCG (minutes per run at N=4095)
+METHODS=(0 1)
+MAX_PCG=${2:-2047}
+
+for size in "${SIZES[@]}"; do
+    for method in "${METHODS[@]}"; do
+        if [ "$method" -eq 1 ] && [ "$size" -gt "$MAX_PCG" ]; then continue; fi
+        echo "Running Method $method with N=$size (3 repetitions)..."
+
+        for i in {1..3}; do
+            result=$(./bin/tpPoisson2D "$method" "$size" "$TOL")
+
+            # Format: "Iterations: K (...)", "Execution time (IMPLEM=X, N=Y): Z ms",
+            # "Final relative residual = R", "The relative forward error is relres = E"
+            iterations=$(echo "$result" | grep "Iterations" | awk '{print $2}')
+            time_ms=$(echo "$result" | grep "Execution time" | awk '{print $(NF-1)}')
+            relres=$(echo "$result" | grep "Final relative residual" | awk '{print $NF}')
+            error=$(echo "$result" | grep "forward error" | awk '{print $NF}')
+
+            if [ -z "$time_ms" ]; then time_ms="Error"; fi
+
+            echo "$method,$size,$iterations,$time_ms,$relres,$error" >> "$OUTPUT_FILE"
+        done
+    done
+done
+
+echo "Benchmark complete."
+cat "$OUTPUT_FILE"
@@ -0,0 +1,42 @@
+#!/bin/bash
+
+# Compile the project
+echo "Compiling..."
+cd "$(dirname "$0")/.." || exit
+make
+
+# Output file
+OUTPUT_FILE="benchmark_results_spmv_scaling.txt"
+echo "Running CSR/CSC SpMV strong-scaling benchmarks... Results will be saved to $OUTPUT_FILE"
+echo "Method,Size,Threads,TimePerIteration(us)" > "$OUTPUT_FILE"
+
+# Define sizes to test (products below POISSON1D_SPMV_PAR_MIN = 16384 rows stay sequential)
+SIZES=(100000 1000000 10000000)
+
+# Thread counts: powers of two up to all cores, then all cores
+NCORES=$(nproc)
+THREADS=()
+for ((t = 1; t < NCORES; t *= 2)); do THREADS+=("$t"); done
+THREADS+=("$NCORES")
+
+# Define methods: 3=CSR (Richardson, dcsrmv), 4=CSC (Richardson, dcscmv), 9=CG_CSR, 16=CHEB_CSC
+METHODS=(3 4 9 16)
+
+run() {
+    # Format: "Time per iteration: Z us"
+    time_us=$(OMP_NUM_THREADS="$3" ./bin/tpPoisson1D_iter "$1" "$2" | grep "Time per iteration" | awk '{print $(NF-1)}')
+    if [ -z "$time_us" ]; then time_us="Error"; fi
+    echo "$1,$2,$3,$time_us" >> "$OUTPUT_FILE"
+}
+
+for size in "${SIZES[@]}"; do
+    for method in "${METHODS[@]}"; do
+        for threads in "${THREADS[@]}"; do
+            echo "Running Method $method with N=$size on $threads threads (5 repetitions)..."
+            for i in {1..5}; do run "$method" "$size" "$threads"; done
+        done
+    done
+done
+
+echo "Benchmark complete."
+cat "$OUTPUT_FILE"
@@ -0,0 +1,47 @@
+#!/bin/bash
+
+# Compile the project
+echo "Compiling..."
+cd "$(dirname "$0")/.." || exit
+make
+
+# Output file
+OUTPUT_FILE="benchmark_results_tiled.txt"
+echo "Running temporally blocked sweep benchmarks... Results will be saved to $OUTPUT_FILE"
+echo "Method,Size,Steps,Tile,Time(ms),Iterations" > "$OUTPUT_FILE"
+
+# Grid larger than the caches: the untiled methods stream X, RHS and AB from memory every iteration
+SIZE=${1:-2000002}
+STEPS_LIST=(1 2 4 8 16 32 64)
+TILE_LIST=(128 256 512 1024 4096 16384)
+
+# Reference methods: 0=ALPHA (GB), 1=JAC (GB), 5=STENCIL (matrix-free, fused)
+for method in 0 1 5; do
+    echo "Running Method $method with N=$SIZE (3 repetitions)..."
+    for i in {1..3}; do
+        result=$(./bin/tpPoisson1D_iter "$method" "$SIZE")
+        time_ms=$(echo "$result" | grep "Execution time" | awk '{print $(NF-1)}')
+        nb_ite=$(echo "$result" | grep "Nb iterations" | awk '{print $NF}')
+        if [ -z "$time_ms" ]; then time_ms="Error"; fi
+        echo "$method,$SIZE,1,$SIZE,$time_ms,$nb_ite" >> "$OUTPUT_FILE"
+    done
+done
+
+# Tiled methods: 21=ALPHA_TILED, 22=JAC_TILED, over the number of sweeps per tile and the tile length
+for method in 21 22; do
+    for steps in "${STEPS_LIST[@]}"; do
+        for tile in "${TILE_LIST[@]}"; do
+            echo "Running Method $method with N=$SIZE, s=$steps, tile=$tile (3 repetitions)..."
+            for i in {1..3}; do
+                result=$(./bin/tpPoisson1D_iter "$method" "$SIZE" "$steps" "$tile")
+                time_ms=$(echo "$result" | grep "Execution time" | awk '{print $(NF-1)}')
+                nb_ite=$(echo "$result" | grep "Nb iterations" | awk '{print $NF}')
+                if [ -z "$time_ms" ]; then time_ms="Error"; fi
+                echo "$method,$SIZE,$steps,$tile,$time_ms,$nb_ite" >> "$OUTPUT_FILE"
+            done
+        done
+    done
+done
+
+echo "Benchmark complete."
+cat "$OUTPUT_FILE"
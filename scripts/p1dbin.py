@@ -0,0 +1,64 @@
+"""Reader for the binary files written by the poisson1D drivers (*.bin).
+
+Layout: a 64-byte header followed by rows*cols native doubles, column-major.
+The data is mapped with numpy.memmap, nothing is copied until it is used.
+"""
+import struct
+import sys
+
+import numpy as np
+
+MAGIC = b'P1DBIN\0\0'
+VERSION = 1
+HEADER_SIZE = 64
+# magic, version, type, layout, elem_size, rows, cols, kl, ku, kv, lab, reserved
+HEADER_FORMAT = '=8s4i2q4i8x'
+
+TYPES = {0: 'vec', 1: 'xy', 2: 'gb', 3: 'tridiag'}
+COLMAJOR, ROWMAJOR = 0, 1
+
+
+def is_p1dbin(path):
+    with open(path, 'rb') as f:
+        return f.read(len(MAGIC)) == MAGIC
+
+
+def read_header(path):
+    with open(path, 'rb') as f:
+        raw = f.read(HEADER_SIZE)
+    if len(raw) < HEADER_SIZE:
+        raise ValueError(f"{path}: file too short for a poisson1D binary header")
+    (magic, version, ftype, layout, elem_size, rows, cols,
+     kl, ku, kv, lab) = struct.unpack(HEADER_FORMAT, raw)
+    if magic != MAGIC or version != VERSION or elem_size != 8:
+        raise ValueError(f"{path}: not a poisson1D binary file (version {VERSION})")
+    return {'type': TYPES.get(ftype, ftype), 'layout': layout, 'rows': rows, 'cols': cols,
+            'kl': kl, 'ku': ku, 'kv': kv, 'lab': lab}
+
+
+def load(path):
+    """Return (header, array). Vectors are 1-D; other types are 2-D with shape (rows, cols).
+
+    xy: column 0 is the grid, column 1 the values.
+    gb: AB[lab, la], the band storage as written by the C code.
+    tridiag: columns dl, d, du (dl[0] = du[n-1] = 0).
+    """
+    hdr = read_header(path)
+    rows, cols = hdr['rows'], hdr['cols']
+    order = 'F' if hdr['layout'] == COLMAJOR else 'C'
+    if rows * cols == 0:
+        data = np.empty((rows, cols))
+    else:
+        data = np.memmap(path, dtype=np.float64, mode='r', offset=HEADER_SIZE,
+                         shape=(rows, cols), order=order)
+    if hdr['type'] == 'vec':
+        data = data[:, 0]
+    return hdr, data
+
+
+if __name__ == "__main__":
+    # Usage: python p1dbin.py file.bin [...] -- prints the header and the first values
+    for path in sys.argv[1:]:
+        hdr, data = load(path)
+        print(path, hdr)
+        print(data[:5])
@@ -21,7 +21,13 @@ def plot_benchmark(file_path):
     method_labels = {
         0: 'LAPACK dgbtrf (Band)',
         1: 'Custom Tridiagonal',
-        2: 'LAPACK dgbsv (Simple Driver)'
+        2: 'LAPACK dgbsv (Simple Driver)',
+        3: 'Custom Thomas (Compact Tridiagonal)',
+        4: 'LAPACK dgttrf/dgttrs',
+        5: 'LAPACK dgtsv',
+        6: 'Cached factorization (handle)',
+        7: 'Partitioned parallel (OpenMP)',
+        8: 'Fast diagonalization (DST)'
     }
 
     plt.figure(figsize=(10, 6))
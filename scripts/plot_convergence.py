@@ -3,6 +3,8 @@ import pandas as pd
 import sys
 import os
 
+from p1dbin import is_p1dbin, load
+
 def plot_combined_convergence(file_label_pairs):
     plt.figure(figsize=(10, 6))
     
@@ -15,7 +17,12 @@ def plot_combined_convergence(file_label_pairs):
             continue
 
         try:
-            data = pd.read_csv(file_path, header=None, names=['Residual'])
+            if is_p1dbin(file_path):
+                # Binary RESVEC.bin: mapped, not parsed
+                _, resvec = load(file_path)
+                data = pd.DataFrame({'Residual': resvec})
+            else:
+                data = pd.read_csv(file_path, header=None, names=['Residual'])
             data['Iteration'] = data.index + 1
             
             # Use distinct color/style
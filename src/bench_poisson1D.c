@@ -0,0 +1,388 @@
+/******************************************/
+/* bench_poisson1D.c                      */
+/* In-process benchmark of the direct and */
+/* iterative solvers: warmup, repeated    */
+/* timed runs and roofline figures        */
+/******************************************/
+#include "lib_poisson1D.h"
+#include <string.h>
+#include <time.h>
+
+#define BENCH_REPS 20           /* Timed repetitions per (method, size) */
+#define BENCH_WARMUP 3          /* Untimed runs before the repetitions */
+#define BENCH_ITERS 20          /* Fixed number of iterations of the iterative methods (tol = 0) */
+#define BENCH_STREAM_N (1 << 23) /* STREAM triad array length (64 MiB per array, well beyond the LLC) */
+#define BENCH_MAX_SIZES 16
+
+/**
+ * Benchmarked method. Traffic and flops are a per-point model of the compulsory work
+ * (each array streamed once per pass), per solve for direct methods and per iteration
+ * for iterative ones; GB/s derived from it is a lower bound of the real traffic.
+ */
+typedef struct {
+  const char *driver;     // "direct" or "iter", matching the tpPoisson1D_* executables
+  int implem;             // IMPLEM number in that driver
+  const char *name;
+  double bytes;           // bytes moved per point
+  double flops;           // floating-point operations per point
+} BenchMethod;
+
+static const BenchMethod methods[] = {
+  {"direct", 0, "TRF (dgbtrf+dgbtrs)", 120.0, 8.0},   // factor: AB r/w (lab=4) + ipiv; solve: AB, ipiv, RHS r/w
+  {"direct", 1, "TRI (dgbtrftridiag)", 120.0, 8.0},
+  {"direct", 2, "SV (dgbsv)", 120.0, 8.0},
+  {"direct", 3, "THOMAS", 80.0, 8.0},                 // factor: dl,d,du read, dl,d written; solve: dl,d,du, RHS r/w
+  {"direct", 8, "DST", 0.0, 0.0},                     // O(n log n): filled in by dst_model()
+  {"direct", 12, "THOMAS stencil", 32.0, 8.0},        // no operator in memory: RHS r/w in each sweep, one division per pivot
+  {"direct", 9, "MIXED TRF (sgbtrf+refinement)", 0.0, 0.0},  // per refinement step: mixed_model()
+  {"direct", 10, "MIXED TRI (sgbtrftridiag+refinement)", 0.0, 0.0},
+  {"iter", 0, "Richardson (GB)", 96.0, 10.0},         // copy b, dgbmv (3 AB rows, x, r r/w), nrm2, axpy
+  {"iter", 1, "Jacobi (GB)", 120.0, 10.0},            // b copied to r, dgbmv, nrm2 as above (72), x += r / diag(AB): r, AB, x r/w (48)
+  {"iter", 2, "Gauss-Seidel (GB)", 144.0, 14.0},      // 72 as above, r copied to z (16), forward substitution: 2 MB rows,
+                                                      // r read, z written (32), x += z (24)
+  {"iter", 3, "Richardson (CSR)", 104.0, 10.0},       // 3 values + 3 col_ind + row_ptr per row
+  {"iter", 4, "Richardson (CSC)", 112.0, 10.0},       // CSC scatter: y read and written
+  {"iter", 5, "Richardson (stencil)", 24.0, 8.0},     // fused: x r/w, b read
+  {"iter", 6, "Gauss-Seidel red-black", 48.0, 10.0},
+  {"iter", 7, "CG (GB)", 144.0, 15.0},                // dgbmv + 2 dots + 3 axpys
+  {"iter", 8, "PCG (GB)", 168.0, 16.0},
+  {"iter", 9, "PCG (CSR)", 176.0, 16.0},
+  {"iter", 10, "CG (stencil)", 120.0, 14.0},
+  {"iter", 11, "Multigrid V", 480.0, 60.0},           // ~2x the fine level work: 2 smoothing sweeps, residual, transfers
+  {"iter", 12, "Full multigrid", 480.0, 60.0},
+  {"iter", 13, "Chebyshev (GB)", 96.0, 11.0},         // dgbmv + x, r, d r/w, no reductions
+  {"iter", 14, "Chebyshev Jacobi (GB)", 104.0, 12.0},
+  {"iter", 15, "Chebyshev Jacobi (CSR)", 120.0, 12.0},
+  {"iter", 16, "Chebyshev Jacobi (CSC)", 128.0, 12.0},
+  {"iter", 17, "Richardson (DIA)", 88.0, 10.0},       // 3 values, no indices
+  {"iter", 18, "Richardson (SELL-8-1)", 104.0, 10.0}, // 3 values + 3 col_ind + perm per row
+  {"iter", 19, "PCG (DIA)", 160.0, 16.0},
+  {"iter", 20, "PCG (SELL-8-1)", 176.0, 16.0},
+  {"iter", 21, "Richardson tiled (GB)", 0.0, 10.0},   // per block of s iterations: tiled_model()
+  {"iter", 22, "Jacobi tiled (GB)", 0.0, 10.0},
+  {"iter", 23, "Gauss-Seidel (stencil)", 24.0, 10.0}, // fused as Richardson (stencil), forward substitution on the block
+};
+#define BENCH_NMETHODS ((int)(sizeof(methods) / sizeof(methods[0])))
+
+/* Operators and vectors of one (method, size) case */
+typedef struct {
+  poisson1D_int la, lab, ku, kl, kv;
+  double *AB, *AB0, *MB, *RHS, *RHS0, *SOL, *resvec;
+  poisson1D_int *ipiv;
+  TriDiagMatrix TD;
+  CSRMatrix CSR_A;
+  CSCMatrix CSC_A;
+  DIAMatrix DIA_A;
+  SELLMatrix SELL_A;
+  StencilOperator ST;
+  MGHierarchy *mg;
+  Poisson1DWorkspace *ws;  // shared by every method of one size
+  double alpha, eigmin, eigmax;
+  int nbite;
+} BenchCase;
+
+static double now(void){
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1.0e-9;
+}
+
+static int cmp_double(const void *a, const void *b){
+  double x = *(const double *) a, y = *(const double *) b;
+  return (x > y) - (x < y);
+}
+
+/* Best-of-5 STREAM triad a = b + s * c, counting 24 bytes per element as STREAM does */
+static double stream_bandwidth(void){
+  size_t n = BENCH_STREAM_N;
+  double *a = (double *) malloc(n * sizeof(double));
+  double *b = (double *) malloc(n * sizeof(double));
+  double *c = (double *) malloc(n * sizeof(double));
+  double s = 3.0, best = 1.0e30;
+  if (a == NULL || b == NULL || c == NULL) {free(a); free(b); free(c); return 0.0;}
+  for (size_t i = 0; i < n; i++) {a[i] = 0.0; b[i] = 1.0; c[i] = 2.0;}
+  for (int r = 0; r < 5; r++) {
+    double t0 = now();
+#pragma omp parallel for simd
+    for (size_t i = 0; i < n; i++) {a[i] = b[i] + s * c[i];}
+    double t = now() - t0;
+    if (t < best) {best = t;}
+  }
+  double check = a[n / 2];
+  free(a); free(b); free(c);
+  return (check == 7.0) ? 3.0 * n * sizeof(double) / best * 1.0e-9 : 0.0;
+}
+
+static void case_setup(const BenchMethod *m, BenchCase *bc, poisson1D_int la, Poisson1DWorkspace *ws){
+  memset(bc, 0, sizeof(*bc));
+  bc->la = la;
+  bc->ws = ws;
+  bc->ku = 1;
+  bc->kl = 1;
+  bc->kv = (strcmp(m->driver, "direct") == 0) ? 1 : 0;
+  bc->lab = bc->kv + bc->kl + bc->ku + 1;
+  double T0 = 5.0, T1 = 20.0;
+  bc->RHS = (double *) malloc(sizeof(double) * la);
+  bc->RHS0 = (double *) malloc(sizeof(double) * la);
+  bc->SOL = (double *) calloc(la, sizeof(double));
+  bc->resvec = (double *) calloc(BENCH_ITERS, sizeof(double));
+  set_dense_RHS_DBC_1D(bc->RHS0, &la, &T0, &T1);
+  bc->AB = (double *) malloc(sizeof(double) * bc->lab * la);
+  bc->AB0 = (double *) malloc(sizeof(double) * bc->lab * la);
+  set_GB_operator_colMajor_poisson1D(bc->AB0, &bc->lab, &la, &bc->kv);
+  memcpy(bc->AB, bc->AB0, sizeof(double) * bc->lab * la);
+  bc->ipiv = (poisson1D_int *) calloc(la, sizeof(poisson1D_int));
+  set_tridiag_operator_poisson1D(&bc->TD, &la);
+  set_stencil_operator_poisson1D(&bc->ST, &la);
+  bc->alpha = richardson_alpha_opt(&la);
+  bc->eigmin = eigmin_poisson1D(&la);
+  bc->eigmax = eigmax_poisson1D(&la);
+
+  if (strcmp(m->driver, "iter") == 0) {
+    int id = m->implem;
+    // Jacobi reads the diagonal row of AB in place: MB only for the Gauss-Seidel variants
+    if (id == 2) {
+      bc->MB = (double *) malloc(sizeof(double) * bc->lab * la);
+      extract_MB_gauss_seidel_tridiag(bc->AB, bc->MB, &bc->lab, &la, &bc->ku, &bc->kl, &bc->kv);
+    } else if (id == 6) {
+      bc->MB = (double *) malloc(sizeof(double) * bc->lab * la);
+      extract_MB_gauss_seidel_redblack_tridiag(bc->AB, bc->MB, &bc->lab, &la, &bc->ku, &bc->kl, &bc->kv);
+    }
+    set_CSR_operator_poisson1D(&bc->CSR_A, &la);
+    set_CSC_operator_poisson1D(&bc->CSC_A, &la);
+    if (id >= 17 && id <= 20) {
+      int C = POISSON1D_SELL_C, sigma = 1;
+      csr_to_dia(&bc->CSR_A, &bc->DIA_A);
+      csr_to_sell(&bc->CSR_A, &C, &sigma, &bc->SELL_A);
+    }
+    if (id == 11 || id == 12) {
+      int smoother = MG_SMOOTHER_GS, maxlevels = 0;
+      bc->mg = mg_hierarchy_create(&la, &smoother, &maxlevels);
+    }
+  } else if (m->implem == 8) {
+    dst_plan_get(&la);
+  }
+}
+
+/* Restore the inputs overwritten by the previous run (untimed) */
+static void case_reset(const BenchMethod *m, BenchCase *bc){
+  poisson1D_int la = bc->la;
+  memcpy(bc->RHS, bc->RHS0, sizeof(double) * la);
+  memset(bc->SOL, 0, sizeof(double) * la);
+  if (strcmp(m->driver, "direct") == 0) {
+    memcpy(bc->AB, bc->AB0, sizeof(double) * bc->lab * la);
+    for (poisson1D_int i = 0; i < la; i++) {bc->TD.d[i] = 2.0;}
+    for (poisson1D_int i = 0; i < la - 1; i++) {bc->TD.dl[i] = -1.0; bc->TD.du[i] = -1.0;}
+  }
+}
+
+static poisson1D_int case_run(const BenchMethod *m, BenchCase *bc){
+  poisson1D_int la = bc->la, nrhs = 1, info = 0;
+  int maxit = BENCH_ITERS, check = BENCH_ITERS, jacobi = 1;
+  double tol = 0.0;  // run exactly maxit iterations
+  double eigmin_jac = 0.5 * bc->eigmin, eigmax_jac = 0.5 * bc->eigmax;
+  poisson1D_int *lab = &bc->lab, *ku = &bc->ku, *kl = &bc->kl;
+
+  if (strcmp(m->driver, "direct") == 0) {
+    switch (m->implem) {
+      case 0:
+        dgbtrf_(&la, &la, kl, ku, bc->AB, lab, bc->ipiv, &info);
+        if (info == 0) {dgbtrs_("N", &la, kl, ku, &nrhs, bc->AB, lab, bc->ipiv, bc->RHS, &la, &info);}
+        break;
+      case 1:
+        dgbtrftridiag(&la, &la, kl, ku, bc->AB, lab, bc->ipiv, &info);
+        if (info == 0) {dgbtrs_("N", &la, kl, ku, &nrhs, bc->AB, lab, bc->ipiv, bc->RHS, &la, &info);}
+        break;
+      case 2:
+        dgbsv_(&la, kl, ku, &nrhs, bc->AB, lab, bc->ipiv, bc->RHS, &la, &info);
+        break;
+      case 3:
+        dgttrftridiag(&la, bc->TD.dl, bc->TD.d, bc->TD.du, &info);
+        if (info == 0) {dgttrstridiag(&la, &nrhs, bc->TD.dl, bc->TD.d, bc->TD.du, bc->RHS, &la, &info);}
+        break;
+      case 8:
+        info = poisson1D_dst_solve(bc->RHS, bc->RHS, &la, &nrhs);
+        break;
+      case 12:
+        dstencil_thomas(&bc->ST, &nrhs, bc->RHS, &la, &info);
+        break;
+      case 9:
+      case 10: {
+        int kind = (m->implem == 9) ? POISSON1D_MIXED_TRF : POISSON1D_MIXED_TRI, maxref = POISSON1D_MIXED_MAXREF;
+        double rtol = 0.0;
+        dgbsv_mixed(&kind, &la, kl, ku, &nrhs, bc->AB, lab, bc->RHS, &la, &rtol, &maxref, &bc->nbite, &info);
+        return info;  // nbite: refinement steps, negative after a fallback to double precision
+      }
+    }
+    bc->nbite = 1;
+    return info;
+  }
+
+  // Scratch comes from the per-size workspace: the timed runs do not allocate
+  Poisson1DWorkspace *ws = bc->ws;
+  int rich = POISSON1D_STENCIL_RICHARDSON, gs = POISSON1D_STENCIL_GS;
+  switch (m->implem) {
+    case 0: richardson_alpha_ws(bc->AB, bc->RHS, bc->SOL, &bc->alpha, lab, &la, ku, kl, &tol, &maxit, bc->resvec, &bc->nbite, ws); break;
+    case 1: richardson_jacobi_ws(bc->AB, bc->RHS, bc->SOL, lab, &la, ku, kl, &tol, &maxit, bc->resvec, &bc->nbite, ws); break;
+    case 2: richardson_MB_ws(bc->AB, bc->RHS, bc->SOL, bc->MB, lab, &la, ku, kl, &tol, &maxit, bc->resvec, &bc->nbite, ws); break;
+    case 3: richardson_alpha_csr_ws(&bc->CSR_A, bc->RHS, bc->SOL, &bc->alpha, &tol, &maxit, bc->resvec, &bc->nbite, ws); break;
+    case 4: richardson_alpha_csc_ws(&bc->CSC_A, bc->RHS, bc->SOL, &bc->alpha, &tol, &maxit, bc->resvec, &bc->nbite, ws); break;
+    case 5: richardson_stencil_op(&bc->ST, bc->RHS, bc->SOL, &bc->alpha, &rich, &tol, &maxit, bc->resvec, &bc->nbite); break;
+    case 6: richardson_MB_redblack_ws(bc->AB, bc->RHS, bc->SOL, bc->MB, lab, &la, ku, kl, &tol, &maxit, bc->resvec, &bc->nbite, ws); break;
+    case 7: conjugate_gradient_ws(bc->AB, bc->RHS, bc->SOL, NULL, lab, &la, ku, kl, &tol, &maxit, bc->resvec, &bc->nbite, ws); break;
+    case 8: conjugate_gradient_ws(bc->AB, bc->RHS, bc->SOL, bc->AB, lab, &la, ku, kl, &tol, &maxit, bc->resvec, &bc->nbite, ws); break;
+    case 9: conjugate_gradient_csr_ws(&bc->CSR_A, bc->RHS, bc->SOL, &jacobi, &tol, &maxit, bc->resvec, &bc->nbite, ws); break;
+    case 10: conjugate_gradient_op_ws(matvec_stencil_op, &bc->ST, NULL, bc->RHS, bc->SOL, &la, &tol, &maxit, bc->resvec, &bc->nbite, ws); break;
+    case 11:
+    case 12: {
+      int fmg = (m->implem == 12);
+      if (bc->mg == NULL) {return -1;}
+      multigrid_solve(bc->mg, bc->RHS, bc->SOL, &fmg, &tol, &maxit, bc->resvec, &bc->nbite);
+      break;
+    }
+    case 13: chebyshev_ws(bc->AB, bc->RHS, bc->SOL, NULL, lab, &la, ku, kl, &bc->eigmin, &bc->eigmax, &check, &tol, &maxit, bc->resvec, &bc->nbite, ws); break;
+    case 14: chebyshev_ws(bc->AB, bc->RHS, bc->SOL, bc->AB, lab, &la, ku, kl, &eigmin_jac, &eigmax_jac, &check, &tol, &maxit, bc->resvec, &bc->nbite, ws); break;
+    case 15: chebyshev_csr_ws(&bc->CSR_A, bc->RHS, bc->SOL, &jacobi, &eigmin_jac, &eigmax_jac, &check, &tol, &maxit, bc->resvec, &bc->nbite, ws); break;
+    case 16: chebyshev_csc_ws(&bc->CSC_A, bc->RHS, bc->SOL, &jacobi, &eigmin_jac, &eigmax_jac, &check, &tol, &maxit, bc->resvec, &bc->nbite, ws); break;
+    case 17: richardson_alpha_dia_ws(&bc->DIA_A, bc->RHS, bc->SOL, &bc->alpha, &tol, &maxit, bc->resvec, &bc->nbite, ws); break;
+    case 18: richardson_alpha_sell_ws(&bc->SELL_A, bc->RHS, bc->SOL, &bc->alpha, &tol, &maxit, bc->resvec, &bc->nbite, ws); break;
+    case 19: conjugate_gradient_dia_ws(&bc->DIA_A, bc->RHS, bc->SOL, &jacobi, &tol, &maxit, bc->resvec, &bc->nbite, ws); break;
+    case 20: conjugate_gradient_sell_ws(&bc->SELL_A, bc->RHS, bc->SOL, &jacobi, &tol, &maxit, bc->resvec, &bc->nbite, ws); break;
+    case 21:
+    case 22: {
+      int steps = POISSON1D_TILE_STEPS, tile = POISSON1D_TILE_SIZE;
+      double one = 1.0;
+      richardson_tiled(bc->AB, bc->RHS, bc->SOL, (m->implem == 22) ? bc->AB : NULL, (m->implem == 22) ? &one : &bc->alpha, lab, &la, ku, kl, &steps, &tile, &tol, &maxit, bc->resvec, &bc->nbite);
+      break;
+    }
+    case 23: richardson_stencil_op(&bc->ST, bc->RHS, bc->SOL, &bc->alpha, &gs, &tol, &maxit, bc->resvec, &bc->nbite); break;
+  }
+  return 0;
+}
+
+static void case_free(BenchCase *bc){
+  free(bc->AB); free(bc->AB0); free(bc->MB);
+  free(bc->RHS); free(bc->RHS0); free(bc->SOL); free(bc->resvec); free(bc->ipiv);
+  free(bc->TD.dl); free(bc->TD.d); free(bc->TD.du);
+  free(bc->CSR_A.values); free(bc->CSR_A.col_ind); free(bc->CSR_A.row_ptr);
+  free(bc->CSC_A.values); free(bc->CSC_A.row_ind); free(bc->CSC_A.col_ptr);
+  free_DIA_matrix(&bc->DIA_A); free_SELL_matrix(&bc->SELL_A);
+  if (bc->mg != NULL) {mg_hierarchy_destroy(bc->mg);}
+}
+
+/* Mixed precision: float factor (AB read, float band written and read back) and solve, then per
+ * refinement step a dgbmv residual (AB, x, b, r) and a float solve (band, r in, dx out, x r/w).
+ * A fallback to double precision adds a TRF solve. */
+static void mixed_model(int steps, double *bytes, double *flops){
+  int fallback = (steps < 0);
+  if (fallback) {steps = -steps - 1;}
+  *bytes = 32.0 + 16.0 + 16.0 + 24.0 + steps * (56.0 + 40.0);
+  *flops = 8.0 + steps * 14.0;
+  if (fallback) {*bytes += 120.0; *flops += 8.0;}
+}
+
+/* Temporally blocked sweeps: x r/w, b and the 3 AB rows (48 bytes, Jacobi reads its diagonal from AB)
+ * are streamed once per block of s iterations, ceil(iters / s) blocks for iters iterations */
+static void tiled_model(int iters, int s, double *bytes){
+  int blocks = (iters + s - 1) / s;
+  *bytes = 48.0 * blocks / (iters > 0 ? iters : 1);
+}
+
+/* DST solve: two complex FFTs of length m = 2(la+1) (5 m log2 m flops each) and four passes over the vector.
+ * A Bluestein plan replaces each FFT by two FFTs of length nb and three chirp products (6 flops per point). */
+static void dst_model(poisson1D_int la, double *bytes, double *flops){
+  double m = 2.0 * (la + 1);
+  DSTPlan *plan = dst_plan_get(&la);
+  *flops = 2.0 * 5.0 * m * log2(m) / la;
+  *bytes = 4.0 * 16.0;
+  if (plan != NULL && plan->inner != NULL) {
+    double nb = plan->inner->m;
+    *flops = 2.0 * (2.0 * 5.0 * nb * log2(nb) + 6.0 * (2.0 * m + nb)) / la;
+    *bytes += 2.0 * 2.0 * 16.0 * (2.0 * nb + m) / la;  // chirp products over the nb buffers, filter read
+  }
+}
+
+/**
+ * Benchmark driver.
+ *
+ * @param argc: Number of command-line arguments
+ * @param argv: argv[1..] (optional): problem sizes la (default 1023 16383 262143 1048575)
+ *              Environment: BENCH_REPS, BENCH_WARMUP override the repetition counts
+ * @return 0 on success
+ */
+int main(int argc, char *argv[])
+{
+  poisson1D_int sizes[BENCH_MAX_SIZES] = {1023, 16383, 262143, 1048575};
+  int nsizes = 4;
+  int reps = BENCH_REPS, warmup = BENCH_WARMUP;
+
+  if (argc > 1) {
+    nsizes = 0;
+    for (int i = 1; i < argc && nsizes < BENCH_MAX_SIZES; i++) {sizes[nsizes++] = (poisson1D_int) atoll(argv[i]);}
+  }
+  if (getenv("BENCH_REPS") != NULL) {reps = atoi(getenv("BENCH_REPS"));}
+  if (getenv("BENCH_WARMUP") != NULL) {warmup = atoi(getenv("BENCH_WARMUP"));}
+  if (reps < 1) {reps = 1;}
+
+  double bw = stream_bandwidth();
+  printf("# STREAM triad bandwidth: %.2f GB/s\n", bw);
+  printf("# SpMV kernels (DIA, SELL): %s\n", poisson1D_simd_name(poisson1D_simd_level()));
+  printf("# %d warmup runs, %d timed runs, iterative methods run %d iterations (tol = 0)\n", warmup, reps, BENCH_ITERS);
+  printf("# MIXED rows: iterations = refinement steps, -(steps + 1) after a fallback to double precision\n");
+  printf("driver,implem,method,n,iterations,min_ms,median_ms,p95_ms,GB/s,GFlop/s,flop/byte,%%stream\n");
+
+  double *times = (double *) malloc(sizeof(double) * reps);
+  for (int s = 0; s < nsizes; s++) {
+    poisson1D_int la = sizes[s];
+    int wsmethod = POISSON1D_WS_ALL;
+    Poisson1DWorkspace *ws = poisson1D_workspace_create(&wsmethod, &la);
+    if (ws == NULL) {
+      fprintf(stderr, "n=%" POISSON1D_PRId ": workspace allocation failed\n", la);
+      continue;
+    }
+    for (int k = 0; k < BENCH_NMETHODS; k++) {
+      const BenchMethod *m = &methods[k];
+      BenchCase bc;
+      poisson1D_int info = 0;
+      case_setup(m, &bc, la, ws);
+      for (int r = 0; r < warmup && info == 0; r++) {
+        case_reset(m, &bc);
+        info = case_run(m, &bc);
+      }
+      for (int r = 0; r < reps && info == 0; r++) {
+        case_reset(m, &bc);
+        double t0 = now();
+        info = case_run(m, &bc);
+        times[r] = now() - t0;
+      }
+      if (info != 0) {
+        fprintf(stderr, "%s %d (%s), n=%" POISSON1D_PRId ": INFO = %" POISSON1D_PRId "\n", m->driver, m->implem, m->name, la, info);
+        case_free(&bc);
+        continue;
+      }
+      qsort(times, reps, sizeof(double), cmp_double);
+      double tmin = times[0], tmed = times[reps / 2], tp95 = times[(int) ceil(0.95 * reps) - 1];
+      double bytes = m->bytes, flops = m->flops;
+      int passes = bc.nbite;
+      if (strcmp(m->driver, "direct") == 0 && m->implem == 8) {dst_model(la, &bytes, &flops);}
+      if (strcmp(m->driver, "iter") == 0 && (m->implem == 21 || m->implem == 22)) {
+        tiled_model(bc.nbite, POISSON1D_TILE_STEPS, &bytes);
+      }
+      if (strcmp(m->driver, "direct") == 0 && (m->implem == 9 || m->implem == 10)) {
+        mixed_model(bc.nbite, &bytes, &flops);
+        passes = 1;
+      }
+      // Per point and per iteration model times the work actually done
+      double total_bytes = bytes * la * passes, total_flops = flops * la * passes;
+      double gbs = total_bytes / tmin * 1.0e-9, gflops = total_flops / tmin * 1.0e-9;
+      printf("%s,%d,%s,%" POISSON1D_PRId ",%d,%.4f,%.4f,%.4f,%.2f,%.2f,%.3f,%.1f\n", m->driver, m->implem, m->name, la, bc.nbite,
+             tmin * 1.0e3, tmed * 1.0e3, tp95 * 1.0e3, gbs, gflops, flops / bytes, (bw > 0.0) ? 100.0 * gbs / bw : 0.0);
+      fflush(stdout);
+      case_free(&bc);
+    }
+    poisson1D_workspace_destroy(ws);
+  }
+  free(times);
+  dst_plan_cache_clear();
+  return 0;
+}
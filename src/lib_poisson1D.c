@@ -8,44 +8,111 @@
 #include <stdlib.h>
 #include <float.h>
 
-void set_GB_operator_colMajor_poisson1D(double* AB, int *lab, int *la, int *kv){
+void set_GB_operator_colMajor_poisson1D(double* AB, poisson1D_int *lab, poisson1D_int *la, poisson1D_int *kv){
+  poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
   // Initialize the whole matrix storage to zero
   memset(AB, 0, (size_t)(*la) * (*lab) * sizeof(double));
   // Set up the tridiagonal matrix for 1D Poisson: -1, 2, -1
-  for (int j = 1; j < *la; j++) {AB[indexABCol(*kv, j, lab)] = -1.0;}
-  for (int j = 0; j < *la; j++) {AB[indexABCol(*kv + 1, j, lab)] = 2.0;}
-  for (int j = 0; j < *la - 1; j++) {AB[indexABCol(*kv + 2, j, lab)] = -1.0;}
+  for (poisson1D_int j = 1; j < *la; j++) {AB[indexABCol(*kv, j, lab)] = -1.0;}
+  for (poisson1D_int j = 0; j < *la; j++) {AB[indexABCol(*kv + 1, j, lab)] = 2.0;}
+  for (poisson1D_int j = 0; j < *la - 1; j++) {AB[indexABCol(*kv + 2, j, lab)] = -1.0;}
+  poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
 }
 
-void set_GB_operator_colMajor_poisson1D_Id(double* AB, int *lab, int *la, int *kv){
+void set_GB_operator_colMajor_poisson1D_varcoef(double* AB, poisson1D_int *lab, poisson1D_int *la, poisson1D_int *kv, double *kappa){
+  poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
+  memset(AB, 0, (size_t)(*la) * (*lab) * sizeof(double));
+  // Row i couples to its neighbours through the faces i (left) and i+1 (right)
+  for (poisson1D_int j = 1; j < *la; j++) {AB[indexABCol(*kv, j, lab)] = -kappa[j];}
+  for (poisson1D_int j = 0; j < *la; j++) {AB[indexABCol(*kv + 1, j, lab)] = kappa[j] + kappa[j + 1];}
+  for (poisson1D_int j = 0; j < *la - 1; j++) {AB[indexABCol(*kv + 2, j, lab)] = -kappa[j + 1];}
+  poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+}
+
+void set_GB_operator_colMajor_poisson1D_shifted(double* AB, poisson1D_int *lab, poisson1D_int *la, poisson1D_int *kv, double *c){
+  poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
+  // c * A, then the identity added on the diagonal row
+  set_GB_operator_colMajor_poisson1D(AB, lab, la, kv);
+  cblas_dscal((*lab) * (*la), *c, AB, 1);
+  for (poisson1D_int j = 0; j < *la; j++) {AB[indexABCol(*kv + 1, j, lab)] += 1.0;}
+  poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+}
+
+void set_GB_operator_colMajor_poisson1D_Id(double* AB, poisson1D_int *lab, poisson1D_int *la, poisson1D_int *kv){
+  poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
   // Initialize the whole matrix storage to zero
   memset(AB, 0, (size_t)(*la) * (*lab) * sizeof(double));
   // Set diagonal elements to 1
-  for (int j = 0; j < *la; j++) {AB[indexABCol(*kv + 1, j, lab)] = 1.0;}
+  for (poisson1D_int j = 0; j < *la; j++) {AB[indexABCol(*kv + 1, j, lab)] = 1.0;}
+  poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
 }
 
-void set_dense_RHS_DBC_1D(double* RHS, int* la, double* BC0, double* BC1){
+void set_dense_RHS_DBC_1D(double* RHS, poisson1D_int* la, double* BC0, double* BC1){
+  poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
   // Initialize RHS to zero
   memset(RHS, 0, (size_t)(*la) * sizeof(double));
   RHS[0] += (*BC0);      // T0 dans le premier point (boundary T0)
   RHS[*la - 1] += (*BC1);  // T1 dans le dernier point (boundary T1)
+  poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
 }  
 
-void set_analytical_solution_DBC_1D(double* EX_SOL, double* X, int* la, double* BC0, double* BC1){
+void set_dense_RHS_DBC_1D_batch(double* RHS, poisson1D_int* la, poisson1D_int* nrhs, double* BC0, double* BC1){
+  poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
+  for (poisson1D_int k = 0; k < *nrhs; k++) {
+    set_dense_RHS_DBC_1D(RHS + (size_t)k * (*la), la, &BC0[k], &BC1[k]);
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+}
+
+void set_analytical_solution_DBC_1D(double* EX_SOL, double* X, poisson1D_int* la, double* BC0, double* BC1){
+  poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
   // Linear solution between BC0 and BC1
   double DELTA_T = (*BC1) - (*BC0);
-  for (int i = 0; i < *la; i++) {EX_SOL[i] = (*BC0) + X[i] * DELTA_T;}
+  for (poisson1D_int i = 0; i < *la; i++) {EX_SOL[i] = (*BC0) + X[i] * DELTA_T;}
+  poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
 }
 
-void set_grid_points_1D(double* x, int* la){
+void set_dense_RHS_DBC_1D_varcoef(double* RHS, poisson1D_int* la, double *kappa, double* BC0, double* BC1){
+  poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
+  memset(RHS, 0, (size_t)(*la) * sizeof(double));
+  RHS[0] += kappa[0] * (*BC0);           // flux through the left boundary face
+  RHS[*la - 1] += kappa[*la] * (*BC1);   // flux through the right boundary face
+  poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+}
+
+void set_exact_solution_DBC_1D_varcoef(double* EX_SOL, poisson1D_int* la, double *kappa, double* BC0, double* BC1){
+  poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
+  // Total resistance between the two boundaries, then the same flux through every face
+  double total = 0.0;
+  for (poisson1D_int i = 0; i <= *la; i++) {total += 1.0 / kappa[i];}
+  double flux = ((*BC1) - (*BC0)) / total;
+  double u = *BC0;
+  for (poisson1D_int i = 0; i < *la; i++) {
+    u += flux / kappa[i];
+    EX_SOL[i] = u;
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+}
+
+void set_grid_points_1D(double* x, poisson1D_int* la){
+  poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
   double h = 1.0 / (double) (*la + 1); // taille du pas
   // Set grid points excluding boundaries
   // x[i] = h, 2h, ..., nh, positions between 0 and 1
-  for (int i = 0; i < *la; i++) {x[i] = (i + 1) * h;}
+  for (poisson1D_int i = 0; i < *la; i++) {x[i] = (i + 1) * h;}
+  poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+}
+
+double relative_forward_error(double* x, double* y, poisson1D_int* la){
+  int method = POISSON1D_WS_NORM;
+  Poisson1DWorkspace *ws = poisson1D_workspace_create(&method, la);
+  double err = relative_forward_error_ws(x, y, la, ws);
+  poisson1D_workspace_destroy(ws);
+  return err;
 }
 
-double relative_forward_error(double* x, double* y, int* la){
-  double *work = (double *) malloc((size_t) (*la) * sizeof(double));
+double relative_forward_error_ws(double* x, double* y, poisson1D_int* la, Poisson1DWorkspace *ws){
+  double *work = poisson1D_workspace_get(ws, (size_t)(*la));
   if (work == NULL) {return DBL_MAX;}
   // Compute work = x - y
   cblas_dcopy(*la, y, 1, work, 1);       // work = y
@@ -53,23 +120,35 @@ double relative_forward_error(double* x, double* y, int* la){
   // Compute norms
   double num = cblas_dnrm2(*la, work, 1); // ||x - y||
   double den = cblas_dnrm2(*la, x, 1);    // ||x|| (reference)
-  free(work);
   if (den == 0.0) {return (num == 0.0) ? 0.0 : DBL_MAX;}
   return num / den; // return ||x - y||/||x||
 }
 
-int indexABCol(int i, int j, int *lab){return j * (*lab) + i;}
+poisson1D_int indexABCol(poisson1D_int i, poisson1D_int j, poisson1D_int *lab){return j * (*lab) + i;}
+
+int poisson1D_index_fits(poisson1D_int m, poisson1D_int n){
+  return (m == 0) || (n <= POISSON1D_INT_MAX / m);
+}
+
+void *poisson1D_malloc(poisson1D_int m, poisson1D_int n, size_t size){
+  if (m < 0 || n < 0 || !poisson1D_index_fits(m, n)) {return NULL;}
+  size_t count = (size_t)m * (size_t)n;
+  if (size != 0 && count > SIZE_MAX / size) {return NULL;}
+  return malloc(count * size);
+}
 
-int dgbtrftridiag(int *la, int*n, int *kl, int *ku, double *AB, int *lab, int *ipiv, int *info){
+poisson1D_int dgbtrftridiag(poisson1D_int *la, poisson1D_int*n, poisson1D_int *kl, poisson1D_int *ku, double *AB, poisson1D_int *lab, poisson1D_int *ipiv, poisson1D_int *info){
   *info = 0;
   if (*n <= 0) {return *info;}
+  poisson1D_timing_begin(POISSON1D_PHASE_FACTOR);
   // Initialize pivot indices (identity permutation, no pivoting implemented)
-  for (int i = 0; i < *n; i++) {ipiv[i] = i + 1;}
+  for (poisson1D_int i = 0; i < *n; i++) {ipiv[i] = i + 1;}
   // Gaussian elimination for tridiagonal matrix
-  for (int j = 0; j < *n - 1; j++) {
+  for (poisson1D_int j = 0; j < *n - 1; j++) {
     double pivot = AB[indexABCol(*kl + *ku, j, lab)];
     if (pivot == 0.0) {
       *info = j + 1; // Singular matrix
+      poisson1D_timing_end(POISSON1D_PHASE_FACTOR);
       return *info;
     }
     // Calculate multiplier (factor) for the sub-diagonal element
@@ -82,21 +161,130 @@ int dgbtrftridiag(int *la, int*n, int *kl, int *ku, double *AB, int *lab, int *i
   if (AB[indexABCol(*kl + *ku, *n - 1, lab)] == 0.0) {
     *info = *n;
   }
+  poisson1D_timing_end(POISSON1D_PHASE_FACTOR);
   return *info;
 }
 
-void set_CSR_operator_poisson1D(CSRMatrix *mat, int *la) {
-    int n = *la;
+poisson1D_int dgttrftridiag(poisson1D_int *n, double *dl, double *d, double *du, poisson1D_int *info){
+  *info = 0;
+  if (*n <= 0) {return *info;}
+  poisson1D_timing_begin(POISSON1D_PHASE_FACTOR);
+  // Gaussian elimination for tridiagonal matrix, no pivoting (see dgbtrftridiag)
+  for (poisson1D_int j = 0; j < *n - 1; j++) {
+    if (d[j] == 0.0) {
+      *info = j + 1; // Singular matrix
+      poisson1D_timing_end(POISSON1D_PHASE_FACTOR);
+      return *info;
+    }
+    // Multiplier stored in place of the sub-diagonal element
+    double factor = dl[j] / d[j];
+    dl[j] = factor;
+    // Update the next diagonal element
+    d[j + 1] -= factor * du[j];
+  }
+  // Check the last diagonal element
+  if (d[*n - 1] == 0.0) {
+    *info = *n;
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_FACTOR);
+  return *info;
+}
+
+poisson1D_int dgttrstridiag(poisson1D_int *n, poisson1D_int *nrhs, double *dl, double *d, double *du, double *B, poisson1D_int *ldb, poisson1D_int *info){
+  *info = 0;
+  if (*n <= 0) {return *info;}
+  poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+  for (poisson1D_int k = 0; k < *nrhs; k++) {
+    double *b = B + (size_t)k * (*ldb);
+    // Solve L * y = b (unit lower bidiagonal)
+    for (poisson1D_int i = 1; i < *n; i++) {b[i] -= dl[i - 1] * b[i - 1];}
+    // Solve U * x = y (upper bidiagonal)
+    b[*n - 1] /= d[*n - 1];
+    for (poisson1D_int i = *n - 2; i >= 0; i--) {b[i] = (b[i] - du[i] * b[i + 1]) / d[i];}
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+  return *info;
+}
+
+poisson1D_int dgttrstridiag_interleaved(poisson1D_int *n, poisson1D_int *nrhs, double *dl, double *d, double *du, double *B, poisson1D_int *info){
+  *info = 0;
+  if (*n <= 0) {return *info;}
+  poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+  poisson1D_int K = *nrhs;
+  // Solve L * Y = B, one row of all right-hand sides at a time
+  for (poisson1D_int i = 1; i < *n; i++) {
+    double l = dl[i - 1];
+    double *bi = B + (size_t)i * K;
+    double *bp = bi - K;
+    #pragma omp simd
+    for (poisson1D_int k = 0; k < K; k++) {bi[k] -= l * bp[k];}
+  }
+  // Solve U * X = Y
+  double *bl = B + (size_t)(*n - 1) * K;
+  double dn = d[*n - 1];
+  #pragma omp simd
+  for (poisson1D_int k = 0; k < K; k++) {bl[k] /= dn;}
+  for (poisson1D_int i = *n - 2; i >= 0; i--) {
+    double u = du[i], di = d[i];
+    double *bi = B + (size_t)i * K;
+    double *bn = bi + K;
+    #pragma omp simd
+    for (poisson1D_int k = 0; k < K; k++) {bi[k] = (bi[k] - u * bn[k]) / di;}
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+  return *info;
+}
+
+void interleave_RHS(double *B, double *BI, poisson1D_int *la, poisson1D_int *nrhs){
+  for (poisson1D_int i = 0; i < *la; i++) {
+    for (poisson1D_int k = 0; k < *nrhs; k++) {BI[(size_t)i * (*nrhs) + k] = B[(size_t)k * (*la) + i];}
+  }
+}
+
+void deinterleave_RHS(double *BI, double *B, poisson1D_int *la, poisson1D_int *nrhs){
+  for (poisson1D_int k = 0; k < *nrhs; k++) {
+    for (poisson1D_int i = 0; i < *la; i++) {B[(size_t)k * (*la) + i] = BI[(size_t)i * (*nrhs) + k];}
+  }
+}
+
+void set_tridiag_operator_poisson1D(TriDiagMatrix *mat, poisson1D_int *la) {
+    poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
+    poisson1D_int n = *la;
     mat->n = n;
+    mat->d = (double *)poisson1D_malloc(n, 1, sizeof(double));
+    mat->dl = (double *)poisson1D_malloc(n > 1 ? n - 1 : 1, 1, sizeof(double));
+    mat->du = (double *)poisson1D_malloc(n > 1 ? n - 1 : 1, 1, sizeof(double));
+
+    // Set up the tridiagonal matrix for 1D Poisson: -1, 2, -1
+    for (poisson1D_int i = 0; i < n; i++) {mat->d[i] = 2.0;}
+    for (poisson1D_int i = 0; i < n - 1; i++) {
+        mat->dl[i] = -1.0;
+        mat->du[i] = -1.0;
+    }
+    poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+}
+
+void set_CSR_operator_poisson1D(CSRMatrix *mat, poisson1D_int *la) {
+    poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
+    poisson1D_int n = *la;
+    mat->n = n;
+    if (!poisson1D_index_fits(3, n)) {
+        // 3N - 2 would wrap around: the operator is left empty
+        fprintf(stderr, "poisson1D: 3*%" POISSON1D_PRId " nonzeros overflow the index type (build with ILP64=1)\n", n);
+        mat->nnz = 0;
+        mat->values = NULL; mat->col_ind = NULL; mat->row_ptr = NULL;
+        poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+        return;
+    }
     mat->nnz = 3 * n - 2; // Tridiagonal: 3N - 2 non-zeros
-    mat->values = (double *)malloc(mat->nnz * sizeof(double));
-    mat->col_ind = (int *)malloc(mat->nnz * sizeof(int));
-    mat->row_ptr = (int *)malloc((n + 1) * sizeof(int));
+    mat->values = (double *)poisson1D_malloc(mat->nnz, 1, sizeof(double));
+    mat->col_ind = (poisson1D_int *)poisson1D_malloc(mat->nnz, 1, sizeof(poisson1D_int));
+    mat->row_ptr = (poisson1D_int *)poisson1D_malloc(n + 1, 1, sizeof(poisson1D_int));
 
-    int count = 0;
+    poisson1D_int count = 0;
     mat->row_ptr[0] = 0;
 
-    for (int i = 0; i < n; i++) {
+    for (poisson1D_int i = 0; i < n; i++) {
         // Lower diagonal (-1)
         if (i > 0) {
             mat->values[count] = -1.0;
@@ -115,20 +303,29 @@ void set_CSR_operator_poisson1D(CSRMatrix *mat, int *la) {
         }
         mat->row_ptr[i + 1] = count;
     }
+    poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
 }
 
-void set_CSC_operator_poisson1D(CSCMatrix *mat, int *la) {
-    int n = *la;
+void set_CSC_operator_poisson1D(CSCMatrix *mat, poisson1D_int *la) {
+    poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
+    poisson1D_int n = *la;
     mat->n = n;
+    if (!poisson1D_index_fits(3, n)) {
+        fprintf(stderr, "poisson1D: 3*%" POISSON1D_PRId " nonzeros overflow the index type (build with ILP64=1)\n", n);
+        mat->nnz = 0;
+        mat->values = NULL; mat->row_ind = NULL; mat->col_ptr = NULL;
+        poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+        return;
+    }
     mat->nnz = 3 * n - 2;
-    mat->values = (double *)malloc(mat->nnz * sizeof(double));
-    mat->row_ind = (int *)malloc(mat->nnz * sizeof(int));
-    mat->col_ptr = (int *)malloc((n + 1) * sizeof(int));
+    mat->values = (double *)poisson1D_malloc(mat->nnz, 1, sizeof(double));
+    mat->row_ind = (poisson1D_int *)poisson1D_malloc(mat->nnz, 1, sizeof(poisson1D_int));
+    mat->col_ptr = (poisson1D_int *)poisson1D_malloc(n + 1, 1, sizeof(poisson1D_int));
 
-    int count = 0;
+    poisson1D_int count = 0;
     mat->col_ptr[0] = 0;
 
-    for (int j = 0; j < n; j++) {
+    for (poisson1D_int j = 0; j < n; j++) {
         // Upper diagonal (-1), stored first in column j because its row index is j-1
         if (j > 0) {
             mat->values[count] = -1.0;
@@ -147,5 +344,6 @@ void set_CSC_operator_poisson1D(CSCMatrix *mat, int *la) {
         }
         mat->col_ptr[j + 1] = count;
     }
+    poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
 }
 
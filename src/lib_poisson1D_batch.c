@@ -0,0 +1,125 @@
+/**********************************************/
+/* lib_poisson1D_batch.c                      */
+/* Batched Thomas solver for many independent */
+/* tridiagonal systems (interleaved storage)  */
+/**********************************************/
+#include "lib_poisson1D.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+int set_tridiag_batch_operator_poisson1D_varcoef(TriDiagBatch *mat, poisson1D_int *la, poisson1D_int *nbatch, double *kappa){
+  poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
+  poisson1D_int n = *la, nb = *nbatch;
+  size_t nsub = (size_t)(n > 1 ? n - 1 : 1) * nb;
+  mat->n = n;
+  mat->nbatch = nb;
+  mat->d = (double *) malloc(sizeof(double) * (size_t)n * nb);
+  mat->dl = (double *) malloc(sizeof(double) * nsub);
+  mat->du = (double *) malloc(sizeof(double) * nsub);
+  if (mat->d == NULL || mat->dl == NULL || mat->du == NULL) {
+    free_tridiag_batch(mat);
+    poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+    return -1;
+  }
+  // Same rows as set_GB_operator_colMajor_poisson1D_varcoef, one profile of la+1 faces per system
+  for (poisson1D_int b = 0; b < nb; b++) {
+    double *k = kappa + (size_t)b * (n + 1);
+    for (poisson1D_int i = 0; i < n; i++) {mat->d[(size_t)i * nb + b] = k[i] + k[i + 1];}
+    for (poisson1D_int i = 0; i < n - 1; i++) {
+      mat->dl[(size_t)i * nb + b] = -k[i + 1];
+      mat->du[(size_t)i * nb + b] = -k[i + 1];
+    }
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+  return 0;
+}
+
+void free_tridiag_batch(TriDiagBatch *mat){
+  free(mat->dl);
+  free(mat->d);
+  free(mat->du);
+  mat->dl = mat->d = mat->du = NULL;
+  mat->n = mat->nbatch = 0;
+}
+
+poisson1D_int dgttrftridiag_batch(poisson1D_int *n, poisson1D_int *nbatch, double *dl, double *d, double *du, poisson1D_int *info){
+  *info = 0;
+  if (*n <= 0 || *nbatch <= 0) {return *info;}
+  poisson1D_timing_begin(POISSON1D_PHASE_FACTOR);
+  poisson1D_int N = *n, K = *nbatch;
+  poisson1D_int nblocks = (K + POISSON1D_BATCH_BLOCK - 1) / POISSON1D_BATCH_BLOCK;
+  poisson1D_int first = K; // smallest singular system, K if none
+
+  // One block of systems per work item: the rows of a block (POISSON1D_BATCH_BLOCK doubles per
+  // array) stay in L1 from one elimination step to the next
+  #pragma omp parallel for schedule(static) reduction(min:first) if((size_t)N * K >= POISSON1D_SPMV_PAR_MIN)
+  for (poisson1D_int blk = 0; blk < nblocks; blk++) {
+    poisson1D_int b0 = blk * POISSON1D_BATCH_BLOCK;
+    poisson1D_int m = (K - b0 < POISSON1D_BATCH_BLOCK) ? K - b0 : POISSON1D_BATCH_BLOCK;
+    for (poisson1D_int j = 0; j < N; j++) {
+      double *dj = d + (size_t)j * K + b0;
+      // Zero pivot check of the whole row before eliminating with it
+      int zero = 0;
+      #pragma omp simd reduction(+:zero)
+      for (poisson1D_int b = 0; b < m; b++) {zero += (dj[b] == 0.0);}
+      if (zero) {
+        for (poisson1D_int b = 0; b < m; b++) {
+          if (dj[b] == 0.0) {if (b0 + b < first) {first = b0 + b;} break;}
+        }
+        break;
+      }
+      if (j == N - 1) {break;}
+      // Same update as dgttrftridiag, one system per SIMD lane
+      double *lj = dl + (size_t)j * K + b0;
+      double *uj = du + (size_t)j * K + b0;
+      double *dn = dj + K;
+      #pragma omp simd
+      for (poisson1D_int b = 0; b < m; b++) {
+        double factor = lj[b] / dj[b];
+        lj[b] = factor;
+        dn[b] -= factor * uj[b];
+      }
+    }
+  }
+  if (first < K) {*info = first + 1;}
+  poisson1D_timing_end(POISSON1D_PHASE_FACTOR);
+  return *info;
+}
+
+poisson1D_int dgttrstridiag_batch(poisson1D_int *n, poisson1D_int *nbatch, double *dl, double *d, double *du, double *B, poisson1D_int *info){
+  *info = 0;
+  if (*n <= 0 || *nbatch <= 0) {return *info;}
+  poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+  poisson1D_int N = *n, K = *nbatch;
+  poisson1D_int nblocks = (K + POISSON1D_BATCH_BLOCK - 1) / POISSON1D_BATCH_BLOCK;
+
+  #pragma omp parallel for schedule(static) if((size_t)N * K >= POISSON1D_SPMV_PAR_MIN)
+  for (poisson1D_int blk = 0; blk < nblocks; blk++) {
+    poisson1D_int b0 = blk * POISSON1D_BATCH_BLOCK;
+    poisson1D_int m = (K - b0 < POISSON1D_BATCH_BLOCK) ? K - b0 : POISSON1D_BATCH_BLOCK;
+    // Solve L * Y = B
+    for (poisson1D_int i = 1; i < N; i++) {
+      double *l = dl + (size_t)(i - 1) * K + b0;
+      double *bi = B + (size_t)i * K + b0;
+      double *bp = bi - K;
+      #pragma omp simd
+      for (poisson1D_int b = 0; b < m; b++) {bi[b] -= l[b] * bp[b];}
+    }
+    // Solve U * X = Y
+    double *dlast = d + (size_t)(N - 1) * K + b0;
+    double *bl = B + (size_t)(N - 1) * K + b0;
+    #pragma omp simd
+    for (poisson1D_int b = 0; b < m; b++) {bl[b] /= dlast[b];}
+    for (poisson1D_int i = N - 2; i >= 0; i--) {
+      double *u = du + (size_t)i * K + b0;
+      double *di = d + (size_t)i * K + b0;
+      double *bi = B + (size_t)i * K + b0;
+      double *bn = bi + K;
+      #pragma omp simd
+      for (poisson1D_int b = 0; b < m; b++) {bi[b] = (bi[b] - u[b] * bn[b]) / di[b];}
+    }
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+  return *info;
+}
@@ -0,0 +1,264 @@
+/**********************************************/
+/* lib_poisson1D_dst.c                        */
+/* Fast diagonalization solver for the 1D     */
+/* Poisson operator by discrete sine          */
+/* transform (in-house mixed-radix FFT)       */
+/**********************************************/
+#include "lib_poisson1D.h"
+#include <string.h>
+#include <complex.h>
+
+/*
+ * A = tridiag(-1, 2, -1) = S diag(eig_poisson1D) S^{-1}, with S_{jk} = sin(jk pi / (la+1)) (DST-I)
+ * and S^2 = (la+1)/2 I, so A^{-1} b = 2/(la+1) S diag(1/lambda) S b.
+ * DST-I of length la: odd extension y = [0, x, 0, -reverse(x)] of length m = 2(la+1), whose DFT
+ * is purely imaginary, Y_k = -2i (S x)_k. Two real sequences share one complex FFT:
+ * z = y1 + i y2 gives Z_k = -Im(Y2_k) + i Im(Y1_k).
+ * When m has a prime factor above DST_MAX_RADIX, the O(p^2) radix-p stage would make the FFT
+ * quadratic: Bluestein's identity jk = (j^2 + k^2 - (k-j)^2) / 2 turns the DFT into
+ * Y_k = c_k sum_j (y_j c_j) conj(c_{k-j}), c_k = exp(-i pi k^2 / m), a circular convolution
+ * computed with power-of-two FFTs of length nb >= 2m - 1.
+ */
+
+/* Plan cache, replaced round-robin */
+static DSTPlan *plan_cache[DST_PLAN_CACHE_SIZE];
+static int plan_cache_next = 0;
+
+/* Complex product without the C99 inf/nan recovery (no call to __muldc3) */
+static inline double complex cmul(double complex a, double complex b){
+  double ar = creal(a), ai = cimag(a), br = creal(b), bi = cimag(b);
+  return CMPLX(ar * br - ai * bi, ar * bi + ai * br);
+}
+
+/* Stockham autosort FFT (decimation in frequency), out of place between buf0 and buf1 */
+static double complex *fft_stockham(DSTPlan *plan, double complex *x, double complex *y){
+  double complex *w = (double complex *) plan->twiddle;
+  poisson1D_int M = plan->m;
+  poisson1D_int n = M, s = 1;
+  for (poisson1D_int f = 0; f < plan->nfactors; f++) {
+    poisson1D_int p = plan->factors[f];
+    poisson1D_int m = n / p;
+    poisson1D_int wstep = M / n; // W_n^k = W_M^{k * wstep}
+    if (p == 4) {
+      for (poisson1D_int q = 0; q < m; q++) {
+        double complex w1 = w[q * wstep], w2 = w[2 * q * wstep], w3 = w[3 * q * wstep];
+        for (poisson1D_int k = 0; k < s; k++) {
+          double complex a0 = x[k + s * q], a1 = x[k + s * (q + m)];
+          double complex a2 = x[k + s * (q + 2 * m)], a3 = x[k + s * (q + 3 * m)];
+          double complex t0 = a0 + a2, t1 = a0 - a2, t2 = a1 + a3, t3 = CMPLX(cimag(a1 - a3), -creal(a1 - a3)); // -i (a1 - a3)
+          y[k + s * (4 * q)] = t0 + t2;
+          y[k + s * (4 * q + 1)] = cmul(t1 + t3, w1);
+          y[k + s * (4 * q + 2)] = cmul(t0 - t2, w2);
+          y[k + s * (4 * q + 3)] = cmul(t1 - t3, w3);
+        }
+      }
+    } else if (p == 2) {
+      for (poisson1D_int q = 0; q < m; q++) {
+        double complex w1 = w[q * wstep];
+        for (poisson1D_int k = 0; k < s; k++) {
+          double complex a = x[k + s * q], b = x[k + s * (q + m)];
+          y[k + s * (2 * q)] = a + b;
+          y[k + s * (2 * q + 1)] = cmul(a - b, w1);
+        }
+      }
+    } else {
+      // Generic radix p, O(p^2) butterfly with the roots of unity W_p = W_M^{M/p}
+      poisson1D_int pstep = M / p;
+      for (poisson1D_int q = 0; q < m; q++) {
+        for (poisson1D_int k = 0; k < s; k++) {
+          for (poisson1D_int t = 0; t < p; t++) {
+            double complex acc = 0.0;
+            for (poisson1D_int r = 0; r < p; r++) {acc += cmul(x[k + s * (q + r * m)], w[((r * t) % p) * pstep]);}
+            y[k + s * (p * q + t)] = cmul(acc, w[q * t * wstep]);
+          }
+        }
+      }
+    }
+    n = m;
+    s *= p;
+    double complex *tmp = x; x = y; y = tmp;
+  }
+  return x;
+}
+
+/* Bluestein DFT of length m through the power-of-two plan inner, y = DFT(x) (x is not modified) */
+static double complex *fft_bluestein(DSTPlan *plan, double complex *x, double complex *y){
+  DSTPlan *inner = plan->inner;
+  double complex *c = (double complex *) plan->chirp;
+  double complex *cf = (double complex *) plan->chirp_fft;
+  double complex *a = (double complex *) inner->work;
+  double complex *b = a + inner->m;
+  poisson1D_int M = plan->m, L = inner->m;
+  for (poisson1D_int k = 0; k < M; k++) {a[k] = cmul(x[k], c[k]);}
+  for (poisson1D_int k = M; k < L; k++) {a[k] = 0.0;}
+  double complex *A = fft_stockham(inner, a, b);
+  // Inverse FFT of A * cf (cf holds the 1/L scaling) as conj(FFT(conj(.)))
+  for (poisson1D_int k = 0; k < L; k++) {A[k] = conj(cmul(A[k], cf[k]));}
+  double complex *B = fft_stockham(inner, A, (A == a) ? b : a);
+  for (poisson1D_int k = 0; k < M; k++) {y[k] = cmul(c[k], conj(B[k]));}
+  return y;
+}
+
+/* DFT of length plan->m, out of place between x and y, returns the buffer holding the result */
+static double complex *fft(DSTPlan *plan, double complex *x, double complex *y){
+  return (plan->inner != NULL) ? fft_bluestein(plan, x, y) : fft_stockham(plan, x, y);
+}
+
+/* S applied to x1 and x2 (x2 may be NULL): s1 = S x1, s2 = S x2 */
+static void dst1_pair(DSTPlan *plan, double *x1, double *x2, double *s1, double *s2){
+  poisson1D_int la = plan->la, M = plan->m;
+  double complex *buf0 = (double complex *) plan->work;
+  double complex *buf1 = buf0 + M;
+  buf0[0] = 0.0;
+  buf0[la + 1] = 0.0;
+  for (poisson1D_int j = 0; j < la; j++) {
+    double v1 = x1[j];
+    double v2 = (x2 != NULL) ? x2[j] : 0.0;
+    buf0[j + 1] = v1 + I * v2;
+    buf0[M - 1 - j] = -v1 - I * v2;
+  }
+  double complex *Z = fft(plan, buf0, buf1);
+  for (poisson1D_int k = 0; k < la; k++) {
+    s1[k] = -0.5 * cimag(Z[k + 1]);
+    if (s2 != NULL) {s2[k] = 0.5 * creal(Z[k + 1]);}
+  }
+}
+
+/* Factorize plan->m (radix 4 first, then 2, then odd primes), return the largest factor, 0 if
+   DST_MAX_FACTORS stages are not enough */
+static poisson1D_int fft_factorize(DSTPlan *plan){
+  poisson1D_int r = plan->m, pmax = 1;
+  plan->nfactors = 0;
+  while (r % 4 == 0 && plan->nfactors < DST_MAX_FACTORS) {plan->factors[plan->nfactors++] = 4; r /= 4; pmax = 4;}
+  while (r % 2 == 0 && plan->nfactors < DST_MAX_FACTORS) {plan->factors[plan->nfactors++] = 2; r /= 2; pmax = (pmax > 2) ? pmax : 2;}
+  for (poisson1D_int p = 3; r > 1 && plan->nfactors < DST_MAX_FACTORS; p += 2) {
+    if ((long)p * p > r) {p = r;} // r is prime
+    while (r % p == 0 && plan->nfactors < DST_MAX_FACTORS) {plan->factors[plan->nfactors++] = p; r /= p; pmax = p;}
+  }
+  return (r == 1) ? pmax : 0;
+}
+
+/* Twiddle factors and the two work buffers of a mixed-radix FFT of length plan->m */
+static int fft_alloc(DSTPlan *plan, int twiddles){
+  plan->work = (double *) malloc(sizeof(double complex) * 2 * plan->m);
+  if (!twiddles) {return (plan->work != NULL) ? 0 : -1;}
+  plan->twiddle = (double *) malloc(sizeof(double complex) * plan->m);
+  if (plan->twiddle == NULL || plan->work == NULL) {return -1;}
+  double complex *w = (double complex *) plan->twiddle;
+  for (poisson1D_int k = 0; k < plan->m; k++) {w[k] = cexp(-2.0 * I * M_PI * k / plan->m);}
+  return 0;
+}
+
+/* Chirp, power-of-two inner plan and transformed filter of a Bluestein plan */
+static int bluestein_init(DSTPlan *plan){
+  poisson1D_int M = plan->m, L = 1;
+  while (L < 2 * M - 1) {
+    if (L > POISSON1D_INT_MAX / 2) {return -1;}
+    L *= 2;
+  }
+  DSTPlan *inner = (DSTPlan *) calloc(1, sizeof(DSTPlan));
+  plan->inner = inner;
+  plan->chirp = (double *) malloc(sizeof(double complex) * M);
+  plan->chirp_fft = (double *) malloc(sizeof(double complex) * L);
+  if (inner == NULL || plan->chirp == NULL || plan->chirp_fft == NULL) {return -1;}
+  inner->m = L;
+  if (fft_factorize(inner) == 0 || fft_alloc(inner, 1) != 0) {return -1;}
+  // c_k = exp(-i pi k^2 / m), k^2 reduced modulo 2m incrementally (no overflow, exact argument)
+  double complex *c = (double complex *) plan->chirp;
+  poisson1D_int q = 0;
+  for (poisson1D_int k = 0; k < M; k++) {
+    c[k] = cexp(-I * M_PI * (double) q / M);
+    q += 2 * k + 1;
+    if (q >= 2 * M) {q -= 2 * M;}
+  }
+  // Filter conj(c_{|k|}) wrapped around to length L, transformed once
+  double complex *b = (double complex *) inner->work;
+  for (poisson1D_int k = 0; k < L; k++) {b[k] = 0.0;}
+  b[0] = conj(c[0]);
+  for (poisson1D_int k = 1; k < M; k++) {b[k] = b[L - k] = conj(c[k]);}
+  double complex *B = fft_stockham(inner, b, b + L);
+  double complex *cf = (double complex *) plan->chirp_fft;
+  for (poisson1D_int k = 0; k < L; k++) {cf[k] = B[k] / (double) L;}
+  return 0;
+}
+
+DSTPlan *dst_plan_create(poisson1D_int *la){
+  poisson1D_timing_begin(POISSON1D_PHASE_FACTOR);
+  DSTPlan *plan = (DSTPlan *) calloc(1, sizeof(DSTPlan));
+  if (plan == NULL) {poisson1D_timing_end(POISSON1D_PHASE_FACTOR); return NULL;}
+  plan->la = *la;
+  plan->m = 2 * (*la + 1);
+  poisson1D_int pmax = fft_factorize(plan);
+  int bluestein = (pmax == 0 || pmax > DST_MAX_RADIX);
+  int err = fft_alloc(plan, !bluestein);
+  if (err == 0 && bluestein) {
+    plan->nfactors = 0;
+    err = bluestein_init(plan);
+  }
+  plan->eigval = (double *) malloc(sizeof(double) * (*la));
+  if (err != 0 || plan->eigval == NULL) {
+    dst_plan_destroy(plan);
+    poisson1D_timing_end(POISSON1D_PHASE_FACTOR);
+    return NULL;
+  }
+  eig_poisson1D(plan->eigval, la);
+  poisson1D_timing_end(POISSON1D_PHASE_FACTOR);
+  return plan;
+}
+
+void dst_plan_destroy(DSTPlan *plan){
+  if (plan == NULL) {return;}
+  free(plan->twiddle);
+  free(plan->work);
+  free(plan->eigval);
+  free(plan->chirp);
+  free(plan->chirp_fft);
+  dst_plan_destroy(plan->inner);
+  free(plan);
+}
+
+DSTPlan *dst_plan_get(poisson1D_int *la){
+  for (poisson1D_int c = 0; c < DST_PLAN_CACHE_SIZE; c++) {
+    if (plan_cache[c] != NULL && plan_cache[c]->la == *la) {return plan_cache[c];}
+  }
+  DSTPlan *plan = dst_plan_create(la);
+  if (plan == NULL) {return NULL;}
+  dst_plan_destroy(plan_cache[plan_cache_next]);
+  plan_cache[plan_cache_next] = plan;
+  plan_cache_next = (plan_cache_next + 1) % DST_PLAN_CACHE_SIZE;
+  return plan;
+}
+
+void dst_plan_cache_clear(void){
+  for (poisson1D_int c = 0; c < DST_PLAN_CACHE_SIZE; c++) {
+    dst_plan_destroy(plan_cache[c]);
+    plan_cache[c] = NULL;
+  }
+  plan_cache_next = 0;
+}
+
+void dst1(DSTPlan *plan, double *x, double *y, poisson1D_int *nrhs){
+  size_t la = plan->la;
+  // Two vectors per complex FFT
+  for (poisson1D_int k = 0; k < *nrhs; k += 2) {
+    int pair = (k + 1 < *nrhs);
+    dst1_pair(plan, x + k * la, pair ? x + (k + 1) * la : NULL, y + k * la, pair ? y + (k + 1) * la : NULL);
+  }
+}
+
+int poisson1D_dst_solve(double *RHS, double *X, poisson1D_int *la, poisson1D_int *nrhs){
+  DSTPlan *plan = dst_plan_get(la);
+  if (plan == NULL) {return -1;}
+  poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+  size_t n = *la;
+  double scale = 2.0 / (*la + 1);
+  // X = S RHS, scaled by 2/(la+1) diag(1/lambda), then X = S X
+  dst1(plan, RHS, X, nrhs);
+  for (poisson1D_int k = 0; k < *nrhs; k++) {
+    double *x = X + k * n;
+    for (size_t j = 0; j < n; j++) {x[j] *= scale / plan->eigval[j];}
+  }
+  dst1(plan, X, X, nrhs);
+  poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+  return 0;
+}
@@ -0,0 +1,193 @@
+/**********************************************/
+/* lib_poisson1D_handle.c                     */
+/* Reusable factorization handles for the 1D  */
+/* Poisson operator, backed by an LRU cache   */
+/* of LU factors keyed by (la, kind)          */
+/**********************************************/
+#include "lib_poisson1D.h"
+#include <string.h>
+
+/* Cached LU factors of the Poisson 1D operator for one (la, kind) pair */
+typedef struct Poisson1DFactor {
+  poisson1D_int la;              // problem size
+  int kind;                      // POISSON1D_FACTOR_*
+  double *AB;                    // GB factors (TRF, TRI) or dl|d|du (THOMAS)
+  poisson1D_int *ipiv;           // pivot indices (TRF, TRI)
+  size_t bytes;                  // memory held by AB and ipiv
+  int refcount;                  // number of handles using these factors
+  struct Poisson1DFactor *prev;  // more recently used entry
+  struct Poisson1DFactor *next;  // less recently used entry
+} Poisson1DFactor;
+
+/* LRU list (head = most recently used) and its limits */
+static Poisson1DFactor *cache_head = NULL;
+static Poisson1DFactor *cache_tail = NULL;
+static size_t cache_bytes = 0;
+static int cache_entries = 0;
+static size_t cache_max_bytes = POISSON1D_CACHE_DEFAULT_MAX_BYTES;
+static int cache_max_entries = POISSON1D_CACHE_DEFAULT_MAX_ENTRIES;
+static int cache_hits = 0;
+static int cache_misses = 0;
+
+static void cache_unlink(Poisson1DFactor *f){
+  if (f->prev != NULL) {f->prev->next = f->next;} else {cache_head = f->next;}
+  if (f->next != NULL) {f->next->prev = f->prev;} else {cache_tail = f->prev;}
+  f->prev = f->next = NULL;
+  cache_bytes -= f->bytes;
+  cache_entries--;
+}
+
+static void cache_push_front(Poisson1DFactor *f){
+  f->prev = NULL;
+  f->next = cache_head;
+  if (cache_head != NULL) {cache_head->prev = f;} else {cache_tail = f;}
+  cache_head = f;
+  cache_bytes += f->bytes;
+  cache_entries++;
+}
+
+static void factor_free(Poisson1DFactor *f){
+  free(f->AB);
+  free(f->ipiv);
+  free(f);
+}
+
+/* Evict unused entries, least recently used first, until the limits hold */
+static void cache_evict(void){
+  Poisson1DFactor *f = cache_tail;
+  while (f != NULL && (cache_bytes > cache_max_bytes || cache_entries > cache_max_entries)) {
+    Poisson1DFactor *prev = f->prev;
+    if (f->refcount == 0) {
+      cache_unlink(f);
+      factor_free(f);
+    }
+    f = prev;
+  }
+}
+
+/* Assemble and factorize the operator, NULL if allocation or factorization fails */
+static Poisson1DFactor *factor_build(poisson1D_int la, int kind, poisson1D_int *info){
+  Poisson1DFactor *f = (Poisson1DFactor *) calloc(1, sizeof(Poisson1DFactor));
+  if (f == NULL) {*info = -1; return NULL;}
+  poisson1D_timing_begin(POISSON1D_PHASE_FACTOR);
+  f->la = la;
+  f->kind = kind;
+  if (kind == POISSON1D_FACTOR_THOMAS) {
+    // dl (la-1) | d (la) | du (la-1), contiguous
+    f->bytes = sizeof(double) * (3 * (size_t)la);
+    f->AB = (double *) malloc(f->bytes);
+    if (f->AB == NULL) {free(f); *info = -1; poisson1D_timing_end(POISSON1D_PHASE_FACTOR); return NULL;}
+    double *dl = f->AB, *d = f->AB + la, *du = f->AB + 2 * (size_t)la;
+    for (poisson1D_int i = 0; i < la; i++) {d[i] = 2.0;}
+    for (poisson1D_int i = 0; i < la - 1; i++) {dl[i] = -1.0; du[i] = -1.0;}
+    dgttrftridiag(&la, dl, d, du, info);
+  } else {
+    poisson1D_int kv = 1, kl = 1, ku = 1;
+    poisson1D_int lab = kv + kl + ku + 1;
+    f->bytes = sizeof(double) * (size_t)lab * la + sizeof(poisson1D_int) * (size_t)la;
+    f->AB = (double *) malloc(sizeof(double) * (size_t)lab * la);
+    f->ipiv = (poisson1D_int *) malloc(sizeof(poisson1D_int) * (size_t)la);
+    if (f->AB == NULL || f->ipiv == NULL) {factor_free(f); *info = -1; poisson1D_timing_end(POISSON1D_PHASE_FACTOR); return NULL;}
+    set_GB_operator_colMajor_poisson1D(f->AB, &lab, &la, &kv);
+    if (kind == POISSON1D_FACTOR_TRF) {
+      dgbtrf_(&la, &la, &kl, &ku, f->AB, &lab, f->ipiv, info);
+    } else {
+      dgbtrftridiag(&la, &la, &kl, &ku, f->AB, &lab, f->ipiv, info);
+    }
+  }
+  if (*info != 0) {factor_free(f); poisson1D_timing_end(POISSON1D_PHASE_FACTOR); return NULL;}
+  poisson1D_timing_end(POISSON1D_PHASE_FACTOR);
+  return f;
+}
+
+Poisson1DSolver *poisson1D_solver_create(poisson1D_int *la, int *kind){
+  if (*la <= 0 || *kind < POISSON1D_FACTOR_TRF || *kind > POISSON1D_FACTOR_THOMAS) {return NULL;}
+  Poisson1DSolver *solver = (Poisson1DSolver *) malloc(sizeof(Poisson1DSolver));
+  if (solver == NULL) {return NULL;}
+  solver->la = *la;
+  solver->kind = *kind;
+  solver->kl = 1;
+  solver->ku = 1;
+  solver->lab = 4;
+  solver->factor = NULL;
+  return solver;
+}
+
+poisson1D_int poisson1D_solver_factor(Poisson1DSolver *solver, poisson1D_int *info){
+  *info = 0;
+  if (solver->factor != NULL) {return *info;}
+  // Look up the factors of the same operator in the cache
+  for (Poisson1DFactor *f = cache_head; f != NULL; f = f->next) {
+    if (f->la == solver->la && f->kind == solver->kind) {
+      cache_unlink(f);
+      cache_push_front(f);
+      f->refcount++;
+      solver->factor = f;
+      cache_hits++;
+      return *info;
+    }
+  }
+  cache_misses++;
+  Poisson1DFactor *f = factor_build(solver->la, solver->kind, info);
+  if (f == NULL) {return *info;}
+  f->refcount = 1;
+  cache_push_front(f);
+  solver->factor = f;
+  cache_evict();
+  return *info;
+}
+
+poisson1D_int poisson1D_solver_solve(Poisson1DSolver *solver, double *RHS, poisson1D_int *nrhs, poisson1D_int *info){
+  *info = 0;
+  if (solver->factor == NULL) {
+    poisson1D_solver_factor(solver, info);
+    if (*info != 0) {return *info;}
+  }
+  poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+  Poisson1DFactor *f = (Poisson1DFactor *) solver->factor;
+  poisson1D_int la = solver->la;
+  if (f->kind == POISSON1D_FACTOR_THOMAS) {
+    dgttrstridiag(&la, nrhs, f->AB, f->AB + la, f->AB + 2 * (size_t)la, RHS, &la, info);
+  } else {
+    dgbtrs_("N", &la, &solver->kl, &solver->ku, nrhs, f->AB, &solver->lab, f->ipiv, RHS, &la, info);
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+  return *info;
+}
+
+void poisson1D_solver_destroy(Poisson1DSolver *solver){
+  if (solver == NULL) {return;}
+  Poisson1DFactor *f = (Poisson1DFactor *) solver->factor;
+  if (f != NULL) {
+    f->refcount--;
+    cache_evict();
+  }
+  free(solver);
+}
+
+void poisson1D_factor_cache_set_limits(size_t max_bytes, int max_entries){
+  cache_max_bytes = max_bytes;
+  cache_max_entries = max_entries;
+  cache_evict();
+}
+
+void poisson1D_factor_cache_clear(void){
+  Poisson1DFactor *f = cache_head;
+  while (f != NULL) {
+    Poisson1DFactor *next = f->next;
+    if (f->refcount == 0) {
+      cache_unlink(f);
+      factor_free(f);
+    }
+    f = next;
+  }
+  cache_hits = 0;
+  cache_misses = 0;
+}
+
+void poisson1D_factor_cache_stats(int *hits, int *misses, int *entries, size_t *bytes){
+  *hits = cache_hits;
+  *misses = cache_misses;
+  *entries = cache_entries;
+  *bytes = cache_bytes;
+}
@@ -0,0 +1,201 @@
+/**********************************************/
+/* lib_poisson1D_heat.c                       */
+/* Transient heat equation: theta-scheme      */
+/* stepper factorized once, and background    */
+/* snapshot writer thread                     */
+/**********************************************/
+#include "lib_poisson1D.h"
+#include <string.h>
+#include <pthread.h>
+
+Poisson1DHeatStepper *poisson1D_heat_create(poisson1D_int *la, double *theta, double *dt, double *BC0, double *BC1, poisson1D_int *info){
+  *info = 0;
+  if (*la <= 0 || *theta <= 0.0 || *theta > 1.0 || *dt <= 0.0) {*info = -1; return NULL;}
+  Poisson1DHeatStepper *st = (Poisson1DHeatStepper *) calloc(1, sizeof(Poisson1DHeatStepper));
+  if (st == NULL) {*info = -1; return NULL;}
+  double h = 1.0 / (*la + 1);
+  st->la = *la;
+  st->kl = 1;
+  st->ku = 1;
+  st->kv = 1;
+  st->lab = st->kv + st->kl + st->ku + 1;
+  st->theta = *theta;
+  st->r = (*dt) / (h * h);
+  st->BC0 = *BC0;
+  st->BC1 = *BC1;
+  st->AB = (double *) malloc(sizeof(double) * st->lab * (size_t)(*la));
+  st->ipiv = (poisson1D_int *) malloc(sizeof(poisson1D_int) * (size_t)(*la));
+  st->lu = (double *) malloc(sizeof(double) * 3 * (size_t)(*la));
+  if (st->AB == NULL || st->ipiv == NULL || st->lu == NULL) {
+    poisson1D_heat_destroy(st);
+    *info = -1;
+    return NULL;
+  }
+  // I + theta r A, factorized once for all the steps
+  double c = st->theta * st->r;
+  set_GB_operator_colMajor_poisson1D_shifted(st->AB, &st->lab, &st->la, &st->kv, &c);
+  dgbtrftridiag(&st->la, &st->la, &st->kl, &st->ku, st->AB, &st->lab, st->ipiv, info);
+  if (*info != 0) {
+    poisson1D_heat_destroy(st);
+    return NULL;
+  }
+  // Unit-stride copy of the factors for the time loop, reciprocal pivots: no division per step
+  poisson1D_int n = st->la, rd = st->kl + st->ku, rl = st->ku + 2 * st->kl, ru = st->kl;
+  double *l = st->lu, *dinv = st->lu + n, *us = st->lu + 2 * (size_t)n;
+  for (poisson1D_int i = 0; i < n; i++) {
+    dinv[i] = 1.0 / st->AB[indexABCol(rd, i, &st->lab)];
+    l[i] = (i < n - 1) ? st->AB[indexABCol(rl, i, &st->lab)] : 0.0;
+    us[i] = (i < n - 1) ? st->AB[indexABCol(ru, i + 1, &st->lab)] : 0.0;
+  }
+  return st;
+}
+
+poisson1D_int poisson1D_heat_step(Poisson1DHeatStepper *st, double *u, int *nsteps, poisson1D_int *info){
+  poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+  *info = 0;
+  poisson1D_int n = st->la;
+  double *l = st->lu, *dinv = st->lu + n, *us = st->lu + 2 * (size_t)n;
+  double a = (1.0 - st->theta) * st->r;
+  // Explicit part takes (1 - theta) r g through the neighbours, the implicit part the rest
+  double g0 = st->theta * st->r * st->BC0;
+  double g1 = st->theta * st->r * st->BC1;
+  for (poisson1D_int s = 0; s < *nsteps; s++) {
+    // u <- L^{-1} ((I - (1 - theta) r A) u + r g): the stencil is fused with the forward
+    // substitution, u[i-1] kept from before its update (l[-1] = 0 handled by the first row)
+    double prev = st->BC0;
+    double cur = u[0];
+    u[0] = cur + a * (prev - 2.0 * cur + (n > 1 ? u[1] : st->BC1)) + g0;
+    prev = cur;
+    for (poisson1D_int i = 1; i < n - 1; i++) {
+      cur = u[i];
+      u[i] = cur + a * (prev - 2.0 * cur + u[i + 1]) - l[i - 1] * u[i - 1];
+      prev = cur;
+    }
+    if (n > 1) {
+      cur = u[n - 1];
+      u[n - 1] = cur + a * (prev - 2.0 * cur + st->BC1) + g1 - l[n - 2] * u[n - 2];
+    } else {
+      u[0] += g1;
+    }
+    // u <- U^{-1} u
+    u[n - 1] *= dinv[n - 1];
+    for (poisson1D_int i = n - 2; i >= 0; i--) {u[i] = (u[i] - us[i] * u[i + 1]) * dinv[i];}
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+  return *info;
+}
+
+void poisson1D_heat_destroy(Poisson1DHeatStepper *st){
+  if (st == NULL) {return;}
+  free(st->AB);
+  free(st->ipiv);
+  free(st->lu);
+  free(st);
+}
+
+/* Ring of snapshot buffers shared by the time loop (producer) and the writer thread */
+struct Poisson1DSnapshotWriter {
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t not_empty;     // signalled when a snapshot is queued or on shutdown
+  pthread_cond_t not_full;      // signalled when a snapshot has been written
+  poisson1D_int la;             // snapshot size
+  int depth;                    // number of buffers
+  int text;                     // 1: .dat files, 0: .bin files
+  char *prefix;                 // filename prefix
+  double *buf;                  // depth snapshots of la values
+  int *steps;                   // step number of each buffer
+  int head;                     // oldest pending buffer
+  int count;                    // number of pending buffers
+  int stop;                     // set by destroy, the thread exits once the ring is empty
+  int written;                  // snapshots written
+  int stalls;                   // pushes that found every buffer pending
+};
+
+static void *snapshot_writer_main(void *arg){
+  Poisson1DSnapshotWriter *w = (Poisson1DSnapshotWriter *) arg;
+  size_t len = strlen(w->prefix) + 32;
+  char *filename = (char *) malloc(len);
+  pthread_mutex_lock(&w->lock);
+  for (;;) {
+    while (w->count == 0 && !w->stop) {pthread_cond_wait(&w->not_empty, &w->lock);}
+    if (w->count == 0) {break;}
+    int slot = w->head;
+    pthread_mutex_unlock(&w->lock);
+    // The buffer is not reused by the producer until count is decremented
+    double *u = w->buf + (size_t)slot * w->la;
+    if (filename != NULL) {
+      snprintf(filename, len, "%s_%06d.%s", w->prefix, w->steps[slot], w->text ? "dat" : "bin");
+      if (w->text) {write_vec(u, &w->la, filename);} else {write_vec_bin(u, &w->la, filename);}
+    }
+    pthread_mutex_lock(&w->lock);
+    w->head = (w->head + 1) % w->depth;
+    w->count--;
+    if (filename != NULL) {w->written++;}
+    pthread_cond_signal(&w->not_full);
+  }
+  pthread_mutex_unlock(&w->lock);
+  free(filename);
+  return NULL;
+}
+
+Poisson1DSnapshotWriter *poisson1D_snapshot_writer_create(poisson1D_int *la, int *depth, char *prefix, int *text){
+  Poisson1DSnapshotWriter *w = (Poisson1DSnapshotWriter *) calloc(1, sizeof(Poisson1DSnapshotWriter));
+  if (w == NULL) {return NULL;}
+  w->la = *la;
+  w->depth = (*depth > 0) ? *depth : POISSON1D_SNAPSHOT_DEPTH;
+  w->text = *text;
+  w->prefix = strdup(prefix);
+  w->buf = (double *) malloc(sizeof(double) * (size_t)w->depth * (size_t)(*la));
+  w->steps = (int *) malloc(sizeof(int) * (size_t)w->depth);
+  if (w->prefix == NULL || w->buf == NULL || w->steps == NULL) {
+    free(w->prefix); free(w->buf); free(w->steps); free(w);
+    return NULL;
+  }
+  pthread_mutex_init(&w->lock, NULL);
+  pthread_cond_init(&w->not_empty, NULL);
+  pthread_cond_init(&w->not_full, NULL);
+  if (pthread_create(&w->thread, NULL, snapshot_writer_main, w) != 0) {
+    pthread_mutex_destroy(&w->lock);
+    pthread_cond_destroy(&w->not_empty);
+    pthread_cond_destroy(&w->not_full);
+    free(w->prefix); free(w->buf); free(w->steps); free(w);
+    return NULL;
+  }
+  return w;
+}
+
+void poisson1D_snapshot_writer_push(Poisson1DSnapshotWriter *w, double *u, int *step){
+  pthread_mutex_lock(&w->lock);
+  if (w->count == w->depth) {
+    w->stalls++;
+    while (w->count == w->depth) {pthread_cond_wait(&w->not_full, &w->lock);}
+  }
+  int slot = (w->head + w->count) % w->depth;
+  pthread_mutex_unlock(&w->lock);
+  // The slot is invisible to the writer thread until count is incremented: copy without the lock
+  memcpy(w->buf + (size_t)slot * w->la, u, sizeof(double) * (size_t)w->la);
+  pthread_mutex_lock(&w->lock);
+  w->steps[slot] = *step;
+  w->count++;
+  pthread_cond_signal(&w->not_empty);
+  pthread_mutex_unlock(&w->lock);
+}
+
+void poisson1D_snapshot_writer_destroy(Poisson1DSnapshotWriter *w, int *written, int *stalls){
+  if (w == NULL) {return;}
+  pthread_mutex_lock(&w->lock);
+  w->stop = 1;
+  pthread_cond_signal(&w->not_empty);
+  pthread_mutex_unlock(&w->lock);
+  pthread_join(w->thread, NULL);
+  if (written != NULL) {*written = w->written;}
+  if (stalls != NULL) {*stalls = w->stalls;}
+  pthread_mutex_destroy(&w->lock);
+  pthread_cond_destroy(&w->not_empty);
+  pthread_cond_destroy(&w->not_full);
+  free(w->prefix);
+  free(w->buf);
+  free(w->steps);
+  free(w);
+}
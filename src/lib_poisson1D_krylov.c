@@ -0,0 +1,245 @@
+/**********************************************/
+/* lib_poisson1D_krylov.c                     */
+/* Krylov (Conjugate Gradient) and Chebyshev  */
+/* solvers for the SPD 1D Poisson operator    */
+/**********************************************/
+#include "lib_poisson1D.h"
+#include <string.h>
+
+/* Operator descriptors handed to the matvec callbacks */
+typedef struct {
+  double *AB;
+  poisson1D_int *lab, *la, *ku, *kl;
+} GBOperator;
+
+static void matvec_GB(void *op, double *x, double *y){
+  GBOperator *A = (GBOperator *) op;
+  cblas_dgbmv(CblasColMajor, CblasNoTrans, *A->la, *A->la, *A->kl, *A->ku, 1.0, A->AB, *A->lab, x, 1, 0.0, y, 1);
+}
+
+static void matvec_CSR(void *op, double *x, double *y){
+  dcsrmv((CSRMatrix *) op, x, y);
+}
+
+static void matvec_CSC(void *op, double *x, double *y){
+  dcscmv((CSCMatrix *) op, x, y);
+}
+
+/* Inverse of the diagonal entries of a CSR/CSC matrix (ptr/ind are row_ptr/col_ind or col_ptr/row_ind),
+   into Dinv or a new array */
+static double *diag_inv_compressed(poisson1D_int n, poisson1D_int *ptr, poisson1D_int *ind, double *values, double *Dinv){
+  if (Dinv == NULL) {Dinv = (double *) malloc((size_t)n * sizeof(double));}
+  for (poisson1D_int i = 0; i < n; i++) {
+    Dinv[i] = 1.0;
+    for (poisson1D_int j = ptr[i]; j < ptr[i+1]; j++) {
+      if (ind[j] == i) {Dinv[i] = 1.0 / values[j];}
+    }
+  }
+  return Dinv;
+}
+
+/* Inverse of the diagonal stored in MB (row ku, as in richardson_MB), into Dinv or a new array */
+static double *diag_inv_MB(double *MB, poisson1D_int *lab, poisson1D_int *la, poisson1D_int *ku, double *Dinv){
+  if (Dinv == NULL) {Dinv = (double *) malloc((size_t)(*la) * sizeof(double));}
+  for (poisson1D_int i = 0; i < *la; i++) {Dinv[i] = 1.0 / MB[i * (*lab) + (*ku)];}
+  return Dinv;
+}
+
+void conjugate_gradient_op(Poisson1DMatvec matvec, void *op, double *Dinv, double *RHS, double *X, poisson1D_int *la, double *tol, int *maxit, double *resvec, int *nbite){
+  int method = POISSON1D_WS_CG;
+  Poisson1DWorkspace *ws = poisson1D_workspace_create(&method, la);
+  conjugate_gradient_op_ws(matvec, op, Dinv, RHS, X, la, tol, maxit, resvec, nbite, ws);
+  poisson1D_workspace_destroy(ws);
+}
+
+void conjugate_gradient_op_ws(Poisson1DMatvec matvec, void *op, double *Dinv, double *RHS, double *X, poisson1D_int *la, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws){
+  poisson1D_int n = *la;
+  double *r = poisson1D_workspace_get(ws, 4 * (size_t)n);
+  *nbite = 0;
+  if (r == NULL) {return;}
+  poisson1D_timing_begin(POISSON1D_PHASE_ITER);
+  double *p = r + n;
+  double *q = r + 2 * (size_t)n;
+  double *z = (Dinv != NULL) ? r + 3 * (size_t)n : r; // z = M^{-1} r
+
+  double norm_b = cblas_dnrm2(n, RHS, 1);
+  if (norm_b == 0.0) {norm_b = 1.0;}
+
+  // r = b - A * x, z = M^{-1} r, p = z
+  matvec(op, X, q);
+  cblas_dcopy(n, RHS, 1, r, 1);
+  cblas_daxpy(n, -1.0, q, 1, r, 1);
+  if (Dinv != NULL) {for (poisson1D_int i = 0; i < n; i++) {z[i] = Dinv[i] * r[i];}}
+  cblas_dcopy(n, z, 1, p, 1);
+  double rz = cblas_ddot(n, r, 1, z, 1);
+
+  for (*nbite = 0; *nbite < *maxit; (*nbite)++) {
+    double norm_r = cblas_dnrm2(n, r, 1);
+    resvec[*nbite] = norm_r / norm_b;
+    poisson1D_timing_iteration(*nbite);
+    if (resvec[*nbite] < *tol) break;
+
+    // q = A * p, step length alpha = (r, z) / (p, A p)
+    matvec(op, p, q);
+    double pq = cblas_ddot(n, p, 1, q, 1);
+    if (pq == 0.0) break; // breakdown (A not SPD or exact solution)
+    double alpha = rz / pq;
+    cblas_daxpy(n, alpha, p, 1, X, 1);
+    cblas_daxpy(n, -alpha, q, 1, r, 1);
+
+    // New search direction p = z + beta * p
+    if (Dinv != NULL) {for (poisson1D_int i = 0; i < n; i++) {z[i] = Dinv[i] * r[i];}}
+    double rz_new = cblas_ddot(n, r, 1, z, 1);
+    double beta = rz_new / rz;
+    rz = rz_new;
+    cblas_dscal(n, beta, p, 1);
+    cblas_daxpy(n, 1.0, z, 1, p, 1);
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_ITER);
+}
+
+void conjugate_gradient(double *AB, double *RHS, double *X, double *MB, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *tol, int *maxit, double *resvec, int *nbite){
+  GBOperator A = {AB, lab, la, ku, kl};
+  // Jacobi preconditioner: inverse of the diagonal stored in MB
+  double *Dinv = (MB != NULL) ? diag_inv_MB(MB, lab, la, ku, NULL) : NULL;
+  conjugate_gradient_op(matvec_GB, &A, Dinv, RHS, X, la, tol, maxit, resvec, nbite);
+  free(Dinv);
+}
+
+void conjugate_gradient_ws(double *AB, double *RHS, double *X, double *MB, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws){
+  GBOperator A = {AB, lab, la, ku, kl};
+  poisson1D_int n = *la;
+  *nbite = 0;
+  if (poisson1D_workspace_get(ws, 5 * (size_t)n) == NULL) {return;}
+  // The Jacobi diagonal lives after the 4 vectors of the engine
+  Poisson1DWorkspace engine = {ws->work, 4 * (size_t)n};
+  double *Dinv = (MB != NULL) ? diag_inv_MB(MB, lab, la, ku, ws->work + 4 * (size_t)n) : NULL;
+  conjugate_gradient_op_ws(matvec_GB, &A, Dinv, RHS, X, la, tol, maxit, resvec, nbite, &engine);
+}
+
+void conjugate_gradient_csr(CSRMatrix *mat, double *RHS, double *X, int *jacobi, double *tol, int *maxit, double *resvec, int *nbite){
+  // Jacobi preconditioner: inverse of the diagonal entries of each row
+  double *Dinv = (*jacobi) ? diag_inv_compressed(mat->n, mat->row_ptr, mat->col_ind, mat->values, NULL) : NULL;
+  conjugate_gradient_op(matvec_CSR, mat, Dinv, RHS, X, &mat->n, tol, maxit, resvec, nbite);
+  free(Dinv);
+}
+
+void conjugate_gradient_csr_ws(CSRMatrix *mat, double *RHS, double *X, int *jacobi, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws){
+  poisson1D_int n = mat->n;
+  *nbite = 0;
+  if (poisson1D_workspace_get(ws, 5 * (size_t)n) == NULL) {return;}
+  Poisson1DWorkspace engine = {ws->work, 4 * (size_t)n};
+  double *Dinv = (*jacobi) ? diag_inv_compressed(n, mat->row_ptr, mat->col_ind, mat->values, ws->work + 4 * (size_t)n) : NULL;
+  conjugate_gradient_op_ws(matvec_CSR, mat, Dinv, RHS, X, &n, tol, maxit, resvec, nbite, &engine);
+}
+
+void conjugate_gradient_stencil(double *RHS, double *X, poisson1D_int *la, double *tol, int *maxit, double *resvec, int *nbite){
+  // Constant diagonal: Jacobi preconditioning would only rescale, plain CG is the same method
+  StencilOperator A;
+  set_stencil_operator_poisson1D(&A, la);
+  conjugate_gradient_op(matvec_stencil_op, &A, NULL, RHS, X, la, tol, maxit, resvec, nbite);
+}
+
+void chebyshev_op(Poisson1DMatvec matvec, void *op, double *Dinv, double *eigmin, double *eigmax, int *check, double *RHS, double *X, poisson1D_int *la, double *tol, int *maxit, double *resvec, int *nbite){
+  int method = POISSON1D_WS_CHEBYSHEV;
+  Poisson1DWorkspace *ws = poisson1D_workspace_create(&method, la);
+  chebyshev_op_ws(matvec, op, Dinv, eigmin, eigmax, check, RHS, X, la, tol, maxit, resvec, nbite, ws);
+  poisson1D_workspace_destroy(ws);
+}
+
+void chebyshev_op_ws(Poisson1DMatvec matvec, void *op, double *Dinv, double *eigmin, double *eigmax, int *check, double *RHS, double *X, poisson1D_int *la, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws){
+  poisson1D_int n = *la;
+  int period = (*check > 0) ? *check : 1;
+  double *r = poisson1D_workspace_get(ws, 3 * (size_t)n);
+  *nbite = 0;
+  if (r == NULL) {return;}
+  poisson1D_timing_begin(POISSON1D_PHASE_ITER);
+  double *d = r + n;
+  double *q = r + 2 * (size_t)n;
+
+  // Spectrum of M^{-1} A in [theta - delta, theta + delta]
+  double theta = 0.5 * (*eigmax + *eigmin);
+  double delta = 0.5 * (*eigmax - *eigmin);
+  double sigma = theta / delta;
+  double rho = 1.0 / sigma;
+
+  double norm_b = cblas_dnrm2(n, RHS, 1);
+  if (norm_b == 0.0) {norm_b = 1.0;}
+
+  // r = b - A * x, d = M^{-1} r / theta
+  matvec(op, X, q);
+  for (poisson1D_int i = 0; i < n; i++) {
+    r[i] = RHS[i] - q[i];
+    d[i] = ((Dinv != NULL) ? Dinv[i] * r[i] : r[i]) / theta;
+  }
+
+  double last = 0.0;
+  for (*nbite = 0; *nbite < *maxit; (*nbite)++) {
+    // The residual norm is the only reduction: measured every 'check' iterations
+    if (*nbite % period == 0) {last = cblas_dnrm2(n, r, 1) / norm_b;}
+    resvec[*nbite] = last;
+    poisson1D_timing_iteration(*nbite);
+    if (*nbite % period == 0 && last < *tol) break;
+
+    // x = x + d, r = r - A d, d = rho_new rho d + (2 rho_new / delta) M^{-1} r
+    matvec(op, d, q);
+    double rho_new = 1.0 / (2.0 * sigma - rho);
+    double c1 = rho_new * rho, c2 = 2.0 * rho_new / delta;
+    for (poisson1D_int i = 0; i < n; i++) {
+      X[i] += d[i];
+      r[i] -= q[i];
+      d[i] = c1 * d[i] + c2 * ((Dinv != NULL) ? Dinv[i] * r[i] : r[i]);
+    }
+    rho = rho_new;
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_ITER);
+}
+
+void chebyshev(double *AB, double *RHS, double *X, double *MB, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *eigmin, double *eigmax, int *check, double *tol, int *maxit, double *resvec, int *nbite){
+  GBOperator A = {AB, lab, la, ku, kl};
+  double *Dinv = (MB != NULL) ? diag_inv_MB(MB, lab, la, ku, NULL) : NULL;
+  chebyshev_op(matvec_GB, &A, Dinv, eigmin, eigmax, check, RHS, X, la, tol, maxit, resvec, nbite);
+  free(Dinv);
+}
+
+void chebyshev_ws(double *AB, double *RHS, double *X, double *MB, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *eigmin, double *eigmax, int *check, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws){
+  GBOperator A = {AB, lab, la, ku, kl};
+  poisson1D_int n = *la;
+  *nbite = 0;
+  if (poisson1D_workspace_get(ws, 4 * (size_t)n) == NULL) {return;}
+  // The Jacobi diagonal lives after the 3 vectors of the engine
+  Poisson1DWorkspace engine = {ws->work, 3 * (size_t)n};
+  double *Dinv = (MB != NULL) ? diag_inv_MB(MB, lab, la, ku, ws->work + 3 * (size_t)n) : NULL;
+  chebyshev_op_ws(matvec_GB, &A, Dinv, eigmin, eigmax, check, RHS, X, la, tol, maxit, resvec, nbite, &engine);
+}
+
+void chebyshev_csr(CSRMatrix *mat, double *RHS, double *X, int *jacobi, double *eigmin, double *eigmax, int *check, double *tol, int *maxit, double *resvec, int *nbite){
+  double *Dinv = (*jacobi) ? diag_inv_compressed(mat->n, mat->row_ptr, mat->col_ind, mat->values, NULL) : NULL;
+  chebyshev_op(matvec_CSR, mat, Dinv, eigmin, eigmax, check, RHS, X, &mat->n, tol, maxit, resvec, nbite);
+  free(Dinv);
+}
+
+void chebyshev_csr_ws(CSRMatrix *mat, double *RHS, double *X, int *jacobi, double *eigmin, double *eigmax, int *check, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws){
+  poisson1D_int n = mat->n;
+  *nbite = 0;
+  if (poisson1D_workspace_get(ws, 4 * (size_t)n) == NULL) {return;}
+  Poisson1DWorkspace engine = {ws->work, 3 * (size_t)n};
+  double *Dinv = (*jacobi) ? diag_inv_compressed(n, mat->row_ptr, mat->col_ind, mat->values, ws->work + 3 * (size_t)n) : NULL;
+  chebyshev_op_ws(matvec_CSR, mat, Dinv, eigmin, eigmax, check, RHS, X, &n, tol, maxit, resvec, nbite, &engine);
+}
+
+void chebyshev_csc(CSCMatrix *mat, double *RHS, double *X, int *jacobi, double *eigmin, double *eigmax, int *check, double *tol, int *maxit, double *resvec, int *nbite){
+  // The diagonal entry of column j is A_jj as well
+  double *Dinv = (*jacobi) ? diag_inv_compressed(mat->n, mat->col_ptr, mat->row_ind, mat->values, NULL) : NULL;
+  chebyshev_op(matvec_CSC, mat, Dinv, eigmin, eigmax, check, RHS, X, &mat->n, tol, maxit, resvec, nbite);
+  free(Dinv);
+}
+
+void chebyshev_csc_ws(CSCMatrix *mat, double *RHS, double *X, int *jacobi, double *eigmin, double *eigmax, int *check, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws){
+  poisson1D_int n = mat->n;
+  *nbite = 0;
+  if (poisson1D_workspace_get(ws, 4 * (size_t)n) == NULL) {return;}
+  Poisson1DWorkspace engine = {ws->work, 3 * (size_t)n};
+  double *Dinv = (*jacobi) ? diag_inv_compressed(n, mat->col_ptr, mat->row_ind, mat->values, ws->work + 3 * (size_t)n) : NULL;
+  chebyshev_op_ws(matvec_CSC, mat, Dinv, eigmin, eigmax, check, RHS, X, &n, tol, maxit, resvec, nbite, &engine);
+}
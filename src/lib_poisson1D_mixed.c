@@ -0,0 +1,136 @@
+/**********************************************/
+/* lib_poisson1D_mixed.c                      */
+/* Mixed-precision direct solve: single-      */
+/* precision LU, double-precision iterative   */
+/* refinement                                 */
+/**********************************************/
+#include "lib_poisson1D.h"
+#include <string.h>
+
+poisson1D_int sgbtrftridiag(poisson1D_int *la, poisson1D_int *n, poisson1D_int *kl, poisson1D_int *ku, float *AB, poisson1D_int *lab, poisson1D_int *ipiv, poisson1D_int *info){
+  *info = 0;
+  if (*n <= 0) {return *info;}
+  // Initialize pivot indices (identity permutation, no pivoting implemented)
+  for (poisson1D_int i = 0; i < *n; i++) {ipiv[i] = i + 1;}
+  for (poisson1D_int j = 0; j < *n - 1; j++) {
+    float pivot = AB[indexABCol(*kl + *ku, j, lab)];
+    if (pivot == 0.0f) {
+      *info = j + 1; // Singular matrix
+      return *info;
+    }
+    float factor = AB[indexABCol(*ku + 2 * (*kl), j, lab)] / pivot;
+    AB[indexABCol(*ku + 2 * (*kl), j, lab)] = factor; // Store L part in place
+    AB[indexABCol(*kl + *ku, j + 1, lab)] -= factor * AB[indexABCol(*kl, j + 1, lab)];
+  }
+  if (AB[indexABCol(*kl + *ku, *n - 1, lab)] == 0.0f) {
+    *info = *n;
+  }
+  return *info;
+}
+
+/* Factor a copy of AB in double and solve: fallback when the refinement does not converge */
+static poisson1D_int solve_double(int *kind, poisson1D_int *la, poisson1D_int *kl, poisson1D_int *ku, poisson1D_int *nrhs, double *AB, poisson1D_int *lab, double *B, poisson1D_int *ldb, poisson1D_int *ipiv, poisson1D_int *info){
+  double *LU = (double *) malloc(sizeof(double) * (size_t)(*lab) * (*la));
+  if (LU == NULL) {*info = -1; return *info;}
+  memcpy(LU, AB, sizeof(double) * (size_t)(*lab) * (*la));
+  if (*kind == POISSON1D_MIXED_TRI) {
+    dgbtrftridiag(la, la, kl, ku, LU, lab, ipiv, info);
+  } else {
+    dgbtrf_(la, la, kl, ku, LU, lab, ipiv, info);
+  }
+  if (*info == 0) {dgbtrs_("N", la, kl, ku, nrhs, LU, lab, ipiv, B, ldb, info);}
+  free(LU);
+  return *info;
+}
+
+poisson1D_int dgbsv_mixed(int *kind, poisson1D_int *la, poisson1D_int *kl, poisson1D_int *ku, poisson1D_int *nrhs, double *AB, poisson1D_int *lab, double *B, poisson1D_int *ldb, double *tol, int *maxref, int *iter, poisson1D_int *info){
+  poisson1D_int n = *la, one = 1;
+  size_t nab = (size_t)(*lab) * n;
+  double eps = (*tol > 0.0) ? *tol : DBL_EPSILON;
+  *info = 0;
+  *iter = 0;
+  if (n <= 0) {return *info;}
+
+  // Operator rows of AB start after the kl rows reserved for the fill-in
+  double *A = AB + *kl;
+  float *ABs = (float *) malloc(sizeof(float) * nab);
+  float *rs = (float *) malloc(sizeof(float) * n);
+  double *x = (double *) malloc(sizeof(double) * n);
+  double *r = (double *) malloc(sizeof(double) * n);
+  poisson1D_int *ipiv = (poisson1D_int *) malloc(sizeof(poisson1D_int) * n);
+  if (ABs == NULL || rs == NULL || x == NULL || r == NULL || ipiv == NULL) {
+    free(ABs); free(rs); free(x); free(r); free(ipiv);
+    *info = -1;
+    return *info;
+  }
+  poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+
+  // Single-precision factorization: half the bytes of the double band
+  for (size_t k = 0; k < nab; k++) {ABs[k] = (float) AB[k];}
+  if (*kind == POISSON1D_MIXED_TRI) {
+    sgbtrftridiag(la, la, kl, ku, ABs, lab, ipiv, info);
+  } else {
+    sgbtrf_(la, la, kl, ku, ABs, lab, ipiv, info);
+  }
+
+  // ||A||_inf (row sums of the band), r is used as scratch
+  for (poisson1D_int i = 0; i < n; i++) {r[i] = 0.0;}
+  for (poisson1D_int jc = 0; jc < n; jc++) {
+    for (poisson1D_int i = (jc - *ku > 0 ? jc - *ku : 0); i <= jc + *kl && i < n; i++) {
+      r[i] += fabs(A[(size_t)jc * (*lab) + *ku + i - jc]);
+    }
+  }
+  double anrm = r[cblas_idamax(n, r, 1)];
+  double cte = anrm * DBL_EPSILON * sqrt((double) n);
+
+  int k = 0, converged = (*info == 0);
+  for (k = 0; k < *nrhs && converged; k++) {
+    double *b = B + (size_t)k * (*ldb);
+    // x0 = A^{-1} b with the single-precision factors
+    for (poisson1D_int i = 0; i < n; i++) {rs[i] = (float) b[i];}
+    sgbtrs_("N", la, kl, ku, &one, ABs, lab, ipiv, rs, la, info);
+    for (poisson1D_int i = 0; i < n; i++) {x[i] = (double) rs[i];}
+    converged = 0;
+    double dxprev = 0.0;
+    for (int step = 1; step <= *maxref; step++) {
+      // r = b - A x in double precision
+      cblas_dcopy(n, b, 1, r, 1);
+      cblas_dgbmv(CblasColMajor, CblasNoTrans, n, n, *kl, *ku, -1.0, A, *lab, x, 1, 1.0, r, 1);
+      double xnrm = fabs(x[cblas_idamax(n, x, 1)]);
+      int backward = (fabs(r[cblas_idamax(n, r, 1)]) <= xnrm * cte);
+      // dx = A^{-1} r in single precision, x = x + dx in double precision
+      for (poisson1D_int i = 0; i < n; i++) {rs[i] = (float) r[i];}
+      sgbtrs_("N", la, kl, ku, &one, ABs, lab, ipiv, rs, la, info);
+      for (poisson1D_int i = 0; i < n; i++) {x[i] += (double) rs[i];}
+      double dxnrm = fabs((double) rs[cblas_isamax(n, rs, 1)]);
+      if (step > *iter) {*iter = step;}
+      if (!isfinite(dxnrm)) break;
+      if (dxnrm <= eps * xnrm) {
+        converged = 1;
+        break;
+      }
+      if (step > 1) {
+        double rho = dxnrm / dxprev;
+        // Backward stable and corrections no longer shrinking: x is at the limiting accuracy
+        if (backward && rho >= 0.5) {
+          converged = 1;
+          break;
+        }
+        // Contraction too slow to reach tol within maxref steps
+        if (rho >= 1.0 || step + log(eps * xnrm / dxnrm) / log(rho) > *maxref) break;
+      }
+      dxprev = dxnrm;
+    }
+    if (converged) {cblas_dcopy(n, x, 1, b, 1);}
+  }
+
+  // Right-hand sides k-1 .. nrhs-1 still hold b: solve them in double precision
+  if (!converged) {
+    poisson1D_int first = (k > 0) ? k - 1 : 0, rest = *nrhs - first;
+    *iter = -(*iter + 1);
+    solve_double(kind, la, kl, ku, &rest, AB, lab, B + (size_t)first * (*ldb), ldb, ipiv, info);
+  }
+  free(ABs); free(rs); free(x); free(r); free(ipiv);
+  poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+  return *info;
+}
@@ -0,0 +1,314 @@
+/**********************************************/
+/* lib_poisson1D_mpi.c                        */
+/* Distributed-memory 1D Poisson: block       */
+/* decomposition, halo exchange, iterative    */
+/* solvers and partitioned direct solve       */
+/**********************************************/
+#include "lib_poisson1D_mpi.h"
+#include <string.h>
+
+int poisson1D_dist_create(Poisson1DDist *dist, MPI_Comm comm, poisson1D_int *la){
+  memset(dist, 0, sizeof(*dist));
+  dist->comm = comm;
+  MPI_Comm_rank(comm, &dist->rank);
+  MPI_Comm_size(comm, &dist->size);
+  int p = dist->rank, P = dist->size;
+  dist->la = *la;
+  dist->offset = (poisson1D_int)(((int64_t)(*la) * p) / P);
+  dist->n = (poisson1D_int)(((int64_t)(*la) * (p + 1)) / P) - dist->offset;
+  dist->left = (p > 0) ? p - 1 : MPI_PROC_NULL;
+  dist->right = (p < P - 1) ? p + 1 : MPI_PROC_NULL;
+  dist->cl = (p > 0) ? -1.0 : 0.0;
+  dist->cr = (p < P - 1) ? -1.0 : 0.0;
+  return (*la >= P && (*la + P - 1) / P <= INT_MAX) ? 0 : -1;
+}
+
+void set_grid_points_1D_dist(double *x, Poisson1DDist *dist){
+  double h = 1.0 / (double) (dist->la + 1);
+  for (poisson1D_int i = 0; i < dist->n; i++) {x[i] = (dist->offset + i + 1) * h;}
+}
+
+void set_GB_operator_colMajor_poisson1D_dist(double *AB, poisson1D_int *lab, poisson1D_int *kv, Poisson1DDist *dist){
+  // The diagonal block of a contiguous slice is the Poisson operator of the slice size
+  set_GB_operator_colMajor_poisson1D(AB, lab, &dist->n, kv);
+}
+
+void set_tridiag_operator_poisson1D_dist(double *dl, double *d, double *du, Poisson1DDist *dist){
+  poisson1D_int n = dist->n;
+  for (poisson1D_int i = 0; i < n; i++) {
+    dl[i] = -1.0;
+    d[i] = 2.0;
+    du[i] = -1.0;
+  }
+  dl[0] = dist->cl;
+  du[n - 1] = dist->cr;
+}
+
+void set_dense_RHS_DBC_1D_dist(double *RHS, Poisson1DDist *dist, double *BC0, double *BC1){
+  memset(RHS, 0, (size_t)dist->n * sizeof(double));
+  if (dist->rank == 0) {RHS[0] += (*BC0);}
+  if (dist->rank == dist->size - 1) {RHS[dist->n - 1] += (*BC1);}
+}
+
+/* Post the receives of the ghosts and the sends of the end values; ghost is zeroed first so
+   that MPI_PROC_NULL neighbours (physical boundaries) leave 0 */
+static void halo_start(double *x, double *ghost, Poisson1DDist *dist, MPI_Request *req){
+  ghost[0] = 0.0;
+  ghost[1] = 0.0;
+  MPI_Irecv(&ghost[0], 1, MPI_DOUBLE, dist->left, 0, dist->comm, &req[0]);
+  MPI_Irecv(&ghost[1], 1, MPI_DOUBLE, dist->right, 1, dist->comm, &req[1]);
+  MPI_Isend(&x[dist->n - 1], 1, MPI_DOUBLE, dist->right, 0, dist->comm, &req[2]);
+  MPI_Isend(&x[0], 1, MPI_DOUBLE, dist->left, 1, dist->comm, &req[3]);
+}
+
+void poisson1D_dist_halo_exchange(double *x, double *ghost, Poisson1DDist *dist){
+  MPI_Request req[4];
+  halo_start(x, ghost, dist, req);
+  MPI_Waitall(4, req, MPI_STATUSES_IGNORE);
+}
+
+void dgbmv_dist(double *AB, double *x, double *y, poisson1D_int *ku, poisson1D_int *kl, Poisson1DDist *dist){
+  MPI_Request req[4];
+  double ghost[2];
+  poisson1D_int n = dist->n;
+  halo_start(x, ghost, dist, req);
+  // Interior contribution while the end values are in flight
+  cblas_dgbmv(CblasColMajor, CblasNoTrans, n, n, *kl, *ku, 1.0, AB, *kl + *ku + 1, x, 1, 0.0, y, 1);
+  MPI_Waitall(4, req, MPI_STATUSES_IGNORE);
+  y[0] += dist->cl * ghost[0];
+  y[n - 1] += dist->cr * ghost[1];
+}
+
+double ddot_dist(double *x, double *y, Poisson1DDist *dist){
+  double loc = cblas_ddot(dist->n, x, 1, y, 1);
+  double glob;
+  MPI_Allreduce(&loc, &glob, 1, MPI_DOUBLE, MPI_SUM, dist->comm);
+  return glob;
+}
+
+void richardson_dist(double *AB, double *RHS, double *X, double *MB, double *alpha, poisson1D_int *lab, poisson1D_int *ku, poisson1D_int *kl, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DDist *dist){
+  poisson1D_int n = dist->n;
+  double *r = (double *) malloc(sizeof(double) * (size_t)n);
+  *nbite = 0;
+  if (r == NULL) {return;}
+  poisson1D_timing_begin(POISSON1D_PHASE_ITER);
+  double norm_b = sqrt(ddot_dist(RHS, RHS, dist));
+  if (norm_b == 0.0) {norm_b = 1.0;}
+  for (*nbite = 0; *nbite < *maxit; (*nbite)++) {
+    // r = b - A * x
+    dgbmv_dist(AB, X, r, ku, kl, dist);
+    for (poisson1D_int i = 0; i < n; i++) {r[i] = RHS[i] - r[i];}
+    resvec[*nbite] = sqrt(ddot_dist(r, r, dist)) / norm_b;
+    poisson1D_timing_iteration(*nbite);
+    if (resvec[*nbite] < *tol) break;
+    // x = x + alpha * r, or x = x + D^{-1} r
+    if (MB == NULL) {
+      cblas_daxpy(n, *alpha, r, 1, X, 1);
+    } else {
+      for (poisson1D_int i = 0; i < n; i++) {X[i] += r[i] / MB[i * (*lab) + (*ku)];}
+    }
+  }
+  free(r);
+  poisson1D_timing_end(POISSON1D_PHASE_ITER);
+}
+
+void conjugate_gradient_dist(double *AB, double *RHS, double *X, double *MB, poisson1D_int *lab, poisson1D_int *ku, poisson1D_int *kl, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DDist *dist){
+  poisson1D_int n = dist->n;
+  double *r = (double *) malloc(sizeof(double) * 4 * (size_t)n);
+  *nbite = 0;
+  if (r == NULL) {return;}
+  poisson1D_timing_begin(POISSON1D_PHASE_ITER);
+  double *p = r + n;
+  double *q = r + 2 * (size_t)n;
+  double *z = (MB != NULL) ? r + 3 * (size_t)n : r; // z = M^{-1} r
+  double loc[2], glob[2];
+
+  double norm_b = sqrt(ddot_dist(RHS, RHS, dist));
+  if (norm_b == 0.0) {norm_b = 1.0;}
+
+  // r = b - A * x, z = M^{-1} r, p = z
+  dgbmv_dist(AB, X, q, ku, kl, dist);
+  for (poisson1D_int i = 0; i < n; i++) {r[i] = RHS[i] - q[i];}
+  if (MB != NULL) {for (poisson1D_int i = 0; i < n; i++) {z[i] = r[i] / MB[i * (*lab) + (*ku)];}}
+  cblas_dcopy(n, z, 1, p, 1);
+  // (r, r) and (r, z) share one reduction
+  loc[0] = cblas_ddot(n, r, 1, r, 1);
+  loc[1] = cblas_ddot(n, r, 1, z, 1);
+  MPI_Allreduce(loc, glob, 2, MPI_DOUBLE, MPI_SUM, dist->comm);
+  double rr = glob[0], rz = glob[1];
+
+  for (*nbite = 0; *nbite < *maxit; (*nbite)++) {
+    resvec[*nbite] = sqrt(rr) / norm_b;
+    poisson1D_timing_iteration(*nbite);
+    if (resvec[*nbite] < *tol) break;
+
+    // q = A * p, step length alpha = (r, z) / (p, A p)
+    dgbmv_dist(AB, p, q, ku, kl, dist);
+    double pq = ddot_dist(p, q, dist);
+    if (pq == 0.0) break; // breakdown (A not SPD or exact solution)
+    double alpha = rz / pq;
+    cblas_daxpy(n, alpha, p, 1, X, 1);
+    cblas_daxpy(n, -alpha, q, 1, r, 1);
+
+    // New search direction p = z + beta * p
+    if (MB != NULL) {for (poisson1D_int i = 0; i < n; i++) {z[i] = r[i] / MB[i * (*lab) + (*ku)];}}
+    loc[0] = cblas_ddot(n, r, 1, r, 1);
+    loc[1] = cblas_ddot(n, r, 1, z, 1);
+    MPI_Allreduce(loc, glob, 2, MPI_DOUBLE, MPI_SUM, dist->comm);
+    double beta = glob[1] / rz;
+    rr = glob[0];
+    rz = glob[1];
+    cblas_dscal(n, beta, p, 1);
+    cblas_daxpy(n, 1.0, z, 1, p, 1);
+  }
+  free(r);
+  poisson1D_timing_end(POISSON1D_PHASE_ITER);
+}
+
+poisson1D_int dgtsvpartition_dist(double *dl, double *d, double *du, double *B, Poisson1DDist *dist, poisson1D_int *info){
+  poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+  *info = 0;
+  poisson1D_int n = dist->n;
+  int p = dist->rank, P = dist->size;
+  // Local block: y = A_p^{-1} f_p at both ends, and the end values of the spikes
+  // V = A_p^{-1} (a e_1) (coupling to the rank above) and W = A_p^{-1} (c e_m) (rank below)
+  double en[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+  double *work = (double *) malloc(sizeof(double) * (size_t)n);
+  poisson1D_int ldr = 7, kl = 2, ku = 2, nr = 2 * P, one = 1;
+  double *ends = (double *) malloc(sizeof(double) * 6 * (size_t)P);
+  double *R = (double *) calloc((size_t)ldr * nr, sizeof(double));
+  double *xr = (double *) malloc(sizeof(double) * nr);
+  poisson1D_int *ipiv = (poisson1D_int *) malloc(sizeof(poisson1D_int) * nr);
+  poisson1D_int bad = (work == NULL || ends == NULL || R == NULL || xr == NULL || ipiv == NULL) ? -1 : 0;
+
+  // Phase 1: LU of the block, same elimination as dgtsvpartition (dl[0] and du[n-1] untouched)
+  if (bad == 0) {
+    for (poisson1D_int i = 0; i < n - 1; i++) {
+      if (d[i] == 0.0) {bad = dist->offset + i + 1; break;}
+      double factor = dl[i + 1] / d[i];
+      dl[i + 1] = factor;
+      d[i + 1] -= factor * du[i];
+    }
+    if (bad == 0 && d[n - 1] == 0.0) {bad = dist->offset + n;}
+  }
+  if (bad == 0) {
+    // Forward substitution in place: B = L^{-1} f
+    for (poisson1D_int i = 1; i < n; i++) {B[i] -= dl[i] * B[i - 1];}
+    // End values of y (back substitution carried as a scalar)
+    double y = B[n - 1] / d[n - 1];
+    en[1] = y;
+    for (poisson1D_int i = n - 2; i >= 0; i--) {y = (B[i] - du[i] * y) / d[i];}
+    en[0] = y;
+    if (p > 0) {
+      work[0] = dl[0];
+      for (poisson1D_int i = 1; i < n; i++) {work[i] = -dl[i] * work[i - 1];}
+      work[n - 1] /= d[n - 1];
+      for (poisson1D_int i = n - 2; i >= 0; i--) {work[i] = (work[i] - du[i] * work[i + 1]) / d[i];}
+      en[2] = work[0];
+      en[3] = work[n - 1];
+    }
+    if (p < P - 1) {
+      double w = du[n - 1] / d[n - 1];
+      en[5] = w;
+      for (poisson1D_int i = n - 2; i >= 0; i--) {w = -du[i] * w / d[i];}
+      en[4] = w;
+    }
+  }
+  // Every rank must agree before the collective of phase 2 (an allocation failure wins)
+  poisson1D_int worst = 0;
+  int neg = (bad < 0), anyneg = 0;
+  MPI_Allreduce(&bad, &worst, 1, POISSON1D_MPI_INT, MPI_MAX, dist->comm);
+  MPI_Allreduce(&neg, &anyneg, 1, MPI_INT, MPI_MAX, dist->comm);
+  if (anyneg || worst != 0) {
+    *info = anyneg ? -1 : worst;
+    free(work); free(ends); free(R); free(xr); free(ipiv);
+    poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+    return *info;
+  }
+
+  // Phase 2: the 6 end values of every rank, then the reduced system solved redundantly
+  // (unknowns (top_q, bottom_q) at (2q, 2q+1), same band layout as dgtsvpartition)
+  MPI_Allgather(en, 6, MPI_DOUBLE, ends, 6, MPI_DOUBLE, dist->comm);
+  for (poisson1D_int q = 0; q < P; q++) {
+    double *eq = ends + 6 * (size_t)q;
+    poisson1D_int t = 2 * q, b = 2 * q + 1;
+    R[kl + ku + t * ldr] = 1.0;
+    R[kl + ku + b * ldr] = 1.0;
+    if (q > 0) {
+      R[kl + ku + t - (b - 2) + (b - 2) * ldr] = eq[2];
+      R[kl + ku + b - (b - 2) + (b - 2) * ldr] = eq[3];
+    }
+    if (q < P - 1) {
+      R[kl + ku + t - (t + 2) + (t + 2) * ldr] = eq[4];
+      R[kl + ku + b - (t + 2) + (t + 2) * ldr] = eq[5];
+    }
+    xr[t] = eq[0];
+    xr[b] = eq[1];
+  }
+  dgbsv_(&nr, &kl, &ku, &one, R, &ldr, ipiv, xr, &nr, info);
+
+  // Phase 3: local solve with the neighbours' end values moved to the right-hand side
+  if (*info == 0) {
+    if (p > 0) {
+      double corr = -dl[0] * xr[2 * p - 1];
+      B[0] += corr;
+      for (poisson1D_int i = 1; i < n; i++) {
+        corr = -dl[i] * corr;
+        B[i] += corr;
+      }
+    }
+    if (p < P - 1) {B[n - 1] -= du[n - 1] * xr[2 * p + 2];}
+    B[n - 1] /= d[n - 1];
+    for (poisson1D_int i = n - 2; i >= 0; i--) {B[i] = (B[i] - du[i] * B[i + 1]) / d[i];}
+  } else if (*info > 0) {
+    *info += dist->la;
+  }
+  free(work); free(ends); free(R); free(xr); free(ipiv);
+  poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+  return *info;
+}
+
+double relative_forward_error_dist(double *x, double *y, Poisson1DDist *dist){
+  double loc[2] = {0.0, 0.0}, glob[2];
+  for (poisson1D_int i = 0; i < dist->n; i++) {
+    double e = y[i] - x[i];
+    loc[0] += e * e;
+    loc[1] += x[i] * x[i];
+  }
+  MPI_Allreduce(loc, glob, 2, MPI_DOUBLE, MPI_SUM, dist->comm);
+  if (glob[1] == 0.0) {return (glob[0] == 0.0) ? 0.0 : DBL_MAX;}
+  return sqrt(glob[0] / glob[1]);
+}
+
+int write_vec_bin_dist(double *vec, Poisson1DDist *dist, char *filename){
+  poisson1D_timing_begin(POISSON1D_PHASE_WRITE);
+  MPI_File fh;
+  int err = MPI_File_open(dist->comm, filename, MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+  if (err != MPI_SUCCESS) {
+    if (dist->rank == 0) {fprintf(stderr, "%s: MPI_File_open failed\n", filename);}
+    poisson1D_timing_end(POISSON1D_PHASE_WRITE);
+    return -1;
+  }
+  // Drop the tail of a previous, longer file
+  int bad = (MPI_File_set_size(fh, POISSON1D_BIN_HEADER_SIZE + (MPI_Offset)sizeof(double) * dist->la) != MPI_SUCCESS);
+  if (dist->rank == 0) {
+    Poisson1DBinHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, POISSON1D_BIN_MAGIC, sizeof(hdr.magic));
+    hdr.version = POISSON1D_BIN_VERSION;
+    hdr.type = POISSON1D_BIN_VEC;
+    hdr.layout = POISSON1D_BIN_COLMAJOR;
+    hdr.elem_size = sizeof(double);
+    hdr.rows = dist->la;
+    hdr.cols = 1;
+    if (MPI_File_write_at(fh, 0, &hdr, sizeof(hdr), MPI_BYTE, MPI_STATUS_IGNORE) != MPI_SUCCESS) {bad = 1;}
+  }
+  MPI_Offset off = POISSON1D_BIN_HEADER_SIZE + (MPI_Offset)sizeof(double) * dist->offset;
+  if (MPI_File_write_at_all(fh, off, vec, (int) dist->n, MPI_DOUBLE, MPI_STATUS_IGNORE) != MPI_SUCCESS) {bad = 1;}
+  if (MPI_File_close(&fh) != MPI_SUCCESS) {bad = 1;}
+  int anybad = 0;
+  MPI_Allreduce(&bad, &anybad, 1, MPI_INT, MPI_MAX, dist->comm);
+  if (anybad && dist->rank == 0) {fprintf(stderr, "%s: MPI-IO write failed\n", filename);}
+  poisson1D_timing_end(POISSON1D_PHASE_WRITE);
+  return anybad ? -1 : 0;
+}
@@ -0,0 +1,243 @@
+/**********************************************/
+/* lib_poisson1D_multigrid.c                  */
+/* Geometric multigrid (V-cycle, FMG) for the */
+/* 1D Poisson problem                         */
+/**********************************************/
+#include "lib_poisson1D.h"
+#include <string.h>
+
+/*
+ * Coarse point j sits on fine point 2j+1, so a grid of la points has la / 2 coarse points. When la
+ * is odd the last coarse point is at distance 2h from the boundary and the grids are nested; when la
+ * is even the last coarse point is the last fine point and sits at distance h from the boundary.
+ * P is operator-dependent: a fine point i between two coarse points takes -A(i,i-1)/A(i,i) and
+ * -A(i,i+1)/A(i,i) of them (zero on the boundary), which is linear interpolation for
+ * tridiag(-1, 2, -1). The restriction is 2 P^T (four times full weighting on nested grids) and each
+ * coarse operator is the Galerkin product 2 P^T A P of the finer one: tridiag(-1, 2, -1) of
+ * set_GB_operator_colMajor_poisson1D again on nested grids, a different last row otherwise.
+ */
+
+/* A(i, k) of a level operator, zero outside the band */
+static double mg_entry(MGHierarchy *mg, MGLevel *lev, poisson1D_int i, poisson1D_int k){
+  if (i < 0 || k < 0 || i >= lev->la || k >= lev->la || i - k > 1 || k - i > 1) {return 0.0;}
+  return lev->AB[k * mg->lab + mg->ku + i - k];
+}
+
+/* Weight of coarse point j in the interpolated value at fine point i */
+static double mg_weight(MGHierarchy *mg, MGLevel *fine, poisson1D_int i, poisson1D_int j){
+  if (i < 0 || i >= fine->la) {return 0.0;}
+  if (i == 2 * j + 1) {return 1.0;}
+  if (i == 2 * j + 2 || i == 2 * j) {return -mg_entry(mg, fine, i, 2 * j + 1) / mg_entry(mg, fine, i, i);}
+  return 0.0;
+}
+
+/* b_c = 2 P^T r */
+static void mg_restrict(MGHierarchy *mg, MGLevel *fine, double *r, double *bc, poisson1D_int lac){
+  for (poisson1D_int j = 0; j < lac; j++) {
+    double v = mg_weight(mg, fine, 2 * j, j) * r[2 * j] + r[2 * j + 1];
+    if (2 * j + 2 < fine->la) {v += mg_weight(mg, fine, 2 * j + 2, j) * r[2 * j + 2];}
+    bc[j] = 2.0 * v;
+  }
+}
+
+/* x = x + P e_c (add = 1) or x = P e_c (add = 0) */
+static void mg_prolongate(MGHierarchy *mg, MGLevel *fine, double *ec, double *x, poisson1D_int lac, int add){
+  poisson1D_int laf = fine->la;
+  if (!add) {memset(x, 0, (size_t)laf * sizeof(double));}
+  for (poisson1D_int j = 0; j < lac; j++) {
+    x[2 * j + 1] += ec[j];
+    x[2 * j] += mg_weight(mg, fine, 2 * j, j) * ec[j];
+    if (2 * j + 2 < laf) {x[2 * j + 2] += mg_weight(mg, fine, 2 * j + 2, j) * ec[j];}
+  }
+}
+
+/* Coarse operator 2 P^T A P, built column by column from the three coarse neighbours */
+static void mg_galerkin(MGHierarchy *mg, MGLevel *fine, MGLevel *coarse){
+  poisson1D_int lac = coarse->la;
+  memset(coarse->AB, 0, (size_t)lac * mg->lab * sizeof(double));
+  for (poisson1D_int k = 0; k < lac; k++) {
+    for (poisson1D_int j = (k > 0) ? k - 1 : 0; j <= k + 1 && j < lac; j++) {
+      double s = 0.0;
+      for (poisson1D_int i = 2 * j; i <= 2 * j + 2; i++) {
+        double w = mg_weight(mg, fine, i, j);
+        for (poisson1D_int m = i - 1; w != 0.0 && m <= i + 1; m++) {s += w * mg_entry(mg, fine, i, m) * mg_weight(mg, fine, m, k);}
+      }
+      coarse->AB[k * mg->lab + mg->ku + j - k] = 2.0 * s;
+    }
+  }
+}
+
+/* r = b - A * x on level l */
+static void mg_residual(MGHierarchy *mg, MGLevel *lev){
+  cblas_dcopy(lev->la, lev->b, 1, lev->r, 1);
+  cblas_dgbmv(CblasColMajor, CblasNoTrans, lev->la, lev->la, mg->kl, mg->ku, -1.0, lev->AB, mg->lab, lev->x, 1, 1.0, lev->r, 1);
+}
+
+/* nu steps of x = x + M^{-1} (b - A x) with M from the extract_MB_* routines */
+static void mg_smooth(MGHierarchy *mg, MGLevel *lev, int nu){
+  poisson1D_int lab = mg->lab, ku = mg->ku;
+  for (poisson1D_int s = 0; s < nu; s++) {
+    mg_residual(mg, lev);
+    if (mg->smoother == MG_SMOOTHER_JACOBI) {
+      // Damped Jacobi: x = x + omega * D^{-1} r
+      for (poisson1D_int i = 0; i < lev->la; i++) {lev->x[i] += mg->omega * lev->r[i] / lev->MB[i * lab + ku];}
+    } else {
+      // Gauss-Seidel: forward substitution (D - E) z = r as in richardson_MB, z stored in r
+      for (poisson1D_int i = 0; i < lev->la; i++) {
+        double val = lev->r[i];
+        if (i > 0) {val -= lev->MB[(i - 1) * lab + (ku + 1)] * lev->r[i - 1];}
+        lev->r[i] = val / lev->MB[i * lab + ku];
+        lev->x[i] += lev->r[i];
+      }
+    }
+  }
+}
+
+/* Direct solve on the coarsest level with the dgbtrftridiag factors */
+static void mg_coarse_solve(MGHierarchy *mg, MGLevel *lev){
+  poisson1D_int kl = 1, ku = 1, one = 1, info;
+  cblas_dcopy(lev->la, lev->b, 1, lev->x, 1);
+  dgbtrs_("N", &lev->la, &kl, &ku, &one, mg->LU, &mg->lab_lu, mg->ipiv, lev->x, &lev->la, &info);
+}
+
+static void mg_vcycle(MGHierarchy *mg, int l){
+  MGLevel *lev = &mg->levels[l];
+  if (l == mg->nlevels - 1) {
+    mg_coarse_solve(mg, lev);
+    return;
+  }
+  MGLevel *coarse = &mg->levels[l + 1];
+  mg_smooth(mg, lev, mg->nu1);
+  mg_residual(mg, lev);
+  mg_restrict(mg, lev, lev->r, coarse->b, coarse->la);
+  memset(coarse->x, 0, (size_t)coarse->la * sizeof(double));
+  mg_vcycle(mg, l + 1);
+  mg_prolongate(mg, lev, coarse->x, lev->x, coarse->la, 1);
+  mg_smooth(mg, lev, mg->nu2);
+}
+
+MGHierarchy *mg_hierarchy_create(poisson1D_int *la, int *smoother, int *maxlevels){
+  MGHierarchy *mg = (MGHierarchy *) calloc(1, sizeof(MGHierarchy));
+  if (mg == NULL) {return NULL;}
+  poisson1D_timing_begin(POISSON1D_PHASE_PRECOND);
+  mg->smoother = *smoother;
+  mg->nu1 = 2;
+  mg->nu2 = 2;
+  mg->omega = 2.0 / 3.0;
+  mg->kv = 0;
+  mg->ku = 1;
+  mg->kl = 1;
+  mg->lab = mg->kv + mg->kl + mg->ku + 1;
+
+  // Coarsen h -> 2h down to the coarse size, odd or even
+  poisson1D_int n = *la;
+  int maxl = (*maxlevels > 0 && *maxlevels < MG_MAX_LEVELS) ? *maxlevels : MG_MAX_LEVELS;
+  mg->nlevels = 1;
+  mg->levels[0].la = n;
+  while (mg->nlevels < maxl && n >= MG_COARSE_SIZE) {
+    n = n / 2;
+    mg->levels[mg->nlevels++].la = n;
+  }
+
+  int ok = 1;
+  for (int l = 0; l < mg->nlevels; l++) {
+    MGLevel *lev = &mg->levels[l];
+    size_t sz = (size_t)lev->la * sizeof(double);
+    lev->AB = (double *) malloc(sz * mg->lab);
+    lev->MB = (double *) malloc(sz * mg->lab);
+    lev->r = (double *) malloc(sz);
+    if (l > 0) {
+      // Finest x and b are the caller's X and RHS
+      lev->x = (double *) malloc(sz);
+      lev->b = (double *) malloc(sz);
+      ok = ok && lev->x != NULL && lev->b != NULL;
+    }
+    if (lev->AB == NULL || lev->MB == NULL || lev->r == NULL) {ok = 0; break;}
+    if (l == 0) {
+      set_GB_operator_colMajor_poisson1D(lev->AB, &mg->lab, &lev->la, &mg->kv);
+    } else {
+      mg_galerkin(mg, &mg->levels[l - 1], lev);
+    }
+    if (mg->smoother == MG_SMOOTHER_JACOBI) {
+      extract_MB_jacobi_tridiag(lev->AB, lev->MB, &mg->lab, &lev->la, &mg->ku, &mg->kl, &mg->kv);
+    } else {
+      extract_MB_gauss_seidel_tridiag(lev->AB, lev->MB, &mg->lab, &lev->la, &mg->ku, &mg->kl, &mg->kv);
+    }
+  }
+
+  // Factorize the coarsest operator once (LU layout, kv = 1: AB shifted down one row)
+  if (ok) {
+    MGLevel *coarse = &mg->levels[mg->nlevels - 1];
+    poisson1D_int kv = 1, info;
+    mg->lab_lu = kv + mg->kl + mg->ku + 1;
+    mg->LU = (double *) malloc(sizeof(double) * mg->lab_lu * coarse->la);
+    mg->ipiv = (poisson1D_int *) malloc(sizeof(poisson1D_int) * coarse->la);
+    if (mg->LU == NULL || mg->ipiv == NULL) {
+      ok = 0;
+    } else {
+      memset(mg->LU, 0, sizeof(double) * mg->lab_lu * coarse->la);
+      for (poisson1D_int k = 0; k < coarse->la; k++) {
+        memcpy(mg->LU + k * mg->lab_lu + kv, coarse->AB + k * mg->lab, sizeof(double) * mg->lab);
+      }
+      dgbtrftridiag(&coarse->la, &coarse->la, &mg->kl, &mg->ku, mg->LU, &mg->lab_lu, mg->ipiv, &info);
+      ok = (info == 0);
+    }
+  }
+  if (!ok) {
+    mg_hierarchy_destroy(mg);
+    poisson1D_timing_end(POISSON1D_PHASE_PRECOND);
+    return NULL;
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_PRECOND);
+  return mg;
+}
+
+void mg_hierarchy_destroy(MGHierarchy *mg){
+  if (mg == NULL) {return;}
+  for (int l = 0; l < mg->nlevels; l++) {
+    free(mg->levels[l].AB);
+    free(mg->levels[l].MB);
+    free(mg->levels[l].r);
+    if (l > 0) {
+      free(mg->levels[l].x);
+      free(mg->levels[l].b);
+    }
+  }
+  free(mg->LU);
+  free(mg->ipiv);
+  free(mg);
+}
+
+void multigrid_solve(MGHierarchy *mg, double *RHS, double *X, int *fmg, double *tol, int *maxit, double *resvec, int *nbite){
+  poisson1D_timing_begin(POISSON1D_PHASE_ITER);
+  MGLevel *fine = &mg->levels[0];
+  fine->x = X;
+  fine->b = RHS;
+
+  if (*fmg) {
+    // Full multigrid: restrict the RHS to every level, solve on the coarsest, then
+    // interpolate each solution as initial guess of one V-cycle on the next finer level
+    for (int l = 0; l < mg->nlevels - 1; l++) {
+      mg_restrict(mg, &mg->levels[l], mg->levels[l].b, mg->levels[l + 1].b, mg->levels[l + 1].la);
+    }
+    mg_coarse_solve(mg, &mg->levels[mg->nlevels - 1]);
+    for (int l = mg->nlevels - 2; l >= 0; l--) {
+      mg_prolongate(mg, &mg->levels[l], mg->levels[l + 1].x, mg->levels[l].x, mg->levels[l + 1].la, 0);
+      mg_vcycle(mg, l);
+    }
+  }
+
+  double norm_b = cblas_dnrm2(fine->la, RHS, 1);
+  if (norm_b == 0.0) {norm_b = 1.0;}
+  for (*nbite = 0; *nbite < *maxit; (*nbite)++) {
+    mg_residual(mg, fine);
+    resvec[*nbite] = cblas_dnrm2(fine->la, fine->r, 1) / norm_b;
+    poisson1D_timing_iteration(*nbite);
+    if (resvec[*nbite] < *tol) break;
+    mg_vcycle(mg, 0);
+  }
+
+  fine->x = NULL;
+  fine->b = NULL;
+  poisson1D_timing_end(POISSON1D_PHASE_ITER);
+}
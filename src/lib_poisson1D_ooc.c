@@ -0,0 +1,245 @@
+/**********************************************/
+/* lib_poisson1D_ooc.c                        */
+/* Out-of-core Thomas solve: operator, RHS,   */
+/* factors and solution stay in memory-mapped */
+/* binary files, streamed by windows          */
+/**********************************************/
+#include "lib_poisson1D.h"
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* One column of doubles inside a mapped binary file */
+typedef struct {
+  double *x;    // first element of the column
+  char *base;   // start of the mapping
+  size_t len;   // length of the mapping
+  int fd;       // descriptor for posix_fadvise
+} OocStream;
+
+static size_t page_size(void){
+  return (size_t) sysconf(_SC_PAGESIZE);
+}
+
+static void stream_set(OocStream *s, Poisson1DBinFile *f, int fd, poisson1D_int col){
+  s->x = f->data + (size_t)col * (size_t)f->hdr.rows;
+  s->base = (char *) f->base;
+  s->len = f->len;
+  s->fd = fd;
+}
+
+/* Ask the kernel to read elements [i0, i1) ahead (pages rounded outwards) */
+static void stream_prefetch(OocStream *s, poisson1D_int i0, poisson1D_int i1){
+  if (s->x == NULL || i1 <= i0) return;
+  size_t pg = page_size();
+  size_t a = (size_t)((char *)(s->x + i0) - s->base) / pg * pg;
+  size_t b = (size_t)((char *)(s->x + i1) - s->base);
+  madvise(s->base + a, b - a, MADV_WILLNEED);
+}
+
+/* Unmap elements [i0, i1) from the process and drop them from the page cache. Written pages
+   are kept in the cache until posix_fadvise has started their writeback. Only the pages inside
+   the range are released: a page shared with the next window stays resident. */
+static void stream_release(OocStream *s, poisson1D_int i0, poisson1D_int i1){
+  if (s->x == NULL || i1 <= i0) return;
+  size_t pg = page_size();
+  size_t a = ((size_t)((char *)(s->x + i0) - s->base) + pg - 1) / pg * pg;
+  size_t b = (size_t)((char *)(s->x + i1) - s->base) / pg * pg;
+  if (b <= a) return;
+  madvise(s->base + a, b - a, MADV_DONTNEED);
+  posix_fadvise(s->fd, (off_t)a, (off_t)(b - a), POSIX_FADV_DONTNEED);
+}
+
+/* Map an input file read-only, plus a descriptor kept for the page cache hints */
+static int map_input(char *filename, int type, poisson1D_int cols, Poisson1DBinFile *f, int *fd){
+  *fd = -1;
+  if (poisson1D_bin_map(filename, f) != 0) return -1;
+  if (f->hdr.type != type || f->hdr.cols != cols || f->hdr.layout != POISSON1D_BIN_COLMAJOR
+      || f->hdr.rows > POISSON1D_INT_MAX){
+    fprintf(stderr, "%s: unexpected poisson1D binary file type\n", filename);
+    poisson1D_bin_unmap(f);
+    return -1;
+  }
+  *fd = open(filename, O_RDONLY);
+  if (*fd < 0){
+    perror(filename);
+    poisson1D_bin_unmap(f);
+    return -1;
+  }
+  return 0;
+}
+
+/* Create a POISSON1D_BIN_VEC file of n doubles and map it read-write */
+static int map_output(char *filename, poisson1D_int n, Poisson1DBinFile *f, int *fd){
+  memset(f, 0, sizeof(*f));
+  Poisson1DBinHeader *hdr = &f->hdr;
+  memcpy(hdr->magic, POISSON1D_BIN_MAGIC, sizeof(hdr->magic));
+  hdr->version = POISSON1D_BIN_VERSION;
+  hdr->type = POISSON1D_BIN_VEC;
+  hdr->layout = POISSON1D_BIN_COLMAJOR;
+  hdr->elem_size = sizeof(double);
+  hdr->rows = n;
+  hdr->cols = 1;
+  size_t len = sizeof(Poisson1DBinHeader) + (size_t)n * sizeof(double);
+  *fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (*fd < 0){
+    perror(filename);
+    return -1;
+  }
+  // Blocks reserved up front: a full disk fails here, not with SIGBUS in the middle of a pass
+  int err = (write(*fd, hdr, sizeof(*hdr)) != (ssize_t)sizeof(*hdr)) ? errno : posix_fallocate(*fd, 0, (off_t)len);
+  if (err != 0){
+    fprintf(stderr, "%s: %s\n", filename, strerror(err));
+    close(*fd);
+    *fd = -1;
+    return -1;
+  }
+  void *base = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, *fd, 0);
+  if (base == MAP_FAILED){
+    perror(filename);
+    close(*fd);
+    *fd = -1;
+    return -1;
+  }
+  f->base = base;
+  f->len = len;
+  f->data = (double *)((char *)base + sizeof(Poisson1DBinHeader));
+  return 0;
+}
+
+static void close_fd(int fd){
+  if (fd >= 0) close(fd);
+}
+
+/* Window length (elements) such that two windows of each of the nstreams streams fit in budget */
+static poisson1D_int window_size(size_t budget, int nstreams){
+  size_t per_page = page_size() / sizeof(double);
+  size_t w = budget / (2 * (size_t)nstreams * sizeof(double)) / per_page * per_page;
+  if (w < per_page) w = per_page;
+  if (w > (size_t)POISSON1D_INT_MAX) w = (size_t)POISSON1D_INT_MAX;
+  return (poisson1D_int) w;
+}
+
+/*
+ * Thomas on streamed columns. Row i reads a_i = A(i,i-1), b_i = A(i,i), c_i = A(i,i+1) from the
+ * streams, or the constants sub, diag, sup for a NULL stream. Forward pass (rows in increasing
+ * order): d'_i = b_i - a_i c'_{i-1}, c'_i = c_i / d'_i to the factor file, y_i = (r_i - a_i y_{i-1}) / d'_i
+ * to the solution file. Backward pass (decreasing order): x_i = y_i - c'_i x_{i+1} in place.
+ */
+static poisson1D_int thomas_ooc(OocStream *op, double *coef, OocStream *r, OocStream *x, OocStream *f,
+                                poisson1D_int n, size_t budget, poisson1D_int *info){
+  OocStream *fwd[] = {&op[0], &op[1], &op[2], r, x, f};
+  OocStream *bwd[] = {x, f};
+  int nfwd = (op[0].x != NULL) ? 6 : 3;
+  OocStream **in = (op[0].x != NULL) ? fwd : fwd + 3;
+  poisson1D_int w = window_size(budget, nfwd);
+  double cp = 0.0, y = 0.0;
+
+  for (int s = 0; s < nfwd; s++) {madvise(in[s]->base, in[s]->len, MADV_SEQUENTIAL);}
+  poisson1D_int i0;
+  for (i0 = 0; i0 < n; i0 += w) {
+    poisson1D_int i1 = (n - i0 > w) ? i0 + w : n;
+    poisson1D_int i2 = (n - i1 > w) ? i1 + w : n;
+    for (int s = 0; s < nfwd; s++) {stream_prefetch(in[s], i1, i2);}
+    for (poisson1D_int i = i0; i < i1; i++) {
+      double a = op[0].x ? op[0].x[i] : coef[0];
+      double b = op[1].x ? op[1].x[i] : coef[1];
+      double c = op[2].x ? op[2].x[i] : coef[2];
+      double d = b - a * cp;
+      if (d == 0.0) {
+        *info = i + 1;
+        return *info;
+      }
+      cp = c / d;
+      y = (r->x[i] - a * y) / d;
+      f->x[i] = cp;
+      x->x[i] = y;
+    }
+    // The outputs of the last window are where the backward pass starts: they stay resident
+    for (int s = 0; s < nfwd; s++) {
+      if (i1 < n || s < nfwd - 2) stream_release(in[s], i0, i1);
+    }
+  }
+
+  // Backward pass: the kernel readahead only goes forward, the windows are prefetched by hand
+  for (int s = 0; s < 2; s++) {madvise(bwd[s]->base, bwd[s]->len, MADV_RANDOM);}
+  double xn = 0.0;
+  poisson1D_int i1 = n;
+  for (i0 = (n > 0) ? (n - 1) / w * w : 0; i1 > 0; i0 -= w) {
+    poisson1D_int im = (i0 > w) ? i0 - w : 0;
+    for (int s = 0; s < 2; s++) {stream_prefetch(bwd[s], im, i0);}
+    for (poisson1D_int i = i1 - 1; i >= i0; i--) {
+      xn = x->x[i] - f->x[i] * xn;
+      x->x[i] = xn;
+    }
+    for (int s = 0; s < 2; s++) {stream_release(bwd[s], i0, i1);}
+    i1 = i0;
+  }
+  // Write errors of the pages dropped above surface here
+  if (fsync(x->fd) != 0) {*info = -1;}
+  return *info;
+}
+
+/* Shared driver: the operator comes from opfile, or from A when opfile is NULL */
+static poisson1D_int solve_ooc(StencilOperator *A, char *opfile, char *rhsfile, char *solfile, char *factorfile,
+                               size_t *budget, poisson1D_int *info){
+  Poisson1DBinFile fop, frhs, fsol, ffac;
+  int dop = -1, drhs = -1, dsol = -1, dfac = -1;
+  OocStream op[3], r, x, f;
+  double coef[3] = {0.0, 0.0, 0.0};
+  poisson1D_int n;
+
+  *info = -1;
+  memset(&fop, 0, sizeof(fop));
+  memset(&frhs, 0, sizeof(frhs));
+  memset(&fsol, 0, sizeof(fsol));
+  memset(&ffac, 0, sizeof(ffac));
+  memset(op, 0, sizeof(op));
+  poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+  if (opfile != NULL && map_input(opfile, POISSON1D_BIN_TRIDIAG, 3, &fop, &dop) != 0) goto out;
+  if (map_input(rhsfile, POISSON1D_BIN_VEC, 1, &frhs, &drhs) != 0) goto out;
+  n = (poisson1D_int) frhs.hdr.rows;
+  if ((opfile != NULL) ? (fop.hdr.rows != n) : (A->n != n)) {
+    fprintf(stderr, "%s: size does not match the operator\n", rhsfile);
+    goto out;
+  }
+  if (map_output(solfile, n, &fsol, &dsol) != 0) goto out;
+  if (map_output(factorfile, n, &ffac, &dfac) != 0) goto out;
+
+  if (opfile != NULL) {
+    for (poisson1D_int k = 0; k < 3; k++) {stream_set(&op[k], &fop, dop, k);}
+  } else {
+    coef[0] = A->sub;
+    coef[1] = A->diag;
+    coef[2] = A->sup;
+  }
+  stream_set(&r, &frhs, drhs, 0);
+  stream_set(&x, &fsol, dsol, 0);
+  stream_set(&f, &ffac, dfac, 0);
+  *info = 0;
+  thomas_ooc(op, coef, &r, &x, &f, n, (*budget > 0) ? *budget : POISSON1D_OOC_BUDGET, info);
+  if (*info < 0) perror(solfile);
+
+out:
+  poisson1D_bin_unmap(&fop);
+  poisson1D_bin_unmap(&frhs);
+  poisson1D_bin_unmap(&fsol);
+  poisson1D_bin_unmap(&ffac);
+  close_fd(dop);
+  close_fd(drhs);
+  close_fd(dsol);
+  close_fd(dfac);
+  poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+  return *info;
+}
+
+poisson1D_int dgtsv_ooc(char *opfile, char *rhsfile, char *solfile, char *factorfile, size_t *budget, poisson1D_int *info){
+  return solve_ooc(NULL, opfile, rhsfile, solfile, factorfile, budget, info);
+}
+
+poisson1D_int dstencil_thomas_ooc(StencilOperator *A, char *rhsfile, char *solfile, char *factorfile, size_t *budget, poisson1D_int *info){
+  return solve_ooc(A, NULL, rhsfile, solfile, factorfile, budget, info);
+}
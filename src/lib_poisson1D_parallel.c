@@ -0,0 +1,146 @@
+/**********************************************/
+/* lib_poisson1D_parallel.c                   */
+/* Shared-memory parallel tridiagonal solver  */
+/* (partition method, OpenMP)                 */
+/**********************************************/
+#include "lib_poisson1D.h"
+#include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define PARTITION_MIN_SIZE 2 /* Minimum number of rows per partition */
+
+poisson1D_int dgtsvpartition(poisson1D_int *n, double *dl, double *d, double *du, double *B, int *nparts, poisson1D_int *info){
+  *info = 0;
+  if (*n <= 0) {return *info;}
+  poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+  int P = *nparts;
+#ifdef _OPENMP
+  if (P <= 0) {P = omp_get_max_threads();}
+#endif
+  if (P <= 0) {P = 1;}
+  if (P > *n / PARTITION_MIN_SIZE) {P = (int)(*n / PARTITION_MIN_SIZE);}
+  if (P <= 1) {
+    // Not worth splitting: plain Thomas
+    poisson1D_int one = 1;
+    dgttrftridiag(n, dl, d, du, info);
+    if (*info == 0) {dgttrstridiag(n, &one, dl, d, du, B, n, info);}
+    poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+    return *info;
+  }
+
+  // Per partition: y = A_p^{-1} f_p at both ends, and the end values of the spikes
+  // V = A_p^{-1} (a e_1) (coupling to the row above) and W = A_p^{-1} (c e_m) (row below)
+  double *ends = (double *) calloc(6 * (size_t)P, sizeof(double));
+  double *work = (double *) malloc(sizeof(double) * (size_t)(*n));
+  poisson1D_int ldr = 7, kl = 2, ku = 2, nr = 2 * P, one = 1;
+  double *R = (double *) calloc((size_t)ldr * nr, sizeof(double));
+  double *xr = (double *) malloc(sizeof(double) * nr);
+  poisson1D_int *ipiv = (poisson1D_int *) malloc(sizeof(poisson1D_int) * nr);
+  if (ends == NULL || work == NULL || R == NULL || xr == NULL || ipiv == NULL) {
+    free(ends); free(work); free(R); free(xr); free(ipiv);
+    *info = -1;
+    poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+    return *info;
+  }
+  poisson1D_int singular = 0;
+
+  // Phase 1: independent factorization and solves of the diagonal blocks
+  #pragma omp parallel for schedule(static) reduction(max:singular)
+  for (poisson1D_int p = 0; p < P; p++) {
+    poisson1D_int s = (poisson1D_int)(((int64_t)(*n) * p) / P);
+    poisson1D_int e = (poisson1D_int)(((int64_t)(*n) * (p + 1)) / P);
+    double *en = ends + 6 * (size_t)p;
+    poisson1D_int bad = 0;
+    // LU of the block, same elimination as dgttrftridiag; dl[s-1] and du[e-1] are untouched
+    for (poisson1D_int i = s; i < e - 1; i++) {
+      if (d[i] == 0.0) {bad = i + 1; break;}
+      double factor = dl[i] / d[i];
+      dl[i] = factor;
+      d[i + 1] -= factor * du[i];
+    }
+    if (bad == 0 && d[e - 1] == 0.0) {bad = e;}
+    if (bad != 0) {
+      if (bad > singular) {singular = bad;}
+      continue;
+    }
+    // Forward substitution in place: B = L^{-1} f
+    for (poisson1D_int i = s + 1; i < e; i++) {B[i] -= dl[i - 1] * B[i - 1];}
+    // End values of y (back substitution carried as a scalar)
+    double y = B[e - 1] / d[e - 1];
+    en[1] = y;
+    for (poisson1D_int i = e - 2; i >= s; i--) {y = (B[i] - du[i] * y) / d[i];}
+    en[0] = y;
+    // Left spike V: needs the full vector for its back substitution
+    if (p > 0) {
+      work[s] = dl[s - 1];
+      for (poisson1D_int i = s + 1; i < e; i++) {work[i] = -dl[i - 1] * work[i - 1];}
+      work[e - 1] /= d[e - 1];
+      for (poisson1D_int i = e - 2; i >= s; i--) {work[i] = (work[i] - du[i] * work[i + 1]) / d[i];}
+      en[2] = work[s];
+      en[3] = work[e - 1];
+    }
+    // Right spike W: L^{-1} (c e_m) = c e_m, back substitution carried as a scalar
+    if (p < P - 1) {
+      double w = du[e - 1] / d[e - 1];
+      en[5] = w;
+      for (poisson1D_int i = e - 2; i >= s; i--) {w = -du[i] * w / d[i];}
+      en[4] = w;
+    }
+  }
+  if (singular != 0) {
+    *info = singular;
+    free(ends); free(work); free(R); free(xr); free(ipiv);
+    poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+    return *info;
+  }
+
+  // Phase 2: reduced system on the partition ends, unknowns (top_p, bottom_p) at (2p, 2p+1)
+  //   top_p    + V0_p bottom_{p-1} + W0_p top_{p+1} = y0_p
+  //   bottom_p + Vm_p bottom_{p-1} + Wm_p top_{p+1} = ym_p
+  // Band storage for dgbsv: element (i,j) at R[kl+ku+i-j + j*ldr]
+  for (poisson1D_int p = 0; p < P; p++) {
+    double *en = ends + 6 * (size_t)p;
+    poisson1D_int t = 2 * p, b = 2 * p + 1;
+    R[kl + ku + t * ldr] = 1.0;
+    R[kl + ku + b * ldr] = 1.0;
+    if (p > 0) {
+      R[kl + ku + t - (b - 2) + (b - 2) * ldr] = en[2];
+      R[kl + ku + b - (b - 2) + (b - 2) * ldr] = en[3];
+    }
+    if (p < P - 1) {
+      R[kl + ku + t - (t + 2) + (t + 2) * ldr] = en[4];
+      R[kl + ku + b - (t + 2) + (t + 2) * ldr] = en[5];
+    }
+    xr[t] = en[0];
+    xr[b] = en[1];
+  }
+  dgbsv_(&nr, &kl, &ku, &one, R, &ldr, ipiv, xr, &nr, info);
+
+  // Phase 3: each block solves again with the coupling terms moved to its right-hand side
+  if (*info == 0) {
+    #pragma omp parallel for schedule(static)
+    for (poisson1D_int p = 0; p < P; p++) {
+      poisson1D_int s = (poisson1D_int)(((int64_t)(*n) * p) / P);
+      poisson1D_int e = (poisson1D_int)(((int64_t)(*n) * (p + 1)) / P);
+      // L^{-1} (f - a x_{s-1} e_1 - c x_e e_m) = B - a x_{s-1} L^{-1} e_1 - c x_e e_m
+      if (p > 0) {
+        double corr = -dl[s - 1] * xr[2 * p - 1];
+        B[s] += corr;
+        for (poisson1D_int i = s + 1; i < e; i++) {
+          corr = -dl[i - 1] * corr;
+          B[i] += corr;
+        }
+      }
+      if (p < P - 1) {B[e - 1] -= du[e - 1] * xr[2 * p + 2];}
+      // Back substitution
+      B[e - 1] /= d[e - 1];
+      for (poisson1D_int i = e - 2; i >= s; i--) {B[i] = (B[i] - du[i] * B[i + 1]) / d[i];}
+    }
+  }
+
+  free(ends); free(work); free(R); free(xr); free(ipiv);
+  poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+  return *info;
+}
@@ -5,29 +5,44 @@
 /**********************************************/
 #include "lib_poisson1D.h"
 #include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
-void eig_poisson1D(double* eigval, int *la){
-  for (int k = 0; k < *la; k++) {
+#define STENCIL_BLOCK 512 /* Block length (doubles) of the fused stencil sweep */
+
+void eig_poisson1D(double* eigval, poisson1D_int *la){
+  for (poisson1D_int k = 0; k < *la; k++) {
     eigval[k] = 2.0 - 2.0 * cos((k + 1) * M_PI / ((*la + 1)));
   }
 }
 
-double eigmax_poisson1D(int *la){
+double eigmax_poisson1D(poisson1D_int *la){
   return 2.0 - 2.0 * cos((*la) * M_PI / ((*la + 1)));
 }
 
-double eigmin_poisson1D(int *la){
+double eigmin_poisson1D(poisson1D_int *la){
   return 2.0 - 2.0 * cos(M_PI / ((*la + 1)));
 }
 
-double richardson_alpha_opt(int *la){
+double richardson_alpha_opt(poisson1D_int *la){
   double min_eig = eigmin_poisson1D(la);
   double max_eig = eigmax_poisson1D(la);
   return 2.0 / (min_eig + max_eig);
 }
 
-void richardson_alpha(double *AB, double *RHS, double *X, double *alpha_rich, int *lab, int *la,int *ku, int*kl, double *tol, int *maxit, double *resvec, int *nbite){
-  double *r = (double *) malloc((size_t)(*la) * sizeof(double));
+void richardson_alpha(double *AB, double *RHS, double *X, double *alpha_rich, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *tol, int *maxit, double *resvec, int *nbite){
+  int method = POISSON1D_WS_RICHARDSON;
+  Poisson1DWorkspace *ws = poisson1D_workspace_create(&method, la);
+  richardson_alpha_ws(AB, RHS, X, alpha_rich, lab, la, ku, kl, tol, maxit, resvec, nbite, ws);
+  poisson1D_workspace_destroy(ws);
+}
+
+void richardson_alpha_ws(double *AB, double *RHS, double *X, double *alpha_rich, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws){
+  double *r = poisson1D_workspace_get(ws, (size_t)(*la));
+  *nbite = 0;
+  if (r == NULL) {return;}
+  poisson1D_timing_begin(POISSON1D_PHASE_ITER);
   double norm_b = cblas_dnrm2(*la, RHS, 1);
   if (norm_b == 0.0) {norm_b = 1.0;}
   for (*nbite = 0; *nbite < *maxit; (*nbite)++) {
@@ -39,26 +54,210 @@ void richardson_alpha(double *AB, double *RHS, double *X, double *alpha_rich, in
     cblas_dgbmv(CblasColMajor, CblasNoTrans, *la, *la, *kl, *ku, -1.0, AB, *lab, X, 1, 1.0, r, 1);
     double norm_r = cblas_dnrm2(*la, r, 1);
     resvec[*nbite] = norm_r / norm_b;
+    poisson1D_timing_iteration(*nbite);
     if (resvec[*nbite] < *tol) break;
     // x = x + alpha * r
     cblas_daxpy(*la, *alpha_rich, r, 1, X, 1);
   }
-  free(r);
+  poisson1D_timing_end(POISSON1D_PHASE_ITER);
+}
+
+void richardson_alpha_stencil(double *RHS, double *X, double *alpha_rich, poisson1D_int *la, double *tol, int *maxit, double *resvec, int *nbite){
+  StencilOperator A;
+  int prec = POISSON1D_STENCIL_RICHARDSON;
+  set_stencil_operator_poisson1D(&A, la);
+  richardson_stencil_op(&A, RHS, X, alpha_rich, &prec, tol, maxit, resvec, nbite);
 }
 
-void extract_MB_jacobi_tridiag(double *AB, double *MB, int *lab, int *la,int *ku, int*kl, int *kv){
+void richardson_stencil_op(StencilOperator *A, double *RHS, double *X, double *alpha_rich, int *prec, double *tol, int *maxit, double *resvec, int *nbite){
+  poisson1D_timing_begin(POISSON1D_PHASE_ITER);
+  poisson1D_int n = A->n;
+  double sub = A->sub, dg = A->diag, sup = A->sup;
+  double w = (*prec == POISSON1D_STENCIL_RICHARDSON) ? *alpha_rich : 1.0 / dg;
+  int gs = (*prec == POISSON1D_STENCIL_GS);
+  double rblk[STENCIL_BLOCK]; // L1-resident residual of the current block
+  double norm_b = cblas_dnrm2(n, RHS, 1);
+  if (norm_b == 0.0) {norm_b = 1.0;}
+  for (*nbite = 0; *nbite < *maxit; (*nbite)++) {
+    double norm2 = 0.0;
+    double xleft = 0.0; // old x[i0-1] (homogeneous Dirichlet outside, BC are in RHS)
+    double z = 0.0;     // last value of the Gauss-Seidel forward substitution
+    for (poisson1D_int i0 = 0; i0 < n; i0 += STENCIL_BLOCK) {
+      poisson1D_int len = (n - i0 < STENCIL_BLOCK) ? n - i0 : STENCIL_BLOCK;
+      double *x = X + i0;
+      double *b = RHS + i0;
+      double xright = (i0 + len < n) ? x[len] : 0.0; // not updated yet
+      double xlast = x[len - 1];                     // old value, left neighbour of next block
+      // r = b - A * x on the block, from the old iterate, first and last rows peeled
+      if (len == 1) {
+        rblk[0] = b[0] - sub * xleft - dg * x[0] - sup * xright;
+        norm2 += rblk[0] * rblk[0];
+      } else {
+        rblk[0] = b[0] - sub * xleft - dg * x[0] - sup * x[1];
+        rblk[len - 1] = b[len - 1] - sub * x[len - 2] - dg * x[len - 1] - sup * xright;
+        norm2 += rblk[0] * rblk[0] + rblk[len - 1] * rblk[len - 1];
+        #pragma omp simd reduction(+:norm2)
+        for (poisson1D_int k = 1; k < len - 1; k++) {
+          rblk[k] = b[k] - sub * x[k - 1] - dg * x[k] - sup * x[k + 1];
+          norm2 += rblk[k] * rblk[k];
+        }
+      }
+      // x = x + w r, or x = x + (D - E)^{-1} r
+      if (gs) {
+        for (poisson1D_int k = 0; k < len; k++) {
+          z = (rblk[k] - sub * z) * w;
+          x[k] += z;
+        }
+      } else {
+        #pragma omp simd
+        for (poisson1D_int k = 0; k < len; k++) {x[k] += w * rblk[k];}
+      }
+      xleft = xlast;
+    }
+    resvec[*nbite] = sqrt(norm2) / norm_b;
+    poisson1D_timing_iteration(*nbite);
+    if (resvec[*nbite] < *tol) break;
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_ITER);
+}
+
+/*
+ * Up to s sweeps x <- x + w (b - A x) on tile [t0, t1), A tridiagonal (packed GB, stride lab_ab),
+ * w = alpha or alpha / M_ii. The local buffers hold [lo - 1, hi + 1) with lo = t0 - s and
+ * hi = t1 + s clipped to the grid (zero guards outside): sweep q updates the points that are still
+ * exact, [lo + q - 1, hi - q + 1), so after s sweeps x is exact on [t0 - 1, t1 + 1) and the residual
+ * of the last iterate on the tile costs no extra pass. nrm[q] += ||b - A x_q||^2 over [t0, t1).
+ */
+static void tile_sweeps(poisson1D_int n, poisson1D_int t0, poisson1D_int t1, int s, int m, double *AB, poisson1D_int lab_ab, poisson1D_int ku, double *MB, poisson1D_int lm, double alpha, double *RHS, double *Xin, double *Xout, double *buf, double *nrm){
+  poisson1D_int lo = (t0 - s > 0) ? t0 - s : 0;
+  poisson1D_int hi = (t1 + s < n) ? t1 + s : n;
+  poisson1D_int len = hi - lo + 2;
+  double *xa = buf, *xb = buf + len, *l = buf + 2 * len, *d = buf + 3 * len;
+  double *u = buf + 4 * len, *w = buf + 5 * len, *b = buf + 6 * len;
+  // Local index k = i - lo + 1: A, w and b are read once for the m sweeps
+  xa[0] = xb[0] = (lo > 0) ? Xin[lo - 1] : 0.0;
+  xa[len - 1] = xb[len - 1] = (hi < n) ? Xin[hi] : 0.0;
+  double *ABd = AB + (size_t)lo * lab_ab + ku;
+  #pragma omp simd
+  for (poisson1D_int k = 1; k < len - 1; k++) {
+    xa[k] = Xin[lo + k - 1];
+    b[k] = RHS[lo + k - 1];
+    d[k] = ABd[(k - 1) * lab_ab];
+  }
+  // A(i, i-1) and A(i, i+1), zero on the first and last rows of the grid
+  poisson1D_int kl0 = (lo == 0) ? 2 : 1, ku1 = (hi == n) ? len - 2 : len - 1;
+  l[1] = 0.0;
+  u[len - 2] = 0.0;
+  #pragma omp simd
+  for (poisson1D_int k = kl0; k < len - 1; k++) {l[k] = ABd[(k - 2) * lab_ab + 1];}
+  #pragma omp simd
+  for (poisson1D_int k = 1; k < ku1; k++) {u[k] = ABd[k * lab_ab - 1];}
+  if (MB != NULL) {
+    double *MBd = MB + (size_t)lo * lm + ku;
+    #pragma omp simd
+    for (poisson1D_int k = 1; k < len - 1; k++) {w[k] = alpha / MBd[(k - 1) * lm];}
+  } else {
+    #pragma omp simd
+    for (poisson1D_int k = 1; k < len - 1; k++) {w[k] = alpha;}
+  }
+  poisson1D_int m0 = t0 - lo + 1, m1 = t1 - lo + 1;  // own points
+  for (poisson1D_int q = 1; q <= m; q++) {
+    poisson1D_int p0 = (lo > 0) ? q : 1;               // first exact point of x_q
+    poisson1D_int p1 = (hi < n) ? len - q : len - 1;   // one past the last
+    double norm2 = 0.0;
+    #pragma omp simd
+    for (poisson1D_int k = p0; k < m0; k++) {xb[k] = xa[k] + w[k] * (b[k] - l[k] * xa[k - 1] - d[k] * xa[k] - u[k] * xa[k + 1]);}
+    #pragma omp simd reduction(+:norm2)
+    for (poisson1D_int k = m0; k < m1; k++) {
+      double r = b[k] - l[k] * xa[k - 1] - d[k] * xa[k] - u[k] * xa[k + 1];
+      xb[k] = xa[k] + w[k] * r;
+      norm2 += r * r;
+    }
+    #pragma omp simd
+    for (poisson1D_int k = m1; k < p1; k++) {xb[k] = xa[k] + w[k] * (b[k] - l[k] * xa[k - 1] - d[k] * xa[k] - u[k] * xa[k + 1]);}
+    nrm[q - 1] += norm2;
+    double *tmp = xa; xa = xb; xb = tmp;
+  }
+  double norm2 = 0.0;
+  #pragma omp simd reduction(+:norm2)
+  for (poisson1D_int k = m0; k < m1; k++) {
+    double r = b[k] - l[k] * xa[k - 1] - d[k] * xa[k] - u[k] * xa[k + 1];
+    norm2 += r * r;
+    Xout[t0 + k - m0] = xa[k];
+  }
+  nrm[m] += norm2;
+}
+
+void richardson_tiled(double *AB, double *RHS, double *X, double *MB, double *alpha, poisson1D_int *lab, poisson1D_int *la, poisson1D_int *ku, poisson1D_int *kl, int *s, int *tile, double *tol, int *maxit, double *resvec, int *nbite){
+  poisson1D_int n = *la;
+  poisson1D_int lab_ab = *kl + *ku + 1; // AB stride (packed)
+  int S = (*s > 0) ? *s : POISSON1D_TILE_STEPS;
+  int T = (*tile > 0) ? *tile : POISSON1D_TILE_SIZE;
+  poisson1D_int ntiles = (n + T - 1) / T;
+  int nt = 1;
+#ifdef _OPENMP
+  nt = omp_get_max_threads();
+#endif
+  size_t len = (size_t)T + 2 * (size_t)S + 2;
+  *nbite = 0;
+  if (n <= 0) {return;}
+  poisson1D_timing_begin(POISSON1D_PHASE_ITER);
+  // Tiles read x_k from one vector and write x_{k+s} to the other: no halo exchange between tiles
+  double *Y = (double *) malloc(sizeof(double) * (size_t)n);
+  double *buf = (double *) malloc(sizeof(double) * 7 * len * nt);
+  double *nrm = (double *) malloc(sizeof(double) * (S + 1));
+  if (Y == NULL || buf == NULL || nrm == NULL) {
+    free(Y); free(buf); free(nrm);
+    poisson1D_timing_end(POISSON1D_PHASE_ITER);
+    return;
+  }
+  double norm_b = cblas_dnrm2(n, RHS, 1);
+  if (norm_b == 0.0) {norm_b = 1.0;}
+
+  double *xin = X, *xout = Y;
+  for (int k = 0; k < *maxit; ) {
+    int m = (*maxit - k < S) ? *maxit - k : S;
+    for (int q = 0; q <= m; q++) {nrm[q] = 0.0;}
+    #pragma omp parallel for schedule(static) reduction(+:nrm[:m + 1]) if(n >= POISSON1D_SPMV_PAR_MIN)
+    for (poisson1D_int t = 0; t < ntiles; t++) {
+      int tid = 0;
+#ifdef _OPENMP
+      tid = omp_get_thread_num();
+#endif
+      poisson1D_int t1 = (t + 1 < ntiles) ? (t + 1) * T : n;
+      tile_sweeps(n, t * T, t1, S, m, AB, lab_ab, *ku, MB, *lab, *alpha, RHS, xin, xout, buf + 7 * len * tid, nrm);
+    }
+    double *tmp = xin; xin = xout; xout = tmp;
+    // Every residual of the block comes out of the sweeps, the test is done once per block
+    for (int q = 0; q <= m && k + q < *maxit; q++) {resvec[k + q] = sqrt(nrm[q]) / norm_b;}
+    k += m;
+    *nbite = k;
+    poisson1D_timing_iteration(k);
+    if (k < *maxit && resvec[k] < *tol) break;
+  }
+  if (xin != X) {memcpy(X, xin, sizeof(double) * (size_t)n);}
+  free(Y);
+  free(buf);
+  free(nrm);
+  poisson1D_timing_end(POISSON1D_PHASE_ITER);
+}
+
+void extract_MB_jacobi_tridiag(double *AB, double *MB, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, poisson1D_int *kv){
+  poisson1D_timing_begin(POISSON1D_PHASE_PRECOND);
   // Initialize MB to 0 and copy the diagonal from AB.
   memset(MB, 0, (size_t)(*la) * (*lab) * sizeof(double));
-  for (int j = 0; j < *la; j++) {
+  for (poisson1D_int j = 0; j < *la; j++) {
     // AB has Diag at row 'ku' (standard GB format)
     // MB has Diag at row 'kv + 1' (as defined by setup)
     MB[j * (*lab) + (*kv + 1)] = AB[j * (*lab) + (*ku)]; 
   }
+  poisson1D_timing_end(POISSON1D_PHASE_PRECOND);
 }
 
-void extract_MB_gauss_seidel_tridiag(double *AB, double *MB, int *lab, int *la,int *ku, int*kl, int *kv){
+void extract_MB_gauss_seidel_tridiag(double *AB, double *MB, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, poisson1D_int *kv){
+  poisson1D_timing_begin(POISSON1D_PHASE_PRECOND);
   memset(MB, 0, (size_t)(*la) * (*lab) * sizeof(double));
-  for (int j = 0; j < *la; j++) {
+  for (poisson1D_int j = 0; j < *la; j++) {
       // Diagonal
       // AB Diag at 'ku', MB Diag at 'kv + 1'
       MB[j * (*lab) + (*kv + 1)] = AB[j * (*lab) + (*ku)];
@@ -69,14 +268,54 @@ void extract_MB_gauss_seidel_tridiag(double *AB, double *MB, int *lab, int *la,i
          MB[j * (*lab) + (*kv + 2)] = AB[j * (*lab) + (*ku + 1)];
       }
   }
+  poisson1D_timing_end(POISSON1D_PHASE_PRECOND);
+}
+
+void richardson_jacobi(double *AB, double *RHS, double *X, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *tol, int *maxit, double *resvec, int *nbite){
+  int method = POISSON1D_WS_RICHARDSON;
+  Poisson1DWorkspace *ws = poisson1D_workspace_create(&method, la);
+  richardson_jacobi_ws(AB, RHS, X, lab, la, ku, kl, tol, maxit, resvec, nbite, ws);
+  poisson1D_workspace_destroy(ws);
+}
+
+void richardson_jacobi_ws(double *AB, double *RHS, double *X, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws){
+  double *r = poisson1D_workspace_get(ws, (size_t)(*la));
+  *nbite = 0;
+  if (r == NULL) {return;}
+  poisson1D_timing_begin(POISSON1D_PHASE_ITER);
+  double *D = AB + *ku; // diagonal of A, stride lab: M = D is never stored
+  double norm_b = cblas_dnrm2(*la, RHS, 1);
+  if (norm_b == 0.0) {norm_b = 1.0;}
+  for (*nbite = 0; *nbite < *maxit; (*nbite)++) {
+    // r = b - A * x
+    cblas_dcopy(*la, RHS, 1, r, 1);
+    cblas_dgbmv(CblasColMajor, CblasNoTrans, *la, *la, *kl, *ku, -1.0, AB, *lab, X, 1, 1.0, r, 1);
+    double norm_r = cblas_dnrm2(*la, r, 1);
+    resvec[*nbite] = norm_r / norm_b;
+    poisson1D_timing_iteration(*nbite);
+    if (resvec[*nbite] < *tol) break;
+    // x = x + D^{-1} r
+    for (poisson1D_int i = 0; i < *la; i++) {X[i] += r[i] / D[(size_t)i * (*lab)];}
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_ITER);
 }
 
-void richardson_MB(double *AB, double *RHS, double *X, double *MB, int *lab, int *la,int *ku, int*kl, double *tol, int *maxit, double *resvec, int *nbite){
-  double *r = (double *) malloc((size_t)(*la) * sizeof(double));
-  double *z = (double *) malloc((size_t)(*la) * sizeof(double)); // Update vector M^{-1} r
+void richardson_MB(double *AB, double *RHS, double *X, double *MB, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *tol, int *maxit, double *resvec, int *nbite){
+  int method = POISSON1D_WS_RICHARDSON_MB;
+  Poisson1DWorkspace *ws = poisson1D_workspace_create(&method, la);
+  richardson_MB_ws(AB, RHS, X, MB, lab, la, ku, kl, tol, maxit, resvec, nbite, ws);
+  poisson1D_workspace_destroy(ws);
+}
+
+void richardson_MB_ws(double *AB, double *RHS, double *X, double *MB, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws){
+  double *r = poisson1D_workspace_get(ws, 2 * (size_t)(*la));
+  *nbite = 0;
+  if (r == NULL) {return;}
+  poisson1D_timing_begin(POISSON1D_PHASE_ITER);
+  double *z = r + *la; // Update vector M^{-1} r
   
   double norm_b = cblas_dnrm2(*la, RHS, 1);
-  int lab_ab = *kl + *ku + 1; // AB stride (packed)
+  poisson1D_int lab_ab = *kl + *ku + 1; // AB stride (packed)
   if (norm_b == 0.0) {norm_b = 1.0;}
   
   for (*nbite = 0; *nbite < *maxit; (*nbite)++) {
@@ -88,6 +327,7 @@ void richardson_MB(double *AB, double *RHS, double *X, double *MB, int *lab, int
     
     double norm_r = cblas_dnrm2(*la, r, 1);
     resvec[*nbite] = norm_r / norm_b;
+    poisson1D_timing_iteration(*nbite);
     
     if (resvec[*nbite] < *tol) break;
     
@@ -95,7 +335,7 @@ void richardson_MB(double *AB, double *RHS, double *X, double *MB, int *lab, int
     cblas_dcopy(*la, r, 1, z, 1);
     
     // Forward substitution
-    for (int i = 0; i < *la; i++) {
+    for (poisson1D_int i = 0; i < *la; i++) {
         double val = r[i];
         if (i > 0) {
             val -= MB[(i-1) * (*lab) + (*ku + 1)] * z[i-1]; // M_{i, i-1} * z_{i-1}
@@ -110,15 +350,81 @@ void richardson_MB(double *AB, double *RHS, double *X, double *MB, int *lab, int
     // x = x + z
     cblas_daxpy(*la, 1.0, z, 1, X, 1);
   }
-  
-  free(r);
-  free(z);
+  poisson1D_timing_end(POISSON1D_PHASE_ITER);
+}
+
+void extract_MB_gauss_seidel_redblack_tridiag(double *AB, double *MB, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, poisson1D_int *kv){
+  poisson1D_timing_begin(POISSON1D_PHASE_PRECOND);
+  // Red-black ordering: red rows (even i) keep the diagonal only, black rows (odd i)
+  // keep the diagonal and their two (red) neighbours
+  memset(MB, 0, (size_t)(*la) * (*lab) * sizeof(double));
+  for (poisson1D_int j = 0; j < *la; j++) {
+    // Diagonal: AB Diag at 'ku', MB Diag at 'kv + 1'
+    MB[j * (*lab) + (*kv + 1)] = AB[j * (*lab) + (*ku)];
+    if (j % 2 == 0) {
+      // M_{j+1, j}: sub-diagonal at column j (AB Sub at 'ku + 1')
+      if (j < *la - 1) {MB[j * (*lab) + (*kv + 2)] = AB[j * (*lab) + (*ku + 1)];}
+      // M_{j-1, j}: super-diagonal at column j (AB Super at 'ku - 1')
+      if (j > 0) {MB[j * (*lab) + (*kv)] = AB[j * (*lab) + (*ku - 1)];}
+    }
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_PRECOND);
+}
+
+void richardson_MB_redblack(double *AB, double *RHS, double *X, double *MB, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *tol, int *maxit, double *resvec, int *nbite){
+  int method = POISSON1D_WS_REDBLACK;
+  Poisson1DWorkspace *ws = poisson1D_workspace_create(&method, la);
+  richardson_MB_redblack_ws(AB, RHS, X, MB, lab, la, ku, kl, tol, maxit, resvec, nbite, ws);
+  poisson1D_workspace_destroy(ws);
+}
+
+void richardson_MB_redblack_ws(double *AB, double *RHS, double *X, double *MB, poisson1D_int *lab, poisson1D_int *la,poisson1D_int *ku, poisson1D_int*kl, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws){
+  poisson1D_int n = *la;
+  poisson1D_int lab_ab = *kl + *ku + 1; // AB stride (packed)
+  poisson1D_int lm = *lab;              // MB stride
+  double *z = poisson1D_workspace_get(ws, (size_t)n); // r, then M^{-1} r
+  *nbite = 0;
+  if (z == NULL) {return;}
+  poisson1D_timing_begin(POISSON1D_PHASE_ITER);
+
+  double norm_b = cblas_dnrm2(n, RHS, 1);
+  if (norm_b == 0.0) {norm_b = 1.0;}
+
+  for (*nbite = 0; *nbite < *maxit; (*nbite)++) {
+    double norm2 = 0.0;
+    // r = b - A * x; red rows of M are diagonal, so z = r / d there right away
+    #pragma omp parallel for simd schedule(static) reduction(+:norm2)
+    for (poisson1D_int i = 0; i < n; i++) {
+      double ax = AB[i * lab_ab + *ku] * X[i];
+      if (i > 0) {ax += AB[(i - 1) * lab_ab + *ku + 1] * X[i - 1];}
+      if (i < n - 1) {ax += AB[(i + 1) * lab_ab + *ku - 1] * X[i + 1];}
+      double r = RHS[i] - ax;
+      norm2 += r * r;
+      z[i] = (i % 2 == 0) ? r / MB[i * lm + *ku] : r;
+    }
+    resvec[*nbite] = sqrt(norm2) / norm_b;
+    poisson1D_timing_iteration(*nbite);
+    if (resvec[*nbite] < *tol) break;
+
+    // Black rows only depend on red values of z: solve them independently, and x = x + z
+    #pragma omp parallel for simd schedule(static)
+    for (poisson1D_int i = 1; i < n; i += 2) {
+      double val = z[i] - MB[(i - 1) * lm + *ku + 1] * z[i - 1]; // M_{i, i-1} * z_{i-1}
+      if (i < n - 1) {val -= MB[(i + 1) * lm + *ku - 1] * z[i + 1];} // M_{i, i+1} * z_{i+1}
+      z[i] = val / MB[i * lm + *ku];
+      X[i - 1] += z[i - 1];
+      X[i] += z[i];
+    }
+    if (n % 2 == 1) {X[n - 1] += z[n - 1];}
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_ITER);
 }
 
 void dcsrmv(CSRMatrix *mat, double *x, double *y) {
-    for (int i = 0; i < mat->n; i++) {
+    #pragma omp parallel for schedule(static) if(mat->n >= POISSON1D_SPMV_PAR_MIN)
+    for (poisson1D_int i = 0; i < mat->n; i++) {
         double sum = 0.0;
-        for (int j = mat->row_ptr[i]; j < mat->row_ptr[i+1]; j++) {
+        for (poisson1D_int j = mat->row_ptr[i]; j < mat->row_ptr[i+1]; j++) {
             sum += mat->values[j] * x[mat->col_ind[j]];
         }
         y[i] = sum;
@@ -126,22 +432,60 @@ void dcsrmv(CSRMatrix *mat, double *x, double *y) {
 }
 
 void dcscmv(CSCMatrix *mat, double *x, double *y) {
-    // Initialize y to 0
-    for (int i = 0; i < mat->n; i++) {
-        y[i] = 0.0;
-    }
-    // Iterate over columns
-    for (int j = 0; j < mat->n; j++) {
-        for (int i = mat->col_ptr[j]; i < mat->col_ptr[j+1]; i++) {
-            y[mat->row_ind[i]] += mat->values[i] * x[j];
+    poisson1D_int n = mat->n;
+    #pragma omp parallel if(n >= POISSON1D_SPMV_PAR_MIN)
+    {
+        int nt = 1, t = 0;
+#ifdef _OPENMP
+        nt = omp_get_num_threads();
+        t = omp_get_thread_num();
+#endif
+        // Columns [j0, j1) and rows [j0, j1) belong to this thread
+        poisson1D_int j0 = (poisson1D_int) ((int64_t) n * t / nt), j1 = (poisson1D_int) ((int64_t) n * (t + 1) / nt);
+        poisson1D_int jlo = j1, jhi = j0 - 1;  // first and last column with entries outside the own rows
+        for (poisson1D_int i = j0; i < j1; i++) {
+            y[i] = 0.0;
+        }
+        for (poisson1D_int j = j0; j < j1; j++) {
+            double xj = x[j];
+            for (poisson1D_int k = mat->col_ptr[j]; k < mat->col_ptr[j+1]; k++) {
+                poisson1D_int r = mat->row_ind[k];
+                if (r >= j0 && r < j1) {
+                    y[r] += mat->values[k] * xj;
+                } else {
+                    if (j < jlo) jlo = j;
+                    jhi = j;
+                }
+            }
+        }
+        // Every row now holds its own-block sum: add the contributions of the other blocks
+        #pragma omp barrier
+        for (poisson1D_int j = jlo; j <= jhi; j++) {
+            for (poisson1D_int k = mat->col_ptr[j]; k < mat->col_ptr[j+1]; k++) {
+                poisson1D_int r = mat->row_ind[k];
+                if (r < j0 || r >= j1) {
+                    #pragma omp atomic
+                    y[r] += mat->values[k] * x[j];
+                }
+            }
         }
     }
 }
 
 void richardson_alpha_csr(CSRMatrix *mat, double *RHS, double *X, double *alpha_rich, double *tol, int *maxit, double *resvec, int *nbite) {
-    int n = mat->n;
-    double *r = (double *)malloc(n * sizeof(double));
-    double *Ax = (double *)malloc(n * sizeof(double));
+    int method = POISSON1D_WS_CSR;
+    Poisson1DWorkspace *ws = poisson1D_workspace_create(&method, &mat->n);
+    richardson_alpha_csr_ws(mat, RHS, X, alpha_rich, tol, maxit, resvec, nbite, ws);
+    poisson1D_workspace_destroy(ws);
+}
+
+void richardson_alpha_csr_ws(CSRMatrix *mat, double *RHS, double *X, double *alpha_rich, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws) {
+    poisson1D_int n = mat->n;
+    double *r = poisson1D_workspace_get(ws, 2 * (size_t)n);
+    *nbite = 0;
+    if (r == NULL) return;
+    poisson1D_timing_begin(POISSON1D_PHASE_ITER);
+    double *Ax = r + n;
     double norm_b = cblas_dnrm2(n, RHS, 1);
     
     if (norm_b == 0.0) norm_b = 1.0;
@@ -157,20 +501,29 @@ void richardson_alpha_csr(CSRMatrix *mat, double *RHS, double *X, double *alpha_
         // Check convergence
         double norm_r = cblas_dnrm2(n, r, 1);
         resvec[*nbite] = norm_r / norm_b;
+        poisson1D_timing_iteration(*nbite);
         if (resvec[*nbite] < *tol) break;
 
         // Update x: x = x + alpha * r
         cblas_daxpy(n, *alpha_rich, r, 1, X, 1);
     }
-
-    free(r);
-    free(Ax);
+    poisson1D_timing_end(POISSON1D_PHASE_ITER);
 }
 
 void richardson_alpha_csc(CSCMatrix *mat, double *RHS, double *X, double *alpha_rich, double *tol, int *maxit, double *resvec, int *nbite) {
-    int n = mat->n;
-    double *r = (double *)malloc(n * sizeof(double));
-    double *Ax = (double *)malloc(n * sizeof(double));
+    int method = POISSON1D_WS_CSC;
+    Poisson1DWorkspace *ws = poisson1D_workspace_create(&method, &mat->n);
+    richardson_alpha_csc_ws(mat, RHS, X, alpha_rich, tol, maxit, resvec, nbite, ws);
+    poisson1D_workspace_destroy(ws);
+}
+
+void richardson_alpha_csc_ws(CSCMatrix *mat, double *RHS, double *X, double *alpha_rich, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws) {
+    poisson1D_int n = mat->n;
+    double *r = poisson1D_workspace_get(ws, 2 * (size_t)n);
+    *nbite = 0;
+    if (r == NULL) return;
+    poisson1D_timing_begin(POISSON1D_PHASE_ITER);
+    double *Ax = r + n;
     double norm_b = cblas_dnrm2(n, RHS, 1);
     
     if (norm_b == 0.0) norm_b = 1.0;
@@ -186,13 +539,12 @@ void richardson_alpha_csc(CSCMatrix *mat, double *RHS, double *X, double *alpha_
         // Check convergence
         double norm_r = cblas_dnrm2(n, r, 1);
         resvec[*nbite] = norm_r / norm_b;
+        poisson1D_timing_iteration(*nbite);
         if (resvec[*nbite] < *tol) break;
 
         // Update x: x = x + alpha * r
         cblas_daxpy(n, *alpha_rich, r, 1, X, 1);
     }
-
-    free(r);
-    free(Ax);
+    poisson1D_timing_end(POISSON1D_PHASE_ITER);
 }
 
@@ -0,0 +1,486 @@
+/**********************************************/
+/* lib_poisson1D_sparse.c                     */
+/* DIA and SELL-C-sigma sparse formats:       */
+/* conversion from CSR, SIMD SpMV kernels     */
+/* with runtime CPU dispatch, Richardson and  */
+/* Conjugate Gradient on top                  */
+/**********************************************/
+#include "lib_poisson1D.h"
+#include <string.h>
+#include <limits.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define POISSON1D_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define POISSON1D_X86_SIMD 0
+#endif
+
+#define DIA_BLOCK 1024  /* Rows per block of the scalar DIA kernel (y block stays in L1) */
+
+static int simd_level = -1;  // selected level, -1 until the first use
+
+int poisson1D_simd_detect(void){
+#if POISSON1D_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {return POISSON1D_SIMD_AVX512;}
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {return POISSON1D_SIMD_AVX2;}
+#endif
+  return POISSON1D_SIMD_SCALAR;
+}
+
+int poisson1D_simd_select(int *level){
+  int best = poisson1D_simd_detect();
+  simd_level = (*level < POISSON1D_SIMD_SCALAR) ? POISSON1D_SIMD_SCALAR : *level;
+  if (simd_level > best) {simd_level = best;}
+  return simd_level;
+}
+
+const char *poisson1D_simd_name(int level){
+  switch (level) {
+    case POISSON1D_SIMD_AVX2: return "avx2";
+    case POISSON1D_SIMD_AVX512: return "avx512";
+  }
+  return "scalar";
+}
+
+int poisson1D_simd_level(void){
+  if (simd_level < 0) {
+    int level = poisson1D_simd_detect();
+    char *env = getenv("POISSON1D_SIMD");
+    if (env != NULL) {
+      if (strcmp(env, "scalar") == 0) {level = POISSON1D_SIMD_SCALAR;}
+      else if (strcmp(env, "avx2") == 0) {level = POISSON1D_SIMD_AVX2;}
+      else if (strcmp(env, "avx512") == 0) {level = POISSON1D_SIMD_AVX512;}
+    }
+    poisson1D_simd_select(&level);
+  }
+  return simd_level;
+}
+
+int csr_to_dia(CSRMatrix *csr, DIAMatrix *dia){
+  poisson1D_int n = csr->n;
+  memset(dia, 0, sizeof(*dia));
+  dia->n = n;
+  if (n <= 0) {return 0;}
+  poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
+  // slot[k + n - 1] = 1 + index of the diagonal with offset k, 0 if absent
+  int *slot = (int *) calloc(2 * (size_t)n - 1, sizeof(int));
+  if (slot == NULL) {poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY); return -1;}
+  for (poisson1D_int i = 0; i < n; i++) {
+    for (poisson1D_int j = csr->row_ptr[i]; j < csr->row_ptr[i+1]; j++) {slot[csr->col_ind[j] - i + n - 1] = 1;}
+  }
+  int ndiag = 0;
+  for (poisson1D_int k = 0; k < 2 * n - 1; k++) {
+    if (slot[k]) {slot[k] = ++ndiag;}
+  }
+  if (ndiag > POISSON1D_DIA_MAX_DIAGS) {
+    fprintf(stderr, "csr_to_dia: %d diagonals, DIA storage limited to %d\n", ndiag, POISSON1D_DIA_MAX_DIAGS);
+    free(slot);
+    poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+    return -1;
+  }
+  dia->offsets = (int *) malloc((ndiag > 0 ? ndiag : 1) * sizeof(int));
+  dia->values = (double *) calloc((size_t)(ndiag > 0 ? ndiag : 1) * n, sizeof(double));
+  if (dia->offsets == NULL || dia->values == NULL) {
+    free(slot);
+    free_DIA_matrix(dia);
+    poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+    return -1;
+  }
+  dia->ndiag = ndiag;
+  for (poisson1D_int k = 0; k < 2 * n - 1; k++) {
+    if (slot[k]) {dia->offsets[slot[k] - 1] = (int) (k - (n - 1));}
+  }
+  for (poisson1D_int i = 0; i < n; i++) {
+    for (poisson1D_int j = csr->row_ptr[i]; j < csr->row_ptr[i+1]; j++) {
+      int d = slot[csr->col_ind[j] - i + n - 1] - 1;
+      dia->values[(size_t)d * n + i] += csr->values[j];
+    }
+  }
+  free(slot);
+  poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+  return 0;
+}
+
+static int cmp_long(const void *a, const void *b){
+  long long x = *(const long long *) a, y = *(const long long *) b;
+  return (x > y) - (x < y);
+}
+
+int csr_to_sell(CSRMatrix *csr, int *C, int *sigma, SELLMatrix *sell){
+  poisson1D_int n = csr->n;
+  int c = *C;
+  memset(sell, 0, sizeof(*sell));
+  if (c < 1 || *sigma < 1 || n < 0) {return -1;}
+  // SELL keeps 32-bit indices for the SIMD gathers
+  if (n > INT_MAX - c || csr->nnz > INT_MAX) {return -1;}
+  poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
+  sell->n = (int) n;
+  sell->C = c;
+  sell->sigma = *sigma;
+  sell->nnz = (int) csr->nnz;
+  sell->nslices = (int) ((n + c - 1) / c);
+  size_t nrows = (size_t) sell->nslices * c;
+
+  sell->perm = (int *) malloc((nrows > 0 ? nrows : 1) * sizeof(int));
+  sell->slice_ptr = (int *) malloc((sell->nslices + 1) * sizeof(int));
+  sell->slice_len = (int *) malloc((sell->nslices > 0 ? sell->nslices : 1) * sizeof(int));
+  long long *keys = (long long *) malloc((*sigma < n ? *sigma : (n > 0 ? n : 1)) * sizeof(long long));
+  if (sell->perm == NULL || sell->slice_ptr == NULL || sell->slice_len == NULL || keys == NULL) {
+    free(keys);
+    free_SELL_matrix(sell);
+    poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+    return -1;
+  }
+  for (size_t k = 0; k < nrows; k++) {sell->perm[k] = (k < (size_t) n) ? (int) k : -1;}
+
+  // Sort each window of sigma rows by decreasing length (ties keep the row order)
+  if (*sigma > 1) {
+    for (poisson1D_int w0 = 0; w0 < n; w0 += *sigma) {
+      poisson1D_int w1 = (w0 + *sigma < n) ? w0 + *sigma : n;
+      for (poisson1D_int i = w0; i < w1; i++) {
+        long long len = csr->row_ptr[i+1] - csr->row_ptr[i];
+        keys[i - w0] = ((long long) INT_MAX - len) << 32 | i;
+      }
+      qsort(keys, w1 - w0, sizeof(long long), cmp_long);
+      for (poisson1D_int i = w0; i < w1; i++) {sell->perm[i] = (int) (keys[i - w0] & 0xffffffffLL);}
+    }
+  }
+  free(keys);
+
+  long long total = 0;
+  sell->slice_ptr[0] = 0;
+  for (int s = 0; s < sell->nslices; s++) {
+    int width = 0;
+    for (int r = 0; r < c; r++) {
+      int row = sell->perm[(size_t)s * c + r];
+      if (row >= 0 && csr->row_ptr[row+1] - csr->row_ptr[row] > width) {width = (int) (csr->row_ptr[row+1] - csr->row_ptr[row]);}
+    }
+    sell->slice_len[s] = width;
+    total += (long long) width * c;
+    if (total > INT_MAX) {
+      free_SELL_matrix(sell);
+      poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+      return -1;
+    }
+    sell->slice_ptr[s+1] = (int) total;
+  }
+
+  sell->values = (double *) calloc(total > 0 ? total : 1, sizeof(double));
+  sell->col_ind = (int *) calloc(total > 0 ? total : 1, sizeof(int));
+  if (sell->values == NULL || sell->col_ind == NULL) {
+    free_SELL_matrix(sell);
+    poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+    return -1;
+  }
+  for (int s = 0; s < sell->nslices; s++) {
+    int base = sell->slice_ptr[s];
+    for (int r = 0; r < c; r++) {
+      int row = sell->perm[(size_t)s * c + r];
+      poisson1D_int len = (row >= 0) ? csr->row_ptr[row+1] - csr->row_ptr[row] : 0;
+      for (int j = 0; j < sell->slice_len[s]; j++) {
+        if (j < len) {
+          sell->values[base + j * c + r] = csr->values[csr->row_ptr[row] + j];
+          sell->col_ind[base + j * c + r] = (int) csr->col_ind[csr->row_ptr[row] + j];
+        } else {
+          // Padding: zero value, column of the row itself so the gather stays local
+          sell->col_ind[base + j * c + r] = (row >= 0) ? row : (int) n - 1;
+        }
+      }
+    }
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+  return 0;
+}
+
+void free_DIA_matrix(DIAMatrix *dia){
+  free(dia->values);
+  free(dia->offsets);
+  dia->values = NULL;
+  dia->offsets = NULL;
+  dia->ndiag = 0;
+}
+
+void free_SELL_matrix(SELLMatrix *sell){
+  free(sell->values);
+  free(sell->col_ind);
+  free(sell->slice_ptr);
+  free(sell->slice_len);
+  free(sell->perm);
+  sell->values = NULL;
+  sell->col_ind = NULL;
+  sell->slice_ptr = NULL;
+  sell->slice_len = NULL;
+  sell->perm = NULL;
+  sell->nslices = 0;
+}
+
+/* Row i of a DIA product, checking that every column is inside the matrix */
+static double dia_row(DIAMatrix *A, double *x, poisson1D_int i){
+  double sum = 0.0;
+  for (poisson1D_int d = 0; d < A->ndiag; d++) {
+    poisson1D_int j = i + A->offsets[d];
+    if (j >= 0 && j < A->n) {sum += A->values[(size_t)d * A->n + i] * x[j];}
+  }
+  return sum;
+}
+
+static void ddiamv_scalar(DIAMatrix *A, double *x, double *y, poisson1D_int lo, poisson1D_int hi){
+  for (poisson1D_int ib = lo; ib < hi; ib += DIA_BLOCK) {
+    poisson1D_int ie = (ib + DIA_BLOCK < hi) ? ib + DIA_BLOCK : hi;
+    for (poisson1D_int i = ib; i < ie; i++) {y[i] = 0.0;}
+    // One unit-stride pass per diagonal over a block of y
+    for (poisson1D_int d = 0; d < A->ndiag; d++) {
+      double *v = A->values + (size_t)d * A->n;
+      double *xd = x + A->offsets[d];
+      #pragma omp simd
+      for (poisson1D_int i = ib; i < ie; i++) {y[i] += v[i] * xd[i];}
+    }
+  }
+}
+
+#if POISSON1D_X86_SIMD
+__attribute__((target("avx2,fma")))
+static void ddiamv_avx2(DIAMatrix *A, double *x, double *y, poisson1D_int lo, poisson1D_int hi){
+  poisson1D_int i = lo;
+  for (; i + 4 <= hi; i += 4) {
+    __m256d acc = _mm256_setzero_pd();
+    for (poisson1D_int d = 0; d < A->ndiag; d++) {
+      __m256d v = _mm256_loadu_pd(A->values + (size_t)d * A->n + i);
+      acc = _mm256_fmadd_pd(v, _mm256_loadu_pd(x + i + A->offsets[d]), acc);
+    }
+    _mm256_storeu_pd(y + i, acc);
+  }
+  if (i < hi) {ddiamv_scalar(A, x, y, i, hi);}
+}
+
+__attribute__((target("avx512f")))
+static void ddiamv_avx512(DIAMatrix *A, double *x, double *y, poisson1D_int lo, poisson1D_int hi){
+  poisson1D_int i = lo;
+  for (; i + 8 <= hi; i += 8) {
+    __m512d acc = _mm512_setzero_pd();
+    for (poisson1D_int d = 0; d < A->ndiag; d++) {
+      __m512d v = _mm512_loadu_pd(A->values + (size_t)d * A->n + i);
+      acc = _mm512_fmadd_pd(v, _mm512_loadu_pd(x + i + A->offsets[d]), acc);
+    }
+    _mm512_storeu_pd(y + i, acc);
+  }
+  if (i < hi) {ddiamv_scalar(A, x, y, i, hi);}
+}
+#endif
+
+void ddiamv(DIAMatrix *mat, double *x, double *y){
+  poisson1D_int n = mat->n, lo = 0, hi = n;
+  // Interior rows [lo, hi): every diagonal stays inside the matrix, no bound checks
+  for (poisson1D_int d = 0; d < mat->ndiag; d++) {
+    int k = mat->offsets[d];
+    if (-k > lo) {lo = -k;}
+    if (n - k < hi) {hi = n - k;}
+  }
+  if (lo > hi) {lo = hi = n;}
+  for (poisson1D_int i = 0; i < lo; i++) {y[i] = dia_row(mat, x, i);}
+  for (poisson1D_int i = hi; i < n; i++) {y[i] = dia_row(mat, x, i);}
+  switch (poisson1D_simd_level()) {
+#if POISSON1D_X86_SIMD
+    case POISSON1D_SIMD_AVX512: ddiamv_avx512(mat, x, y, lo, hi); break;
+    case POISSON1D_SIMD_AVX2: ddiamv_avx2(mat, x, y, lo, hi); break;
+#endif
+    default: ddiamv_scalar(mat, x, y, lo, hi); break;
+  }
+}
+
+/* Rows r0 .. r0+nr-1 of slice s */
+static void dsellmv_scalar(SELLMatrix *A, double *x, double *y, int s, int r0, int nr){
+  int c = A->C, base = A->slice_ptr[s];
+  for (int r = r0; r < r0 + nr; r++) {
+    int row = A->perm[(size_t)s * c + r];
+    if (row < 0) continue;
+    double sum = 0.0;
+    for (int j = 0; j < A->slice_len[s]; j++) {
+      sum += A->values[base + j * c + r] * x[A->col_ind[base + j * c + r]];
+    }
+    y[row] = sum;
+  }
+}
+
+#if POISSON1D_X86_SIMD
+__attribute__((target("avx2,fma")))
+static void dsellmv_avx2(SELLMatrix *A, double *x, double *y){
+  int c = A->C;
+  double tmp[4];
+  for (int s = 0; s < A->nslices; s++) {
+    int base = A->slice_ptr[s];
+    int *perm = A->perm + (size_t)s * c;
+    for (int r = 0; r < c; r += 4) {
+      __m256d acc = _mm256_setzero_pd();
+      for (int j = 0; j < A->slice_len[s]; j++) {
+        __m128i idx = _mm_loadu_si128((__m128i *) (A->col_ind + base + j * c + r));
+        __m256d v = _mm256_loadu_pd(A->values + base + j * c + r);
+        acc = _mm256_fmadd_pd(v, _mm256_i32gather_pd(x, idx, 8), acc);
+      }
+      _mm256_storeu_pd(tmp, acc);
+      for (int t = 0; t < 4; t++) {
+        if (perm[r + t] >= 0) {y[perm[r + t]] = tmp[t];}
+      }
+    }
+  }
+}
+
+__attribute__((target("avx512f")))
+static void dsellmv_avx512(SELLMatrix *A, double *x, double *y){
+  int c = A->C;
+  double tmp[8];
+  for (int s = 0; s < A->nslices; s++) {
+    int base = A->slice_ptr[s];
+    int *perm = A->perm + (size_t)s * c;
+    for (int r = 0; r < c; r += 8) {
+      __m512d acc = _mm512_setzero_pd();
+      for (int j = 0; j < A->slice_len[s]; j++) {
+        __m256i idx = _mm256_loadu_si256((__m256i *) (A->col_ind + base + j * c + r));
+        __m512d v = _mm512_loadu_pd(A->values + base + j * c + r);
+        acc = _mm512_fmadd_pd(v, _mm512_i32gather_pd(idx, x, 8), acc);
+      }
+      _mm512_storeu_pd(tmp, acc);
+      for (int t = 0; t < 8; t++) {
+        if (perm[r + t] >= 0) {y[perm[r + t]] = tmp[t];}
+      }
+    }
+  }
+}
+#endif
+
+void dsellmv(SELLMatrix *mat, double *x, double *y){
+  int level = poisson1D_simd_level();
+#if POISSON1D_X86_SIMD
+  // The vector kernels need whole vectors per slice
+  if (level >= POISSON1D_SIMD_AVX512 && mat->C % 8 == 0) {dsellmv_avx512(mat, x, y); return;}
+  if (level >= POISSON1D_SIMD_AVX2 && mat->C % 4 == 0) {dsellmv_avx2(mat, x, y); return;}
+#endif
+  (void) level;
+  for (int s = 0; s < mat->nslices; s++) {dsellmv_scalar(mat, x, y, s, 0, mat->C);}
+}
+
+static void matvec_DIA(void *op, double *x, double *y){
+  ddiamv((DIAMatrix *) op, x, y);
+}
+
+static void matvec_SELL(void *op, double *x, double *y){
+  dsellmv((SELLMatrix *) op, x, y);
+}
+
+/* Richardson x = x + alpha (b - A x) on any operator, as richardson_alpha_csr_ws */
+static void richardson_alpha_op_ws(Poisson1DMatvec matvec, void *op, poisson1D_int n, double *RHS, double *X, double *alpha_rich, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws){
+  double *r = poisson1D_workspace_get(ws, 2 * (size_t)n);
+  *nbite = 0;
+  if (r == NULL) return;
+  poisson1D_timing_begin(POISSON1D_PHASE_ITER);
+  double *Ax = r + n;
+  double norm_b = cblas_dnrm2(n, RHS, 1);
+
+  if (norm_b == 0.0) norm_b = 1.0;
+
+  for (*nbite = 0; *nbite < *maxit; (*nbite)++) {
+    // r = b - A * x
+    matvec(op, X, Ax);
+    cblas_dcopy(n, RHS, 1, r, 1);
+    cblas_daxpy(n, -1.0, Ax, 1, r, 1);
+
+    resvec[*nbite] = cblas_dnrm2(n, r, 1) / norm_b;
+    poisson1D_timing_iteration(*nbite);
+    if (resvec[*nbite] < *tol) break;
+
+    cblas_daxpy(n, *alpha_rich, r, 1, X, 1);
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_ITER);
+}
+
+void richardson_alpha_dia(DIAMatrix *mat, double *RHS, double *X, double *alpha_rich, double *tol, int *maxit, double *resvec, int *nbite){
+  int method = POISSON1D_WS_CSR;
+  Poisson1DWorkspace *ws = poisson1D_workspace_create(&method, &mat->n);
+  richardson_alpha_dia_ws(mat, RHS, X, alpha_rich, tol, maxit, resvec, nbite, ws);
+  poisson1D_workspace_destroy(ws);
+}
+
+void richardson_alpha_dia_ws(DIAMatrix *mat, double *RHS, double *X, double *alpha_rich, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws){
+  richardson_alpha_op_ws(matvec_DIA, mat, mat->n, RHS, X, alpha_rich, tol, maxit, resvec, nbite, ws);
+}
+
+void richardson_alpha_sell(SELLMatrix *mat, double *RHS, double *X, double *alpha_rich, double *tol, int *maxit, double *resvec, int *nbite){
+  int method = POISSON1D_WS_CSR;
+  poisson1D_int n = mat->n;
+  Poisson1DWorkspace *ws = poisson1D_workspace_create(&method, &n);
+  richardson_alpha_sell_ws(mat, RHS, X, alpha_rich, tol, maxit, resvec, nbite, ws);
+  poisson1D_workspace_destroy(ws);
+}
+
+void richardson_alpha_sell_ws(SELLMatrix *mat, double *RHS, double *X, double *alpha_rich, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws){
+  richardson_alpha_op_ws(matvec_SELL, mat, mat->n, RHS, X, alpha_rich, tol, maxit, resvec, nbite, ws);
+}
+
+/* Inverse of the offset-0 diagonal of a DIA matrix (identity if the matrix has none) */
+static void diag_inv_dia(DIAMatrix *mat, double *Dinv){
+  for (poisson1D_int i = 0; i < mat->n; i++) {Dinv[i] = 1.0;}
+  for (poisson1D_int d = 0; d < mat->ndiag; d++) {
+    if (mat->offsets[d] != 0) continue;
+    for (poisson1D_int i = 0; i < mat->n; i++) {Dinv[i] = 1.0 / mat->values[(size_t)d * mat->n + i];}
+  }
+}
+
+/* Inverse of the diagonal entries of a SELL matrix, found through the row permutation */
+static void diag_inv_sell(SELLMatrix *mat, double *Dinv){
+  for (poisson1D_int i = 0; i < mat->n; i++) {Dinv[i] = 1.0;}
+  for (int s = 0; s < mat->nslices; s++) {
+    int base = mat->slice_ptr[s];
+    for (int r = 0; r < mat->C; r++) {
+      int row = mat->perm[(size_t)s * mat->C + r];
+      if (row < 0) continue;
+      for (int j = 0; j < mat->slice_len[s]; j++) {
+        double v = mat->values[base + j * mat->C + r];
+        if (mat->col_ind[base + j * mat->C + r] == row && v != 0.0) {Dinv[row] = 1.0 / v;}
+      }
+    }
+  }
+}
+
+void conjugate_gradient_dia(DIAMatrix *mat, double *RHS, double *X, int *jacobi, double *tol, int *maxit, double *resvec, int *nbite){
+  int method = POISSON1D_WS_CG;
+  Poisson1DWorkspace *ws = poisson1D_workspace_create(&method, &mat->n);
+  conjugate_gradient_dia_ws(mat, RHS, X, jacobi, tol, maxit, resvec, nbite, ws);
+  poisson1D_workspace_destroy(ws);
+}
+
+void conjugate_gradient_dia_ws(DIAMatrix *mat, double *RHS, double *X, int *jacobi, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws){
+  poisson1D_int n = mat->n;
+  *nbite = 0;
+  if (poisson1D_workspace_get(ws, 5 * (size_t)n) == NULL) {return;}
+  // The Jacobi diagonal lives after the 4 vectors of the engine
+  Poisson1DWorkspace engine = {ws->work, 4 * (size_t)n};
+  double *Dinv = NULL;
+  if (*jacobi) {
+    Dinv = ws->work + 4 * (size_t)n;
+    diag_inv_dia(mat, Dinv);
+  }
+  conjugate_gradient_op_ws(matvec_DIA, mat, Dinv, RHS, X, &n, tol, maxit, resvec, nbite, &engine);
+}
+
+void conjugate_gradient_sell(SELLMatrix *mat, double *RHS, double *X, int *jacobi, double *tol, int *maxit, double *resvec, int *nbite){
+  int method = POISSON1D_WS_CG;
+  poisson1D_int n = mat->n;
+  Poisson1DWorkspace *ws = poisson1D_workspace_create(&method, &n);
+  conjugate_gradient_sell_ws(mat, RHS, X, jacobi, tol, maxit, resvec, nbite, ws);
+  poisson1D_workspace_destroy(ws);
+}
+
+void conjugate_gradient_sell_ws(SELLMatrix *mat, double *RHS, double *X, int *jacobi, double *tol, int *maxit, double *resvec, int *nbite, Poisson1DWorkspace *ws){
+  poisson1D_int n = mat->n;
+  *nbite = 0;
+  if (poisson1D_workspace_get(ws, 5 * (size_t)n) == NULL) {return;}
+  Poisson1DWorkspace engine = {ws->work, 4 * (size_t)n};
+  double *Dinv = NULL;
+  if (*jacobi) {
+    Dinv = ws->work + 4 * (size_t)n;
+    diag_inv_sell(mat, Dinv);
+  }
+  conjugate_gradient_op_ws(matvec_SELL, mat, Dinv, RHS, X, &n, tol, maxit, resvec, nbite, &engine);
+}
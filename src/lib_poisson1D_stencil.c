@@ -0,0 +1,177 @@
+/**********************************************/
+/* lib_poisson1D_stencil.c                    */
+/* Constant-coefficient tridiagonal operator  */
+/* in O(1) storage: products, residual,       */
+/* preconditioners, Thomas with closed-form   */
+/* pivots                                     */
+/**********************************************/
+#include "lib_poisson1D.h"
+#include <limits.h>
+
+#define PIVOT_CONST 0    /* sub * sup = 0: every pivot is diag */
+#define PIVOT_DOUBLE 1   /* Double root r: d_i = r (i+2)/(i+1) */
+#define PIVOT_REAL 2     /* Real roots r1, r1 q, 0 < q < 1: d_i = r1 expm1((i+2) L) / expm1((i+1) L), L = log q */
+#define PIVOT_ALT 3      /* Real roots of opposite signs, q < 0: d_i = r1 (1 - q^{i+2}) / (1 - q^{i+1}) */
+#define PIVOT_COMPLEX 4  /* Complex roots rho e^{+-i theta}: d_i = rho sin((i+2) theta) / sin((i+1) theta) */
+
+/* Closed form of the pivots of tridiag(sub, diag, sup): d_i = D_{i+1} / D_i, D_k the leading
+   minors, which satisfy D_k = diag D_{k-1} - sub sup D_{k-2} */
+typedef struct {
+  int kind;
+  poisson1D_int kconv; // from this row on, q^{i+1} is below the rounding error and d_i = r1
+  double r1;     // dominant root (PIVOT_DOUBLE: the double root, PIVOT_COMPLEX: rho)
+  double inv_r1; // 1 / r1, pivot inverse of the converged rows
+  double c;      // L (PIVOT_REAL), q (PIVOT_ALT) or theta (PIVOT_COMPLEX)
+} StencilPivots;
+
+static void pivots_init(StencilOperator *A, StencilPivots *p){
+  double ss = A->sub * A->sup;
+  double disc = A->diag * A->diag - 4.0 * ss;
+  p->kconv = POISSON1D_INT_MAX;
+  p->c = 0.0;
+  if (ss == 0.0) {
+    p->kind = PIVOT_CONST;
+    p->r1 = A->diag;
+    p->kconv = 0;
+  } else if (disc == 0.0) {
+    p->kind = PIVOT_DOUBLE;
+    p->r1 = 0.5 * A->diag;
+  } else if (disc > 0.0) {
+    double s = sqrt(disc);
+    // Larger root without cancellation, q = r2 / r1 = ss / r1^2
+    p->r1 = 0.5 * (A->diag + copysign(s, A->diag));
+    if (ss > 0.0) {
+      // q = (|diag| - s) / (|diag| + s): log q = -2 atanh(s / |diag|), accurate when q -> 1
+      p->kind = PIVOT_REAL;
+      p->c = -2.0 * atanh(s / fabs(A->diag));
+    } else {
+      p->kind = PIVOT_ALT;
+      p->c = ss / (p->r1 * p->r1);
+    }
+    double lq = (p->kind == PIVOT_REAL) ? p->c : log(fabs(p->c));
+    if (lq < 0.0) {
+      double k = ceil(log(0.5 * DBL_EPSILON) / lq);
+      if (k < (double)POISSON1D_INT_MAX) {p->kconv = (poisson1D_int)k;}
+    }
+  } else {
+    p->kind = PIVOT_COMPLEX;
+    p->r1 = sqrt(ss);
+    p->c = atan2(sqrt(-disc), A->diag);
+  }
+  p->inv_r1 = 1.0 / p->r1;
+}
+
+/* 1 / d_i (infinite on a zero pivot) */
+static inline double inv_pivot(const StencilPivots *p, poisson1D_int i){
+  if (i >= p->kconv) {return p->inv_r1;}
+  double k = (double)i + 1.0;
+  switch (p->kind) {
+    case PIVOT_DOUBLE:
+      return k / ((k + 1.0) * p->r1);
+    case PIVOT_REAL:
+      return expm1(k * p->c) / (p->r1 * expm1((k + 1.0) * p->c));
+    case PIVOT_ALT:
+      return (1.0 - pow(p->c, k)) / (p->r1 * (1.0 - pow(p->c, k + 1.0)));
+    case PIVOT_COMPLEX:
+      return sin(k * p->c) / (p->r1 * sin((k + 1.0) * p->c));
+    default:
+      return p->inv_r1;
+  }
+}
+
+void set_stencil_operator_poisson1D(StencilOperator *A, poisson1D_int *la){
+  A->sub = -1.0;
+  A->diag = 2.0;
+  A->sup = -1.0;
+  A->n = *la;
+}
+
+void dstencilmv(StencilOperator *A, double *x, double *y){
+  poisson1D_int n = A->n;
+  double sub = A->sub, dg = A->diag, sup = A->sup;
+  if (n == 1) {y[0] = dg * x[0]; return;}
+  y[0] = dg * x[0] + sup * x[1];
+  #pragma omp parallel for simd schedule(static) if(n >= POISSON1D_SPMV_PAR_MIN)
+  for (poisson1D_int i = 1; i < n - 1; i++) {y[i] = sub * x[i - 1] + dg * x[i] + sup * x[i + 1];}
+  y[n - 1] = sub * x[n - 2] + dg * x[n - 1];
+}
+
+void matvec_stencil_op(void *op, double *x, double *y){
+  dstencilmv((StencilOperator *) op, x, y);
+}
+
+double dstencil_residual(StencilOperator *A, double *RHS, double *X, double *R){
+  poisson1D_int n = A->n;
+  double sub = A->sub, dg = A->diag, sup = A->sup;
+  if (n == 1) {R[0] = RHS[0] - dg * X[0]; return fabs(R[0]);}
+  R[0] = RHS[0] - dg * X[0] - sup * X[1];
+  R[n - 1] = RHS[n - 1] - sub * X[n - 2] - dg * X[n - 1];
+  double norm2 = R[0] * R[0] + R[n - 1] * R[n - 1];
+  #pragma omp parallel for simd schedule(static) reduction(+:norm2) if(n >= POISSON1D_SPMV_PAR_MIN)
+  for (poisson1D_int i = 1; i < n - 1; i++) {
+    R[i] = RHS[i] - sub * X[i - 1] - dg * X[i] - sup * X[i + 1];
+    norm2 += R[i] * R[i];
+  }
+  return sqrt(norm2);
+}
+
+void dstencil_jacobi(StencilOperator *A, double *R, double *Z){
+  double w = 1.0 / A->diag;
+  #pragma omp simd
+  for (poisson1D_int i = 0; i < A->n; i++) {Z[i] = w * R[i];}
+}
+
+void dstencil_gauss_seidel(StencilOperator *A, double *R, double *Z){
+  double w = 1.0 / A->diag, sub = A->sub;
+  double z = 0.0;
+  for (poisson1D_int i = 0; i < A->n; i++) {
+    z = (R[i] - sub * z) * w;
+    Z[i] = z;
+  }
+}
+
+int dstencil_eig(StencilOperator *A, double *eigmin, double *eigmax){
+  double ss = A->sub * A->sup;
+  if (ss <= 0.0) {return -1;}
+  // Similar to the symmetric tridiag(sqrt(ss), diag, sqrt(ss))
+  double t = 2.0 * sqrt(ss) * cos(M_PI / (A->n + 1));
+  *eigmin = A->diag - t;
+  *eigmax = A->diag + t;
+  return 0;
+}
+
+poisson1D_int dstencil_thomas(StencilOperator *A, poisson1D_int *nrhs, double *B, poisson1D_int *ldb, poisson1D_int *info){
+  *info = 0;
+  poisson1D_int n = A->n;
+  if (n <= 0) {return *info;}
+  poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+  StencilPivots p;
+  pivots_init(A, &p);
+  // Pivots of same-sign roots are all of the sign of r1; the others are checked once before
+  // B is touched (only the transient rows can vanish)
+  if (p.kind == PIVOT_CONST || p.kind == PIVOT_ALT || p.kind == PIVOT_COMPLEX) {
+    poisson1D_int last = (p.kconv < n) ? p.kconv + 1 : n;
+    for (poisson1D_int i = 0; i < last; i++) {
+      if (!isfinite(inv_pivot(&p, i))) {*info = i + 1; poisson1D_timing_end(POISSON1D_PHASE_SOLVE); return *info;}
+    }
+  }
+  double sub = A->sub, sup = A->sup;
+  for (poisson1D_int k = 0; k < *nrhs; k++) {
+    double *b = B + (size_t)k * (*ldb);
+    // L y = b, L(i, i-1) = sub / d_{i-1}; y overwrites b
+    double y = b[0];
+    for (poisson1D_int i = 1; i < n; i++) {
+      y = b[i] - sub * inv_pivot(&p, i - 1) * y;
+      b[i] = y;
+    }
+    // U x = y, U = bidiag(d_i, sup)
+    double x = b[n - 1] * inv_pivot(&p, n - 1);
+    b[n - 1] = x;
+    for (poisson1D_int i = n - 2; i >= 0; i--) {
+      x = (b[i] - sup * x) * inv_pivot(&p, i);
+      b[i] = x;
+    }
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+  return *info;
+}
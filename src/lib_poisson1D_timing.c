@@ -0,0 +1,248 @@
+/**********************************************/
+/* lib_poisson1D_timing.c                     */
+/* Per-phase wall-clock timing and optional   */
+/* hardware counters (perf_event_open) with a */
+/* JSON/CSV report                            */
+/**********************************************/
+#include "lib_poisson1D.h"
+#include <string.h>
+#include <time.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+static const char *phase_names[POISSON1D_NPHASES] = {"assembly", "precond", "factor", "solve", "iter", "write"};
+static const char *counter_names[POISSON1D_NCOUNTERS] = {"cycles", "instructions", "llc_misses"};
+
+/* Accumulated measurements of one phase */
+typedef struct {
+  long calls;                                 // number of begin/end pairs
+  long count;                                 // work items (iterations, right-hand sides)
+  double seconds;                             // accumulated wall-clock time
+  long long counters[POISSON1D_NCOUNTERS];    // accumulated counter deltas
+  struct timespec t0;                         // start of the open interval
+  long long c0[POISSON1D_NCOUNTERS];          // counter values at the start of the open interval
+} Poisson1DPhase;
+
+static Poisson1DPhase phases[POISSON1D_NPHASES];
+static int counter_fd[POISSON1D_NCOUNTERS] = {-1, -1, -1};
+static int ncounters = 0;
+static int active = 0;      // set by poisson1D_timing_init: the library entry points time themselves
+static int depth = 0;       // nesting of begin/end pairs: only the outermost one is timed
+static int open_phase = -1; // phase of the outermost open pair
+
+/* Iteration samples of the last outermost iterative phase: iteration index and time since its start.
+   When the buffer is full every other sample is dropped and the stride doubles. */
+static int sampling = 0;    // POISSON1D_TIMING set when the timers were initialized
+static long sample_it[POISSON1D_TIMING_SAMPLES];
+static double sample_t[POISSON1D_TIMING_SAMPLES];
+static int nsamples = 0;
+static long stride = 1;
+
+/* Timers are per process: calls made inside a parallel region are ignored */
+static int timing_off(void){
+#ifdef _OPENMP
+  if (omp_in_parallel()) {return 1;}
+#endif
+  return !active;
+}
+
+static double elapsed(struct timespec *t0, struct timespec *t1){
+  return (t1->tv_sec - t0->tv_sec) + (t1->tv_nsec - t0->tv_nsec) * 1.0e-9;
+}
+
+#ifdef __linux__
+static int open_counter(unsigned long long config){
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  // Calling thread only: OpenMP worker threads are not counted
+  return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+static void read_counters(long long *values){
+  for (int c = 0; c < POISSON1D_NCOUNTERS; c++) {
+    values[c] = 0;
+#ifdef __linux__
+    if (counter_fd[c] >= 0 && read(counter_fd[c], &values[c], sizeof(long long)) != sizeof(long long)) {
+      values[c] = 0;
+    }
+#endif
+  }
+}
+
+int poisson1D_timing_init(int *counters){
+  poisson1D_timing_finalize();
+  memset(phases, 0, sizeof(phases));
+  nsamples = 0;
+  stride = 1;
+  sampling = (getenv("POISSON1D_TIMING") != NULL);
+  active = 1;
+#ifdef __linux__
+  if (*counters) {
+    // LLC misses: the generic cache-miss event, which maps to the last level cache on x86
+    unsigned long long config[POISSON1D_NCOUNTERS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES};
+    for (int c = 0; c < POISSON1D_NCOUNTERS; c++) {
+      counter_fd[c] = open_counter(config[c]);
+      if (counter_fd[c] >= 0) {ncounters++;}
+    }
+  }
+#endif
+  return ncounters;
+}
+
+void poisson1D_timing_finalize(void){
+  for (int c = 0; c < POISSON1D_NCOUNTERS; c++) {
+#ifdef __linux__
+    if (counter_fd[c] >= 0) {close(counter_fd[c]);}
+#endif
+    counter_fd[c] = -1;
+  }
+  ncounters = 0;
+  active = 0;
+  depth = 0;
+  open_phase = -1;
+}
+
+void poisson1D_timing_begin(int phase){
+  if (timing_off() || depth++ > 0) return;
+  Poisson1DPhase *p = &phases[phase];
+  open_phase = phase;
+  if (phase == POISSON1D_PHASE_ITER) {
+    nsamples = 0;
+    stride = 1;
+  }
+  if (ncounters > 0) {read_counters(p->c0);}
+  clock_gettime(CLOCK_MONOTONIC, &p->t0);
+}
+
+void poisson1D_timing_end(int phase){
+  if (timing_off() || --depth > 0) return;
+  struct timespec t1;
+  long long c1[POISSON1D_NCOUNTERS];
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  // Nested pairs are accounted to the outermost phase
+  Poisson1DPhase *p = &phases[(open_phase >= 0) ? open_phase : phase];
+  if (ncounters > 0) {
+    read_counters(c1);
+    for (int c = 0; c < POISSON1D_NCOUNTERS; c++) {p->counters[c] += c1[c] - p->c0[c];}
+  }
+  p->seconds += elapsed(&p->t0, &t1);
+  p->calls++;
+  open_phase = -1;
+}
+
+void poisson1D_timing_iteration(long it){
+  if (!sampling || open_phase != POISSON1D_PHASE_ITER || timing_off() || it % stride != 0) return;
+  struct timespec t1;
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  if (nsamples == POISSON1D_TIMING_SAMPLES) {
+    for (int k = 0; 2 * k < nsamples; k++) {
+      sample_it[k] = sample_it[2 * k];
+      sample_t[k] = sample_t[2 * k];
+    }
+    nsamples = (nsamples + 1) / 2;
+    stride *= 2;
+    if (it % stride != 0) return;
+  }
+  sample_it[nsamples] = it;
+  sample_t[nsamples] = elapsed(&phases[POISSON1D_PHASE_ITER].t0, &t1);
+  nsamples++;
+}
+
+void poisson1D_timing_add_count(int phase, long count){
+  phases[phase].count += count;
+}
+
+double poisson1D_timing_seconds(int phase){
+  return phases[phase].seconds;
+}
+
+void poisson1D_timing_print(void){
+  printf("Phase times (ms):");
+  for (int k = 0; k < POISSON1D_NPHASES; k++) {
+    if (phases[k].calls > 0) {printf(" %s=%f", phase_names[k], phases[k].seconds * 1000.0);}
+  }
+  printf("\n");
+  if (phases[POISSON1D_PHASE_ITER].count > 0) {
+    printf("Time per iteration: %f us\n", phases[POISSON1D_PHASE_ITER].seconds * 1.0e6 / phases[POISSON1D_PHASE_ITER].count);
+  }
+}
+
+int poisson1D_timing_samples(long *it, double *seconds, int *max){
+  int m = (nsamples < *max) ? nsamples : *max;
+  for (int k = 0; k < m; k++) {
+    it[k] = sample_it[k];
+    seconds[k] = sample_t[k];
+  }
+  return m;
+}
+
+int poisson1D_timing_write(char *filename, char *driver, int *implem, poisson1D_int *n){
+  size_t len = strlen(filename);
+  int json = (len >= 5 && strcmp(filename + len - 5, ".json") == 0);
+  FILE *file;
+
+  if (json) {
+    file = fopen(filename, "w");
+    if (file == NULL) {perror(filename); return -1;}
+    fprintf(file, "{\n  \"driver\": \"%s\",\n  \"implem\": %d,\n  \"n\": %" POISSON1D_PRId ",\n  \"counters\": %s,\n  \"phases\": [\n",
+            driver, *implem, *n, (ncounters > 0) ? "true" : "false");
+    int first = 1;
+    for (int k = 0; k < POISSON1D_NPHASES; k++) {
+      Poisson1DPhase *p = &phases[k];
+      if (p->calls == 0) continue;
+      fprintf(file, "%s    {\"phase\": \"%s\", \"calls\": %ld, \"count\": %ld, \"seconds\": %.9e",
+              first ? "" : ",\n", phase_names[k], p->calls, p->count, p->seconds);
+      for (int c = 0; c < POISSON1D_NCOUNTERS; c++) {
+        if (counter_fd[c] >= 0) {fprintf(file, ", \"%s\": %lld", counter_names[c], p->counters[c]);}
+      }
+      fprintf(file, "}");
+      first = 0;
+    }
+    fprintf(file, "\n  ]");
+    // Cumulative time of the last iterative solve at the sampled iterations
+    if (nsamples > 0) {
+      fprintf(file, ",\n  \"iterations\": {\"stride\": %ld, \"samples\": [", stride);
+      for (int k = 0; k < nsamples; k++) {
+        fprintf(file, "%s[%ld, %.9e]", (k > 0) ? ", " : "", sample_it[k], sample_t[k]);
+      }
+      fprintf(file, "]}");
+    }
+    fprintf(file, "\n}\n");
+  } else {
+    // CSV is appended so that a benchmark sweep collects every run in one file
+    file = fopen(filename, "a");
+    if (file == NULL) {perror(filename); return -1;}
+    fseek(file, 0, SEEK_END);
+    if (ftell(file) == 0) {
+      fprintf(file, "driver,implem,n,phase,calls,count,seconds,cycles,instructions,llc_misses\n");
+    }
+    for (int k = 0; k < POISSON1D_NPHASES; k++) {
+      Poisson1DPhase *p = &phases[k];
+      if (p->calls == 0) continue;
+      fprintf(file, "%s,%d,%" POISSON1D_PRId ",%s,%ld,%ld,%.9e", driver, *implem, *n, phase_names[k], p->calls, p->count, p->seconds);
+      // Empty fields for counters that could not be opened
+      for (int c = 0; c < POISSON1D_NCOUNTERS; c++) {
+        if (counter_fd[c] >= 0) {fprintf(file, ",%lld", p->counters[c]);} else {fprintf(file, ",");}
+      }
+      fprintf(file, "\n");
+    }
+    // One "iteration" line per sample: count = iteration index, seconds = time since the solve started
+    for (int k = 0; k < nsamples; k++) {
+      fprintf(file, "%s,%d,%" POISSON1D_PRId ",iteration,1,%ld,%.9e,,,\n", driver, *implem, *n, sample_it[k], sample_t[k]);
+    }
+  }
+  if (fclose(file) != 0) {perror(filename); return -1;}
+  return 0;
+}
@@ -0,0 +1,49 @@
+/**********************************************/
+/* lib_poisson1D_workspace.c                  */
+/* Caller-owned scratch space for the         */
+/* iterative solvers and norms, so repeated   */
+/* solves do not allocate                     */
+/**********************************************/
+#include "lib_poisson1D.h"
+
+size_t poisson1D_workspace_query(int *method, poisson1D_int *la){
+  size_t n = (*la > 0) ? (size_t)(*la) : 0;
+  switch (*method) {
+    case POISSON1D_WS_RICHARDSON: return n;      // r
+    case POISSON1D_WS_RICHARDSON_MB: return 2 * n; // r, z
+    case POISSON1D_WS_REDBLACK: return n;        // z
+    case POISSON1D_WS_CSR:
+    case POISSON1D_WS_CSC: return 2 * n;         // r, Ax
+    case POISSON1D_WS_CG: return 5 * n;          // r, p, q, z, Dinv (Jacobi wrappers)
+    case POISSON1D_WS_CHEBYSHEV: return 4 * n;   // r, d, q, Dinv (Jacobi wrappers)
+    case POISSON1D_WS_NORM: return n;            // x - y
+    case POISSON1D_WS_ALL: return 5 * n;
+  }
+  return 0;
+}
+
+Poisson1DWorkspace *poisson1D_workspace_create(int *method, poisson1D_int *la){
+  Poisson1DWorkspace *ws = (Poisson1DWorkspace *) malloc(sizeof(Poisson1DWorkspace));
+  if (ws == NULL) {return NULL;}
+  ws->size = poisson1D_workspace_query(method, la);
+  ws->work = (double *) malloc((ws->size > 0 ? ws->size : 1) * sizeof(double));
+  if (ws->work == NULL) {
+    free(ws);
+    return NULL;
+  }
+  return ws;
+}
+
+void poisson1D_workspace_destroy(Poisson1DWorkspace *ws){
+  if (ws == NULL) {return;}
+  free(ws->work);
+  free(ws);
+}
+
+double *poisson1D_workspace_get(Poisson1DWorkspace *ws, size_t size){
+  if (ws == NULL || ws->size < size) {
+    fprintf(stderr, "poisson1D: workspace too small (%zu doubles needed)\n", size);
+    return NULL;
+  }
+  return ws->work;
+}
@@ -4,8 +4,14 @@
 /* Poisson problem (Heat equation)            */
 /**********************************************/
 #include "lib_poisson1D.h"
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
-void write_GB_operator_rowMajor_poisson1D(double* AB, int* lab, int* la, char* filename){
+void write_GB_operator_rowMajor_poisson1D(double* AB, poisson1D_int* lab, poisson1D_int* la, char* filename){
+  poisson1D_timing_begin(POISSON1D_PHASE_WRITE);
   FILE * file;
   int ii,jj;
   file = fopen(filename, "w");
@@ -22,9 +28,11 @@ void write_GB_operator_rowMajor_poisson1D(double* AB, int* lab, int* la, char* f
   else{
     perror(filename);
   }
+  poisson1D_timing_end(POISSON1D_PHASE_WRITE);
 }
 
-void write_GB_operator_colMajor_poisson1D(double* AB, int* lab, int* la, char* filename){
+void write_GB_operator_colMajor_poisson1D(double* AB, poisson1D_int* lab, poisson1D_int* la, char* filename){
+  poisson1D_timing_begin(POISSON1D_PHASE_WRITE);
   FILE * file;
   int ii,jj;
   file = fopen(filename, "w");
@@ -41,9 +49,11 @@ void write_GB_operator_colMajor_poisson1D(double* AB, int* lab, int* la, char* f
   else{
     perror(filename);
   }
+  poisson1D_timing_end(POISSON1D_PHASE_WRITE);
 }
 
-void write_GB2AIJ_operator_poisson1D(double* AB, int* la, char* filename){
+void write_GB2AIJ_operator_poisson1D(double* AB, poisson1D_int* la, char* filename){
+  poisson1D_timing_begin(POISSON1D_PHASE_WRITE);
   FILE * file;
   int jj;
   file = fopen(filename, "w");
@@ -63,9 +73,29 @@ void write_GB2AIJ_operator_poisson1D(double* AB, int* la, char* filename){
   else{
     perror(filename);
   }
+  poisson1D_timing_end(POISSON1D_PHASE_WRITE);
 }
 
-void write_vec(double* vec, int* la, char* filename){
+void write_tridiag_operator_poisson1D(TriDiagMatrix *mat, char* filename){
+  poisson1D_timing_begin(POISSON1D_PHASE_WRITE);
+  FILE * file;
+  int jj;
+  file = fopen(filename, "w");
+  // One row per line: sub-diagonal (0 on first row), diagonal, super-diagonal (0 on last row)
+  if (file != NULL){
+    for (jj=0;jj<mat->n;jj++){
+      fprintf(file,"%lf\t%lf\t%lf\n",(jj>0)?mat->dl[jj-1]:0.0,mat->d[jj],(jj<mat->n-1)?mat->du[jj]:0.0);
+    }
+    fclose(file);
+  }
+  else{
+    perror(filename);
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_WRITE);
+}
+
+void write_vec(double* vec, poisson1D_int* la, char* filename){
+  poisson1D_timing_begin(POISSON1D_PHASE_WRITE);
   int jj;
   FILE * file;
   file = fopen(filename, "w");
@@ -79,9 +109,11 @@ void write_vec(double* vec, int* la, char* filename){
   else{
     perror(filename);
   } 
+  poisson1D_timing_end(POISSON1D_PHASE_WRITE);
 }  
 
-void write_xy(double* vec, double* x, int* la, char* filename){
+void write_xy(double* vec, double* x, poisson1D_int* la, char* filename){
+  poisson1D_timing_begin(POISSON1D_PHASE_WRITE);
   int jj;
   FILE * file;
   file = fopen(filename, "w");
@@ -95,4 +127,143 @@ void write_xy(double* vec, double* x, int* la, char* filename){
   else{
     perror(filename);
   } 
+  poisson1D_timing_end(POISSON1D_PHASE_WRITE);
 }  
+
+_Static_assert(sizeof(Poisson1DBinHeader) == POISSON1D_BIN_HEADER_SIZE, "binary header must be 64 bytes");
+
+static void set_bin_header(Poisson1DBinHeader *hdr, int type, int64_t rows, int64_t cols){
+  memset(hdr, 0, sizeof(*hdr));
+  memcpy(hdr->magic, POISSON1D_BIN_MAGIC, sizeof(hdr->magic));
+  hdr->version = POISSON1D_BIN_VERSION;
+  hdr->type = type;
+  hdr->layout = POISSON1D_BIN_COLMAJOR;
+  hdr->elem_size = sizeof(double);
+  hdr->rows = rows;
+  hdr->cols = cols;
+}
+
+/* Open filename and write the header; the caller writes the data and closes the file */
+static FILE *open_bin(Poisson1DBinHeader *hdr, char* filename){
+  FILE * file = fopen(filename, "wb");
+  if (file == NULL){
+    perror(filename);
+    return NULL;
+  }
+  if (fwrite(hdr, sizeof(*hdr), 1, file) != 1){
+    perror(filename);
+    fclose(file);
+    return NULL;
+  }
+  return file;
+}
+
+static void close_bin(FILE *file, int ok, char* filename){
+  if (fclose(file) != 0) ok = 0;
+  if (!ok) perror(filename);
+}
+
+void write_vec_bin(double* vec, poisson1D_int* la, char* filename){
+  poisson1D_timing_begin(POISSON1D_PHASE_WRITE);
+  Poisson1DBinHeader hdr;
+  set_bin_header(&hdr, POISSON1D_BIN_VEC, *la, 1);
+  FILE * file = open_bin(&hdr, filename);
+  if (file != NULL){
+    close_bin(file, fwrite(vec, sizeof(double), *la, file) == (size_t)(*la), filename);
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_WRITE);
+}
+
+void write_xy_bin(double* vec, double* x, poisson1D_int* la, char* filename){
+  poisson1D_timing_begin(POISSON1D_PHASE_WRITE);
+  Poisson1DBinHeader hdr;
+  set_bin_header(&hdr, POISSON1D_BIN_XY, *la, 2);
+  FILE * file = open_bin(&hdr, filename);
+  if (file != NULL){
+    int ok = fwrite(x, sizeof(double), *la, file) == (size_t)(*la);
+    ok = ok && fwrite(vec, sizeof(double), *la, file) == (size_t)(*la);
+    close_bin(file, ok, filename);
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_WRITE);
+}
+
+void write_GB_operator_colMajor_poisson1D_bin(double* AB, poisson1D_int* lab, poisson1D_int* la, poisson1D_int *kl, poisson1D_int *ku, poisson1D_int *kv, char* filename){
+  poisson1D_timing_begin(POISSON1D_PHASE_WRITE);
+  Poisson1DBinHeader hdr;
+  size_t count = (size_t)(*lab) * (*la);
+  set_bin_header(&hdr, POISSON1D_BIN_GB, *lab, *la);
+  hdr.kl = (int32_t)(*kl);
+  hdr.ku = (int32_t)(*ku);
+  hdr.kv = (int32_t)(*kv);
+  hdr.lab = (int32_t)(*lab);
+  FILE * file = open_bin(&hdr, filename);
+  if (file != NULL){
+    close_bin(file, fwrite(AB, sizeof(double), count, file) == count, filename);
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_WRITE);
+}
+
+void write_tridiag_operator_poisson1D_bin(TriDiagMatrix *mat, char* filename){
+  poisson1D_timing_begin(POISSON1D_PHASE_WRITE);
+  Poisson1DBinHeader hdr;
+  size_t n = mat->n, m = (n > 0) ? n - 1 : 0;
+  double zero = 0.0;
+  set_bin_header(&hdr, POISSON1D_BIN_TRIDIAG, mat->n, 3);
+  FILE * file = open_bin(&hdr, filename);
+  if (file != NULL){
+    // Same padding as the text writer: dl[-1] = 0, du[n-1] = 0
+    int ok = (n == 0) || fwrite(&zero, sizeof(double), 1, file) == 1;
+    ok = ok && fwrite(mat->dl, sizeof(double), m, file) == m;
+    ok = ok && fwrite(mat->d, sizeof(double), n, file) == n;
+    ok = ok && fwrite(mat->du, sizeof(double), m, file) == m;
+    ok = ok && ((n == 0) || fwrite(&zero, sizeof(double), 1, file) == 1);
+    close_bin(file, ok, filename);
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_WRITE);
+}
+
+int poisson1D_bin_map(char* filename, Poisson1DBinFile *file){
+  struct stat st;
+  memset(file, 0, sizeof(*file));
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0){
+    perror(filename);
+    return -1;
+  }
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Poisson1DBinHeader)){
+    fprintf(stderr, "%s: not a poisson1D binary file\n", filename);
+    close(fd);
+    return -1;
+  }
+  void *base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);  // the mapping keeps the file referenced
+  if (base == MAP_FAILED){
+    perror(filename);
+    return -1;
+  }
+  memcpy(&file->hdr, base, sizeof(Poisson1DBinHeader));
+  Poisson1DBinHeader *hdr = &file->hdr;
+  size_t need = sizeof(Poisson1DBinHeader) + (size_t)hdr->rows * (size_t)hdr->cols * sizeof(double);
+  if (memcmp(hdr->magic, POISSON1D_BIN_MAGIC, sizeof(hdr->magic)) != 0 || hdr->version != POISSON1D_BIN_VERSION
+      || hdr->elem_size != sizeof(double) || hdr->rows < 0 || hdr->cols < 0 || (size_t)st.st_size < need){
+    fprintf(stderr, "%s: invalid or truncated poisson1D binary file\n", filename);
+    munmap(base, (size_t)st.st_size);
+    return -1;
+  }
+  file->base = base;
+  file->len = (size_t)st.st_size;
+  file->data = (double *)((char *)base + sizeof(Poisson1DBinHeader));
+  return 0;
+}
+
+void poisson1D_bin_unmap(Poisson1DBinFile *file){
+  if (file->base != NULL){
+    munmap(file->base, file->len);
+  }
+  memset(file, 0, sizeof(*file));
+}
+
+int poisson1D_output_text(void){
+  const char *mode = getenv("POISSON1D_OUTPUT");
+  return mode != NULL && strcmp(mode, "text") == 0;
+}
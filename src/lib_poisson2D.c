@@ -0,0 +1,290 @@
+/**********************************************/
+/* lib_poisson2D.c                            */
+/* 2D five-point Poisson operator (CSR) and   */
+/* alternating-direction-implicit solver      */
+/* built on the 1D tridiagonal elimination    */
+/**********************************************/
+#include "lib_poisson1D.h"
+#include <string.h>
+#include <float.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define ADI_TILE 32 /* Tile edge of the blocked transposes (two 8 KiB tiles stay in L1) */
+#define ADI_LINE_BLOCK 64 /* Lines per work item of the line solves (SIMD lanes across lines) */
+
+void set_CSR_operator_poisson2D(CSRMatrix *mat, poisson1D_int *nx, poisson1D_int *ny) {
+  poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
+  poisson1D_int mx = *nx, my = *ny;
+  mat->nnz = 0;
+  mat->values = NULL; mat->col_ind = NULL; mat->row_ptr = NULL;
+  if (!poisson1D_index_fits(mx, my) || !poisson1D_index_fits(5, mx * my)) {
+    // nx*ny or 5n - 2nx - 2ny would wrap around: the operator is left empty
+    fprintf(stderr, "poisson2D: %" POISSON1D_PRId "x%" POISSON1D_PRId " grid overflows the index type (build with ILP64=1)\n", mx, my);
+    mat->n = 0;
+    poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+    return;
+  }
+  poisson1D_int n = mx * my;
+  mat->n = n;
+  mat->nnz = 5 * n - 2 * mx - 2 * my; // Five-point stencil minus the missing boundary neighbours
+  mat->values = (double *)poisson1D_malloc(mat->nnz, 1, sizeof(double));
+  mat->col_ind = (poisson1D_int *)poisson1D_malloc(mat->nnz, 1, sizeof(poisson1D_int));
+  mat->row_ptr = (poisson1D_int *)poisson1D_malloc(n + 1, 1, sizeof(poisson1D_int));
+  if (mat->values == NULL || mat->col_ind == NULL || mat->row_ptr == NULL) {
+    perror("set_CSR_operator_poisson2D");
+    free(mat->values); free(mat->col_ind); free(mat->row_ptr);
+    mat->values = NULL; mat->col_ind = NULL; mat->row_ptr = NULL;
+    mat->nnz = 0;
+    poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+    return;
+  }
+
+  poisson1D_int count = 0;
+  mat->row_ptr[0] = 0;
+
+  // Row k = i + j * nx, columns in increasing order
+  for (poisson1D_int j = 0; j < my; j++) {
+    for (poisson1D_int i = 0; i < mx; i++) {
+      poisson1D_int k = i + j * mx;
+      if (j > 0) {mat->values[count] = -1.0; mat->col_ind[count] = k - mx; count++;}
+      if (i > 0) {mat->values[count] = -1.0; mat->col_ind[count] = k - 1; count++;}
+      mat->values[count] = 4.0;
+      mat->col_ind[count] = k;
+      count++;
+      if (i < mx - 1) {mat->values[count] = -1.0; mat->col_ind[count] = k + 1; count++;}
+      if (j < my - 1) {mat->values[count] = -1.0; mat->col_ind[count] = k + mx; count++;}
+      mat->row_ptr[k + 1] = count;
+    }
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+}
+
+void set_dense_RHS_poisson2D(double *RHS, poisson1D_int *nx, poisson1D_int *ny){
+  poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
+  // u = x (Lx - x) y (Ly - y) on (0, Lx) x (0, Ly), h = 1/(nx+1): -lap u = 2 (x (Lx - x) + y (Ly - y))
+  double h = 1.0 / (*nx + 1);
+  double lx = (*nx + 1) * h, ly = (*ny + 1) * h;
+  for (poisson1D_int j = 0; j < *ny; j++) {
+    double y = (j + 1) * h;
+    for (poisson1D_int i = 0; i < *nx; i++) {
+      double x = (i + 1) * h;
+      RHS[i + (size_t)j * (*nx)] = 2.0 * h * h * (x * (lx - x) + y * (ly - y));
+    }
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+}
+
+void set_analytical_solution_poisson2D(double *EX_SOL, poisson1D_int *nx, poisson1D_int *ny){
+  poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
+  // Quadratic along each direction: the five-point stencil is exact, so is the discrete solution
+  double h = 1.0 / (*nx + 1);
+  double lx = (*nx + 1) * h, ly = (*ny + 1) * h;
+  for (poisson1D_int j = 0; j < *ny; j++) {
+    double y = (j + 1) * h;
+    for (poisson1D_int i = 0; i < *nx; i++) {
+      double x = (i + 1) * h;
+      EX_SOL[i + (size_t)j * (*nx)] = x * (lx - x) * y * (ly - y);
+    }
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+}
+
+void dtranspose_blocked(poisson1D_int *nr, poisson1D_int *nc, double *A, double *B){
+  poisson1D_int m = *nr, n = *nc;
+  #pragma omp parallel for collapse(2) schedule(static) if((size_t)m * n >= POISSON1D_SPMV_PAR_MIN)
+  for (poisson1D_int jb = 0; jb < n; jb += ADI_TILE) {
+    for (poisson1D_int ib = 0; ib < m; ib += ADI_TILE) {
+      poisson1D_int je = (jb + ADI_TILE < n) ? jb + ADI_TILE : n;
+      poisson1D_int ie = (ib + ADI_TILE < m) ? ib + ADI_TILE : m;
+      for (poisson1D_int j = jb; j < je; j++) {
+        for (poisson1D_int i = ib; i < ie; i++) {B[j + (size_t)i * n] = A[i + (size_t)j * m];}
+      }
+    }
+  }
+}
+
+/*
+ * r = b - A u for the five-point operator on an n1 x n2 grid stored with index i1 + i2 n1 (zero
+ * outside), written transposed (index i2 + i1 n2) together with the transposed iterate ut: the
+ * residual of an ADI half-step fused with the blocked transpose that makes the next lines
+ * unit-stride across lines. Returns ||r||^2.
+ */
+static double residual_transpose(poisson1D_int n1, poisson1D_int n2, double *u, double *b, double *rt, double *ut){
+  double s2 = 0.0;
+  #pragma omp parallel for collapse(2) schedule(static) reduction(+:s2) if((size_t)n1 * n2 >= POISSON1D_SPMV_PAR_MIN)
+  for (poisson1D_int jb = 0; jb < n2; jb += ADI_TILE) {
+    for (poisson1D_int ib = 0; ib < n1; ib += ADI_TILE) {
+      poisson1D_int je = (jb + ADI_TILE < n2) ? jb + ADI_TILE : n2;
+      poisson1D_int ie = (ib + ADI_TILE < n1) ? ib + ADI_TILE : n1;
+      poisson1D_int m = ie - ib;
+      double tr[ADI_TILE][ADI_TILE], tu[ADI_TILE][ADI_TILE];  // transposed tiles, stored row by row
+      for (poisson1D_int j = jb; j < je; j++) {
+        double v[ADI_TILE];
+        double *uj = u + (size_t)j * n1 + ib;
+        double *bj = b + (size_t)j * n1 + ib;
+        // Unit-stride residual of one tile row, boundary neighbours handled outside the loops
+        #pragma omp simd
+        for (poisson1D_int i = 0; i < m; i++) {v[i] = bj[i] - 4.0 * uj[i];}
+        if (j > 0) {
+          double *um = uj - n1;
+          #pragma omp simd
+          for (poisson1D_int i = 0; i < m; i++) {v[i] += um[i];}
+        }
+        if (j < n2 - 1) {
+          double *up = uj + n1;
+          #pragma omp simd
+          for (poisson1D_int i = 0; i < m; i++) {v[i] += up[i];}
+        }
+        poisson1D_int lo = (ib == 0) ? 1 : 0, hi = (ie == n1) ? m - 1 : m;
+        #pragma omp simd
+        for (poisson1D_int i = lo; i < m; i++) {v[i] += uj[i - 1];}
+        #pragma omp simd
+        for (poisson1D_int i = 0; i < hi; i++) {v[i] += uj[i + 1];}
+        for (poisson1D_int i = 0; i < m; i++) {
+          tr[i][j - jb] = v[i];
+          tu[i][j - jb] = uj[i];
+          s2 += v[i] * v[i];
+        }
+      }
+      // Contiguous stores of the transposed tiles
+      for (poisson1D_int i = 0; i < m; i++) {
+        memcpy(rt + jb + (size_t)(ib + i) * n2, tr[i], sizeof(double) * (je - jb));
+        memcpy(ut + jb + (size_t)(ib + i) * n2, tu[i], sizeof(double) * (je - jb));
+      }
+    }
+  }
+  return s2;
+}
+
+/*
+ * Solve the same tridiagonal system (factors of dgttrftridiag: multipliers l, reciprocal pivots
+ * dinv, super-diagonal du) for the K interleaved lines of B (element i of line b at i K + b),
+ * and add the solutions to U. Blocks of ADI_LINE_BLOCK lines are distributed over the threads.
+ */
+static void line_solve_add(poisson1D_int n, poisson1D_int K, double *l, double *dinv, double *du, double *B, double *U){
+  poisson1D_int nblocks = (K + ADI_LINE_BLOCK - 1) / ADI_LINE_BLOCK;
+  #pragma omp parallel for schedule(static) if((size_t)n * K >= POISSON1D_SPMV_PAR_MIN)
+  for (poisson1D_int blk = 0; blk < nblocks; blk++) {
+    poisson1D_int b0 = blk * ADI_LINE_BLOCK;
+    poisson1D_int m = (K - b0 < ADI_LINE_BLOCK) ? K - b0 : ADI_LINE_BLOCK;
+    for (poisson1D_int i = 1; i < n; i++) {
+      double li = l[i - 1];
+      double *bi = B + (size_t)i * K + b0;
+      double *bp = bi - K;
+      #pragma omp simd
+      for (poisson1D_int b = 0; b < m; b++) {bi[b] -= li * bp[b];}
+    }
+    double *bl = B + (size_t)(n - 1) * K + b0;
+    double *ul = U + (size_t)(n - 1) * K + b0;
+    double dl = dinv[n - 1];
+    #pragma omp simd
+    for (poisson1D_int b = 0; b < m; b++) {
+      bl[b] *= dl;
+      ul[b] += bl[b];
+    }
+    for (poisson1D_int i = n - 2; i >= 0; i--) {
+      double ui = du[i], di = dinv[i];
+      double *bi = B + (size_t)i * K + b0;
+      double *bn = bi + K;
+      double *xi = U + (size_t)i * K + b0;
+      #pragma omp simd
+      for (poisson1D_int b = 0; b < m; b++) {
+        bi[b] = (bi[b] - ui * bn[b]) * di;
+        xi[b] += bi[b];
+      }
+    }
+  }
+}
+
+/* Factors of T + rho I of order n (dgttrftridiag), stored as l | dinv | du (3n values) */
+static void shifted_factors(poisson1D_int n, double rho, double *f){
+  double *l = f, *d = f + n, *du = f + 2 * (size_t)n;
+  poisson1D_int info;  // T + rho I is diagonally dominant for rho > 0: no zero pivot
+  for (poisson1D_int i = 0; i < n; i++) {
+    l[i] = -1.0;
+    d[i] = 2.0 + rho;
+    du[i] = -1.0;
+  }
+  dgttrftridiag(&n, l, d, du, &info);
+  for (poisson1D_int i = 0; i < n; i++) {d[i] = 1.0 / d[i];}
+}
+
+int adi_poisson2D_nshifts(poisson1D_int *nx, poisson1D_int *ny){
+  poisson1D_int nmax = (*nx > *ny) ? *nx : *ny, nmin = (*nx < *ny) ? *nx : *ny;
+  double a = 2.0 - 2.0 * cos(M_PI / (nmax + 1));
+  double b = 2.0 + 2.0 * cos(M_PI / (nmin + 1));
+  // Error reduced by about one digit per shift cycle with J ~ log(b/a) / 2 geometric shifts
+  int J = (int) ceil(0.5 * log(b / a));
+  return (J < 1) ? 1 : J;
+}
+
+void adi_poisson2D(double *RHS, double *X, poisson1D_int *nx, poisson1D_int *ny, int *nshifts, double *tol, int *maxit, double *resvec, int *nbite){
+  poisson1D_int mx = *nx, my = *ny;
+  *nbite = 0;
+  if (!poisson1D_index_fits(mx, my)) {
+    fprintf(stderr, "poisson2D: %" POISSON1D_PRId "x%" POISSON1D_PRId " grid overflows the index type (build with ILP64=1)\n", mx, my);
+    return;
+  }
+  poisson1D_int n = mx * my;
+  int J = (*nshifts > 0) ? *nshifts : adi_poisson2D_nshifts(nx, ny);
+
+  // Spectrum of the 1D operators: [a, b], shared by H = I (x) T_x and V = T_y (x) I
+  poisson1D_int nmax = (mx > my) ? mx : my, nmin = (mx < my) ? mx : my;
+  double a = 2.0 - 2.0 * cos(M_PI / (nmax + 1));
+  double b = 2.0 + 2.0 * cos(M_PI / (nmin + 1));
+
+  double *w = (double *) malloc(sizeof(double) * 3 * (size_t)n);
+  double *shifts = (double *) malloc(sizeof(double) * J);
+  double *fx = (double *) malloc(sizeof(double) * 3 * (size_t)mx * J);
+  double *fy = (double *) malloc(sizeof(double) * 3 * (size_t)my * J);
+  if (w == NULL || shifts == NULL || fx == NULL || fy == NULL) {
+    free(w); free(shifts); free(fx); free(fy);
+    return;
+  }
+  double *r = w;                  // residual, then correction (layout of the lines being solved)
+  double *half = w + n;           // half-step iterate in the x-lines layout (index j + i ny)
+  double *bt = w + 2 * (size_t)n; // right-hand side in the x-lines layout
+  poisson1D_timing_begin(POISSON1D_PHASE_ITER);
+
+  // Geometric shifts between a and b, one factorization per shift and direction
+  for (poisson1D_int s = 0; s < J; s++) {
+    shifts[s] = a * pow(b / a, (s + 0.5) / J);
+    shifted_factors(mx, shifts[s], fx + 3 * (size_t)mx * s);
+    shifted_factors(my, shifts[s], fy + 3 * (size_t)my * s);
+  }
+  dtranspose_blocked(nx, ny, RHS, bt);
+
+  double norm_b = cblas_dnrm2(n, RHS, 1);
+  if (norm_b == 0.0) {norm_b = 1.0;}
+
+  // Correction form: the line solves act on residuals, so rounding errors scale with the
+  // residual rather than with the iterate
+  double cycle_res = DBL_MAX;
+  for (*nbite = 0; *nbite < *maxit; (*nbite)++) {
+    int s = *nbite % J;
+    double *lx = fx + 3 * (size_t)mx * s, *ly = fy + 3 * (size_t)my * s;
+    // u_half = u + (H + rho I)^{-1} (b - A u): lines along x
+    double s2 = residual_transpose(mx, my, X, RHS, r, half);
+    resvec[*nbite] = sqrt(s2) / norm_b;
+    poisson1D_timing_iteration(*nbite);
+    if (resvec[*nbite] < *tol) break;
+    // Rounding floor: the small shifts amplify the rounding errors of the residual by about
+    // 1/rho, a whole cycle then stops reducing the residual
+    if (s == 0) {
+      if (resvec[*nbite] >= cycle_res) break;
+      cycle_res = resvec[*nbite];
+    }
+    line_solve_add(mx, my, lx, lx + mx, lx + 2 * (size_t)mx, r, half);
+    // u = u_half + (V + rho I)^{-1} (b - A u_half): lines along y
+    residual_transpose(my, mx, half, bt, r, X);
+    line_solve_add(my, mx, ly, ly + my, ly + 2 * (size_t)my, r, X);
+  }
+
+  free(w);
+  free(shifts);
+  free(fx);
+  free(fy);
+  poisson1D_timing_end(POISSON1D_PHASE_ITER);
+}
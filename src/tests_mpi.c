@@ -0,0 +1,204 @@
+#include "lib_poisson1D_mpi.h"
+#include <string.h>
+
+/* Every rank also builds the global problem (small sizes) and checks its own slice against the
+   serial routines; the verdict is reduced so that rank 0 prints one line per test. */
+
+static int rank0;
+
+static void report(int ok, Poisson1DDist *dist, const char *pass, const char *fail) {
+    int all = 0;
+    MPI_Allreduce(&ok, &all, 1, MPI_INT, MPI_MIN, dist->comm);
+    if (!rank0) return;
+    if (all) printf("[PASS] %s\n\n", pass);
+    else printf("[FAIL] %s\n\n", fail);
+}
+
+void test_matvec_dist(poisson1D_int la) {
+    Poisson1DDist dist;
+    poisson1D_dist_create(&dist, MPI_COMM_WORLD, &la);
+    if (rank0) printf("=== Test: Distributed matvec with halo exchange (la=%" POISSON1D_PRId ", P=%d) ===\n", la, dist.size);
+
+    poisson1D_int kv = 0, ku = 1, kl = 1, n = dist.n;
+    int ok = 1;
+    poisson1D_int lab = kv + kl + ku + 1;
+    double *AB = (double *)malloc(lab * la * sizeof(double));
+    double *x = (double *)malloc(la * sizeof(double));
+    double *y = (double *)malloc(la * sizeof(double));
+    double *ABl = (double *)malloc(lab * n * sizeof(double));
+    double *yl = (double *)malloc(n * sizeof(double));
+    set_GB_operator_colMajor_poisson1D(AB, &lab, &la, &kv);
+    set_GB_operator_colMajor_poisson1D_dist(ABl, &lab, &kv, &dist);
+    for (int i = 0; i < la; i++) x[i] = sin(0.37 * i) + 1.0 / (1.0 + i);
+    cblas_dgbmv(CblasColMajor, CblasNoTrans, la, la, kl, ku, 1.0, AB, lab, x, 1, 0.0, y, 1);
+    dgbmv_dist(ABl, x + dist.offset, yl, &ku, &kl, &dist);
+    for (int i = 0; i < n; i++) {
+        if (fabs(yl[i] - y[dist.offset + i]) > 1e-14) ok = 0;
+    }
+    double dot = ddot_dist(x + dist.offset, x + dist.offset, &dist);
+    if (fabs(dot - cblas_ddot(la, x, 1, x, 1)) > 1e-12 * dot) ok = 0;
+
+    report(ok, &dist, "Local rows plus ghost couplings give the global product.", "Distributed matvec differs from dgbmv.");
+    free(AB); free(x); free(y); free(ABl); free(yl);
+}
+
+void test_iterative_dist(poisson1D_int la) {
+    Poisson1DDist dist;
+    poisson1D_dist_create(&dist, MPI_COMM_WORLD, &la);
+    if (rank0) printf("=== Test: Distributed Richardson, Jacobi and CG (la=%" POISSON1D_PRId ", P=%d) ===\n", la, dist.size);
+
+    poisson1D_int kv = 0, ku = 1, kl = 1, n = dist.n;
+    int ok = 1;
+    poisson1D_int lab = kv + kl + ku + 1;
+    double T0 = 5.0, T1 = 20.0;
+    double *AB = (double *)malloc(lab * la * sizeof(double));
+    double *MB = (double *)malloc(lab * la * sizeof(double));
+    double *RHS = (double *)malloc(la * sizeof(double));
+    double *X_ref = (double *)malloc(la * sizeof(double));
+    double *ABl = (double *)malloc(lab * n * sizeof(double));
+    double *MBl = (double *)malloc(lab * n * sizeof(double));
+    double *RHSl = (double *)malloc(n * sizeof(double));
+    double *Xl = (double *)malloc(n * sizeof(double));
+    set_GB_operator_colMajor_poisson1D(AB, &lab, &la, &kv);
+    extract_MB_jacobi_tridiag(AB, MB, &lab, &la, &ku, &kl, &kv);
+    set_dense_RHS_DBC_1D(RHS, &la, &T0, &T1);
+    set_GB_operator_colMajor_poisson1D_dist(ABl, &lab, &kv, &dist);
+    extract_MB_jacobi_tridiag(ABl, MBl, &lab, &n, &ku, &kl, &kv);
+    set_dense_RHS_DBC_1D_dist(RHSl, &dist, &T0, &T1);
+
+    int maxit = (int) (2 * la);
+    double tol = 1e-10, alpha = richardson_alpha_opt(&la);
+    double *res_ref = (double *)calloc(maxit, sizeof(double));
+    double *res_dist = (double *)calloc(maxit, sizeof(double));
+    const char *names[4] = {"Richardson", "Jacobi", "CG", "PCG"};
+    for (int m = 0; m < 4; m++) {
+        int nb_ref = 0, nb_dist = 0;
+        double *M = (m % 2) ? MB : NULL, *Ml = (m % 2) ? MBl : NULL;
+        memset(X_ref, 0, la * sizeof(double));
+        memset(Xl, 0, n * sizeof(double));
+        if (m == 0) richardson_alpha(AB, RHS, X_ref, &alpha, &lab, &la, &ku, &kl, &tol, &maxit, res_ref, &nb_ref);
+        if (m == 1) richardson_MB(AB, RHS, X_ref, MB, &lab, &la, &ku, &kl, &tol, &maxit, res_ref, &nb_ref);
+        if (m >= 2) conjugate_gradient(AB, RHS, X_ref, M, &lab, &la, &ku, &kl, &tol, &maxit, res_ref, &nb_ref);
+        if (m < 2) richardson_dist(ABl, RHSl, Xl, Ml, &alpha, &lab, &ku, &kl, &tol, &maxit, res_dist, &nb_dist, &dist);
+        else conjugate_gradient_dist(ABl, RHSl, Xl, Ml, &lab, &ku, &kl, &tol, &maxit, res_dist, &nb_dist, &dist);
+        /* Same iterates up to the summation order of the reductions */
+        int nres = (nb_ref < maxit) ? nb_ref + 1 : maxit;
+        double dres = 0.0, dx = 0.0, nx = 0.0;
+        for (int i = 0; i < nres; i++) dres = fmax(dres, fabs(res_ref[i] - res_dist[i]) / res_ref[0]);
+        for (int i = 0; i < n; i++) {
+            dx = fmax(dx, fabs(Xl[i] - X_ref[dist.offset + i]));
+            nx = fmax(nx, fabs(X_ref[dist.offset + i]));
+        }
+        double tol_x = (m < 2) ? 1e-12 : 1e-8;
+        if (abs(nb_dist - nb_ref) > ((m < 2) ? 0 : 1) || dres > 1e-8 || dx > tol_x * nx) ok = 0;
+        if (rank0) printf("%s: %d iterations (serial %d), residual history difference %e\n", names[m], nb_dist, nb_ref, dres);
+    }
+
+    report(ok, &dist, "Distributed iterations follow the serial residual histories.", "Distributed iterations diverge from the serial ones.");
+    free(AB); free(MB); free(RHS); free(X_ref); free(ABl); free(MBl); free(RHSl); free(Xl);
+    free(res_ref); free(res_dist);
+}
+
+void test_partition_dist(poisson1D_int la) {
+    Poisson1DDist dist;
+    poisson1D_dist_create(&dist, MPI_COMM_WORLD, &la);
+    if (rank0) printf("=== Test: Distributed partitioned tridiagonal solve (la=%" POISSON1D_PRId ", P=%d) ===\n", la, dist.size);
+
+    poisson1D_int n = dist.n, info = 0, nrhs = 1;
+    int ok = 1;
+    double T0 = -5.0, T1 = 5.0;
+    /* Poisson operator against the exact linear solution */
+    double *dl = (double *)malloc(n * sizeof(double));
+    double *d = (double *)malloc(n * sizeof(double));
+    double *du = (double *)malloc(n * sizeof(double));
+    double *B = (double *)malloc(n * sizeof(double));
+    double *X = (double *)malloc(n * sizeof(double));
+    double *EX = (double *)malloc(n * sizeof(double));
+    set_tridiag_operator_poisson1D_dist(dl, d, du, &dist);
+    set_dense_RHS_DBC_1D_dist(B, &dist, &T0, &T1);
+    set_grid_points_1D_dist(X, &dist);
+    set_analytical_solution_DBC_1D(EX, X, &n, &T0, &T1);
+    dgtsvpartition_dist(dl, d, du, B, &dist, &info);
+    double err = relative_forward_error_dist(EX, B, &dist);
+    if (info != 0 || err > 1e-15 * la * la) ok = 0; /* cond(A) grows as la^2 */
+
+    /* Nonsymmetric, diagonally dominant system against LAPACK dgtsv on the whole matrix */
+    double *gdl = (double *)malloc(la * sizeof(double));
+    double *gd = (double *)malloc(la * sizeof(double));
+    double *gdu = (double *)malloc(la * sizeof(double));
+    double *gb = (double *)malloc(la * sizeof(double));
+    for (int i = 0; i < la; i++) {
+        gdl[i] = -1.0 - 0.5 * sin(i);           /* A(i, i-1) */
+        gdu[i] = -0.7 + 0.2 * cos(3.0 * i);     /* A(i, i+1) */
+        gd[i] = 3.0 + 0.1 * i / la;
+        gb[i] = 1.0 + cos(0.1 * i);
+    }
+    for (int i = 0; i < n; i++) {
+        poisson1D_int g = dist.offset + i;
+        dl[i] = (g > 0) ? gdl[g] : 0.0;
+        du[i] = (g < la - 1) ? gdu[g] : 0.0;
+        d[i] = gd[g];
+        B[i] = gb[g];
+    }
+    /* LAPACK convention: dl[j] = A(j+1, j), du[j] = A(j, j+1) */
+    for (int j = 0; j < la - 1; j++) gdl[j] = gdl[j + 1];
+    dgtsv_(&la, &nrhs, gdl, gd, gdu, gb, &la, &info);
+    poisson1D_int info_dist = 0;
+    dgtsvpartition_dist(dl, d, du, B, &dist, &info_dist);
+    double dx = 0.0;
+    for (int i = 0; i < n; i++) dx = fmax(dx, fabs(B[i] - gb[dist.offset + i]) / fabs(gb[dist.offset + i]));
+    if (info != 0 || info_dist != 0 || dx > 1e-12) ok = 0;
+    if (rank0) printf("Poisson forward error %e, nonsymmetric system vs dgtsv %e\n", err, dx);
+
+    report(ok, &dist, "Partitioned solve matches the sequential solution.", "Partitioned solve is wrong.");
+    free(dl); free(d); free(du); free(B); free(X); free(EX);
+    free(gdl); free(gd); free(gdu); free(gb);
+}
+
+void test_write_dist(poisson1D_int la) {
+    Poisson1DDist dist;
+    poisson1D_dist_create(&dist, MPI_COMM_WORLD, &la);
+    if (rank0) printf("=== Test: MPI-IO binary write (la=%" POISSON1D_PRId ", P=%d) ===\n", la, dist.size);
+
+    poisson1D_int n = dist.n;
+    int ok = 1;
+    double *x = (double *)malloc(n * sizeof(double));
+    for (int i = 0; i < n; i++) x[i] = 1.0 / (3.0 + dist.offset + i);
+    if (write_vec_bin_dist(x, &dist, "test_vec_mpi.bin") != 0) ok = 0;
+    MPI_Barrier(dist.comm);
+    /* Every rank reads the whole file back through the serial reader */
+    Poisson1DBinFile f;
+    if (poisson1D_bin_map("test_vec_mpi.bin", &f) != 0) {
+        ok = 0;
+    } else {
+        if (f.hdr.type != POISSON1D_BIN_VEC || f.hdr.rows != la || f.hdr.cols != 1) ok = 0;
+        for (int i = 0; ok && i < la; i++) {
+            if (f.data[i] != 1.0 / (3.0 + i)) ok = 0;
+        }
+        poisson1D_bin_unmap(&f);
+    }
+
+    report(ok, &dist, "Slices written at their offsets form a valid binary vector file.", "MPI-IO file does not match the serial format.");
+    free(x);
+}
+
+int main(int argc, char *argv[]) {
+    MPI_Init(&argc, &argv);
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    rank0 = (rank == 0);
+    if (rank0) printf("Starting MPI Tests (%d ranks)...\n\n", size);
+
+    test_matvec_dist(size);       /* one point per rank */
+    test_matvec_dist(1001);
+    test_iterative_dist(97);
+    test_partition_dist(size);
+    test_partition_dist(1000);
+    test_partition_dist(100003);
+    test_write_dist(1001);
+
+    if (rank0) printf("All tests finished.\n");
+    MPI_Finalize();
+    return 0;
+}
@@ -1,10 +1,14 @@
 #include "lib_poisson1D.h"
 #include <assert.h>
 #include <string.h>
+#include <time.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 /* Helper to print matrix for debugging */
-void print_GB_matrix(double *AB, int lab, int la, const char *name) {
-    printf("Matrix %s (%dx%d):\n", name, lab, la);
+void print_GB_matrix(double *AB, poisson1D_int lab, poisson1D_int la, const char *name) {
+    printf("Matrix %s (%" POISSON1D_PRId "x%" POISSON1D_PRId "):\n", name, lab, la);
     for (int i = 0; i < lab; i++) {
         for (int j = 0; j < la; j++) {
             printf("%6.2f ", AB[j * lab + i]);
@@ -15,14 +19,14 @@ void print_GB_matrix(double *AB, int lab, int la, const char *name) {
 }
 
 /* Exercise 4 Validation: Use dgbmv to verify Ax = b */
-void test_dgbmv_ax_equals_b(int n) {
-    printf("=== Test: dgbmv verification (n=%d) ===\n", n);
+void test_dgbmv_ax_equals_b(poisson1D_int n) {
+    printf("=== Test: dgbmv verification (n=%" POISSON1D_PRId ") ===\n", n);
     
     /* 1. Setup Matrix A in GB format */
-    int kv = 1;
+    poisson1D_int kv = 1;
     int ku = 1;
     int kl = 1;
-    int lab = kv + kl + ku + 1;
+    poisson1D_int lab = kv + kl + ku + 1;
     double *AB = (double *)malloc(lab * n * sizeof(double));
     set_GB_operator_colMajor_poisson1D(AB, &lab, &n, &kv);
     
@@ -70,11 +74,11 @@ void test_dgbmv_ax_equals_b(int n) {
 }
 
 /* Exercise 6 Validation: Compare Custom LU (dgbtrftridiag) with LAPACK (dgbtrf) */
-void test_lu_compare(int n) {
-    printf("=== Test: LU Custom vs LAPACK (n=%d) ===\n", n);
+void test_lu_compare(poisson1D_int n) {
+    printf("=== Test: LU Custom vs LAPACK (n=%" POISSON1D_PRId ") ===\n", n);
     
-    int kv = 1, ku = 1, kl = 1;
-    int lab = kv + kl + ku + 1;
+    poisson1D_int kv = 1, ku = 1, kl = 1;
+    poisson1D_int lab = kv + kl + ku + 1;
     
     /* Create two identical matrices */
     double *AB_lapack = (double *)malloc(lab * n * sizeof(double));
@@ -83,19 +87,19 @@ void test_lu_compare(int n) {
     set_GB_operator_colMajor_poisson1D(AB_lapack, &lab, &n, &kv);
     memcpy(AB_custom, AB_lapack, lab * n * sizeof(double));
     
-    int *ipiv_lapack = (int *)malloc(n * sizeof(int));
-    int *ipiv_custom = (int *)malloc(n * sizeof(int));
-    int info;
+    poisson1D_int *ipiv_lapack = (poisson1D_int *)malloc(n * sizeof(poisson1D_int));
+    poisson1D_int *ipiv_custom = (poisson1D_int *)malloc(n * sizeof(poisson1D_int));
+    poisson1D_int info;
     
     /* Run LAPACK dgbtrf */
     info = 0;
     dgbtrf_(&n, &n, &kl, &ku, AB_lapack, &lab, ipiv_lapack, &info);
-    if (info != 0) printf("LAPACK dgbtrf failed with info=%d\n", info);
+    if (info != 0) printf("LAPACK dgbtrf failed with info=%" POISSON1D_PRId "\n", info);
     
     /* Run Custom dgbtrftridiag */
     info = 0;
     dgbtrftridiag(&lab, &n, &kl, &ku, AB_custom, &lab, ipiv_custom, &info);
-    if (info != 0) printf("Custom dgbtrftridiag failed with info=%d\n", info);
+    if (info != 0) printf("Custom dgbtrftridiag failed with info=%" POISSON1D_PRId "\n", info);
 
     /* Compare LU Factors (in AB) */
     /* Note: LAPACK might choose pivots, but for Poisson matrix (diag dominant), 
@@ -131,6 +135,1473 @@ void test_lu_compare(int n) {
     free(ipiv_lapack); free(ipiv_custom);
 }
 
+/* Validation of the compact Thomas solver against the GB custom LU + dgbtrs */
+void test_thomas_compare(poisson1D_int n) {
+    printf("=== Test: Thomas (compact) vs GB LU (n=%" POISSON1D_PRId ") ===\n", n);
+
+    poisson1D_int kv = 1, ku = 1, kl = 1, nrhs = 1, info;
+    poisson1D_int lab = kv + kl + ku + 1;
+    double *AB = (double *)malloc(lab * n * sizeof(double));
+    poisson1D_int *ipiv = (poisson1D_int *)malloc(n * sizeof(poisson1D_int));
+    set_GB_operator_colMajor_poisson1D(AB, &lab, &n, &kv);
+
+    TriDiagMatrix TD;
+    set_tridiag_operator_poisson1D(&TD, &n);
+
+    double T0 = -5.0, T1 = 5.0;
+    double *b_gb = (double *)malloc(n * sizeof(double));
+    double *b_td = (double *)malloc(n * sizeof(double));
+    set_dense_RHS_DBC_1D(b_gb, &n, &T0, &T1);
+    memcpy(b_td, b_gb, n * sizeof(double));
+
+    dgbtrftridiag(&n, &n, &kl, &ku, AB, &lab, ipiv, &info);
+    dgbtrs_("N", &n, &kl, &ku, &nrhs, AB, &lab, ipiv, b_gb, &n, &info);
+    dgttrftridiag(&n, TD.dl, TD.d, TD.du, &info);
+    if (info != 0) printf("Custom dgttrftridiag failed with info=%" POISSON1D_PRId "\n", info);
+    dgttrstridiag(&n, &nrhs, TD.dl, TD.d, TD.du, b_td, &n, &info);
+
+    /* Factors must match the ones stored in the GB layout */
+    double max_diff = 0.0;
+    for (int j = 0; j < n; j++) {
+        double diff = fabs(AB[indexABCol(kl + ku, j, &lab)] - TD.d[j]);
+        if (diff > max_diff) max_diff = diff;
+        if (j < n - 1) {
+            diff = fabs(AB[indexABCol(ku + 2 * kl, j, &lab)] - TD.dl[j]);
+            if (diff > max_diff) max_diff = diff;
+        }
+    }
+    double sol_err = relative_forward_error(b_gb, b_td, &n);
+    printf("Max difference in LU factors: %e, relative solution difference: %e\n", max_diff, sol_err);
+
+    if (max_diff < 1e-14 && sol_err < 1e-14) {
+        printf("[PASS] Thomas solver matches GB LU.\n");
+    } else {
+        printf("[FAIL] Thomas solver differs from GB LU!\n");
+    }
+    printf("\n");
+
+    free(AB); free(ipiv); free(b_gb); free(b_td);
+    free(TD.dl); free(TD.d); free(TD.du);
+}
+
+/* Validation of the interleaved multi-RHS Thomas solve against one solve per column */
+void test_thomas_interleaved(poisson1D_int n, poisson1D_int nrhs) {
+    printf("=== Test: Interleaved multi-RHS Thomas (n=%" POISSON1D_PRId ", nrhs=%" POISSON1D_PRId ") ===\n", n, nrhs);
+
+    poisson1D_int info;
+    TriDiagMatrix TD;
+    set_tridiag_operator_poisson1D(&TD, &n);
+    dgttrftridiag(&n, TD.dl, TD.d, TD.du, &info);
+
+    double *BC0 = (double *)malloc(nrhs * sizeof(double));
+    double *BC1 = (double *)malloc(nrhs * sizeof(double));
+    for (int k = 0; k < nrhs; k++) { BC0[k] = -5.0 + k; BC1[k] = 5.0 - 2.0 * k; }
+
+    double *B = (double *)malloc(n * nrhs * sizeof(double));
+    double *BI = (double *)malloc(n * nrhs * sizeof(double));
+    double *B_ref = (double *)malloc(n * nrhs * sizeof(double));
+    set_dense_RHS_DBC_1D_batch(B_ref, &n, &nrhs, BC0, BC1);
+    interleave_RHS(B_ref, BI, &n, &nrhs);
+
+    dgttrstridiag(&n, &nrhs, TD.dl, TD.d, TD.du, B_ref, &n, &info);
+    dgttrstridiag_interleaved(&n, &nrhs, TD.dl, TD.d, TD.du, BI, &info);
+    deinterleave_RHS(BI, B, &n, &nrhs);
+
+    double max_diff = 0.0;
+    for (int i = 0; i < n * nrhs; i++) {
+        double diff = fabs(B[i] - B_ref[i]);
+        if (diff > max_diff) max_diff = diff;
+    }
+    printf("Max difference with column-wise solves: %e\n", max_diff);
+
+    if (max_diff < 1e-12) {
+        printf("[PASS] Interleaved solve matches column-wise solves.\n");
+    } else {
+        printf("[FAIL] Interleaved solve differs from column-wise solves!\n");
+    }
+    printf("\n");
+
+    free(BC0); free(BC1); free(B); free(BI); free(B_ref);
+    free(TD.dl); free(TD.d); free(TD.du);
+}
+
+/* Validation of the batched Thomas solver (one variable-coefficient system per lane) against
+   per-system Thomas solves and the exact discrete solution */
+void test_thomas_batch(poisson1D_int n, poisson1D_int nbatch) {
+    printf("=== Test: Batched Thomas, variable coefficients (n=%" POISSON1D_PRId ", nbatch=%" POISSON1D_PRId ") ===\n", n, nbatch);
+
+    poisson1D_int info, one = 1;
+    double T0 = -5.0, T1 = 5.0;
+    double *kappa = (double *)malloc((size_t)(n + 1) * nbatch * sizeof(double));
+    for (int b = 0; b < nbatch; b++) {
+        for (int i = 0; i <= n; i++) {
+            kappa[(size_t)b * (n + 1) + i] = 1.0 + 0.9 * sin(0.1 * (b + 1) * i);
+        }
+    }
+    TriDiagBatch TB;
+    set_tridiag_batch_operator_poisson1D_varcoef(&TB, &n, &nbatch, kappa);
+
+    double *B = (double *)malloc((size_t)n * nbatch * sizeof(double));
+    double *BI = (double *)malloc((size_t)n * nbatch * sizeof(double));
+    double *ex = (double *)malloc(n * sizeof(double));
+    for (int b = 0; b < nbatch; b++) {
+        set_dense_RHS_DBC_1D_varcoef(B + (size_t)b * n, &n, kappa + (size_t)b * (n + 1), &T0, &T1);
+    }
+    interleave_RHS(B, BI, &n, &nbatch);
+
+    dgttrftridiag_batch(&n, &nbatch, TB.dl, TB.d, TB.du, &info);
+    if (info != 0) printf("dgttrftridiag_batch failed with info=%" POISSON1D_PRId "\n", info);
+    dgttrstridiag_batch(&n, &nbatch, TB.dl, TB.d, TB.du, BI, &info);
+
+    /* Reference: each system assembled in GB storage, copied to compact storage and solved alone */
+    poisson1D_int kv = 0, lab = 3;
+    double *AB = (double *)malloc((size_t)lab * n * sizeof(double));
+    TriDiagMatrix TD;
+    set_tridiag_operator_poisson1D(&TD, &n);
+    double max_diff = 0.0, max_err = 0.0;
+    for (int b = 0; b < nbatch; b++) {
+        double *kb = kappa + (size_t)b * (n + 1);
+        double *bb = B + (size_t)b * n;
+        set_GB_operator_colMajor_poisson1D_varcoef(AB, &lab, &n, &kv, kb);
+        for (int i = 0; i < n; i++) {
+            TD.d[i] = AB[indexABCol(kv + 1, i, &lab)];
+            if (i < n - 1) {
+                TD.du[i] = AB[indexABCol(kv, i + 1, &lab)];
+                TD.dl[i] = AB[indexABCol(kv + 2, i, &lab)];
+            }
+        }
+        dgttrftridiag(&n, TD.dl, TD.d, TD.du, &info);
+        dgttrstridiag(&n, &one, TD.dl, TD.d, TD.du, bb, &n, &info);
+        set_exact_solution_DBC_1D_varcoef(ex, &n, kb, &T0, &T1);
+        for (int i = 0; i < n; i++) {
+            double diff = fabs(BI[(size_t)i * nbatch + b] - bb[i]);
+            if (diff > max_diff) max_diff = diff;
+            if (i < n - 1) {
+                diff = fabs(TB.dl[(size_t)i * nbatch + b] - TD.dl[i]);
+                if (diff > max_diff) max_diff = diff;
+            }
+            diff = fabs(TB.d[(size_t)i * nbatch + b] - TD.d[i]);
+            if (diff > max_diff) max_diff = diff;
+        }
+        double err = relative_forward_error(ex, bb, &n);
+        if (err > max_err) max_err = err;
+    }
+
+    /* A zero pivot in the last system is reported with its index */
+    poisson1D_int n2 = 4;
+    poisson1D_int last = nbatch - 1;
+    TriDiagBatch TS;
+    set_tridiag_batch_operator_poisson1D_varcoef(&TS, &n2, &nbatch, kappa);
+    TS.d[last] = 0.0;
+    poisson1D_int info_sing;
+    dgttrftridiag_batch(&n2, &nbatch, TS.dl, TS.d, TS.du, &info_sing);
+
+    printf("Max difference with per-system Thomas: %e, max error vs exact solution: %e, singular info: %" POISSON1D_PRId "\n",
+           max_diff, max_err, info_sing);
+    if (max_diff < 1e-12 && max_err < 1e-10 && info_sing == nbatch) {
+        printf("[PASS] Batched Thomas matches per-system solves.\n");
+    } else {
+        printf("[FAIL] Batched Thomas differs from per-system solves!\n");
+    }
+    printf("\n");
+
+    free(kappa); free(B); free(BI); free(ex); free(AB);
+    free(TD.dl); free(TD.d); free(TD.du);
+    free_tridiag_batch(&TB);
+    free_tridiag_batch(&TS);
+}
+
+/* Validation of the partitioned parallel solver against Thomas for several partition counts */
+void test_partition_solver(poisson1D_int n) {
+    printf("=== Test: Partitioned tridiagonal solver vs Thomas (n=%" POISSON1D_PRId ") ===\n", n);
+
+    poisson1D_int one = 1, info;
+    int ok = 1;
+    double *dl = (double *)malloc(n * sizeof(double));
+    double *d = (double *)malloc(n * sizeof(double));
+    double *du = (double *)malloc(n * sizeof(double));
+    double *dl0 = (double *)malloc(n * sizeof(double));
+    double *d0 = (double *)malloc(n * sizeof(double));
+    double *du0 = (double *)malloc(n * sizeof(double));
+    double *b0 = (double *)malloc(n * sizeof(double));
+    double *x_ref = (double *)malloc(n * sizeof(double));
+    double *x = (double *)malloc(n * sizeof(double));
+
+    /* Non-symmetric, diagonally dominant test matrix */
+    for (int i = 0; i < n; i++) {
+        dl0[i] = -1.0 + 0.3 * sin(i);
+        du0[i] = -1.0 + 0.2 * cos(i);
+        d0[i] = 2.5 + 0.1 * (i % 7);
+        b0[i] = 1.0 + (i % 5);
+    }
+    memcpy(dl, dl0, n * sizeof(double)); memcpy(d, d0, n * sizeof(double));
+    memcpy(du, du0, n * sizeof(double)); memcpy(x_ref, b0, n * sizeof(double));
+    dgttrftridiag(&n, dl, d, du, &info);
+    dgttrstridiag(&n, &one, dl, d, du, x_ref, &n, &info);
+
+    for (int nparts = 1; nparts <= 8; nparts++) {
+        memcpy(dl, dl0, n * sizeof(double)); memcpy(d, d0, n * sizeof(double));
+        memcpy(du, du0, n * sizeof(double)); memcpy(x, b0, n * sizeof(double));
+        dgtsvpartition(&n, dl, d, du, x, &nparts, &info);
+        double err = relative_forward_error(x, x_ref, &n);
+        if (info != 0 || err > 1e-13) {
+            printf("nparts=%d: info=%" POISSON1D_PRId ", relative difference %e\n", nparts, info, err);
+            ok = 0;
+        }
+    }
+
+    if (ok) {
+        printf("[PASS] Partitioned solver matches Thomas for 1 to 8 partitions.\n");
+    } else {
+        printf("[FAIL] Partitioned solver differs from Thomas!\n");
+    }
+    printf("\n");
+
+    free(dl); free(d); free(du); free(dl0); free(d0); free(du0);
+    free(b0); free(x_ref); free(x);
+}
+
+/* Validation of the solver handles and of the LRU factor cache */
+void test_solver_handle_cache(void) {
+    printf("=== Test: Solver handle and factor cache ===\n");
+
+    int sizes[3] = {50, 100, 50};
+    poisson1D_int nrhs = 1, info = 0;
+    int kind = POISSON1D_FACTOR_TRI, ok = 1;
+    int hits, misses, entries;
+    size_t bytes;
+    double T0 = -5.0, T1 = 5.0;
+
+    poisson1D_factor_cache_clear();
+    poisson1D_factor_cache_set_limits(POISSON1D_CACHE_DEFAULT_MAX_BYTES, 1);
+    for (int t = 0; t < 3; t++) {
+        poisson1D_int n = sizes[t];
+        double *B = (double *)malloc(n * sizeof(double));
+        double *X = (double *)malloc(n * sizeof(double));
+        double *EX = (double *)malloc(n * sizeof(double));
+        set_dense_RHS_DBC_1D(B, &n, &T0, &T1);
+        set_grid_points_1D(X, &n);
+        set_analytical_solution_DBC_1D(EX, X, &n, &T0, &T1);
+
+        /* Two handles on the same size: the second one reuses the factors */
+        Poisson1DSolver *s1 = poisson1D_solver_create(&n, &kind);
+        Poisson1DSolver *s2 = poisson1D_solver_create(&n, &kind);
+        poisson1D_solver_factor(s1, &info);
+        poisson1D_solver_factor(s2, &info);
+        if (s1->factor != s2->factor) ok = 0;
+        poisson1D_solver_solve(s2, B, &nrhs, &info);
+        if (info != 0 || relative_forward_error(B, EX, &n) > 1e-12) ok = 0;
+        poisson1D_solver_destroy(s1);
+        poisson1D_solver_destroy(s2);
+
+        free(B); free(X); free(EX);
+    }
+    /* 50 is evicted by 100 (max 1 entry), so it is factorized twice */
+    poisson1D_factor_cache_stats(&hits, &misses, &entries, &bytes);
+    printf("Cache: %d hits, %d misses, %d entries, %zu bytes\n", hits, misses, entries, bytes);
+    if (hits != 3 || misses != 3 || entries != 1) ok = 0;
+
+    poisson1D_factor_cache_clear();
+    poisson1D_factor_cache_stats(&hits, &misses, &entries, &bytes);
+    if (entries != 0 || bytes != 0) ok = 0;
+    poisson1D_factor_cache_set_limits(POISSON1D_CACHE_DEFAULT_MAX_BYTES, POISSON1D_CACHE_DEFAULT_MAX_ENTRIES);
+
+    if (ok) {
+        printf("[PASS] Solver handles reuse cached factors.\n");
+    } else {
+        printf("[FAIL] Solver handle or factor cache misbehaves!\n");
+    }
+    printf("\n");
+}
+
+/* Validation of the DST fast diagonalization solver against Thomas (several radix mixes) */
+void test_dst_solver(poisson1D_int n, poisson1D_int nrhs) {
+    printf("=== Test: DST solver vs Thomas (n=%" POISSON1D_PRId ", nrhs=%" POISSON1D_PRId ") ===\n", n, nrhs);
+
+    poisson1D_int info;
+    TriDiagMatrix TD;
+    set_tridiag_operator_poisson1D(&TD, &n);
+    dgttrftridiag(&n, TD.dl, TD.d, TD.du, &info);
+
+    /* Non-trivial right-hand sides (all sine modes present) */
+    double *B = (double *)malloc(n * nrhs * sizeof(double));
+    double *X_ref = (double *)malloc(n * nrhs * sizeof(double));
+    double *X = (double *)malloc(n * nrhs * sizeof(double));
+    for (int i = 0; i < n * nrhs; i++) B[i] = cos(0.37 * i) + (i % 3);
+    memcpy(X_ref, B, n * nrhs * sizeof(double));
+    dgttrstridiag(&n, &nrhs, TD.dl, TD.d, TD.du, X_ref, &n, &info);
+
+    info = poisson1D_dst_solve(B, X, &n, &nrhs);
+    double max_err = 0.0;
+    for (int k = 0; k < nrhs; k++) {
+        double err = relative_forward_error(X + k * n, X_ref + k * n, &n);
+        if (err > max_err) max_err = err;
+    }
+    printf("Max relative difference: %e\n", max_err);
+
+    /* Both solutions are accurate to about eps * cond(A), cond(A) ~ 4 (n+1)^2 / pi^2 */
+    double tol = fmax(1e-10, DBL_EPSILON * (double)(n + 1) * (n + 1));
+    if (info == 0 && max_err < tol) {
+        printf("[PASS] DST solver matches Thomas.\n");
+    } else {
+        printf("[FAIL] DST solver differs from Thomas!\n");
+    }
+    printf("\n");
+
+    free(B); free(X_ref); free(X);
+    free(TD.dl); free(TD.d); free(TD.du);
+}
+
+/* Validation of the fused matrix-free Richardson against the GB implementation */
+void test_richardson_stencil(poisson1D_int n) {
+    printf("=== Test: Richardson stencil vs GB (n=%" POISSON1D_PRId ") ===\n", n);
+
+    poisson1D_int kv = 0, ku = 1, kl = 1;
+    poisson1D_int lab = kv + kl + ku + 1;
+    double *AB = (double *)malloc(lab * n * sizeof(double));
+    set_GB_operator_colMajor_poisson1D(AB, &lab, &n, &kv);
+
+    double T0 = 5.0, T1 = 20.0;
+    double *RHS = (double *)malloc(n * sizeof(double));
+    set_dense_RHS_DBC_1D(RHS, &n, &T0, &T1);
+
+    double *X_gb = (double *)calloc(n, sizeof(double));
+    double *X_st = (double *)calloc(n, sizeof(double));
+    double alpha = richardson_alpha_opt(&n);
+    double tol = 1e-3;
+    int maxit = 200;
+    double *res_gb = (double *)calloc(maxit, sizeof(double));
+    double *res_st = (double *)calloc(maxit, sizeof(double));
+    int nbite_gb = 0, nbite_st = 0;
+
+    richardson_alpha(AB, RHS, X_gb, &alpha, &lab, &n, &ku, &kl, &tol, &maxit, res_gb, &nbite_gb);
+    richardson_alpha_stencil(RHS, X_st, &alpha, &n, &tol, &maxit, res_st, &nbite_st);
+
+    /* Same residual history; the stencil version also applies the last update */
+    int nres = (nbite_gb < maxit) ? nbite_gb + 1 : maxit;
+    double max_diff = 0.0;
+    for (int i = 0; i < nres; i++) {
+        double diff = fabs(res_gb[i] - res_st[i]);
+        if (diff > max_diff) max_diff = diff;
+    }
+    printf("Iterations GB = %d, stencil = %d, max residual history difference: %e\n", nbite_gb, nbite_st, max_diff);
+
+    if (nbite_gb == nbite_st && max_diff < 1e-12) {
+        printf("[PASS] Stencil Richardson matches GB Richardson.\n");
+    } else {
+        printf("[FAIL] Stencil Richardson differs from GB Richardson!\n");
+    }
+    printf("\n");
+
+    free(AB); free(RHS); free(X_gb); free(X_st); free(res_gb); free(res_st);
+}
+
+/* Temporally blocked sweeps: same iterates and residuals as the GB Richardson / Jacobi */
+void test_richardson_tiled(poisson1D_int n) {
+    printf("=== Test: Temporally blocked Richardson and Jacobi (n=%" POISSON1D_PRId ") ===\n", n);
+
+    poisson1D_int kv = 0, ku = 1, kl = 1;
+    int ok = 1;
+    poisson1D_int lab = kv + kl + ku + 1;
+    double *AB = (double *)malloc(lab * n * sizeof(double));
+    double *MB = (double *)malloc(lab * n * sizeof(double));
+    set_GB_operator_colMajor_poisson1D(AB, &lab, &n, &kv);
+    extract_MB_jacobi_tridiag(AB, MB, &lab, &n, &ku, &kl, &kv);
+
+    double T0 = 5.0, T1 = 20.0;
+    double *RHS = (double *)malloc(n * sizeof(double));
+    double *X_ref = (double *)malloc(n * sizeof(double));
+    double *X_til = (double *)malloc(n * sizeof(double));
+    set_dense_RHS_DBC_1D(RHS, &n, &T0, &T1);
+
+    int maxit = 150;
+    double *res_ref = (double *)calloc(maxit, sizeof(double));
+    double *res_til = (double *)calloc(maxit, sizeof(double));
+    double alphas[2] = {richardson_alpha_opt(&n), 1.0};
+    int steps[3] = {1, 4, 7}, tiles[3] = {(int) n, 64, 5};
+
+    for (int jac = 0; jac < 2; jac++) {
+        for (int c = 0; c < 3; c++) {
+            /* Fixed number of iterations (not a multiple of s), then stop on the tolerance */
+            double tols[2] = {0.0, 0.0};
+            for (int t = 0; t < 2; t++) {
+                int nb_ref = 0, nb_til = 0;
+                for (int i = 0; i < n; i++) X_ref[i] = X_til[i] = 0.0;
+                if (jac) richardson_MB(AB, RHS, X_ref, MB, &lab, &n, &ku, &kl, &tols[t], &maxit, res_ref, &nb_ref);
+                else richardson_alpha(AB, RHS, X_ref, &alphas[0], &lab, &n, &ku, &kl, &tols[t], &maxit, res_ref, &nb_ref);
+                if (t == 0) tols[1] = res_ref[maxit / 3];
+                richardson_tiled(AB, RHS, X_til, jac ? MB : NULL, &alphas[jac], &lab, &n, &ku, &kl, &steps[c], &tiles[c], &tols[t], &maxit, res_til, &nb_til);
+                /* the reference stops at the first residual below tol, the blocked sweeps at the next multiple of s */
+                int expect = (t == 0) ? maxit : ((nb_ref + steps[c] - 1) / steps[c]) * steps[c];
+                int nres = (nb_ref < maxit) ? nb_ref + 1 : maxit;
+                double dres = 0.0;
+                for (int i = 0; i < nres; i++) dres = fmax(dres, fabs(res_ref[i] - res_til[i]) / res_ref[0]);
+                if (t == 0) {
+                    double dx = relative_forward_error(X_ref, X_til, &n);
+                    if (dx > 1e-12) ok = 0;
+                }
+                if (nb_til != expect || dres > 1e-12 || (t == 1 && res_til[nb_til] >= tols[1])) ok = 0;
+                if (t == 1) printf("%s s=%d tile=%d: stopped at %d (reference %d), residual history difference %e\n",
+                                   jac ? "Jacobi" : "Richardson", steps[c], tiles[c], nb_til, nb_ref, dres);
+            }
+        }
+    }
+
+    if (ok) {
+        printf("[PASS] Blocked sweeps reproduce the Richardson and Jacobi iterates.\n");
+    } else {
+        printf("[FAIL] Blocked sweeps differ from Richardson / Jacobi!\n");
+    }
+    printf("\n");
+
+    free(AB); free(MB); free(RHS); free(X_ref); free(X_til); free(res_ref); free(res_til);
+}
+
+/* O(1) stencil operator: products and iterations against GB, closed-form Thomas against dgtsv */
+void test_stencil_operator(poisson1D_int n) {
+    printf("=== Test: Constant-coefficient stencil operator (n=%" POISSON1D_PRId ") ===\n", n);
+
+    poisson1D_int kv = 0, ku = 1, kl = 1, one = 1, info;
+    int ok = 1;
+    poisson1D_int lab = kv + kl + ku + 1;
+    StencilOperator A = {-1.2, 3.0, -0.7, n};
+    double *AB = (double *)malloc((size_t)lab * n * sizeof(double));
+    double *MB = (double *)malloc((size_t)lab * n * sizeof(double));
+    for (int j = 0; j < n; j++) {
+        AB[indexABCol(kv, j, &lab)] = (j > 0) ? A.sup : 0.0;
+        AB[indexABCol(kv + 1, j, &lab)] = A.diag;
+        AB[indexABCol(kv + 2, j, &lab)] = (j < n - 1) ? A.sub : 0.0;
+    }
+    double *x = (double *)malloc(n * sizeof(double));
+    double *y = (double *)malloc(n * sizeof(double));
+    double *r = (double *)malloc(n * sizeof(double));
+    double *RHS = (double *)malloc(n * sizeof(double));
+    for (int i = 0; i < n; i++) {
+        x[i] = sin(0.37 * i) + 1.0 / (1.0 + i);
+        RHS[i] = 1.0 + cos(0.1 * i);
+    }
+
+    /* Product and residual on a nonsymmetric operator */
+    double max_mv = 0.0;
+    cblas_dgbmv(CblasColMajor, CblasNoTrans, n, n, kl, ku, 1.0, AB, lab, x, 1, 0.0, y, 1);
+    dstencilmv(&A, x, r);
+    for (int i = 0; i < n; i++) max_mv = fmax(max_mv, fabs(r[i] - y[i]));
+    double nres = dstencil_residual(&A, RHS, x, r), nref = 0.0;
+    for (int i = 0; i < n; i++) {
+        max_mv = fmax(max_mv, fabs(r[i] - (RHS[i] - y[i])));
+        nref += (RHS[i] - y[i]) * (RHS[i] - y[i]);
+    }
+    if (max_mv > 1e-13 || fabs(nres - sqrt(nref)) > 1e-12 * sqrt(nref)) ok = 0;
+
+    /* Jacobi and Gauss-Seidel sweeps follow richardson_MB */
+    int maxit = 100, nb_gb = 0, nb_st = 0;
+    double tol = 1e-10, alpha = 0.0, max_res = 0.0;
+    double *res_gb = (double *)calloc(maxit, sizeof(double));
+    double *res_st = (double *)calloc(maxit, sizeof(double));
+    for (int prec = POISSON1D_STENCIL_JACOBI; prec <= POISSON1D_STENCIL_GS; prec++) {
+        if (prec == POISSON1D_STENCIL_JACOBI) extract_MB_jacobi_tridiag(AB, MB, &lab, &n, &ku, &kl, &kv);
+        else extract_MB_gauss_seidel_tridiag(AB, MB, &lab, &n, &ku, &kl, &kv);
+        memset(x, 0, n * sizeof(double));
+        richardson_MB(AB, RHS, x, MB, &lab, &n, &ku, &kl, &tol, &maxit, res_gb, &nb_gb);
+        memset(x, 0, n * sizeof(double));
+        richardson_stencil_op(&A, RHS, x, &alpha, &prec, &tol, &maxit, res_st, &nb_st);
+        int nr = (nb_gb < maxit) ? nb_gb + 1 : maxit;
+        for (int i = 0; i < nr; i++) max_res = fmax(max_res, fabs(res_gb[i] - res_st[i]));
+        if (nb_gb != nb_st) ok = 0;
+    }
+
+    /* Matrix-free CG through the operator callback on the Poisson stencil */
+    StencilOperator P;
+    set_stencil_operator_poisson1D(&P, &n);
+    set_GB_operator_colMajor_poisson1D(AB, &lab, &n, &kv);
+    double *X_gb = (double *)calloc(n, sizeof(double));
+    double *X_st = (double *)calloc(n, sizeof(double));
+    conjugate_gradient(AB, RHS, X_gb, NULL, &lab, &n, &ku, &kl, &tol, &maxit, res_gb, &nb_gb);
+    conjugate_gradient_op(matvec_stencil_op, &P, NULL, RHS, X_st, &n, &tol, &maxit, res_st, &nb_st);
+    int nr = (nb_gb < maxit) ? nb_gb + 1 : maxit;
+    for (int i = 0; i < nr; i++) max_res = fmax(max_res, fabs(res_gb[i] - res_st[i]));
+    if (nb_gb != nb_st || max_res > 1e-12) ok = 0;
+
+    /* Thomas with closed-form pivots: double root (Poisson), real roots, roots of opposite signs,
+       complex roots; two right-hand sides with ldb > n */
+    double cases[4][3] = {{-1.0, 2.0, -1.0}, {-1.2, 3.0, -0.7}, {1.0, 2.0, -1.0}, {-1.0, 2.5, -2.0}};
+    poisson1D_int nrhs = 2, ldb = n + 3;
+    double *B = (double *)malloc((size_t)ldb * nrhs * sizeof(double));
+    double *G = (double *)malloc((size_t)n * nrhs * sizeof(double));
+    double *dl = (double *)malloc(n * sizeof(double));
+    double *d = (double *)malloc(n * sizeof(double));
+    double *du = (double *)malloc(n * sizeof(double));
+    double max_diff = 0.0;
+    for (int c = 0; c < 4; c++) {
+        StencilOperator S = {cases[c][0], cases[c][1], cases[c][2], n};
+        for (int k = 0; k < nrhs; k++) {
+            for (int i = 0; i < n; i++) {
+                B[(size_t)k * ldb + i] = G[(size_t)k * n + i] = (k + 1.0) * RHS[i];
+            }
+        }
+        for (int i = 0; i < n; i++) {dl[i] = S.sub; d[i] = S.diag; du[i] = S.sup;}
+        dgtsv_(&n, &nrhs, dl, d, du, G, &n, &info);
+        dstencil_thomas(&S, &nrhs, B, &ldb, &info);
+        if (info != 0) ok = 0;
+        /* Backward error of the stencil solution, distance to the pivoted LAPACK one */
+        for (int k = 0; k < nrhs; k++) {
+            double *xb = B + (size_t)k * ldb, *xg = G + (size_t)k * n;
+            double nx = cblas_dnrm2(n, xg, 1);
+            dstencilmv(&S, xb, y);
+            for (int i = 0; i < n; i++) {
+                double b = (k + 1.0) * RHS[i];
+                if (fabs(y[i] - b) > 1e-12 * (fabs(S.sub) + fabs(S.diag) + fabs(S.sup)) * nx) ok = 0;
+            }
+            double dx = 0.0, mx = 0.0;
+            for (int i = 0; i < n; i++) {dx = fmax(dx, fabs(xb[i] - xg[i])); mx = fmax(mx, fabs(xg[i]));}
+            if (c == 1) max_diff = fmax(max_diff, dx / mx); /* diagonally dominant: well conditioned */
+        }
+    }
+
+    /* Poisson forward error against the exact linear solution */
+    double T0 = -5.0, T1 = 5.0;
+    set_grid_points_1D(x, &n);
+    set_analytical_solution_DBC_1D(y, x, &n, &T0, &T1);
+    set_dense_RHS_DBC_1D(B, &n, &T0, &T1);
+    dstencil_thomas(&P, &one, B, &n, &info);
+    double err = relative_forward_error(y, B, &n);
+    if (info != 0 || max_diff > 1e-10 || err > 1e-15 * n * (double)n) ok = 0;
+
+    /* A zero pivot is found before B is modified: diag = 0, sub sup = 0 */
+    StencilOperator Z = {0.0, 0.0, 1.0, n};
+    B[0] = 1.0;
+    dstencil_thomas(&Z, &one, B, &n, &info);
+    if (info != 1 || B[0] != 1.0) ok = 0;
+
+    printf("Matvec/residual difference: %e, residual history difference: %e, Thomas vs dgtsv: %e, Poisson forward error: %e\n",
+           max_mv, max_res, max_diff, err);
+    printf("Operator storage: %zu bytes (GB: %zu bytes)\n", sizeof(StencilOperator), sizeof(double) * lab * (size_t)n);
+    if (ok && max_res < 1e-12) {
+        printf("[PASS] Stencil operator matches the stored operators.\n");
+    } else {
+        printf("[FAIL] Stencil operator differs from the stored operators!\n");
+    }
+    printf("\n");
+
+    free(AB); free(MB); free(x); free(y); free(r); free(RHS); free(res_gb); free(res_st);
+    free(X_gb); free(X_st); free(B); free(G); free(dl); free(d); free(du);
+}
+
+/* Red-black Gauss-Seidel must keep the convergence rate of lexicographic Gauss-Seidel */
+void test_gauss_seidel_redblack(poisson1D_int n) {
+    printf("=== Test: Red-black vs lexicographic Gauss-Seidel (n=%" POISSON1D_PRId ") ===\n", n);
+
+    poisson1D_int kv = 0, ku = 1, kl = 1;
+    poisson1D_int lab = kv + kl + ku + 1;
+    double *AB = (double *)malloc(lab * n * sizeof(double));
+    double *MB = (double *)malloc(lab * n * sizeof(double));
+    set_GB_operator_colMajor_poisson1D(AB, &lab, &n, &kv);
+
+    double T0 = 5.0, T1 = 20.0;
+    double *RHS = (double *)malloc(n * sizeof(double));
+    double *X = (double *)malloc(n * sizeof(double));
+    double *EX = (double *)malloc(n * sizeof(double));
+    double *X_gs = (double *)calloc(n, sizeof(double));
+    double *X_rb = (double *)calloc(n, sizeof(double));
+    set_dense_RHS_DBC_1D(RHS, &n, &T0, &T1);
+    set_grid_points_1D(X, &n);
+    set_analytical_solution_DBC_1D(EX, X, &n, &T0, &T1);
+
+    double tol = 1e-8;
+    int maxit = 20000, nbite_gs = 0, nbite_rb = 0;
+    double *resvec = (double *)calloc(maxit, sizeof(double));
+
+    extract_MB_gauss_seidel_tridiag(AB, MB, &lab, &n, &ku, &kl, &kv);
+    richardson_MB(AB, RHS, X_gs, MB, &lab, &n, &ku, &kl, &tol, &maxit, resvec, &nbite_gs);
+    extract_MB_gauss_seidel_redblack_tridiag(AB, MB, &lab, &n, &ku, &kl, &kv);
+    richardson_MB_redblack(AB, RHS, X_rb, MB, &lab, &n, &ku, &kl, &tol, &maxit, resvec, &nbite_rb);
+
+    double err = relative_forward_error(X_rb, EX, &n);
+    printf("Iterations GS = %d, red-black GS = %d, red-black forward error = %e\n", nbite_gs, nbite_rb, err);
+
+    /* Same asymptotic rate: iteration counts within 10% */
+    if (nbite_rb < maxit && abs(nbite_rb - nbite_gs) <= nbite_gs / 10 + 1 && err < 1e-5) {
+        printf("[PASS] Red-black Gauss-Seidel converges like Gauss-Seidel.\n");
+    } else {
+        printf("[FAIL] Red-black Gauss-Seidel convergence differs!\n");
+    }
+    printf("\n");
+
+    free(AB); free(MB); free(RHS); free(X); free(EX); free(X_gs); free(X_rb); free(resvec);
+}
+
+/* Conjugate Gradient on GB, CSR and stencil backends: convergence in at most n iterations */
+void test_conjugate_gradient(poisson1D_int n) {
+    printf("=== Test: Conjugate Gradient GB / PCG / CSR / stencil (n=%" POISSON1D_PRId ") ===\n", n);
+
+    poisson1D_int kv = 0, ku = 1, kl = 1;
+    int jacobi = 1, ok = 1;
+    poisson1D_int lab = kv + kl + ku + 1;
+    double *AB = (double *)malloc(lab * n * sizeof(double));
+    double *MB = (double *)malloc(lab * n * sizeof(double));
+    set_GB_operator_colMajor_poisson1D(AB, &lab, &n, &kv);
+    extract_MB_jacobi_tridiag(AB, MB, &lab, &n, &ku, &kl, &kv);
+    CSRMatrix CSR_A;
+    set_CSR_operator_poisson1D(&CSR_A, &n);
+
+    double T0 = 5.0, T1 = 20.0;
+    double *RHS = (double *)malloc(n * sizeof(double));
+    double *X = (double *)malloc(n * sizeof(double));
+    double *EX = (double *)malloc(n * sizeof(double));
+    double *SOL = (double *)malloc(n * sizeof(double));
+    set_dense_RHS_DBC_1D(RHS, &n, &T0, &T1);
+    set_grid_points_1D(X, &n);
+    set_analytical_solution_DBC_1D(EX, X, &n, &T0, &T1);
+
+    double tol = 1e-10;
+    int maxit = (int) (n + 10), nbite;
+    double *resvec = (double *)calloc(maxit, sizeof(double));
+    const char *names[4] = {"CG (GB)", "PCG (GB)", "PCG (CSR)", "CG (stencil)"};
+    for (int m = 0; m < 4; m++) {
+        memset(SOL, 0, n * sizeof(double));
+        nbite = 0;
+        if (m == 0) conjugate_gradient(AB, RHS, SOL, NULL, &lab, &n, &ku, &kl, &tol, &maxit, resvec, &nbite);
+        if (m == 1) conjugate_gradient(AB, RHS, SOL, MB, &lab, &n, &ku, &kl, &tol, &maxit, resvec, &nbite);
+        if (m == 2) conjugate_gradient_csr(&CSR_A, RHS, SOL, &jacobi, &tol, &maxit, resvec, &nbite);
+        if (m == 3) conjugate_gradient_stencil(RHS, SOL, &n, &tol, &maxit, resvec, &nbite);
+        double err = relative_forward_error(SOL, EX, &n);
+        printf("%-13s: %d iterations, forward error %e\n", names[m], nbite, err);
+        if (nbite > n || err > 1e-8) ok = 0;
+    }
+
+    if (ok) {
+        printf("[PASS] Conjugate Gradient converges in at most n iterations.\n");
+    } else {
+        printf("[FAIL] Conjugate Gradient did not converge!\n");
+    }
+    printf("\n");
+
+    free(AB); free(MB); free(RHS); free(X); free(EX); free(SOL); free(resvec);
+    free(CSR_A.values); free(CSR_A.col_ind); free(CSR_A.row_ptr);
+}
+
+/* Chebyshev iteration on GB, CSR and CSC backends, plain and Jacobi, with sparse residual checks */
+void test_chebyshev(poisson1D_int n) {
+    printf("=== Test: Chebyshev GB / Jacobi GB / CSR / CSC (n=%" POISSON1D_PRId ") ===\n", n);
+
+    poisson1D_int kv = 0, ku = 1, kl = 1;
+    int jacobi = 1, check = 10, ok = 1;
+    poisson1D_int lab = kv + kl + ku + 1;
+    double *AB = (double *)malloc(lab * n * sizeof(double));
+    double *MB = (double *)malloc(lab * n * sizeof(double));
+    set_GB_operator_colMajor_poisson1D(AB, &lab, &n, &kv);
+    extract_MB_jacobi_tridiag(AB, MB, &lab, &n, &ku, &kl, &kv);
+    CSRMatrix CSR_A;
+    CSCMatrix CSC_A;
+    set_CSR_operator_poisson1D(&CSR_A, &n);
+    set_CSC_operator_poisson1D(&CSC_A, &n);
+
+    double T0 = 5.0, T1 = 20.0;
+    double *RHS = (double *)malloc(n * sizeof(double));
+    double *X = (double *)malloc(n * sizeof(double));
+    double *EX = (double *)malloc(n * sizeof(double));
+    double *SOL = (double *)malloc(n * sizeof(double));
+    set_dense_RHS_DBC_1D(RHS, &n, &T0, &T1);
+    set_grid_points_1D(X, &n);
+    set_analytical_solution_DBC_1D(EX, X, &n, &T0, &T1);
+
+    // Bounds of A, and of D^{-1} A = A / 2 for Jacobi
+    double eigmin = eigmin_poisson1D(&n), eigmax = eigmax_poisson1D(&n);
+    double eigmin_jac = 0.5 * eigmin, eigmax_jac = 0.5 * eigmax;
+    double tol = 1e-10;
+    int maxit = (int) (20 * n + 100), nbite;
+    double *resvec = (double *)calloc(maxit, sizeof(double));
+    const char *names[4] = {"Cheb (GB)", "PCheb (GB)", "PCheb (CSR)", "PCheb (CSC)"};
+    for (int m = 0; m < 4; m++) {
+        memset(SOL, 0, n * sizeof(double));
+        nbite = 0;
+        if (m == 0) chebyshev(AB, RHS, SOL, NULL, &lab, &n, &ku, &kl, &eigmin, &eigmax, &check, &tol, &maxit, resvec, &nbite);
+        if (m == 1) chebyshev(AB, RHS, SOL, MB, &lab, &n, &ku, &kl, &eigmin_jac, &eigmax_jac, &check, &tol, &maxit, resvec, &nbite);
+        if (m == 2) chebyshev_csr(&CSR_A, RHS, SOL, &jacobi, &eigmin_jac, &eigmax_jac, &check, &tol, &maxit, resvec, &nbite);
+        if (m == 3) chebyshev_csc(&CSC_A, RHS, SOL, &jacobi, &eigmin_jac, &eigmax_jac, &check, &tol, &maxit, resvec, &nbite);
+        double err = relative_forward_error(SOL, EX, &n);
+        printf("%-12s: %d iterations, forward error %e\n", names[m], nbite, err);
+        // Convergence can only be detected on a check iteration
+        if (nbite >= maxit || nbite % check != 0 || err > 1e-8) ok = 0;
+    }
+
+    if (ok) {
+        printf("[PASS] Chebyshev iteration converges on all backends.\n");
+    } else {
+        printf("[FAIL] Chebyshev iteration did not converge!\n");
+    }
+    printf("\n");
+
+    free(AB); free(MB); free(RHS); free(X); free(EX); free(SOL); free(resvec);
+    free(CSR_A.values); free(CSR_A.col_ind); free(CSR_A.row_ptr);
+    free(CSC_A.values); free(CSC_A.row_ind); free(CSC_A.col_ptr);
+}
+
+/* Mixed precision: float LU + double refinement reaches the accuracy of the double solve */
+void test_mixed_precision(poisson1D_int n, poisson1D_int nrhs) {
+    printf("=== Test: Mixed-precision solve with refinement (n=%" POISSON1D_PRId ", nrhs=%" POISSON1D_PRId ") ===\n", n, nrhs);
+
+    poisson1D_int kv = 1, ku = 1, kl = 1, info;
+    int ok = 1;
+    poisson1D_int lab = kv + kl + ku + 1;
+    double *AB = (double *)malloc(lab * n * sizeof(double));
+    double *LU = (double *)malloc(lab * n * sizeof(double));
+    float *ABs = (float *)malloc(lab * n * sizeof(float));
+    float *ABt = (float *)malloc(lab * n * sizeof(float));
+    poisson1D_int *ipiv = (poisson1D_int *)malloc(n * sizeof(poisson1D_int));
+    set_GB_operator_colMajor_poisson1D(AB, &lab, &n, &kv);
+
+    // sgbtrftridiag gives the sgbtrf factors (no pivoting happens on this operator)
+    for (int i = 0; i < lab * n; i++) ABs[i] = ABt[i] = (float)AB[i];
+    sgbtrf_(&n, &n, &kl, &ku, ABs, &lab, ipiv, &info);
+    sgbtrftridiag(&lab, &n, &kl, &ku, ABt, &lab, ipiv, &info);
+    float fdiff = 0.0f;
+    for (int i = 0; i < lab * n; i++) fdiff = fmaxf(fdiff, fabsf(ABs[i] - ABt[i]));
+    if (info != 0 || fdiff > 1e-6f) ok = 0;
+
+    double *X = (double *)malloc(n * sizeof(double));
+    double *T0s = (double *)malloc(nrhs * sizeof(double));
+    double *T1s = (double *)malloc(nrhs * sizeof(double));
+    double *B = (double *)malloc((size_t)n * nrhs * sizeof(double));
+    double *Bd = (double *)malloc((size_t)n * nrhs * sizeof(double));
+    double *EX = (double *)malloc(n * sizeof(double));
+    for (int k = 0; k < nrhs; k++) {T0s[k] = -5.0 + k; T1s[k] = 5.0 - 0.5 * k;}
+    set_grid_points_1D(X, &n);
+    set_dense_RHS_DBC_1D_batch(B, &n, &nrhs, T0s, T1s);
+    memcpy(Bd, B, (size_t)n * nrhs * sizeof(double));
+
+    // Double-precision reference accuracy
+    memcpy(LU, AB, lab * n * sizeof(double));
+    dgbtrftridiag(&lab, &n, &kl, &ku, LU, &lab, ipiv, &info);
+    dgbtrs_("N", &n, &kl, &ku, &nrhs, LU, &lab, ipiv, Bd, &n, &info);
+
+    for (int kind = POISSON1D_MIXED_TRF; kind <= POISSON1D_MIXED_TRI; kind++) {
+        double *Bm = (double *)malloc((size_t)n * nrhs * sizeof(double));
+        double tol = 0.0, err = 0.0, errd = 0.0;
+        int maxref = POISSON1D_MIXED_MAXREF, iter;
+        memcpy(Bm, B, (size_t)n * nrhs * sizeof(double));
+        dgbsv_mixed(&kind, &n, &kl, &ku, &nrhs, AB, &lab, Bm, &n, &tol, &maxref, &iter, &info);
+        for (int k = 0; k < nrhs; k++) {
+            set_analytical_solution_DBC_1D(EX, X, &n, &T0s[k], &T1s[k]);
+            err = fmax(err, relative_forward_error(Bm + (size_t)k * n, EX, &n));
+            errd = fmax(errd, relative_forward_error(Bd + (size_t)k * n, EX, &n));
+        }
+        printf("%s: refinement steps %d, forward error %e (double LU %e)\n",
+               kind == POISSON1D_MIXED_TRF ? "sgbtrf       " : "sgbtrftridiag", iter, err, errd);
+        if (info != 0 || iter == 0 || err > 10.0 * errd + 1e-15) ok = 0;
+        free(Bm);
+    }
+
+    if (ok) {
+        printf("[PASS] Mixed-precision solve is as accurate as the double solve.\n");
+    } else {
+        printf("[FAIL] Mixed-precision solve lost accuracy!\n");
+    }
+    printf("\n");
+
+    free(AB); free(LU); free(ABs); free(ABt); free(ipiv);
+    free(X); free(T0s); free(T1s); free(B); free(Bd); free(EX);
+}
+
+/* Threaded dcsrmv/dcscmv against a serial loop, with entries far from the diagonal (atomic path) */
+void test_parallel_spmv(poisson1D_int n) {
+    printf("=== Test: Parallel CSR / CSC SpMV (n=%" POISSON1D_PRId ") ===\n", n);
+
+    // A in CSC: tridiagonal plus one far entry per column and a dense first row every 100 columns.
+    // The same arrays read as CSR hold A^T.
+    CSCMatrix A;
+    A.n = n;
+    A.col_ptr = (poisson1D_int *)malloc((n + 1) * sizeof(poisson1D_int));
+    A.row_ind = (poisson1D_int *)malloc(5 * n * sizeof(poisson1D_int));
+    A.values = (double *)malloc(5 * n * sizeof(double));
+    A.nnz = 0;
+    srand(11);
+    for (int j = 0; j < n; j++) {
+        A.col_ptr[j] = A.nnz;
+        int rows[5] = {j - 1, j, j + 1, (int)(((long long)j * 7919 + 13) % n), (j % 100 == 0) ? 0 : -1};
+        for (int k = 0; k < 5; k++) {
+            if (rows[k] < 0 || rows[k] >= n) continue;
+            A.row_ind[A.nnz] = rows[k];
+            A.values[A.nnz++] = (double)rand() / RAND_MAX - 0.5;
+        }
+    }
+    A.col_ptr[n] = A.nnz;
+    CSRMatrix AT = {A.values, A.row_ind, A.col_ptr, A.nnz, n};
+
+    double *x = (double *)malloc(n * sizeof(double));
+    double *y = (double *)malloc(n * sizeof(double));
+    double *yref = (double *)calloc(n, sizeof(double));
+    double *ytref = (double *)calloc(n, sizeof(double));
+    for (int i = 0; i < n; i++) x[i] = (double)rand() / RAND_MAX;
+    for (int j = 0; j < n; j++) {
+        for (poisson1D_int k = A.col_ptr[j]; k < A.col_ptr[j + 1]; k++) {
+            yref[A.row_ind[k]] += A.values[k] * x[j];
+            ytref[j] += A.values[k] * x[A.row_ind[k]];
+        }
+    }
+
+    int ok = 1, maxthreads = 4;
+#ifdef _OPENMP
+    int saved = omp_get_max_threads();
+#else
+    maxthreads = 1;
+#endif
+    for (int nt = 1; nt <= maxthreads; nt++) {
+#ifdef _OPENMP
+        omp_set_num_threads(nt);
+#endif
+        double err = 0.0, errt = 0.0;
+        dcscmv(&A, x, y);
+        for (int i = 0; i < n; i++) err = fmax(err, fabs(y[i] - yref[i]) / (1.0 + fabs(yref[i])));
+        dcsrmv(&AT, x, y);
+        for (int i = 0; i < n; i++) errt = fmax(errt, fabs(y[i] - ytref[i]) / (1.0 + fabs(ytref[i])));
+        printf("%d thread(s): CSC error %e, CSR error %e\n", nt, err, errt);
+        if (err > 1e-13 || errt > 1e-13) ok = 0;
+    }
+#ifdef _OPENMP
+    omp_set_num_threads(saved);
+#endif
+
+    if (ok) {
+        printf("[PASS] Threaded CSR/CSC products match the serial loops.\n");
+    } else {
+        printf("[FAIL] Threaded CSR/CSC products differ!\n");
+    }
+    printf("\n");
+
+    free(x); free(y); free(yref); free(ytref);
+    free(A.values); free(A.row_ind); free(A.col_ptr);
+}
+
+/* DIA and SELL-C-sigma: every SIMD level against dcsrmv, on Poisson and on an irregular pattern */
+void test_sparse_formats(poisson1D_int n) {
+    printf("=== Test: DIA / SELL-C-sigma SpMV and solvers (n=%" POISSON1D_PRId ") ===\n", n);
+
+    int ok = 1, jacobi = 1, best = poisson1D_simd_detect();
+    CSRMatrix P, Q;
+    set_CSR_operator_poisson1D(&P, &n);
+
+    // Irregular pattern: rows of 2 to 5 entries on 5 diagonals (-2, -1, 0, 1, 3)
+    Q.n = n;
+    Q.row_ptr = (poisson1D_int *)malloc((n + 1) * sizeof(poisson1D_int));
+    Q.col_ind = (poisson1D_int *)malloc(5 * n * sizeof(poisson1D_int));
+    Q.values = (double *)malloc(5 * n * sizeof(double));
+    Q.nnz = 0;
+    srand(7);
+    for (int i = 0; i < n; i++) {
+        Q.row_ptr[i] = Q.nnz;
+        int cols[5] = {i - 2, i - 1, i, i + 1, i + 3};
+        for (int k = 0; k < 5; k++) {
+            int j = cols[k];
+            if (j < 0 || j >= n) continue;
+            if ((k == 0 && i % 3 != 0) || (k == 4 && i % 4 != 0)) continue;
+            Q.col_ind[Q.nnz] = j;
+            Q.values[Q.nnz++] = (j == i) ? 8.0 : (double)rand() / RAND_MAX - 0.5;
+        }
+    }
+    Q.row_ptr[n] = Q.nnz;
+
+    double *x = (double *)malloc(n * sizeof(double));
+    double *yref = (double *)malloc(n * sizeof(double));
+    double *y = (double *)malloc(n * sizeof(double));
+    for (int i = 0; i < n; i++) x[i] = (double)rand() / RAND_MAX;
+
+    int Cs[3] = {8, 4, 3}, sigmas[3] = {1, 16, 5};
+    for (int level = POISSON1D_SIMD_SCALAR; level <= best; level++) {
+        poisson1D_simd_select(&level);
+        for (int m = 0; m < 2; m++) {
+            CSRMatrix *A = (m == 0) ? &P : &Q;
+            DIAMatrix D;
+            dcsrmv(A, x, yref);
+            if (csr_to_dia(A, &D) != 0 || D.ndiag != ((m == 0) ? 3 : 5)) {ok = 0; continue;}
+            ddiamv(&D, x, y);
+            for (int i = 0; i < n; i++) if (fabs(y[i] - yref[i]) > 1e-14 * (1.0 + fabs(yref[i]))) ok = 0;
+            free_DIA_matrix(&D);
+            for (int k = 0; k < 3; k++) {
+                SELLMatrix S;
+                if (csr_to_sell(A, &Cs[k], &sigmas[k], &S) != 0) {ok = 0; continue;}
+                memset(y, 0, n * sizeof(double));
+                dsellmv(&S, x, y);
+                for (int i = 0; i < n; i++) if (fabs(y[i] - yref[i]) > 1e-14 * (1.0 + fabs(yref[i]))) ok = 0;
+                free_SELL_matrix(&S);
+            }
+        }
+        printf("SpMV kernels %-6s: %s\n", poisson1D_simd_name(level), ok ? "match dcsrmv" : "MISMATCH");
+    }
+    poisson1D_simd_select(&best);
+
+    // Solvers on the Poisson operator: same iteration counts as CSR
+    double T0 = 5.0, T1 = 20.0, tol = 1e-10, alpha = richardson_alpha_opt(&n), rtol = 1e-3;
+    int maxit = (int) (n + 10), rmaxit = 200, C = POISSON1D_SELL_C, sigma = 1, nb_ref, nb;
+    double *RHS = (double *)malloc(n * sizeof(double));
+    double *SOL = (double *)malloc(n * sizeof(double));
+    double *REF = (double *)malloc(n * sizeof(double));
+    double *resvec = (double *)calloc(maxit > rmaxit ? maxit : rmaxit, sizeof(double));
+    set_dense_RHS_DBC_1D(RHS, &n, &T0, &T1);
+    DIAMatrix D;
+    SELLMatrix S;
+    csr_to_dia(&P, &D);
+    csr_to_sell(&P, &C, &sigma, &S);
+
+    memset(REF, 0, n * sizeof(double));
+    conjugate_gradient_csr(&P, RHS, REF, &jacobi, &tol, &maxit, resvec, &nb_ref);
+    for (int m = 0; m < 2; m++) {
+        memset(SOL, 0, n * sizeof(double));
+        if (m == 0) conjugate_gradient_dia(&D, RHS, SOL, &jacobi, &tol, &maxit, resvec, &nb);
+        else conjugate_gradient_sell(&S, RHS, SOL, &jacobi, &tol, &maxit, resvec, &nb);
+        if (abs(nb - nb_ref) > 1 || relative_forward_error(SOL, REF, &n) > 1e-8) ok = 0;
+    }
+    memset(REF, 0, n * sizeof(double));
+    richardson_alpha_csr(&P, RHS, REF, &alpha, &rtol, &rmaxit, resvec, &nb_ref);
+    for (int m = 0; m < 2; m++) {
+        memset(SOL, 0, n * sizeof(double));
+        if (m == 0) richardson_alpha_dia(&D, RHS, SOL, &alpha, &rtol, &rmaxit, resvec, &nb);
+        else richardson_alpha_sell(&S, RHS, SOL, &alpha, &rtol, &rmaxit, resvec, &nb);
+        if (nb != nb_ref || relative_forward_error(SOL, REF, &n) > 1e-12) ok = 0;
+    }
+
+    if (ok) {
+        printf("[PASS] DIA and SELL-C-sigma match CSR on every SIMD level.\n");
+    } else {
+        printf("[FAIL] DIA / SELL-C-sigma differ from CSR!\n");
+    }
+    printf("\n");
+
+    free_DIA_matrix(&D); free_SELL_matrix(&S);
+    free(x); free(y); free(yref); free(RHS); free(SOL); free(REF); free(resvec);
+    free(P.values); free(P.col_ind); free(P.row_ptr);
+    free(Q.values); free(Q.col_ind); free(Q.row_ptr);
+}
+
+/* Workspace API: *_ws solvers reuse one workspace and match the allocating versions */
+void test_workspace_solvers(poisson1D_int n) {
+    printf("=== Test: Workspace solvers (n=%" POISSON1D_PRId ") ===\n", n);
+
+    poisson1D_int kv = 0, ku = 1, kl = 1;
+    int ok = 1, check = 5;
+    poisson1D_int lab = kv + kl + ku + 1;
+    double *AB = (double *)malloc(lab * n * sizeof(double));
+    double *MB = (double *)malloc(lab * n * sizeof(double));
+    double *MBj = (double *)malloc(lab * n * sizeof(double));
+    set_GB_operator_colMajor_poisson1D(AB, &lab, &n, &kv);
+    extract_MB_gauss_seidel_tridiag(AB, MB, &lab, &n, &ku, &kl, &kv);
+    extract_MB_jacobi_tridiag(AB, MBj, &lab, &n, &ku, &kl, &kv);
+    CSRMatrix CSR_A;
+    set_CSR_operator_poisson1D(&CSR_A, &n);
+
+    double T0 = 5.0, T1 = 20.0;
+    double *RHS = (double *)malloc(n * sizeof(double));
+    double *X1 = (double *)malloc(n * sizeof(double));
+    double *X2 = (double *)malloc(n * sizeof(double));
+    set_grid_points_1D(X1, &n);
+    set_dense_RHS_DBC_1D(RHS, &n, &T0, &T1);
+
+    double tol = 1e-6, alpha = richardson_alpha_opt(&n);
+    double eigmin = eigmin_poisson1D(&n), eigmax = eigmax_poisson1D(&n);
+    double eigmin_jac = 0.5 * eigmin, eigmax_jac = 0.5 * eigmax;
+    int maxit = 200, nb1, nb2, jacobi = 1;
+    double *res1 = (double *)calloc(maxit, sizeof(double));
+    double *res2 = (double *)calloc(maxit, sizeof(double));
+    int method = POISSON1D_WS_ALL;
+    size_t need = 0;
+    for (int m = 0; m < POISSON1D_WS_ALL; m++) {
+        size_t sz = poisson1D_workspace_query(&m, &n);
+        if (sz > need) need = sz;
+    }
+    Poisson1DWorkspace *ws = poisson1D_workspace_create(&method, &n);
+    if (ws == NULL || ws->size != need) ok = 0;
+
+    // Same workspace for every method, solved twice to exercise reuse
+    for (int rep = 0; rep < 2 && ok; rep++) {
+        for (int m = 0; m < 9; m++) {
+            memset(X1, 0, n * sizeof(double));
+            memset(X2, 0, n * sizeof(double));
+            if (m == 0) {
+                richardson_alpha(AB, RHS, X1, &alpha, &lab, &n, &ku, &kl, &tol, &maxit, res1, &nb1);
+                richardson_alpha_ws(AB, RHS, X2, &alpha, &lab, &n, &ku, &kl, &tol, &maxit, res2, &nb2, ws);
+            } else if (m == 1) {
+                richardson_MB(AB, RHS, X1, MB, &lab, &n, &ku, &kl, &tol, &maxit, res1, &nb1);
+                richardson_MB_ws(AB, RHS, X2, MB, &lab, &n, &ku, &kl, &tol, &maxit, res2, &nb2, ws);
+            } else if (m == 2) {
+                richardson_alpha_csr(&CSR_A, RHS, X1, &alpha, &tol, &maxit, res1, &nb1);
+                richardson_alpha_csr_ws(&CSR_A, RHS, X2, &alpha, &tol, &maxit, res2, &nb2, ws);
+            } else if (m == 3) {
+                conjugate_gradient(AB, RHS, X1, NULL, &lab, &n, &ku, &kl, &tol, &maxit, res1, &nb1);
+                conjugate_gradient_ws(AB, RHS, X2, NULL, &lab, &n, &ku, &kl, &tol, &maxit, res2, &nb2, ws);
+            } else if (m == 4) {
+                chebyshev(AB, RHS, X1, NULL, &lab, &n, &ku, &kl, &eigmin, &eigmax, &check, &tol, &maxit, res1, &nb1);
+                chebyshev_ws(AB, RHS, X2, NULL, &lab, &n, &ku, &kl, &eigmin, &eigmax, &check, &tol, &maxit, res2, &nb2, ws);
+            } else if (m == 5) {
+                conjugate_gradient_csr(&CSR_A, RHS, X1, &jacobi, &tol, &maxit, res1, &nb1);
+                conjugate_gradient_csr_ws(&CSR_A, RHS, X2, &jacobi, &tol, &maxit, res2, &nb2, ws);
+            } else if (m == 6) {
+                chebyshev_csr(&CSR_A, RHS, X1, &jacobi, &eigmin_jac, &eigmax_jac, &check, &tol, &maxit, res1, &nb1);
+                chebyshev_csr_ws(&CSR_A, RHS, X2, &jacobi, &eigmin_jac, &eigmax_jac, &check, &tol, &maxit, res2, &nb2, ws);
+            } else if (m == 7) {
+                // Jacobi without MB: the diagonal is read from AB
+                richardson_MB(AB, RHS, X1, MBj, &lab, &n, &ku, &kl, &tol, &maxit, res1, &nb1);
+                richardson_jacobi_ws(AB, RHS, X2, &lab, &n, &ku, &kl, &tol, &maxit, res2, &nb2, ws);
+            } else {
+                conjugate_gradient(AB, RHS, X1, MBj, &lab, &n, &ku, &kl, &tol, &maxit, res1, &nb1);
+                conjugate_gradient_ws(AB, RHS, X2, AB, &lab, &n, &ku, &kl, &tol, &maxit, res2, &nb2, ws);
+            }
+            if (nb1 != nb2 || memcmp(X1, X2, n * sizeof(double)) != 0) ok = 0;
+        }
+    }
+    if (relative_forward_error_ws(X1, X2, &n, ws) != 0.0) ok = 0;
+
+    // A workspace that is too small is refused without touching X
+    poisson1D_int small = n / 2;
+    method = POISSON1D_WS_RICHARDSON;
+    Poisson1DWorkspace *tiny = poisson1D_workspace_create(&method, &small);
+    set_grid_points_1D(X2, &n);
+    memcpy(X1, X2, n * sizeof(double));
+    richardson_alpha_ws(AB, RHS, X2, &alpha, &lab, &n, &ku, &kl, &tol, &maxit, res2, &nb2, tiny);
+    if (nb2 != 0 || memcmp(X1, X2, n * sizeof(double)) != 0) ok = 0;
+
+    if (ok) {
+        printf("[PASS] Workspace solvers match the allocating solvers.\n");
+    } else {
+        printf("[FAIL] Workspace solvers differ!\n");
+    }
+    printf("\n");
+
+    poisson1D_workspace_destroy(ws);
+    poisson1D_workspace_destroy(tiny);
+    free(AB); free(MB); free(MBj); free(RHS); free(X1); free(X2); free(res1); free(res2);
+    free(CSR_A.values); free(CSR_A.col_ind); free(CSR_A.row_ptr);
+}
+
+/* Multigrid: convergence rate independent of n, for both smoothers and with FMG */
+void test_multigrid(poisson1D_int n) {
+    printf("=== Test: Multigrid V-cycle / FMG (n=%" POISSON1D_PRId ") ===\n", n);
+
+    double T0 = 5.0, T1 = 20.0;
+    double *RHS = (double *)malloc(n * sizeof(double));
+    double *X = (double *)malloc(n * sizeof(double));
+    double *EX = (double *)malloc(n * sizeof(double));
+    double *SOL = (double *)malloc(n * sizeof(double));
+    set_dense_RHS_DBC_1D(RHS, &n, &T0, &T1);
+    set_grid_points_1D(X, &n);
+    set_analytical_solution_DBC_1D(EX, X, &n, &T0, &T1);
+
+    double tol = 1e-10;
+    int maxit = 50, nbite, maxlevels = 0, ok = 1;
+    double *resvec = (double *)calloc(maxit, sizeof(double));
+    const char *names[3] = {"V (Jacobi)", "V (GS)", "FMG (GS)"};
+    for (int m = 0; m < 3; m++) {
+        int smoother = (m == 0) ? MG_SMOOTHER_JACOBI : MG_SMOOTHER_GS;
+        int fmg = (m == 2);
+        MGHierarchy *mg = mg_hierarchy_create(&n, &smoother, &maxlevels);
+        memset(SOL, 0, n * sizeof(double));
+        nbite = 0;
+        multigrid_solve(mg, RHS, SOL, &fmg, &tol, &maxit, resvec, &nbite);
+        double err = relative_forward_error(SOL, EX, &n);
+        printf("%-10s: %d levels, %d cycles, forward error %e\n", names[m], mg->nlevels, nbite, err);
+        if (nbite > 20 || err > 1e-8 || mg->nlevels < 2) ok = 0;
+        mg_hierarchy_destroy(mg);
+    }
+
+    if (ok) {
+        printf("[PASS] Multigrid converges in a bounded number of cycles.\n");
+    } else {
+        printf("[FAIL] Multigrid convergence too slow!\n");
+    }
+    printf("\n");
+
+    free(RHS); free(X); free(EX); free(SOL); free(resvec);
+}
+
+/* Binary container: written vectors and operators map back bit-exact with the right header */
+void test_binary_roundtrip(poisson1D_int n) {
+    printf("=== Test: Binary write / mmap read (n=%" POISSON1D_PRId ") ===\n", n);
+
+    poisson1D_int kv = 1, ku = 1, kl = 1;
+    int ok = 1;
+    poisson1D_int lab = kv + kl + ku + 1;
+    double *AB = (double *)malloc(lab * n * sizeof(double));
+    double *X = (double *)malloc(n * sizeof(double));
+    double *V = (double *)malloc(n * sizeof(double));
+    set_GB_operator_colMajor_poisson1D(AB, &lab, &n, &kv);
+    set_grid_points_1D(X, &n);
+    for (int i = 0; i < n; i++) V[i] = 1.0 / (3.0 + i);  // not representable in 6 decimals
+    TriDiagMatrix TD;
+    set_tridiag_operator_poisson1D(&TD, &n);
+
+    write_vec_bin(V, &n, "test_vec.bin");
+    write_xy_bin(V, X, &n, "test_xy.bin");
+    write_GB_operator_colMajor_poisson1D_bin(AB, &lab, &n, &kl, &ku, &kv, "test_gb.bin");
+    write_tridiag_operator_poisson1D_bin(&TD, "test_td.bin");
+
+    Poisson1DBinFile f;
+    if (poisson1D_bin_map("test_vec.bin", &f) != 0 || f.hdr.type != POISSON1D_BIN_VEC || f.hdr.rows != n
+        || memcmp(f.data, V, n * sizeof(double)) != 0) ok = 0;
+    poisson1D_bin_unmap(&f);
+    if (poisson1D_bin_map("test_xy.bin", &f) != 0 || f.hdr.type != POISSON1D_BIN_XY || f.hdr.cols != 2
+        || memcmp(f.data, X, n * sizeof(double)) != 0 || memcmp(f.data + n, V, n * sizeof(double)) != 0) ok = 0;
+    poisson1D_bin_unmap(&f);
+    if (poisson1D_bin_map("test_gb.bin", &f) != 0 || f.hdr.type != POISSON1D_BIN_GB || f.hdr.lab != lab
+        || f.hdr.kv != kv || f.hdr.cols != n || memcmp(f.data, AB, lab * n * sizeof(double)) != 0) ok = 0;
+    poisson1D_bin_unmap(&f);
+    if (poisson1D_bin_map("test_td.bin", &f) != 0 || f.hdr.type != POISSON1D_BIN_TRIDIAG
+        || f.data[0] != 0.0 || memcmp(f.data + 1, TD.dl, (n - 1) * sizeof(double)) != 0
+        || memcmp(f.data + n, TD.d, n * sizeof(double)) != 0
+        || memcmp(f.data + 2 * n, TD.du, (n - 1) * sizeof(double)) != 0 || f.data[3 * n - 1] != 0.0) ok = 0;
+    poisson1D_bin_unmap(&f);
+    // A text file must be rejected
+    write_vec(V, &n, "test_vec.dat");
+    if (poisson1D_bin_map("test_vec.dat", &f) == 0) {ok = 0; poisson1D_bin_unmap(&f);}
+
+    if (ok) {
+        printf("[PASS] Binary files map back exactly.\n");
+    } else {
+        printf("[FAIL] Binary round trip mismatch!\n");
+    }
+    printf("\n");
+
+    remove("test_vec.bin"); remove("test_xy.bin"); remove("test_gb.bin"); remove("test_td.bin"); remove("test_vec.dat");
+    free(AB); free(X); free(V);
+    free(TD.dl); free(TD.d); free(TD.du);
+}
+
+/* Out-of-core solves against the in-core Thomas factorization (same recurrence): a 64 KiB budget
+   gives windows of 512 rows, so n > 512 crosses window and page boundaries in both passes */
+void test_out_of_core(poisson1D_int n) {
+    printf("=== Test: Out-of-core tridiagonal solve (n=%" POISSON1D_PRId ") ===\n", n);
+
+    poisson1D_int one = 1, info;
+    int ok = 1;
+    size_t budget = (size_t)64 << 10;
+    TriDiagMatrix TD;
+    TD.n = n;
+    TD.dl = (double *)malloc((n > 1 ? n - 1 : 1) * sizeof(double));
+    TD.d = (double *)malloc(n * sizeof(double));
+    TD.du = (double *)malloc((n > 1 ? n - 1 : 1) * sizeof(double));
+    for (int i = 0; i < n - 1; i++) {
+        TD.dl[i] = -1.0 - 0.5 * sin(0.3 * i);
+        TD.du[i] = -1.0 + 0.25 * cos(0.7 * i);
+    }
+    for (int i = 0; i < n; i++) TD.d[i] = 3.0 + 0.5 * sin(0.11 * i);
+    double *B = (double *)malloc(n * sizeof(double));
+    double *X = (double *)malloc(n * sizeof(double));
+    for (int i = 0; i < n; i++) B[i] = 1.0 + cos(0.1 * i);
+    write_tridiag_operator_poisson1D_bin(&TD, "test_ooc_op.bin");
+    write_vec_bin(B, &n, "test_ooc_rhs.bin");
+
+    /* Operator file */
+    double max_err = 0.0;
+    memcpy(X, B, n * sizeof(double));
+    dgttrftridiag(&n, TD.dl, TD.d, TD.du, &info);
+    dgttrstridiag(&n, &one, TD.dl, TD.d, TD.du, X, &n, &info);
+    Poisson1DBinFile f;
+    dgtsv_ooc("test_ooc_op.bin", "test_ooc_rhs.bin", "test_ooc_sol.bin", "test_ooc_fac.bin", &budget, &info);
+    if (info != 0 || poisson1D_bin_map("test_ooc_sol.bin", &f) != 0) {
+        ok = 0;
+    } else {
+        if (f.hdr.rows != n) ok = 0;
+        for (int i = 0; i < n && ok; i++) max_err = fmax(max_err, fabs(f.data[i] - X[i]) / fabs(X[i]));
+        poisson1D_bin_unmap(&f);
+    }
+
+    /* Stencil operator, default budget */
+    StencilOperator A = {-1.2, 3.0, -0.7, n};
+    size_t dflt = 0;
+    memcpy(X, B, n * sizeof(double));
+    dstencil_thomas(&A, &one, X, &n, &info);
+    dstencil_thomas_ooc(&A, "test_ooc_rhs.bin", "test_ooc_sol.bin", "test_ooc_fac.bin", &dflt, &info);
+    if (info != 0 || poisson1D_bin_map("test_ooc_sol.bin", &f) != 0) {
+        ok = 0;
+    } else {
+        if (f.hdr.rows != n) ok = 0;
+        for (int i = 0; i < n && ok; i++) max_err = fmax(max_err, fabs(f.data[i] - X[i]) / fabs(X[i]));
+        poisson1D_bin_unmap(&f);
+    }
+
+    /* Zero first pivot, then a size mismatch */
+    StencilOperator Z = {1.0, 0.0, 1.0, n};
+    dstencil_thomas_ooc(&Z, "test_ooc_rhs.bin", "test_ooc_sol.bin", "test_ooc_fac.bin", &budget, &info);
+    if (info != 1) ok = 0;
+    A.n = n + 1;
+    dstencil_thomas_ooc(&A, "test_ooc_rhs.bin", "test_ooc_sol.bin", "test_ooc_fac.bin", &budget, &info);
+    if (info != -1) ok = 0;
+
+    if (ok && max_err < 1e-13) {
+        printf("[PASS] Out-of-core solutions match the in-core Thomas solve (max rel err = %e).\n", max_err);
+    } else {
+        printf("[FAIL] Out-of-core solve mismatch (max rel err = %e)!\n", max_err);
+    }
+    printf("\n");
+
+    remove("test_ooc_op.bin"); remove("test_ooc_rhs.bin"); remove("test_ooc_sol.bin"); remove("test_ooc_fac.bin");
+    free(B); free(X);
+    free(TD.dl); free(TD.d); free(TD.du);
+}
+
+/* Timing layer: phases accumulate over begin/end pairs and the CSV report has one line per phase */
+void test_timing_report(void) {
+    printf("=== Test: Per-phase timing report ===\n");
+
+    poisson1D_int n = 100;
+    int counters = 0, implem = 0, ok = 1;
+    poisson1D_timing_init(&counters);
+    for (int k = 0; k < 3; k++) {
+        poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+        struct timespec pause = {0, 1000000};  // 1 ms
+        nanosleep(&pause, NULL);
+        poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+    }
+    poisson1D_timing_add_count(POISSON1D_PHASE_SOLVE, 3);
+    double t = poisson1D_timing_seconds(POISSON1D_PHASE_SOLVE);
+    printf("solve phase: %f ms over 3 calls\n", t * 1000.0);
+    if (t < 3.0e-3 || t > 1.0 || poisson1D_timing_seconds(POISSON1D_PHASE_FACTOR) != 0.0) ok = 0;
+
+    remove("test_timing.csv");
+    poisson1D_timing_write("test_timing.csv", "test", &implem, &n);
+    poisson1D_timing_write("test_timing.csv", "test", &implem, &n);
+    FILE *f = fopen("test_timing.csv", "r");
+    char line[256];
+    int lines = 0, solve_lines = 0;
+    while (f != NULL && fgets(line, sizeof(line), f) != NULL) {
+        lines++;
+        if (strstr(line, "test,0,100,solve,3,3,") == line) solve_lines++;
+    }
+    if (f != NULL) fclose(f);
+    // header once, then one line per used phase and per run
+    if (lines != 3 || solve_lines != 2) ok = 0;
+    poisson1D_timing_finalize();
+
+    // Library entry points time themselves, nested ones count once; iterations sampled with POISSON1D_TIMING
+    double *RHS = (double *)malloc(n * sizeof(double));
+    double *X = (double *)calloc(n, sizeof(double));
+    double resvec[50], alpha = 0.5, T0 = -5.0, T1 = 5.0, tol = 1e-30, sec[64];
+    long it[64];
+    int maxit = 50, nbite = 0, max = 64;
+    setenv("POISSON1D_TIMING", "1", 1);
+    poisson1D_timing_init(&counters);
+    set_dense_RHS_DBC_1D(RHS, &n, &T0, &T1);
+    poisson1D_timing_begin(POISSON1D_PHASE_ITER);
+    richardson_alpha_stencil(RHS, X, &alpha, &n, &tol, &maxit, resvec, &nbite);
+    poisson1D_timing_end(POISSON1D_PHASE_ITER);
+    int ns = poisson1D_timing_samples(it, sec, &max);
+    if (ns != nbite || nbite != maxit || it[ns - 1] != nbite - 1 || sec[ns - 1] < sec[0]) ok = 0;
+    remove("test_timing.csv");
+    poisson1D_timing_write("test_timing.csv", "test", &implem, &n);
+    f = fopen("test_timing.csv", "r");
+    int assembly_lines = 0, iter_lines = 0, sample_lines = 0;
+    while (f != NULL && fgets(line, sizeof(line), f) != NULL) {
+        if (strstr(line, "test,0,100,assembly,1,") == line) assembly_lines++;
+        if (strstr(line, "test,0,100,iter,1,") == line) iter_lines++;
+        if (strstr(line, "test,0,100,iteration,1,") == line) sample_lines++;
+    }
+    if (f != NULL) fclose(f);
+    if (assembly_lines != 1 || iter_lines != 1 || sample_lines != nbite) ok = 0;
+    poisson1D_timing_finalize();
+    unsetenv("POISSON1D_TIMING");
+    printf("library phases: %d iteration samples over %d iterations\n", ns, nbite);
+    free(RHS); free(X);
+
+    if (ok) {
+        printf("[PASS] Phase timings and CSV report are consistent.\n");
+    } else {
+        printf("[FAIL] Phase timing report mismatch!\n");
+    }
+    printf("\n");
+
+    remove("test_timing.csv");
+}
+
+/* Validation of the theta-scheme stepper against the discrete solution (eigenmode damped by g per
+   step) and of the background snapshot writer (more snapshots than buffers) */
+void test_heat_stepper(poisson1D_int n) {
+    printf("=== Test: Theta-scheme heat stepper and snapshot writer (n=%" POISSON1D_PRId ") ===\n", n);
+
+    poisson1D_int info;
+    int ok = 1, nsteps = 50;
+    double T0 = -5.0, T1 = 5.0, dt = 1.0e-3, h = 1.0 / (n + 1);
+    double thetas[2] = {POISSON1D_THETA_EULER, POISSON1D_THETA_CN};
+    double *X = (double *)malloc(n * sizeof(double));
+    double *U = (double *)malloc(n * sizeof(double));
+    double *ref = (double *)malloc(n * sizeof(double));
+    set_grid_points_1D(X, &n);
+    double lambda = eigmin_poisson1D(&n) / (h * h);
+
+    for (int k = 0; k < 2; k++) {
+        Poisson1DHeatStepper *st = poisson1D_heat_create(&n, &thetas[k], &dt, &T0, &T1, &info);
+        if (st == NULL) {ok = 0; continue;}
+        set_analytical_solution_DBC_1D(U, X, &n, &T0, &T1);
+        set_analytical_solution_DBC_1D(ref, X, &n, &T0, &T1);
+        double g = (1.0 - (1.0 - thetas[k]) * dt * lambda) / (1.0 + thetas[k] * dt * lambda);
+        for (int i = 0; i < n; i++) {
+            U[i] += sin(M_PI * X[i]);
+            ref[i] += pow(g, nsteps) * sin(M_PI * X[i]);
+        }
+        poisson1D_heat_step(st, U, &nsteps, &info);
+        double err = relative_forward_error(ref, U, &n);
+        printf("theta=%.1f: relative error vs discrete solution %e\n", thetas[k], err);
+        if (info != 0 || err > 1e-12) ok = 0;
+        poisson1D_heat_destroy(st);
+    }
+
+    /* 10 snapshots through 2 buffers, then read back */
+    int depth = 2, text = 0, written = -1, stalls = -1;
+    Poisson1DSnapshotWriter *w = poisson1D_snapshot_writer_create(&n, &depth, "test_snap", &text);
+    if (w == NULL) ok = 0;
+    for (int step = 0; w != NULL && step < 10; step++) {
+        for (int i = 0; i < n; i++) U[i] = step + 1.0 / (1.0 + i);
+        poisson1D_snapshot_writer_push(w, U, &step);
+    }
+    poisson1D_snapshot_writer_destroy(w, &written, &stalls);
+    if (written != 10) ok = 0;
+    for (int step = 0; step < 10; step++) {
+        char name[64];
+        Poisson1DBinFile f;
+        snprintf(name, sizeof(name), "test_snap_%06d.bin", step);
+        if (poisson1D_bin_map(name, &f) != 0 || f.hdr.rows != n || f.data[n - 1] != step + 1.0 / n) ok = 0;
+        else poisson1D_bin_unmap(&f);
+        remove(name);
+    }
+    printf("Snapshots written: %d (%d pushes waited)\n", written, stalls);
+
+    if (ok) {
+        printf("[PASS] Heat stepper matches the discrete solution, snapshots written.\n");
+    } else {
+        printf("[FAIL] Heat stepper or snapshot writer error!\n");
+    }
+    printf("\n");
+
+    free(X); free(U); free(ref);
+}
+
+void test_adi_poisson2D(poisson1D_int nx, poisson1D_int ny) {
+    printf("=== Test: 2D five-point operator, blocked transpose and ADI solver (%" POISSON1D_PRId "x%" POISSON1D_PRId ") ===\n", nx, ny);
+
+    poisson1D_int n = nx * ny;
+    int ok = 1, maxit = 500, nbite, nshifts = 0;
+    double tol = 1e-10;
+    CSRMatrix A;
+    set_CSR_operator_poisson2D(&A, &nx, &ny);
+    if (A.row_ptr[n] != A.nnz) ok = 0;
+
+    double *RHS = (double *)malloc(n * sizeof(double));
+    double *X = (double *)calloc(n, sizeof(double));
+    double *EX = (double *)malloc(n * sizeof(double));
+    double *Y = (double *)malloc(n * sizeof(double));
+    double *T = (double *)malloc(n * sizeof(double));
+    double *resvec = (double *)malloc(maxit * sizeof(double));
+    set_dense_RHS_poisson2D(RHS, &nx, &ny);
+    set_analytical_solution_poisson2D(EX, &nx, &ny);
+
+    /* The exact solution solves the discrete system */
+    dcsrmv(&A, EX, Y);
+    double d = 0.0;
+    for (int k = 0; k < n; k++) d = fmax(d, fabs(Y[k] - RHS[k]));
+    if (d > 1e-14) ok = 0;
+
+    /* Transpose: T(j, i) = EX(i, j), and back */
+    dtranspose_blocked(&nx, &ny, EX, T);
+    for (int j = 0; j < ny; j++)
+        for (int i = 0; i < nx; i++)
+            if (T[j + i * ny] != EX[i + j * nx]) ok = 0;
+    dtranspose_blocked(&ny, &nx, T, Y);
+    if (memcmp(Y, EX, n * sizeof(double)) != 0) ok = 0;
+
+    adi_poisson2D(RHS, X, &nx, &ny, &nshifts, &tol, &maxit, resvec, &nbite);
+    dcsrmv(&A, X, Y);
+    for (int k = 0; k < n; k++) Y[k] = RHS[k] - Y[k];
+    double relres = cblas_dnrm2(n, Y, 1) / cblas_dnrm2(n, RHS, 1);
+    double err = relative_forward_error(EX, X, &n);
+    printf("ADI: %d iterations (%d shifts), residual %e (reported %e), error %e\n",
+           nbite, adi_poisson2D_nshifts(&nx, &ny), relres, resvec[nbite], err);
+    if (nbite >= maxit || fabs(relres - resvec[nbite]) > 1e-12 || relres > tol || err > 1e-9) ok = 0;
+
+    /* Same solution as the PCG baseline on the CSR operator */
+    int jacobi = 1;
+    for (int k = 0; k < n; k++) Y[k] = 0.0;
+    conjugate_gradient_csr(&A, RHS, Y, &jacobi, &tol, &maxit, resvec, &nbite);
+    double diff = relative_forward_error(Y, X, &n);
+    printf("PCG: %d iterations, ADI vs PCG %e\n", nbite, diff);
+    if (diff > 1e-9) ok = 0;
+
+    if (ok) {
+        printf("[PASS] ADI matches the exact discrete solution and PCG on CSR.\n");
+    } else {
+        printf("[FAIL] 2D operator, transpose or ADI mismatch!\n");
+    }
+    printf("\n");
+
+    free(RHS); free(X); free(EX); free(Y); free(T); free(resvec);
+    free(A.values); free(A.col_ind); free(A.row_ptr);
+}
+
+/* Index type: overflow-checked allocation, then (ILP64 build with POISSON1D_LARGE_TEST=1 only) a GB
+   operator of more than 2^31 entries factorized by dgbtrftridiag, about 26 GB of memory */
+void test_index_type(void) {
+    printf("=== Test: Index type (%zu bytes) and operators beyond 2^31 entries ===\n", sizeof(poisson1D_int));
+
+    int ok = 1;
+    if (!poisson1D_index_fits(3, POISSON1D_INT_MAX / 3) || poisson1D_index_fits(3, POISSON1D_INT_MAX / 3 + 1)) ok = 0;
+    if (poisson1D_malloc(4, POISSON1D_INT_MAX / 2, sizeof(double)) != NULL) ok = 0;
+    if (poisson1D_malloc(-1, 10, sizeof(double)) != NULL) ok = 0;
+    double *p = (double *)poisson1D_malloc(0, 10, sizeof(double));
+    free(p);
+    /* 5 nx ny nonzeros beyond the index type: empty 2D operator, nothing allocated */
+    CSRMatrix A2;
+    poisson1D_int nx = POISSON1D_INT_MAX / 8, ny = 2;
+    set_CSR_operator_poisson2D(&A2, &nx, &ny);
+    if (A2.nnz != 0 || A2.values != NULL || A2.row_ptr != NULL) ok = 0;
+    /* nx ny itself beyond the index type: ADI refuses the grid before allocating */
+    poisson1D_int bx = POISSON1D_INT_MAX / 2 + 1;
+    int nsh = 0, one = 1, nb = -1;
+    double tol2 = 1e-6, res2;
+    adi_poisson2D(NULL, NULL, &bx, &ny, &nsh, &tol2, &one, &res2, &nb);
+    if (nb != 0) ok = 0;
+
+#ifdef POISSON1D_ILP64
+    if (getenv("POISSON1D_LARGE_TEST") != NULL) {
+        poisson1D_int kv = 1, ku = 1, kl = 1, nrhs = 1, info;
+        poisson1D_int lab = kv + kl + ku + 1;
+        poisson1D_int n = (poisson1D_int)INT_MAX / lab + 2;  /* lab*n > INT_MAX */
+        double *AB = (double *)poisson1D_malloc(lab, n, sizeof(double));
+        double *X = (double *)poisson1D_malloc(n, 1, sizeof(double));
+        poisson1D_int *ipiv = (poisson1D_int *)poisson1D_malloc(n, 1, sizeof(poisson1D_int));
+        if (AB == NULL || X == NULL || ipiv == NULL) {
+            printf("Not enough memory for la=%" POISSON1D_PRId "\n", n);
+            ok = 0;
+        } else {
+            double T0 = -5.0, T1 = 5.0;
+            set_GB_operator_colMajor_poisson1D(AB, &lab, &n, &kv);
+            set_dense_RHS_DBC_1D(X, &n, &T0, &T1);
+            dgbtrftridiag(&n, &n, &kl, &ku, AB, &lab, ipiv, &info);
+            if (info == 0) dgbtrs_("N", &n, &kl, &ku, &nrhs, AB, &lab, ipiv, X, &n, &info);
+            /* cond(A) ~ n^2 makes the forward error meaningless: normwise backward error with the
+               stencil, b being T0 e_1 + T1 e_n */
+            double rmax = 0.0, xmax = 0.0;
+            for (poisson1D_int i = 0; i < n; i++) {
+                double b = (i == 0) ? T0 : ((i == n - 1) ? T1 : 0.0);
+                double ax = 2.0 * X[i] - ((i > 0) ? X[i - 1] : 0.0) - ((i < n - 1) ? X[i + 1] : 0.0);
+                rmax = fmax(rmax, fabs(b - ax));
+                xmax = fmax(xmax, fabs(X[i]));
+            }
+            double berr = rmax / (4.0 * xmax + fmax(fabs(T0), fabs(T1)));
+            printf("la=%" POISSON1D_PRId ", lab*la=%" POISSON1D_PRId ": info=%" POISSON1D_PRId ", backward error %e\n", n, lab * n, info, berr);
+            if (info != 0 || !(berr < 1e-12)) ok = 0;
+        }
+        free(AB); free(X); free(ipiv);
+    } else {
+        printf("Large solve skipped (set POISSON1D_LARGE_TEST=1, about 26 GB)\n");
+    }
+#else
+    printf("Large solve skipped (needs make ILP64=1)\n");
+#endif
+
+    if (ok) {
+        printf("[PASS] Index products are checked before allocation.\n");
+    } else {
+        printf("[FAIL] Index type overflow handling!\n");
+    }
+    printf("\n");
+}
+
 int main(int argc, char *argv[]) {
     printf("Starting Tests...\n\n");
     
@@ -141,6 +1612,56 @@ int main(int argc, char *argv[]) {
     /* Test 2: Larger scale */
     test_dgbmv_ax_equals_b(100);
     test_lu_compare(100);
+    test_thomas_compare(5);
+    test_thomas_compare(100);
+    test_thomas_interleaved(100, 7);
+    test_thomas_batch(100, 133);
+    test_solver_handle_cache();
+    test_partition_solver(5);
+    test_partition_solver(1000);
+    test_dst_solver(1, 1);
+    test_dst_solver(127, 3);  /* FFT length 256 = 4^4 */
+    test_dst_solver(100, 2);  /* FFT length 202 = 2 * 101: Bluestein */
+    test_dst_solver(1499, 1); /* FFT length 3000 = 4 * 2 * 3 * 5^3 */
+    test_dst_solver(100000, 3); /* FFT length 200002 = 2 * 11 * 9091: Bluestein */
+    test_dst_solver(131070, 1); /* FFT length 262142 = 2 * (2^17 - 1): Bluestein */
+    test_mixed_precision(100, 3);
+    test_mixed_precision(2000, 1);
+    test_mixed_precision(50000, 2);  /* cond(A) * eps_single > 1: falls back to double precision */
+    dst_plan_cache_clear();
+    test_binary_roundtrip(100);
+    test_out_of_core(5);
+    test_out_of_core(100003);
+    test_timing_report();
+    test_heat_stepper(200);
+
+    /* Test 3: Iterative kernels */
+    test_richardson_stencil(10);
+    test_richardson_stencil(1000);
+    test_richardson_tiled(200);
+    test_richardson_tiled(40000);
+    test_stencil_operator(100);
+    test_stencil_operator(1000000);
+    test_gauss_seidel_redblack(50);
+    test_conjugate_gradient(10);
+    test_conjugate_gradient(1000);
+    test_chebyshev(10);
+    test_chebyshev(500);
+    test_workspace_solvers(100);
+    test_sparse_formats(7);
+    test_parallel_spmv(100);
+    test_parallel_spmv(50000);
+    test_sparse_formats(1001);
+    test_multigrid(63);
+    test_multigrid(16383);
+    test_multigrid(998);
+
+    /* Test 4: 2D problem */
+    test_adi_poisson2D(31, 31);
+    test_adi_poisson2D(40, 25);
+
+    /* Test 5: Index type */
+    test_index_type();
 
     return 0;
 }
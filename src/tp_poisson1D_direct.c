@@ -5,18 +5,37 @@
 /* using direct methods (LU factorization)*/
 /******************************************/
 #include "lib_poisson1D.h"
+#include <string.h>
 #include <time.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #define TRF 0  /* Use LAPACK dgbtrf for LU factorization */
 #define TRI 1  /* Use custom tridiagonal LU factorization */
 #define SV 2   /* Use LAPACK dgbsv (all-in-one solver) */
+#define THOMAS 3 /* Use custom Thomas factor+solve on compact tridiagonal storage */
+#define GTTRF 4  /* Use LAPACK dgttrf + dgttrs on compact tridiagonal storage */
+#define GTSV 5   /* Use LAPACK dgtsv (all-in-one tridiagonal solver) */
+#define CACHED 6 /* Use a Poisson1DSolver handle per solve, factors reused from the cache */
+#define PAR 7    /* Use the OpenMP partitioned tridiagonal solver (dgtsvpartition) */
+#define DST 8    /* Use the fast diagonalization solver (discrete sine transform) */
+#define MIXED_TRF 9  /* Use sgbtrf + sgbtrs with double-precision iterative refinement */
+#define MIXED_TRI 10 /* Use sgbtrftridiag + sgbtrs with double-precision iterative refinement */
+#define BATCH 11     /* Use the batched Thomas solver: NRHS independent systems, one conductivity profile each */
+#define STENCIL 12   /* Use Thomas on the O(1) stencil operator, pivots in closed form (dstencil_thomas) */
+#define OOC 13       /* Use the out-of-core Thomas solve on memory-mapped files (dstencil_thomas_ooc) */
 
 /**
  * Main function to solve the 1D Poisson equation -u''(x) = f(x) with Dirichlet BC.
  * 
  * @param argc: Number of command-line arguments
  * @param argv: Array of argument strings
- *              argv[1] (optional): Implementation method (0=TRF, 1=TRI, 2=SV)
+ *              argv[1] (optional): Implementation method (0=TRF, 1=TRI, 2=SV, 3=THOMAS, 4=GTTRF, 5=GTSV, 6=CACHED, 7=PAR, 8=DST,
+ *                                                   9=MIXED_TRF, 10=MIXED_TRI, 11=BATCH, 12=STENCIL, 13=OOC)
+ *              argv[2] (optional): Number of discretization points
+ *              argv[3] (optional): Number of right-hand sides solved with one factorization
+ *                                  (BATCH: number of independent systems)
  * @return 0 on success
  */
 int main(int argc,char *argv[])
@@ -24,24 +43,37 @@ int main(int argc,char *argv[])
 /* ** argv: Valeur des arguments */
 {
   int ierr;                      /* Error code for various operations */
-  int jj;                        /* Loop counter */
-  int nbpoints, la;              /* nbpoints: total points, la: interior points */
-  int ku, kl, kv, lab;           /* Band matrix parameters: ku/kl=super/sub diagonals, kv=extra space, lab=leading dimension */
-  int *ipiv;                     /* Pivot indices for LU factorization */
-  int info = 1;                  /* LAPACK info parameter (0=success) */
-  int NRHS;                      /* Number of right-hand sides */
-  int IMPLEM = 0;                /* Implementation method (TRF, TRI, or SV) */
+  poisson1D_int jj;              /* Loop counter */
+  poisson1D_int nbpoints, la;    /* nbpoints: total points, la: interior points */
+  poisson1D_int ku, kl, kv, lab; /* Band matrix parameters: ku/kl=super/sub diagonals, kv=extra space, lab=leading dimension */
+  poisson1D_int *ipiv;           /* Pivot indices for LU factorization */
+  poisson1D_int info = 1;        /* LAPACK info parameter (0=success) */
+  poisson1D_int NRHS;            /* Number of right-hand sides */
+  int IMPLEM = 0;                /* Implementation method (see the IMPLEM defines above) */
   double T0, T1;                 /* Boundary conditions: T0 at x=0, T1 at x=1 */
   double *RHS, *EX_SOL, *X;      /* RHS: right-hand side, EX_SOL: exact solution, X: grid points */
+  double *T0s, *T1s;             /* Boundary conditions of each right-hand side */
+  double *RHSI = NULL;           /* Right-hand sides in interleaved layout (THOMAS, NRHS > 1) */
   double **AAB;                  /* Unused variable */
-  double *AB;                    /* Coefficient matrix in band storage */
+  double *AB = NULL;             /* Coefficient matrix in band storage */
+  TriDiagMatrix TD_A;            /* Coefficient matrix in compact tridiagonal storage */
+  double *du2 = NULL;            /* Second super-diagonal fill-in for dgttrf */
+  int use_gb, use_td;            /* 1 if the method works on the GB / compact tridiagonal storage */
+  Poisson1DSolver *solver;       /* Solver handle (CACHED) */
+  TriDiagBatch TB_A;             /* Independent operators in interleaved storage (BATCH) */
+  StencilOperator ST_A;          /* Coefficients of the operator only (STENCIL, OOC) */
+  size_t ooc_budget = 0;         /* Resident memory of the out-of-core solve (OOC, POISSON1D_OOC_BUDGET in MiB) */
+  char ooc_rhs[64], ooc_sol[64]; /* Per right-hand side files of the out-of-core solve (OOC) */
+  double *kappa = NULL;          /* Conductivity profiles at the cell faces (BATCH, size (la+1)*NRHS) */
 
   double relres;                 /* Relative forward error */
 
-  if (argc == 2) {
+  if (argc >= 2) {
     IMPLEM = atoi(argv[1]);
-  } else if (argc > 3) {
-    perror("Application takes at most two arguments");
+  }
+
+  if (argc > 4) {
+    perror("Application takes at most three arguments");
     exit(1);
   }
 
@@ -49,27 +81,65 @@ int main(int argc,char *argv[])
   NRHS=1;           /* Solving Ax=b with one right-hand side */
   nbpoints=10;      /* Total number of discretization points (including boundaries) */
   if (argc >= 3){
-    nbpoints = atoi(argv[2]);
+    nbpoints = (poisson1D_int) atoll(argv[2]);
+  }
+  if (argc >= 4){
+    NRHS = (poisson1D_int) atoll(argv[3]);
   }
   la=nbpoints-2;    /* Number of interior points (excluding boundaries) */
   T0=-5.0;          /* Dirichlet boundary condition at x=0 */
   T1=5.0;           /* Dirichlet boundary condition at x=1 */
 
   printf("--------- Poisson 1D ---------\n\n");
+  /* Per-phase timers (report with POISSON1D_TIMING=file.json|file.csv, counters with POISSON1D_PERF=1) */
+  int counters = (getenv("POISSON1D_PERF") != NULL);
+  poisson1D_timing_init(&counters);
+
   /* Allocate memory for vectors */
-  RHS=(double *) malloc(sizeof(double)*la);      /* Right-hand side vector */
-  EX_SOL=(double *) malloc(sizeof(double)*la);   /* Analytical/exact solution */
-  X=(double *) malloc(sizeof(double)*la);        /* Grid points */
+  RHS=(double *) poisson1D_malloc(la, NRHS, sizeof(double));    /* Right-hand side vectors */
+  EX_SOL=(double *) poisson1D_malloc(la, NRHS, sizeof(double)); /* Analytical/exact solutions */
+  X=(double *) malloc(sizeof(double)*la);                       /* Grid points */
+  T0s=(double *) malloc(sizeof(double)*NRHS);
+  T1s=(double *) malloc(sizeof(double)*NRHS);
+
+  /* One (T0, T1) pair per right-hand side, the first one is (T0, T1) */
+  for (jj = 0; jj < NRHS; jj++) {
+    T0s[jj] = T0 + jj;
+    T1s[jj] = T1 - 0.5 * jj;
+  }
 
   /* Initialize the problem: grid, RHS, and exact solution */
+  poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
   set_grid_points_1D(X, &la);                                /* Create uniform grid */
-  set_dense_RHS_DBC_1D(RHS,&la,&T0,&T1);                     /* Set up RHS with BC */
-  set_analytical_solution_DBC_1D(EX_SOL, X, &la, &T0, &T1);  /* Compute exact solution */
+  set_dense_RHS_DBC_1D_batch(RHS,&la,&NRHS,T0s,T1s);         /* Set up RHS with BC */
+  for (jj = 0; jj < NRHS; jj++) {                            /* Compute exact solutions */
+    set_analytical_solution_DBC_1D(EX_SOL + (size_t)jj*la, X, &la, &T0s[jj], &T1s[jj]);
+  }
+  if (IMPLEM == BATCH) {
+    /* One smooth conductivity profile per system: -(kappa u')' = 0, exact discrete solution known */
+    kappa = (double *) malloc(sizeof(double)*(la+1)*NRHS);
+    for (jj = 0; jj < NRHS; jj++) {
+      double *kj = kappa + (size_t)jj*(la+1);
+      for (poisson1D_int i = 0; i <= la; i++) {kj[i] = 1.0 + 0.5 * sin(2.0 * M_PI * (jj + 1) * (i + 0.5) / (la + 1));}
+      set_dense_RHS_DBC_1D_varcoef(RHS + (size_t)jj*la, &la, kj, &T0s[jj], &T1s[jj]);
+      set_exact_solution_DBC_1D_varcoef(EX_SOL + (size_t)jj*la, &la, kj, &T0s[jj], &T1s[jj]);
+    }
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
   
-  /* Write initial data to files for visualization */
-  write_vec(RHS, &la, "RHS.dat");
-  write_vec(EX_SOL, &la, "EX_SOL.dat");
-  write_vec(X, &la, "X_grid.dat");
+  /* Write initial data to files for visualization (binary .bin, or .dat with POISSON1D_OUTPUT=text) */
+  int text = poisson1D_output_text();
+  poisson1D_timing_begin(POISSON1D_PHASE_WRITE);
+  if (text) {
+    write_vec(RHS, &la, "RHS.dat");
+    write_vec(EX_SOL, &la, "EX_SOL.dat");
+    write_vec(X, &la, "X_grid.dat");
+  } else {
+    write_vec_bin(RHS, &la, "RHS.bin");
+    write_vec_bin(EX_SOL, &la, "EX_SOL.bin");
+    write_vec_bin(X, &la, "X_grid.bin");
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_WRITE);
 
   /* Set up band storage parameters for tridiagonal matrix */
   kv=1;             /* Number of superdiagonals */
@@ -77,56 +147,304 @@ int main(int argc,char *argv[])
   kl=1;             /* Number of subdiagonals */
   lab=kv+kl+ku+1;   /* Leading dimension of band storage */
 
-  /* Allocate and initialize the coefficient matrix */
-  AB = (double *) malloc(sizeof(double)*lab*la);
+  use_gb = (IMPLEM == TRF || IMPLEM == TRI || IMPLEM == SV || IMPLEM == MIXED_TRF || IMPLEM == MIXED_TRI);
+  use_td = (IMPLEM == THOMAS || IMPLEM == GTTRF || IMPLEM == GTSV || IMPLEM == PAR);
 
-  set_GB_operator_colMajor_poisson1D(AB, &lab, &la, &kv);
-  write_GB_operator_colMajor_poisson1D(AB, &lab, &la, "AB.dat");
+  /* Allocate and initialize the coefficient matrix */
+  poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
+  if (use_gb) {
+    AB = (double *) poisson1D_malloc(lab, la, sizeof(double));
+    set_GB_operator_colMajor_poisson1D(AB, &lab, &la, &kv);
+  } else if (use_td) {
+    /* Compact storage: sub, diag and super diagonals only */
+    set_tridiag_operator_poisson1D(&TD_A, &la);
+  } else if (IMPLEM == BATCH) {
+    if (set_tridiag_batch_operator_poisson1D_varcoef(&TB_A, &la, &NRHS, kappa) != 0) {
+      perror("set_tridiag_batch_operator_poisson1D_varcoef");
+      exit(1);
+    }
+  } else if (IMPLEM == STENCIL || IMPLEM == OOC) {
+    set_stencil_operator_poisson1D(&ST_A, &la);
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+  poisson1D_timing_begin(POISSON1D_PHASE_WRITE);
+  if (use_gb) {
+    if (text) write_GB_operator_colMajor_poisson1D(AB, &lab, &la, "AB.dat");
+    else write_GB_operator_colMajor_poisson1D_bin(AB, &lab, &la, &kl, &ku, &kv, "AB.bin");
+    printf("Operator storage (GB): %zu bytes\n", sizeof(double)*lab*la);
+  } else if (use_td) {
+    if (text) write_tridiag_operator_poisson1D(&TD_A, "AB.dat");
+    else write_tridiag_operator_poisson1D_bin(&TD_A, "AB.bin");
+    printf("Operator storage (tridiagonal): %zu bytes\n", sizeof(double)*(3*(size_t)la-2));
+  } else if (IMPLEM == STENCIL || IMPLEM == OOC) {
+    printf("Operator storage (stencil): %zu bytes\n", sizeof(StencilOperator));
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_WRITE);
 
   printf("Solution with LAPACK\n");
-  ipiv = (int *) calloc(la, sizeof(int));  /* Pivot indices for LU factorization */
+  ipiv = (poisson1D_int *) calloc(la, sizeof(poisson1D_int));  /* Pivot indices for LU factorization */
+  if (IMPLEM == GTTRF) {
+    du2 = (double *) malloc(sizeof(double)*(la > 2 ? la-2 : 1));
+  }
+  if ((IMPLEM == THOMAS && NRHS > 1) || IMPLEM == BATCH) {
+    /* Right-hand sides are handed to the batched Thomas solve interleaved */
+    RHSI = (double *) poisson1D_malloc(la, NRHS, sizeof(double));
+    interleave_RHS(RHS, RHSI, &la, &NRHS);
+  }
+  if (IMPLEM == DST) {
+    /* Build the cached DST plan outside of the timed region */
+    dst_plan_get(&la);
+  }
+  if (IMPLEM == OOC) {
+    /* The right-hand sides go to disk outside of the timed region, one file each */
+    if (getenv("POISSON1D_OOC_BUDGET") != NULL) {
+      ooc_budget = (size_t) atoll(getenv("POISSON1D_OOC_BUDGET")) << 20;
+    }
+    for (jj = 0; jj < NRHS; jj++) {
+      snprintf(ooc_rhs, sizeof(ooc_rhs), "RHS_ooc_%" POISSON1D_PRId ".bin", jj);
+      write_vec_bin(RHS + (size_t)jj*la, &la, ooc_rhs);
+    }
+  }
 
-  clock_t start, end;
+  /* Wall-clock timing (CPU time would add up the time of all threads) */
+  struct timespec start, end;
   double cpu_time_used;
-  start = clock();
+  clock_gettime(CLOCK_MONOTONIC, &start);
 
   /* LU Factorization using LAPACK's general band factorization */
   if (IMPLEM == TRF) {
+    poisson1D_timing_begin(POISSON1D_PHASE_FACTOR);
     dgbtrf_(&la, &la, &kl, &ku, AB, &lab, ipiv, &info);
+    poisson1D_timing_end(POISSON1D_PHASE_FACTOR);
   }
 
   /* LU for tridiagonal matrix (can replace dgbtrf_) - custom implementation */
   if (IMPLEM == TRI) {
+    poisson1D_timing_begin(POISSON1D_PHASE_FACTOR);
     dgbtrftridiag(&la, &la, &kl, &ku, AB, &lab, ipiv, &info);
+    poisson1D_timing_end(POISSON1D_PHASE_FACTOR);
   }
 
   /* Back-substitution to solve the system after factorization */
   if (IMPLEM == TRI || IMPLEM == TRF){
     /* Solution (Triangular) - solve using the LU factors */
     if (info==0){
+      poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
       dgbtrs_("N", &la, &kl, &ku, &NRHS, AB, &lab, ipiv, RHS, &la, &info);
-      if (info!=0){printf("\n INFO DGBTRS = %d\n",info);}
+      poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+      if (info!=0){printf("\n INFO DGBTRS = %" POISSON1D_PRId "\n",info);}
     }else{
-      printf("\n INFO = %d\n",info);
+      printf("\n INFO = %" POISSON1D_PRId "\n",info);
     }
   }
 
   /* Alternative: solve directly using dgbsv */
   if (IMPLEM == SV) {
+    poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
     dgbsv_(&la, &kl, &ku, &NRHS, AB, &lab, ipiv, RHS, &la, &info);
-    if (info!=0){printf("\n INFO DGBSV = %d\n",info);}
+    poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+    if (info!=0){printf("\n INFO DGBSV = %" POISSON1D_PRId "\n",info);}
+  }
+
+  /* Thomas algorithm on the compact storage */
+  if (IMPLEM == THOMAS) {
+    poisson1D_timing_begin(POISSON1D_PHASE_FACTOR);
+    dgttrftridiag(&la, TD_A.dl, TD_A.d, TD_A.du, &info);
+    poisson1D_timing_end(POISSON1D_PHASE_FACTOR);
+    if (info==0 && RHSI != NULL){
+      poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+      dgttrstridiag_interleaved(&la, &NRHS, TD_A.dl, TD_A.d, TD_A.du, RHSI, &info);
+      poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+    }else if (info==0){
+      poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+      dgttrstridiag(&la, &NRHS, TD_A.dl, TD_A.d, TD_A.du, RHS, &la, &info);
+      poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+    }else{
+      printf("\n INFO = %" POISSON1D_PRId "\n",info);
+    }
+  }
+
+  /* Batched Thomas: all the systems factorized and solved together, one per SIMD lane */
+  if (IMPLEM == BATCH) {
+    poisson1D_timing_begin(POISSON1D_PHASE_FACTOR);
+    dgttrftridiag_batch(&la, &NRHS, TB_A.dl, TB_A.d, TB_A.du, &info);
+    poisson1D_timing_end(POISSON1D_PHASE_FACTOR);
+    if (info==0){
+      poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+      dgttrstridiag_batch(&la, &NRHS, TB_A.dl, TB_A.d, TB_A.du, RHSI, &info);
+      poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+    }else{
+      printf("\n INFO DGTTRFTRIDIAG_BATCH = %" POISSON1D_PRId "\n",info);
+    }
+  }
+
+  /* LAPACK general tridiagonal factorization (with partial pivoting) and solve */
+  if (IMPLEM == GTTRF) {
+    poisson1D_timing_begin(POISSON1D_PHASE_FACTOR);
+    dgttrf_(&la, TD_A.dl, TD_A.d, TD_A.du, du2, ipiv, &info);
+    poisson1D_timing_end(POISSON1D_PHASE_FACTOR);
+    if (info==0){
+      poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+      dgttrs_("N", &la, &NRHS, TD_A.dl, TD_A.d, TD_A.du, du2, ipiv, RHS, &la, &info);
+      poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+      if (info!=0){printf("\n INFO DGTTRS = %" POISSON1D_PRId "\n",info);}
+    }else{
+      printf("\n INFO = %" POISSON1D_PRId "\n",info);
+    }
+  }
+
+  /* LAPACK tridiagonal driver */
+  if (IMPLEM == GTSV) {
+    poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+    dgtsv_(&la, &NRHS, TD_A.dl, TD_A.d, TD_A.du, RHS, &la, &info);
+    poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+    if (info!=0){printf("\n INFO DGTSV = %" POISSON1D_PRId "\n",info);}
+  }
+
+  /* Partitioned parallel solve, one partition per OpenMP thread */
+  if (IMPLEM == PAR) {
+    int nparts = 0;
+    info = 0;
+    poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+    for (jj = 0; jj < NRHS && info == 0; jj++) {
+      if (jj > 0) {
+        /* The solver overwrites the operator */
+        for (poisson1D_int i = 0; i < la; i++) {TD_A.d[i] = 2.0;}
+        for (poisson1D_int i = 0; i < la - 1; i++) {TD_A.dl[i] = -1.0;}
+      }
+      dgtsvpartition(&la, TD_A.dl, TD_A.d, TD_A.du, RHS + (size_t)jj*la, &nparts, &info);
+    }
+    poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+    if (info!=0){printf("\n INFO DGTSVPARTITION = %" POISSON1D_PRId "\n",info);}
+  }
+
+  /* Thomas without factors: the pivots of the constant stencil are recomputed in closed form */
+  if (IMPLEM == STENCIL) {
+    poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+    dstencil_thomas(&ST_A, &NRHS, RHS, &la, &info);
+    poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+    if (info!=0){printf("\n INFO DSTENCIL_THOMAS = %" POISSON1D_PRId "\n",info);}
+  }
+
+  /* Out of core: RHS_ooc_<j>.bin -> SOL_ooc_<j>.bin, modified coefficients in LU_ooc.bin */
+  if (IMPLEM == OOC) {
+    poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+    for (jj = 0; jj < NRHS; jj++) {
+      snprintf(ooc_rhs, sizeof(ooc_rhs), "RHS_ooc_%" POISSON1D_PRId ".bin", jj);
+      snprintf(ooc_sol, sizeof(ooc_sol), "SOL_ooc_%" POISSON1D_PRId ".bin", jj);
+      if (dstencil_thomas_ooc(&ST_A, ooc_rhs, ooc_sol, "LU_ooc.bin", &ooc_budget, &info) != 0) break;
+    }
+    poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+    if (info!=0){printf("\n INFO DSTENCIL_THOMAS_OOC = %" POISSON1D_PRId "\n",info);}
+  }
+
+  /* Fast diagonalization: the DST plan of size la is built on the first call and cached */
+  if (IMPLEM == DST) {
+    poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+    info = poisson1D_dst_solve(RHS, RHS, &la, &NRHS);
+    poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+    if (info!=0){printf("\n INFO DST = %" POISSON1D_PRId "\n",info);}
+  }
+
+  /* Single-precision factors refined in double precision; AB keeps the operator */
+  if (IMPLEM == MIXED_TRF || IMPLEM == MIXED_TRI) {
+    int kind = (IMPLEM == MIXED_TRF) ? POISSON1D_MIXED_TRF : POISSON1D_MIXED_TRI;
+    int maxref = POISSON1D_MIXED_MAXREF, iter;
+    double tol = 0.0;  /* DBL_EPSILON * sqrt(la) */
+    poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+    dgbsv_mixed(&kind, &la, &kl, &ku, &NRHS, AB, &lab, RHS, &la, &tol, &maxref, &iter, &info);
+    poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+    if (iter >= 0) {
+      printf("Refinement steps (N=%" POISSON1D_PRId "): %d\n", nbpoints, iter);
+    } else {
+      printf("Refinement steps (N=%" POISSON1D_PRId "): no convergence after %d, solved in double precision\n", nbpoints, -iter - 1);
+    }
+    if (info!=0){printf("\n INFO DGBSV_MIXED = %" POISSON1D_PRId "\n",info);}
+  }
+
+  /* Repeated solves through short-lived handles: only the first one factorizes */
+  if (IMPLEM == CACHED) {
+    int kind = POISSON1D_FACTOR_TRI;
+    poisson1D_int one = 1;
+    for (jj = 0; jj < NRHS; jj++) {
+      solver = poisson1D_solver_create(&la, &kind);
+      poisson1D_timing_begin(POISSON1D_PHASE_FACTOR);
+      poisson1D_solver_factor(solver, &info);
+      poisson1D_timing_end(POISSON1D_PHASE_FACTOR);
+      if (info==0){
+        poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+        poisson1D_solver_solve(solver, RHS + (size_t)jj*la, &one, &info);
+        poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+      }
+      poisson1D_solver_destroy(solver);
+      if (info!=0){printf("\n INFO = %" POISSON1D_PRId "\n",info); break;}
+    }
   }
   
-  end = clock();
-  cpu_time_used = ((double) (end - start)) * 1000.0 / CLOCKS_PER_SEC; // in ms
-  printf("Execution time (IMPLEM=%d, N=%d): %f ms\n", IMPLEM, nbpoints, cpu_time_used);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  cpu_time_used = (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_nsec - start.tv_nsec) / 1.0e6; // in ms
+  printf("Execution time (IMPLEM=%d, N=%" POISSON1D_PRId "): %f ms\n", IMPLEM, nbpoints, cpu_time_used);
+#ifdef _OPENMP
+  printf("Threads: %d\n", omp_get_max_threads());
+#endif
+  printf("Throughput (IMPLEM=%d, N=%" POISSON1D_PRId ", NRHS=%" POISSON1D_PRId "): %f solves/s\n", IMPLEM, nbpoints, NRHS, NRHS * 1000.0 / cpu_time_used);
+  poisson1D_timing_add_count(POISSON1D_PHASE_SOLVE, NRHS);
+  poisson1D_timing_print();
+
+  if (RHSI != NULL) {
+    deinterleave_RHS(RHSI, RHS, &la, &NRHS);
+  }
+  if (IMPLEM == OOC) {
+    /* Solutions back in RHS for the checks below, scratch files removed */
+    printf("Out-of-core budget: %zu bytes\n", ooc_budget > 0 ? ooc_budget : POISSON1D_OOC_BUDGET);
+    for (jj = 0; jj < NRHS; jj++) {
+      Poisson1DBinFile sol;
+      snprintf(ooc_rhs, sizeof(ooc_rhs), "RHS_ooc_%" POISSON1D_PRId ".bin", jj);
+      snprintf(ooc_sol, sizeof(ooc_sol), "SOL_ooc_%" POISSON1D_PRId ".bin", jj);
+      if (info == 0 && poisson1D_bin_map(ooc_sol, &sol) == 0) {
+        memcpy(RHS + (size_t)jj*la, sol.data, sizeof(double)*la);
+        poisson1D_bin_unmap(&sol);
+      }
+      remove(ooc_rhs);
+      remove(ooc_sol);
+    }
+    remove("LU_ooc.bin");
+  }
+  if (IMPLEM == CACHED) {
+    int hits, misses, entries;
+    size_t bytes;
+    poisson1D_factor_cache_stats(&hits, &misses, &entries, &bytes);
+    printf("Factor cache: %d hits, %d misses, %d entries, %zu bytes\n", hits, misses, entries, bytes);
+  }
 
   /* Write results to files */
-  write_GB_operator_colMajor_poisson1D(AB, &lab, &la, "LU.dat");  /* LU factors */
-  write_xy(RHS, X, &la, "SOL.dat");  /* Solution at grid points (RHS now contains solution) */
+  poisson1D_timing_begin(POISSON1D_PHASE_WRITE);
+  if (text) {
+    if (use_gb) {
+      write_GB_operator_colMajor_poisson1D(AB, &lab, &la, "LU.dat");  /* LU factors */
+    } else if (use_td) {
+      write_tridiag_operator_poisson1D(&TD_A, "LU.dat");
+    }
+    write_xy(RHS, X, &la, "SOL.dat");  /* Solution at grid points (RHS now contains solution) */
+  } else {
+    if (use_gb) {
+      write_GB_operator_colMajor_poisson1D_bin(AB, &lab, &la, &kl, &ku, &kv, "LU.bin");
+    } else if (use_td) {
+      write_tridiag_operator_poisson1D_bin(&TD_A, "LU.bin");
+    }
+    write_xy_bin(RHS, X, &la, "SOL.bin");
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_WRITE);
 
   /* Relative forward error - compare numerical solution with exact solution */
-  relres = relative_forward_error(RHS, EX_SOL, &la);
+  int wsmethod = POISSON1D_WS_NORM;
+  Poisson1DWorkspace *ws = poisson1D_workspace_create(&wsmethod, &la);  /* one scratch for all RHS */
+  relres = 0.0;
+  for (jj = 0; jj < NRHS; jj++) {
+    double err = relative_forward_error_ws(RHS + (size_t)jj*la, EX_SOL + (size_t)jj*la, &la, ws);
+    if (err > relres) {relres = err;}
+  }
+  poisson1D_workspace_destroy(ws);
   
   printf("\nThe relative forward error is relres = %e\n",relres);
 
@@ -134,6 +452,30 @@ int main(int argc,char *argv[])
   free(RHS);
   free(EX_SOL);
   free(X);
-  free(AB);
+  free(T0s);
+  free(T1s);
+  free(RHSI);
+  free(ipiv);
+  if (use_gb) {
+    free(AB);
+  } else if (use_td) {
+    free(TD_A.dl);
+    free(TD_A.d);
+    free(TD_A.du);
+  }
+  free(du2);
+  if (IMPLEM == BATCH) {
+    free_tridiag_batch(&TB_A);
+    free(kappa);
+  }
+  poisson1D_factor_cache_clear();
+  dst_plan_cache_clear();
+
+  /* Machine-readable per-phase report */
+  char *report = getenv("POISSON1D_TIMING");
+  if (report != NULL) {
+    poisson1D_timing_write(report, "direct", &IMPLEM, &nbpoints);
+  }
+  poisson1D_timing_finalize();
   printf("\n\n--------- End -----------\n");
 }
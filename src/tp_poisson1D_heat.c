@@ -0,0 +1,153 @@
+/******************************************/
+/* tp_poisson1D_heat.c                    */
+/* This file contains the main function   */
+/* to solve the transient heat equation   */
+/* u_t = u_xx with a theta-scheme         */
+/******************************************/
+#include "lib_poisson1D.h"
+#include <time.h>
+
+#define EULER 0 /* Implicit Euler (theta = 1) */
+#define CN 1    /* Crank-Nicolson (theta = 1/2) */
+
+#define T_FINAL 0.1 /* Final time */
+
+/**
+ * Main function to solve u_t = u_xx on (0, 1) with Dirichlet BC, from
+ * u(x, 0) = T0 + (T1 - T0) x + sin(pi x), whose exact solution is
+ * u(x, t) = T0 + (T1 - T0) x + exp(-pi^2 t) sin(pi x).
+ *
+ * @param argc: Number of command-line arguments
+ * @param argv: Array of argument strings
+ *              argv[1] (optional): Scheme (0=EULER, 1=CN)
+ *              argv[2] (optional): Number of discretization points
+ *              argv[3] (optional): Number of time steps up to T_FINAL
+ *              argv[4] (optional): Snapshot interval in steps (0: no snapshots)
+ * @return 0 on success
+ */
+int main(int argc,char *argv[])
+{
+  poisson1D_int nbpoints, la;    /* nbpoints: total points, la: interior points */
+  int nsteps, every;             /* Number of time steps, snapshot interval */
+  poisson1D_int info = 0;
+  int SCHEME = CN;
+  double T0, T1, theta, dt, h, lambda, g;
+  double *U, *EX_SOL, *DISC_SOL, *X;
+  Poisson1DHeatStepper *stepper;
+  Poisson1DSnapshotWriter *writer = NULL;
+
+  if (argc > 5) {
+    perror("Application takes at most four arguments");
+    exit(1);
+  }
+  nbpoints = 102;
+  nsteps = 100;
+  every = 10;
+  if (argc >= 2) {SCHEME = atoi(argv[1]);}
+  if (argc >= 3) {nbpoints = (poisson1D_int) atoll(argv[2]);}
+  if (argc >= 4) {nsteps = atoi(argv[3]);}
+  if (argc >= 5) {every = atoi(argv[4]);}
+  la = nbpoints - 2;
+  T0 = -5.0;
+  T1 = 5.0;
+  theta = (SCHEME == EULER) ? POISSON1D_THETA_EULER : POISSON1D_THETA_CN;
+  dt = T_FINAL / nsteps;
+  h = 1.0 / (la + 1);
+
+  printf("--------- Heat 1D ---------\n\n");
+  int counters = (getenv("POISSON1D_PERF") != NULL);
+  poisson1D_timing_init(&counters);
+
+  U = (double *) malloc(sizeof(double)*la);
+  EX_SOL = (double *) malloc(sizeof(double)*la);
+  DISC_SOL = (double *) malloc(sizeof(double)*la);
+  X = (double *) malloc(sizeof(double)*la);
+
+  /* Initial condition: steady state plus the first eigenmode */
+  poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
+  set_grid_points_1D(X, &la);
+  set_analytical_solution_DBC_1D(U, X, &la, &T0, &T1);
+  for (poisson1D_int i = 0; i < la; i++) {U[i] += sin(M_PI * X[i]);}
+  poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+
+  /* Implicit operator I + theta dt/h^2 A, factorized once */
+  poisson1D_timing_begin(POISSON1D_PHASE_FACTOR);
+  stepper = poisson1D_heat_create(&la, &theta, &dt, &T0, &T1, &info);
+  poisson1D_timing_end(POISSON1D_PHASE_FACTOR);
+  if (stepper == NULL) {
+    printf("\n INFO POISSON1D_HEAT_CREATE = %" POISSON1D_PRId "\n", info);
+    exit(1);
+  }
+  printf("Scheme: %s, dt = %e, dt/h^2 = %f, %d steps\n", (SCHEME == EULER) ? "implicit Euler" : "Crank-Nicolson", dt, stepper->r, nsteps);
+
+  /* Snapshots (binary .bin, or .dat with POISSON1D_OUTPUT=text) written by a background thread */
+  int text = poisson1D_output_text();
+  if (every > 0) {
+    int depth = POISSON1D_SNAPSHOT_DEPTH;
+    writer = poisson1D_snapshot_writer_create(&la, &depth, "SNAP", &text);
+    if (writer == NULL) {perror("poisson1D_snapshot_writer_create"); exit(1);}
+    int step0 = 0;
+    poisson1D_snapshot_writer_push(writer, U, &step0);
+  }
+
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int step = 0; step < nsteps && info == 0; ) {
+    int chunk = (every > 0) ? every - step % every : nsteps;
+    if (chunk > nsteps - step) {chunk = nsteps - step;}
+    poisson1D_timing_begin(POISSON1D_PHASE_ITER);
+    poisson1D_heat_step(stepper, U, &chunk, &info);
+    poisson1D_timing_end(POISSON1D_PHASE_ITER);
+    step += chunk;
+    if (writer != NULL && step % every == 0) {
+      /* Only the copy into a free buffer is on the critical path */
+      poisson1D_timing_begin(POISSON1D_PHASE_WRITE);
+      poisson1D_snapshot_writer_push(writer, U, &step);
+      poisson1D_timing_end(POISSON1D_PHASE_WRITE);
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double time_ms = (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_nsec - start.tv_nsec) / 1.0e6;
+  if (info != 0) {printf("\n INFO POISSON1D_HEAT_STEP = %" POISSON1D_PRId "\n", info);}
+
+  if (writer != NULL) {
+    int written, stalls;
+    poisson1D_snapshot_writer_destroy(writer, &written, &stalls);
+    printf("Snapshots: %d written, %d pushes waited for a free buffer\n", written, stalls);
+  }
+  printf("Execution time (SCHEME=%d, N=%" POISSON1D_PRId "): %f ms\n", SCHEME, nbpoints, time_ms);
+  printf("Time per step: %f us\n", time_ms * 1000.0 / nsteps);
+  poisson1D_timing_add_count(POISSON1D_PHASE_ITER, nsteps);
+  poisson1D_timing_print();
+
+  /* Exact solutions: continuous, and discrete (the eigenmode is damped by g per step) */
+  lambda = eigmin_poisson1D(&la) / (h * h);
+  g = (1.0 - (1.0 - theta) * dt * lambda) / (1.0 + theta * dt * lambda);
+  set_analytical_solution_DBC_1D(EX_SOL, X, &la, &T0, &T1);
+  set_analytical_solution_DBC_1D(DISC_SOL, X, &la, &T0, &T1);
+  for (poisson1D_int i = 0; i < la; i++) {
+    EX_SOL[i] += exp(-M_PI * M_PI * T_FINAL) * sin(M_PI * X[i]);
+    DISC_SOL[i] += pow(g, nsteps) * sin(M_PI * X[i]);
+  }
+
+  poisson1D_timing_begin(POISSON1D_PHASE_WRITE);
+  if (text) {write_xy(U, X, &la, "SOL.dat");} else {write_xy_bin(U, X, &la, "SOL.bin");}
+  poisson1D_timing_end(POISSON1D_PHASE_WRITE);
+
+  printf("\nRelative error vs the discrete solution = %e\n", relative_forward_error(DISC_SOL, U, &la));
+  printf("The relative forward error is relres = %e\n", relative_forward_error(EX_SOL, U, &la));
+
+  free(U);
+  free(EX_SOL);
+  free(DISC_SOL);
+  free(X);
+  poisson1D_heat_destroy(stepper);
+
+  char *report = getenv("POISSON1D_TIMING");
+  if (report != NULL) {
+    poisson1D_timing_write(report, "heat", &SCHEME, &nbpoints);
+  }
+  poisson1D_timing_finalize();
+  printf("\n\n--------- End -----------\n");
+  return 0;
+}
@@ -13,13 +13,39 @@
 
 #define CSR 3 /* Richardson with CSR format */
 #define CSC 4 /* Richardson with CSC format */
+#define STENCIL 5 /* Matrix-free fused Richardson on the -1/2/-1 stencil */
+#define GSRB 6    /* Red-black Gauss-Seidel (parallel colour sweeps) */
+#define CG 7          /* Conjugate Gradient with GB format */
+#define PCG 8         /* Jacobi-preconditioned Conjugate Gradient with GB format */
+#define CG_CSR 9      /* Jacobi-preconditioned Conjugate Gradient with CSR format */
+#define CG_STENCIL 10 /* Matrix-free Conjugate Gradient on the -1/2/-1 stencil */
+#define MG 11         /* Geometric multigrid V-cycles (Gauss-Seidel smoothing) */
+#define FMG 12        /* Full multigrid followed by V-cycles */
+#define CHEB 13       /* Chebyshev iteration with GB format */
+#define PCHEB 14      /* Jacobi-preconditioned Chebyshev iteration with GB format */
+#define CHEB_CSR 15   /* Jacobi-preconditioned Chebyshev iteration with CSR format */
+#define CHEB_CSC 16   /* Jacobi-preconditioned Chebyshev iteration with CSC format */
+#define DIA 17        /* Richardson with DIA format (SIMD kernels) */
+#define SELL 18       /* Richardson with SELL-C-sigma format (SIMD kernels) */
+#define CG_DIA 19     /* Jacobi-preconditioned Conjugate Gradient with DIA format */
+#define CG_SELL 20    /* Jacobi-preconditioned Conjugate Gradient with SELL-C-sigma format */
+#define ALPHA_TILED 21 /* Richardson with temporally blocked sweeps (s iterations per tile) */
+#define JAC_TILED 22   /* Jacobi with temporally blocked sweeps (s iterations per tile) */
+#define GS_STENCIL 23  /* Gauss-Seidel on the O(1) stencil operator (no AB nor MB) */
 
 /**
  * Main function to solve the 1D Poisson equation using iterative methods.
  * 
  * @param argc: Number of command-line arguments
  * @param argv: Array of argument strings
- *              argv[1] (optional): Method selection (0=ALPHA, 1=JAC, 2=GS, 3=CSR, 4=CSC)
+ *              argv[1] (optional): Method selection (0=ALPHA, 1=JAC, 2=GS, 3=CSR, 4=CSC, 5=STENCIL, 6=GSRB,
+ *                                        7=CG, 8=PCG, 9=CG_CSR, 10=CG_STENCIL, 11=MG, 12=FMG,
+ *                                        13=CHEB, 14=PCHEB, 15=CHEB_CSR, 16=CHEB_CSC,
+ *                                        17=DIA, 18=SELL, 19=CG_DIA, 20=CG_SELL,
+ *                                        21=ALPHA_TILED, 22=JAC_TILED, 23=GS_STENCIL)
+ *              argv[2] (optional): Number of discretization points
+ *              argv[3] (optional): Iterations per tile s of the tiled methods
+ *              argv[4] (optional): Tile length of the tiled methods
  * @return 0 on success
  */
 int main(int argc,char *argv[])
@@ -27,13 +53,13 @@ int main(int argc,char *argv[])
 /* ** argv: Values of arguments */
 {
   int ierr;                           /* Error code */
-  int jj;                             /* Loop counter */
-  int nbpoints, la;                   /* nbpoints: total points, la: interior points */
-  int ku, kl, lab, kv;               /* Band matrix parameters */
-  int *ipiv;                          /* Pivot indices (unused in iterative methods) */
-  int info;                           /* Info parameter */
-  int NRHS;                           /* Number of right-hand sides */
-  int IMPLEM = 0;                     /* Implementation method (ALPHA, JAC, GS, CSR_RICH, CSC_RICH) */
+  poisson1D_int jj;                   /* Loop counter */
+  poisson1D_int nbpoints, la;         /* nbpoints: total points, la: interior points */
+  poisson1D_int ku, kl, lab, kv;      /* Band matrix parameters */
+  poisson1D_int *ipiv;                /* Pivot indices (unused in iterative methods) */
+  poisson1D_int info;                 /* Info parameter */
+  poisson1D_int NRHS;                 /* Number of right-hand sides */
+  int IMPLEM = 0;                     /* Implementation method (see the IMPLEM defines above) */
   double T0, T1;                      /* Boundary conditions */
   double *RHS, *SOL, *EX_SOL, *X;     /* RHS, solution, exact solution, grid points */
   double *AB;                         /* Coefficient matrix */
@@ -51,8 +77,8 @@ int main(int argc,char *argv[])
     IMPLEM = atoi(argv[1]);
   } 
   
-  if (argc > 3) {
-    perror("Application takes at most two arguments");
+  if (argc > 5) {
+    perror("Application takes at most four arguments");
     exit(1);
   }
 
@@ -60,7 +86,7 @@ int main(int argc,char *argv[])
   NRHS=1;           /* Single right-hand side */
   nbpoints=12;      /* Total discretization points */
   if (argc >= 3) {
-      nbpoints = atoi(argv[2]);
+      nbpoints = (poisson1D_int) atoll(argv[2]);
   }
   la=nbpoints-2;    /* Interior points only */
 
@@ -69,6 +95,10 @@ int main(int argc,char *argv[])
   T1=20.0;          /* Right boundary value */
 
   printf("--------- Poisson 1D ---------\n\n");
+  /* Per-phase timers (report with POISSON1D_TIMING=file.json|file.csv, counters with POISSON1D_PERF=1) */
+  int counters = (getenv("POISSON1D_PERF") != NULL);
+  poisson1D_timing_init(&counters);
+
   /* Allocate memory for vectors */
   RHS=(double *) malloc(sizeof(double)*la);       /* Right-hand side */
   SOL=(double *) calloc(la, sizeof(double));      /* Solution (initialized to 0) */
@@ -82,9 +112,16 @@ int main(int argc,char *argv[])
   set_analytical_solution_DBC_1D(EX_SOL, X, &la, &T0, &T1); /* Compute exact solution */
   
   /* Write initial data to files */
-  write_vec(RHS, &la, "RHS.dat");
-  write_vec(EX_SOL, &la, "EX_SOL.dat");
-  write_vec(X, &la, "X_grid.dat");
+  int text = poisson1D_output_text();  /* Binary .bin files, or .dat with POISSON1D_OUTPUT=text */
+  if (text) {
+    write_vec(RHS, &la, "RHS.dat");
+    write_vec(EX_SOL, &la, "EX_SOL.dat");
+    write_vec(X, &la, "X_grid.dat");
+  } else {
+    write_vec_bin(RHS, &la, "RHS.bin");
+    write_vec_bin(EX_SOL, &la, "EX_SOL.bin");
+    write_vec_bin(X, &la, "X_grid.bin");
+  }
 
   /* Set up band storage parameters */
   kv=0;             /* No extra space needed for problem construction */
@@ -93,11 +130,12 @@ int main(int argc,char *argv[])
   lab=kv+kl+ku+1;   /* Leading dimension of band storage */
   
   /* Allocate and initialize coefficient matrix */
-  AB = (double *) malloc(sizeof(double)*lab*la);
+  AB = (double *) poisson1D_malloc(lab, la, sizeof(double));
   set_GB_operator_colMajor_poisson1D(AB, &lab, &la, &kv);
   
   /* uncomment the following to check matrix A */
-  write_GB_operator_colMajor_poisson1D(AB, &lab, &la, "AB.dat");
+  if (text) write_GB_operator_colMajor_poisson1D(AB, &lab, &la, "AB.dat");
+  else write_GB_operator_colMajor_poisson1D_bin(AB, &lab, &la, &kl, &ku, &kv, "AB.bin");
   
   /********************************************/
   /* Solution (Richardson with optimal alpha) */
@@ -114,42 +152,98 @@ int main(int argc,char *argv[])
 
   resvec=(double *) calloc(maxit, sizeof(double));
 
-  clock_t start, end;
+  /* Scratch space shared by the solvers and the error norm, allocated once */
+  int wsmethod = POISSON1D_WS_ALL;
+  Poisson1DWorkspace *ws = poisson1D_workspace_create(&wsmethod, &la);
+
+  /* Wall-clock timing (CPU time would add up the time of all threads) */
+  struct timespec start, end;
   double cpu_time_used;
-  start = clock();
+  clock_gettime(CLOCK_MONOTONIC, &start);
 
   /* Solve with Richardson alpha (simple Richardson with optimal alpha) */
   if (IMPLEM == ALPHA) {
-    richardson_alpha(AB, RHS, SOL, &opt_alpha, &lab, &la, &ku, &kl, &tol, &maxit, resvec, &nbite);
+    richardson_alpha_ws(AB, RHS, SOL, &opt_alpha, &lab, &la, &ku, &kl, &tol, &maxit, resvec, &nbite, ws);
   }
 
   /* Richardson General Tridiag (Preconditioned methods) */
 
-  /* get MB (:=M, D for Jacobi, (D-E) for Gauss-seidel) */
+  /* get MB (:=M, (D-E) for Gauss-seidel). Jacobi (M = D) reads the diagonal row of AB in place */
   kv = 0;               /* No extra space needed for iterative methods */
   ku = 1;
   kl = 1;
-  MB = (double *) malloc(sizeof(double)*(lab)*la);
+  MB = NULL;           /* Only allocated for the Gauss-Seidel variants */
+  if (IMPLEM == GS || IMPLEM == GSRB) {
+    MB = (double *) poisson1D_malloc(lab, la, sizeof(double));
+  }
   
   /* Extract preconditioner matrix based on method */
-  if (IMPLEM == JAC) {
-    /* Jacobi: MB = D (diagonal of A) */
-    extract_MB_jacobi_tridiag(AB, MB, &lab, &la, &ku, &kl, &kv);
-  } else if (IMPLEM == GS) {
+  if (IMPLEM == GS) {
     /* Gauss-Seidel: MB = D - E (lower triangular + diagonal) */
     extract_MB_gauss_seidel_tridiag(AB, MB, &lab, &la, &ku, &kl, &kv);
+  } else if (IMPLEM == GSRB) {
+    /* Red-black Gauss-Seidel: MB = D - E for the red-then-black ordering */
+    extract_MB_gauss_seidel_redblack_tridiag(AB, MB, &lab, &la, &ku, &kl, &kv);
+  }
+
+  /* Solve with Jacobi */
+  if (IMPLEM == JAC) {
+    richardson_jacobi_ws(AB, RHS, SOL, &lab, &la, &ku, &kl, &tol, &maxit, resvec, &nbite, ws);
   }
 
   /* Solve with General Richardson (preconditioned) */
-  if (IMPLEM == JAC || IMPLEM == GS) {
-    write_GB_operator_colMajor_poisson1D(MB, &lab, &la, "MB.dat");
-    richardson_MB(AB, RHS, SOL, MB, &lab, &la, &ku, &kl, &tol, &maxit, resvec, &nbite);
+  if (IMPLEM == GS) {
+    if (text) write_GB_operator_colMajor_poisson1D(MB, &lab, &la, "MB.dat");
+    else write_GB_operator_colMajor_poisson1D_bin(MB, &lab, &la, &kl, &ku, &kv, "MB.bin");
+    richardson_MB_ws(AB, RHS, SOL, MB, &lab, &la, &ku, &kl, &tol, &maxit, resvec, &nbite, ws);
+  }
+
+  /* Solve with red-black Gauss-Seidel */
+  if (IMPLEM == GSRB) {
+    if (text) write_GB_operator_colMajor_poisson1D(MB, &lab, &la, "MB.dat");
+    else write_GB_operator_colMajor_poisson1D_bin(MB, &lab, &la, &kl, &ku, &kv, "MB.bin");
+    richardson_MB_redblack_ws(AB, RHS, SOL, MB, &lab, &la, &ku, &kl, &tol, &maxit, resvec, &nbite, ws);
+  }
+
+  /* Solve with Conjugate Gradient (GB), plain or Jacobi-preconditioned (AB passed as MB: M = diag(A), inverted in the workspace) */
+  if (IMPLEM == CG) {
+    conjugate_gradient_ws(AB, RHS, SOL, NULL, &lab, &la, &ku, &kl, &tol, &maxit, resvec, &nbite, ws);
+  }
+  if (IMPLEM == PCG) {
+    conjugate_gradient_ws(AB, RHS, SOL, AB, &lab, &la, &ku, &kl, &tol, &maxit, resvec, &nbite, ws);
+  }
+
+  /* Solve with Chebyshev iteration: spectral bounds of A, halved for Jacobi (D = 2I) */
+  double eigmin = eigmin_poisson1D(&la), eigmax = eigmax_poisson1D(&la);
+  double eigmin_jac = 0.5 * eigmin, eigmax_jac = 0.5 * eigmax;
+  int check = 10;       /* Residual norm evaluated every 'check' iterations */
+  if (IMPLEM == CHEB) {
+    chebyshev_ws(AB, RHS, SOL, NULL, &lab, &la, &ku, &kl, &eigmin, &eigmax, &check, &tol, &maxit, resvec, &nbite, ws);
+  }
+  if (IMPLEM == PCHEB) {
+    chebyshev_ws(AB, RHS, SOL, AB, &lab, &la, &ku, &kl, &eigmin_jac, &eigmax_jac, &check, &tol, &maxit, resvec, &nbite, ws);
+  }
+  if (IMPLEM == CHEB_CSR) {
+      int jacobi = 1;
+      set_CSR_operator_poisson1D(&CSR_A, &la);
+      chebyshev_csr(&CSR_A, RHS, SOL, &jacobi, &eigmin_jac, &eigmax_jac, &check, &tol, &maxit, resvec, &nbite);
+      free(CSR_A.values);
+      free(CSR_A.col_ind);
+      free(CSR_A.row_ptr);
+  }
+  if (IMPLEM == CHEB_CSC) {
+      int jacobi = 1;
+      set_CSC_operator_poisson1D(&CSC_A, &la);
+      chebyshev_csc(&CSC_A, RHS, SOL, &jacobi, &eigmin_jac, &eigmax_jac, &check, &tol, &maxit, resvec, &nbite);
+      free(CSC_A.values);
+      free(CSC_A.row_ind);
+      free(CSC_A.col_ptr);
   }
 
   /* Solve with CSR Richardson */
   if (IMPLEM == CSR) {
       set_CSR_operator_poisson1D(&CSR_A, &la);
-      richardson_alpha_csr(&CSR_A, RHS, SOL, &opt_alpha, &tol, &maxit, resvec, &nbite);
+      richardson_alpha_csr_ws(&CSR_A, RHS, SOL, &opt_alpha, &tol, &maxit, resvec, &nbite, ws);
       // Free CSR
       free(CSR_A.values);
       free(CSR_A.col_ind);
@@ -159,26 +253,108 @@ int main(int argc,char *argv[])
   /* Solve with CSC Richardson */
   if (IMPLEM == CSC) {
       set_CSC_operator_poisson1D(&CSC_A, &la);
-      richardson_alpha_csc(&CSC_A, RHS, SOL, &opt_alpha, &tol, &maxit, resvec, &nbite);
+      richardson_alpha_csc_ws(&CSC_A, RHS, SOL, &opt_alpha, &tol, &maxit, resvec, &nbite, ws);
       // Free CSC
       free(CSC_A.values);
       free(CSC_A.row_ind);
       free(CSC_A.col_ptr);
   }
+
+  /* Solve with Jacobi-preconditioned Conjugate Gradient (CSR) */
+  if (IMPLEM == CG_CSR) {
+      int jacobi = 1;
+      set_CSR_operator_poisson1D(&CSR_A, &la);
+      conjugate_gradient_csr(&CSR_A, RHS, SOL, &jacobi, &tol, &maxit, resvec, &nbite);
+      free(CSR_A.values);
+      free(CSR_A.col_ind);
+      free(CSR_A.row_ptr);
+  }
+
+  /* Solve with the DIA / SELL-C-sigma formats, converted from CSR */
+  if (IMPLEM == DIA || IMPLEM == SELL || IMPLEM == CG_DIA || IMPLEM == CG_SELL) {
+      DIAMatrix DIA_A;
+      SELLMatrix SELL_A;
+      int C = POISSON1D_SELL_C, sigma = 1, jacobi = 1, conv;
+      int dia = (IMPLEM == DIA || IMPLEM == CG_DIA);
+      set_CSR_operator_poisson1D(&CSR_A, &la);
+      conv = dia ? csr_to_dia(&CSR_A, &DIA_A) : csr_to_sell(&CSR_A, &C, &sigma, &SELL_A);
+      free(CSR_A.values);
+      free(CSR_A.col_ind);
+      free(CSR_A.row_ptr);
+      if (conv == 0) {
+          printf("SpMV kernels: %s\n", poisson1D_simd_name(poisson1D_simd_level()));
+          if (IMPLEM == DIA) richardson_alpha_dia_ws(&DIA_A, RHS, SOL, &opt_alpha, &tol, &maxit, resvec, &nbite, ws);
+          if (IMPLEM == SELL) richardson_alpha_sell_ws(&SELL_A, RHS, SOL, &opt_alpha, &tol, &maxit, resvec, &nbite, ws);
+          if (IMPLEM == CG_DIA) conjugate_gradient_dia(&DIA_A, RHS, SOL, &jacobi, &tol, &maxit, resvec, &nbite);
+          if (IMPLEM == CG_SELL) conjugate_gradient_sell(&SELL_A, RHS, SOL, &jacobi, &tol, &maxit, resvec, &nbite);
+          if (dia) free_DIA_matrix(&DIA_A); else free_SELL_matrix(&SELL_A);
+      } else {
+          printf("\n Sparse format conversion failed\n");
+      }
+  }
+
+  /* Solve with matrix-free Conjugate Gradient */
+  if (IMPLEM == CG_STENCIL) {
+      conjugate_gradient_stencil(RHS, SOL, &la, &tol, &maxit, resvec, &nbite);
+  }
+
+  /* Solve with geometric multigrid (nbpoints = 2^k + 1 keeps every level nested) */
+  if (IMPLEM == MG || IMPLEM == FMG) {
+      int smoother = MG_SMOOTHER_GS, maxlevels = 0;
+      int fmg = (IMPLEM == FMG);
+      MGHierarchy *mg = mg_hierarchy_create(&la, &smoother, &maxlevels);
+      if (mg != NULL) {
+          printf("Multigrid levels: %d\n", mg->nlevels);
+          multigrid_solve(mg, RHS, SOL, &fmg, &tol, &maxit, resvec, &nbite);
+          mg_hierarchy_destroy(mg);
+      } else {
+          printf("\n Multigrid hierarchy allocation failed\n");
+      }
+  }
+
+  /* Solve with temporally blocked Richardson / Jacobi (convergence tested every s iterations) */
+  if (IMPLEM == ALPHA_TILED || IMPLEM == JAC_TILED) {
+      int steps = (argc >= 4) ? atoi(argv[3]) : POISSON1D_TILE_STEPS;
+      int tile = (argc >= 5) ? atoi(argv[4]) : POISSON1D_TILE_SIZE;
+      double one = 1.0;
+      printf("Tiled sweeps: s = %d, tile = %d\n", steps, tile);
+      if (IMPLEM == ALPHA_TILED) richardson_tiled(AB, RHS, SOL, NULL, &opt_alpha, &lab, &la, &ku, &kl, &steps, &tile, &tol, &maxit, resvec, &nbite);
+      else richardson_tiled(AB, RHS, SOL, AB, &one, &lab, &la, &ku, &kl, &steps, &tile, &tol, &maxit, resvec, &nbite);
+  }
+
+  /* Solve with matrix-free stencil Richardson (no AB, single pass per iteration) */
+  if (IMPLEM == STENCIL) {
+      richardson_alpha_stencil(RHS, SOL, &opt_alpha, &la, &tol, &maxit, resvec, &nbite);
+  }
+
+  /* Solve with Gauss-Seidel on the stencil operator (three coefficients instead of AB and MB) */
+  if (IMPLEM == GS_STENCIL) {
+      StencilOperator ST_A;
+      int prec = POISSON1D_STENCIL_GS;
+      set_stencil_operator_poisson1D(&ST_A, &la);
+      printf("Operator storage (stencil): %zu bytes\n", sizeof(StencilOperator));
+      richardson_stencil_op(&ST_A, RHS, SOL, &opt_alpha, &prec, &tol, &maxit, resvec, &nbite);
+  }
   
-  end = clock();
-  cpu_time_used = ((double) (end - start)) * 1000.0 / CLOCKS_PER_SEC; // in ms
-  printf("Execution time (IMPLEM=%d, N=%d): %f ms\n", IMPLEM, nbpoints, cpu_time_used);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  cpu_time_used = (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_nsec - start.tv_nsec) / 1.0e6; // in ms
+  printf("Execution time (IMPLEM=%d, N=%" POISSON1D_PRId "): %f ms\n", IMPLEM, nbpoints, cpu_time_used);
   printf("Nb iterations: %d\n", nbite);
+  poisson1D_timing_add_count(POISSON1D_PHASE_ITER, nbite);
+  poisson1D_timing_print();
 
   /* Write solution and convergence history to files */
-  write_vec(SOL, &la, "SOL.dat");              /* Final solution */
-
-  /* Write convergence history */
-  write_vec(resvec, &nbite, "RESVEC.dat");     /* Residual norm at each iteration */
+  poisson1D_int nres = nbite;
+  if (text) {
+    write_vec(SOL, &la, "SOL.dat");              /* Final solution */
+    write_vec(resvec, &nres, "RESVEC.dat");      /* Residual norm at each iteration */
+  } else {
+    write_vec_bin(SOL, &la, "SOL.bin");
+    write_vec_bin(resvec, &nres, "RESVEC.bin");
+  }
   
   /* Validate result */
-  relres = relative_forward_error(SOL, EX_SOL, &la);
+  relres = relative_forward_error_ws(SOL, EX_SOL, &la, ws);
   printf("\nThe relative forward error is relres = %e\n", relres);
 
   /* Free allocated memory */
@@ -189,5 +365,13 @@ int main(int argc,char *argv[])
   free(X);
   free(AB);
   free(MB);
+  poisson1D_workspace_destroy(ws);
+
+  /* Machine-readable per-phase report */
+  char *report = getenv("POISSON1D_TIMING");
+  if (report != NULL) {
+    poisson1D_timing_write(report, "iter", &IMPLEM, &nbpoints);
+  }
+  poisson1D_timing_finalize();
   printf("\n\n--------- End -----------\n");
 }
@@ -0,0 +1,177 @@
+/******************************************/
+/* tp_poisson1D_mpi.c                     */
+/* This file contains the main function   */
+/* to solve the Poisson 1D problem with   */
+/* MPI domain decomposition               */
+/******************************************/
+#include "lib_poisson1D_mpi.h"
+
+#define ALPHA 0 /* Distributed Richardson iteration with optimal alpha */
+#define JAC 1   /* Distributed Jacobi iteration */
+#define CG 2    /* Distributed Conjugate Gradient */
+#define PCG 3   /* Distributed Jacobi-preconditioned Conjugate Gradient */
+#define PAR 4   /* Distributed partitioned tridiagonal direct solve (one partition per rank) */
+
+/**
+ * Main function to solve the 1D Poisson equation with the grid split into one contiguous slice
+ * per MPI rank (run with mpirun -np K).
+ *
+ * @param argc: Number of command-line arguments
+ * @param argv: Array of argument strings
+ *              argv[1] (optional): Method selection (0=ALPHA, 1=JAC, 2=CG, 3=PCG, 4=PAR)
+ *              argv[2] (optional): Number of discretization points
+ *              argv[3] (optional): Maximum number of iterations of the iterative methods
+ * @return 0 on success
+ */
+int main(int argc,char *argv[])
+{
+  poisson1D_int nbpoints, la;         /* nbpoints: total points, la: interior points */
+  poisson1D_int ku, kl, kv, lab;      /* Band matrix parameters (local operator) */
+  poisson1D_int info = 0;
+  int IMPLEM = ALPHA;
+  int nbite = 0, maxit = 1000;
+  double tol = 1e-3;
+  double T0, T1;
+  double *RHS, *SOL, *EX_SOL, *X, *AB = NULL, *MB = NULL, *resvec = NULL;
+  Poisson1DDist dist;
+
+  MPI_Init(&argc, &argv);
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if (argc > 4) {
+    if (rank == 0) {perror("Application takes at most three arguments");}
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+  nbpoints = 12;
+  if (argc >= 2) {IMPLEM = atoi(argv[1]);}
+  if (argc >= 3) {nbpoints = (poisson1D_int) atoll(argv[2]);}
+  if (argc >= 4) {maxit = atoi(argv[3]);}
+  la = nbpoints - 2;
+  T0 = 5.0;
+  T1 = 20.0;
+  if (IMPLEM < ALPHA || IMPLEM > PAR) {
+    if (rank == 0) {printf("Unknown method %d\n", IMPLEM);}
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+  if (poisson1D_dist_create(&dist, MPI_COMM_WORLD, &la) != 0) {
+    if (rank == 0) {printf("%" POISSON1D_PRId " interior points cannot be split over %d ranks\n", la, dist.size);}
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+  poisson1D_int n = dist.n;
+
+  if (rank == 0) {printf("--------- Poisson 1D (MPI, %d ranks) ---------\n\n", dist.size);}
+  int counters = (getenv("POISSON1D_PERF") != NULL);
+  poisson1D_timing_init(&counters);
+
+  RHS = (double *) malloc(sizeof(double) * n);
+  SOL = (double *) calloc(n, sizeof(double));
+  EX_SOL = (double *) malloc(sizeof(double) * n);
+  X = (double *) malloc(sizeof(double) * n);
+
+  /* Local slices of the problem: no rank ever holds a global vector */
+  kv = 0;
+  ku = 1;
+  kl = 1;
+  lab = kv + kl + ku + 1;
+  poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
+  set_grid_points_1D_dist(X, &dist);
+  set_dense_RHS_DBC_1D_dist(RHS, &dist, &T0, &T1);
+  set_analytical_solution_DBC_1D(EX_SOL, X, &n, &T0, &T1);
+  if (IMPLEM != PAR) {
+    AB = (double *) malloc(sizeof(double) * lab * n);
+    set_GB_operator_colMajor_poisson1D_dist(AB, &lab, &kv, &dist);
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+  if (IMPLEM == JAC || IMPLEM == PCG) {
+    poisson1D_timing_begin(POISSON1D_PHASE_PRECOND);
+    MB = (double *) malloc(sizeof(double) * lab * n);
+    extract_MB_jacobi_tridiag(AB, MB, &lab, &n, &ku, &kl, &kv);
+    poisson1D_timing_end(POISSON1D_PHASE_PRECOND);
+  }
+
+  MPI_Barrier(MPI_COMM_WORLD);
+  double start = MPI_Wtime();
+  if (IMPLEM == PAR) {
+    double *dl = (double *) malloc(sizeof(double) * n);
+    double *d = (double *) malloc(sizeof(double) * n);
+    double *du = (double *) malloc(sizeof(double) * n);
+    set_tridiag_operator_poisson1D_dist(dl, d, du, &dist);
+    cblas_dcopy(n, RHS, 1, SOL, 1);
+    poisson1D_timing_begin(POISSON1D_PHASE_SOLVE);
+    dgtsvpartition_dist(dl, d, du, SOL, &dist, &info);
+    poisson1D_timing_end(POISSON1D_PHASE_SOLVE);
+    free(dl);
+    free(d);
+    free(du);
+  } else {
+    double opt_alpha = richardson_alpha_opt(&la);
+    resvec = (double *) calloc(maxit, sizeof(double));
+    poisson1D_timing_begin(POISSON1D_PHASE_ITER);
+    if (IMPLEM == ALPHA) {richardson_dist(AB, RHS, SOL, NULL, &opt_alpha, &lab, &ku, &kl, &tol, &maxit, resvec, &nbite, &dist);}
+    if (IMPLEM == JAC) {richardson_dist(AB, RHS, SOL, MB, &opt_alpha, &lab, &ku, &kl, &tol, &maxit, resvec, &nbite, &dist);}
+    if (IMPLEM == CG) {conjugate_gradient_dist(AB, RHS, SOL, NULL, &lab, &ku, &kl, &tol, &maxit, resvec, &nbite, &dist);}
+    if (IMPLEM == PCG) {conjugate_gradient_dist(AB, RHS, SOL, MB, &lab, &ku, &kl, &tol, &maxit, resvec, &nbite, &dist);}
+    poisson1D_timing_end(POISSON1D_PHASE_ITER);
+    poisson1D_timing_add_count(POISSON1D_PHASE_ITER, nbite);
+  }
+  /* The slowest rank sets the time */
+  double elapsed = MPI_Wtime() - start, time_max;
+  MPI_Reduce(&elapsed, &time_max, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+  double relres = relative_forward_error_dist(EX_SOL, SOL, &dist);
+
+  if (rank == 0) {
+    if (info != 0) {printf("\n INFO DGTSVPARTITION_DIST = %" POISSON1D_PRId "\n", info);}
+    printf("Local points per rank: %" POISSON1D_PRId " to %" POISSON1D_PRId "\n", la / dist.size, (la + dist.size - 1) / dist.size);
+    if (IMPLEM != PAR) {printf("Nb iterations: %d\n", nbite);}
+    printf("Execution time (IMPLEM=%d, N=%" POISSON1D_PRId ", P=%d): %f ms\n", IMPLEM, nbpoints, dist.size, time_max * 1000.0);
+    poisson1D_timing_print();
+  }
+
+  /* Solution in one file: MPI-IO for the binary format, gathered on rank 0 for text */
+  int text = poisson1D_output_text();
+  poisson1D_timing_begin(POISSON1D_PHASE_WRITE);
+  if (text) {
+    int *counts = NULL, *displs = NULL;
+    double *glob = NULL;
+    if (rank == 0) {
+      counts = (int *) malloc(sizeof(int) * dist.size);
+      displs = (int *) malloc(sizeof(int) * dist.size);
+      glob = (double *) malloc(sizeof(double) * la);
+      for (int p = 0; p < dist.size; p++) {
+        displs[p] = (int)(((long)la * p) / dist.size);
+        counts[p] = (int)(((long)la * (p + 1)) / dist.size) - displs[p];
+      }
+    }
+    MPI_Gatherv(SOL, (int) n, MPI_DOUBLE, glob, counts, displs, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    if (rank == 0) {write_vec(glob, &la, "SOL.dat");}
+    free(counts);
+    free(displs);
+    free(glob);
+  } else {
+    write_vec_bin_dist(SOL, &dist, "SOL.bin");
+  }
+  if (rank == 0 && resvec != NULL) {
+    poisson1D_int nres = (nbite < maxit) ? nbite + 1 : maxit;
+    if (text) {write_vec(resvec, &nres, "RESVEC.dat");} else {write_vec_bin(resvec, &nres, "RESVEC.bin");}
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_WRITE);
+
+  if (rank == 0) {printf("\nThe relative forward error is relres = %e\n", relres);}
+
+  free(RHS);
+  free(SOL);
+  free(EX_SOL);
+  free(X);
+  free(AB);
+  free(MB);
+  free(resvec);
+
+  char *report = getenv("POISSON1D_TIMING");
+  if (report != NULL && rank == 0) {
+    poisson1D_timing_write(report, "mpi", &IMPLEM, &nbpoints);
+  }
+  poisson1D_timing_finalize();
+  if (rank == 0) {printf("\n\n--------- End -----------\n");}
+  MPI_Finalize();
+  return 0;
+}
@@ -0,0 +1,119 @@
+/******************************************/
+/* tp_poisson2D.c                         */
+/* This file contains the main function   */
+/* to solve the 2D Poisson problem with   */
+/* ADI line solves or PCG on CSR          */
+/******************************************/
+#include "lib_poisson1D.h"
+#include <time.h>
+
+#define ADI 0     /* Peaceman-Rachford ADI, batched tridiagonal line solves */
+#define PCG_CSR 1 /* Jacobi-preconditioned Conjugate Gradient with CSR format (baseline) */
+
+/**
+ * Main function to solve -lap u = f on an N x N interior grid (five-point stencil, homogeneous
+ * Dirichlet BC, exact solution u = x (1 - x) y (1 - y))
+ *
+ * @param argc: Number of command-line arguments
+ * @param argv: Array of argument strings
+ *              argv[1] (optional): Method selection (0=ADI, 1=PCG_CSR)
+ *              argv[2] (optional): Number of interior points per direction N
+ *              argv[3] (optional): Tolerance on the relative residual
+ * @return 0 on success
+ */
+int main(int argc,char *argv[])
+{
+  poisson1D_int nx, ny, n;       /* Interior points per direction, unknowns */
+  int nbite = 0, maxit;
+  int IMPLEM = ADI;
+  double tol = 1e-6;
+  double *RHS, *SOL, *EX_SOL, *R, *resvec;
+  CSRMatrix CSR_A;
+
+  if (argc > 4) {
+    perror("Application takes at most three arguments");
+    exit(1);
+  }
+  nx = 255;
+  if (argc >= 2) {IMPLEM = atoi(argv[1]);}
+  if (argc >= 3) {nx = (poisson1D_int) atoll(argv[2]);}
+  if (argc >= 4) {tol = atof(argv[3]);}
+  if (IMPLEM != ADI && IMPLEM != PCG_CSR) {
+    printf("Unknown method %d\n", IMPLEM);
+    exit(1);
+  }
+  ny = nx;
+  n = nx * ny;
+  /* CG needs O(N) iterations, ADI O(log N) */
+  maxit = (int) (10 * nx + 100);
+
+  printf("--------- Poisson 2D ---------\n\n");
+  int counters = (getenv("POISSON1D_PERF") != NULL);
+  poisson1D_timing_init(&counters);
+
+  RHS = (double *) malloc(sizeof(double) * (size_t)n);
+  SOL = (double *) calloc((size_t)n, sizeof(double));
+  EX_SOL = (double *) malloc(sizeof(double) * (size_t)n);
+  R = (double *) malloc(sizeof(double) * (size_t)n);
+  resvec = (double *) calloc(maxit, sizeof(double));
+
+  poisson1D_timing_begin(POISSON1D_PHASE_ASSEMBLY);
+  set_dense_RHS_poisson2D(RHS, &nx, &ny);
+  set_analytical_solution_poisson2D(EX_SOL, &nx, &ny);
+  set_CSR_operator_poisson2D(&CSR_A, &nx, &ny);
+  poisson1D_timing_end(POISSON1D_PHASE_ASSEMBLY);
+
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  poisson1D_timing_begin(POISSON1D_PHASE_ITER);
+  if (IMPLEM == ADI) {
+    int nshifts = adi_poisson2D_nshifts(&nx, &ny);
+    printf("ADI with %d shifts per cycle\n", nshifts);
+    adi_poisson2D(RHS, SOL, &nx, &ny, &nshifts, &tol, &maxit, resvec, &nbite);
+  }
+  if (IMPLEM == PCG_CSR) {
+    int jacobi = 1;
+    conjugate_gradient_csr(&CSR_A, RHS, SOL, &jacobi, &tol, &maxit, resvec, &nbite);
+  }
+  poisson1D_timing_end(POISSON1D_PHASE_ITER);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  poisson1D_timing_add_count(POISSON1D_PHASE_ITER, nbite);
+  double time_ms = (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_nsec - start.tv_nsec) / 1.0e6;
+
+  /* True residual of the returned solution */
+  dcsrmv(&CSR_A, SOL, R);
+  for (poisson1D_int k = 0; k < n; k++) {R[k] = RHS[k] - R[k];}
+  double relres_true = cblas_dnrm2(n, R, 1) / cblas_dnrm2(n, RHS, 1);
+
+  printf("Iterations: %d (maxit %d, tol %e)\n", nbite, maxit, tol);
+  printf("Execution time (IMPLEM=%d, N=%" POISSON1D_PRId "): %f ms\n", IMPLEM, nx, time_ms);
+  printf("Throughput (IMPLEM=%d, N=%" POISSON1D_PRId "): %f Mpoints*it/s\n", IMPLEM, nx, (nbite > 0) ? (double)n * nbite / (time_ms * 1.0e3) : 0.0);
+  printf("Final relative residual = %e\n", relres_true);
+  poisson1D_timing_print();
+
+  /* Convergence history */
+  int text = poisson1D_output_text();
+  poisson1D_int nres = (nbite < maxit) ? nbite + 1 : maxit;
+  poisson1D_timing_begin(POISSON1D_PHASE_WRITE);
+  if (text) {write_vec(resvec, &nres, "RESVEC2D.dat");} else {write_vec_bin(resvec, &nres, "RESVEC2D.bin");}
+  poisson1D_timing_end(POISSON1D_PHASE_WRITE);
+
+  printf("\nThe relative forward error is relres = %e\n", relative_forward_error(EX_SOL, SOL, &n));
+
+  free(RHS);
+  free(SOL);
+  free(EX_SOL);
+  free(R);
+  free(resvec);
+  free(CSR_A.values);
+  free(CSR_A.col_ind);
+  free(CSR_A.row_ptr);
+
+  char *report = getenv("POISSON1D_TIMING");
+  if (report != NULL) {
+    poisson1D_timing_write(report, "poisson2D", &IMPLEM, &nx);
+  }
+  poisson1D_timing_finalize();
+  printf("\n\n--------- End -----------\n");
+  return 0;
+}